@@ -14,7 +14,8 @@ SOURCES += megasync-plugin.cpp \
     megasync-plugin-overlay.json
 
 
-HEADERS += megasync-plugin.h
+HEADERS += megasync-plugin.h \
+    megasync-plugin-cache.h
 
 # library
 target.path = $$system(kde4-config --path module | cut -d ":" -f2)
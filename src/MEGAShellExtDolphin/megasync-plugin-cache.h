@@ -0,0 +1,83 @@
+#ifndef _MEGA_SYNC_PLUGIN_CACHE_H_
+#define _MEGA_SYNC_PLUGIN_CACHE_H_
+
+#include <QCache>
+#include <QDir>
+#include <QString>
+#include <QStringList>
+
+// states answered by the Ext Server, valid until the Notify Server reports a change of the path.
+// The least recently used paths are dropped first
+class MegasyncPathStateCache
+{
+public:
+    explicit MegasyncPathStateCache(int maxPaths)
+        : m_states(maxPaths)
+    {
+    }
+
+    bool find(const QString& path, int& state)
+    {
+        if (int* cached = m_states.object(path))
+        {
+            m_hits++;
+            state = *cached;
+            return true;
+        }
+        m_misses++;
+        return false;
+    }
+
+    void insert(const QString& path, int state)
+    {
+        m_states.insert(path, new int(state));
+    }
+
+    void remove(const QString& path)
+    {
+        m_states.remove(path);
+    }
+
+    // remove the items of the folder and of its subfolders, and return their paths
+    QStringList removeChildren(const QString& folder)
+    {
+        QStringList removed;
+        QString prefix = folder + QDir::separator();
+        for (const QString& path : m_states.keys())
+        {
+            if (path.startsWith(prefix))
+            {
+                m_states.remove(path);
+                removed.append(path);
+            }
+        }
+        return removed;
+    }
+
+    void clear()
+    {
+        m_states.clear();
+    }
+
+    int size() const
+    {
+        return m_states.size();
+    }
+
+    long long hits() const
+    {
+        return m_hits;
+    }
+
+    long long misses() const
+    {
+        return m_misses;
+    }
+
+private:
+    QCache<QString, int> m_states;
+    long long m_hits = 0;
+    long long m_misses = 0;
+};
+
+#endif
@@ -11,6 +11,8 @@
 //#include <QLocalServer>
 #endif
 
+#include "megasync-plugin-cache.h"
+
 #include <QtNetwork/QLocalSocket>
 #include <QDir>
 #include <QMetaEnum>
@@ -38,6 +40,8 @@ const char OP_STRING      = 'T'; //Get Translated String
 const char OP_VIEW        = 'V'; //View on MEGA
 const char OP_PREVIOUS    = 'R'; //View previous versions
 
+const int PATH_STATE_CACHE_MAX_PATHS = 65536;
+
 class MegasyncDolphinOverlayPlugin : public KOverlayIconPlugin
 {
     Q_PLUGIN_METADATA(IID "com.megasync.ovarlayiconplugin" FILE "megasync-plugin-overlay.json")
@@ -51,6 +55,8 @@ class MegasyncDolphinOverlayPlugin : public KOverlayIconPlugin
     QLocalSocket sockExtServer;
     QString sockPathExtServer;
 
+    MegasyncPathStateCache m_pathStates;
+
 private slots:
 
     void sockNotifyServer_connected()
@@ -61,6 +67,8 @@ private slots:
     void sockNotifyServer_disconnected()
     {
         qDebug("MEGASYNCOVERLAYPLUGIN: disconnected from Notify Server");
+        // changes are not notified until it is connected again
+        m_pathStates.clear();
     }
 
     void sockNotifyServer_error(QLocalSocket::LocalSocketError err)
@@ -101,6 +109,9 @@ private slots:
             case 'P': // item state changed
                 action="item state changed";
                 break;
+            case 'R': // state of many items in the folder changed
+                action="folder items changed";
+                break;
             case 'A': // sync folder added
                 action="sync folder added";
                 break;
@@ -117,6 +128,21 @@ private slots:
 
             qDebug("MEGASYNCOVERLAYPLUGIN: Server notified <%s>: %s",action.toUtf8().constData(), url.toUtf8().constData());
 
+            if (*type == 'R')
+            {
+                folderChanged(url);
+                continue;
+            }
+
+            if (*type == 'P')
+            {
+                m_pathStates.remove(cacheKey(url));
+            }
+            else
+            {
+                m_pathStates.clear();
+            }
+
             emit overlaysChanged(QUrl::fromLocalFile(url), getOverlays(QUrl::fromLocalFile(url)));
         }
     }
@@ -124,6 +150,7 @@ private slots:
 public:
 
     MegasyncDolphinOverlayPlugin()
+        : m_pathStates(PATH_STATE_CACHE_MAX_PATHS)
     {
         qDebug("MEGASYNCOVERLAYPLUGIN: Loading plugin ... ");
 
@@ -200,11 +227,52 @@ public:
 
 private:
 
+    void folderChanged(const QString& folder)
+    {
+        m_pathStates.removeChildren(cacheKey(folder));
+
+        // Dolphin does not ask again for the items it shows, so every item of the folder is refreshed,
+        // as Nautilus and Nemo do
+        QDir dir(folder);
+        for (const QString& name : dir.entryList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot))
+        {
+            QUrl url = QUrl::fromLocalFile(dir.filePath(name));
+            emit overlaysChanged(url, getOverlays(url));
+        }
+    }
+
+    // states are cached by canonical path, as they are requested, so the paths notified under a symlinked sync
+    // find them too. Removed files have no canonical path
+    static QString cacheKey(const QString& path)
+    {
+        QString canonicalPath = QFileInfo(path).canonicalFilePath();
+        return canonicalPath.isEmpty() ? path : canonicalPath;
+    }
+
     int getState(QString path)
     {
+        QString canonicalPath = cacheKey(path);
+        int state;
+        if (m_pathStates.find(canonicalPath, state))
+        {
+            return state;
+        }
+
+        if ((m_pathStates.hits() + m_pathStates.misses()) % 1000 == 0)
+        {
+            qDebug("MEGASYNCOVERLAYPLUGIN: path state cache: %lld hits, %lld misses", m_pathStates.hits(), m_pathStates.misses());
+        }
+
         QString res;
-        res = sendRequest(OP_PATH_STATE, QFileInfo(path).canonicalFilePath());
-        return res.toInt();
+        res = sendRequest(OP_PATH_STATE, canonicalPath);
+
+        bool ok;
+        state = res.toInt(&ok);
+        if (ok && state != FILE_ERROR)
+        {
+            m_pathStates.insert(canonicalPath, state);
+        }
+        return state;
     }
 
     // send request and receive response from Extension server
@@ -17,6 +17,19 @@
 #include "mega_notify_client.h"
 #include <string.h>
 
+// time to gather the files requested by Nautilus in the same path state batch
+#define PATH_STATE_BATCH_DELAY_MS 20
+#define PATH_STATE_BATCH_MAX_FILES 512
+#define PATH_STATE_CACHE_MAX_PATHS 65536
+
+typedef struct {
+    NautilusFileInfo *file; // NULL if the update was cancelled
+    GClosure *update_complete; // NULL for items changed in the notify server
+    gchar *path; // path of the file, also the key of its cached state
+    gchar *canonical_path; // sent instead of path if the server did not find it
+    gboolean canonical_sent;
+} MEGAExtFileRequest;
+
 static GObjectClass *parent_class;
 
 static void mega_ext_class_init(MEGAExtClass *class, G_GNUC_UNUSED gpointer class_data)
@@ -29,6 +42,12 @@ static void mega_ext_instance_init(MEGAExt *mega_ext, G_GNUC_UNUSED gpointer g_c
     mega_ext->srv_sock = -1;
     mega_ext->notify_sock = -1;
     mega_ext->chan = NULL;
+    mega_ext->batch_sock = -1;
+    mega_ext->batch_chan = NULL;
+    mega_ext->pending_files = g_queue_new();
+    mega_ext->requested_files = g_ptr_array_new();
+    mega_ext->batch_timer = 0;
+    mega_ext->path_states = mega_ext_cache_new(PATH_STATE_CACHE_MAX_PATHS);
     mega_ext->num_retries = 2;
     mega_ext->h_syncs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
     mega_ext->string_getlink = NULL;
@@ -59,6 +78,147 @@ static const gchar *file_state_to_str(FileState state)
     }
 }
 
+static void mega_ext_file_request_free(MEGAExtFileRequest *request)
+{
+    if (request->file)
+        g_object_unref(request->file);
+    if (request->update_complete)
+        g_closure_unref(request->update_complete);
+    g_free(request->path);
+    g_free(request->canonical_path);
+    g_free(request);
+}
+
+static void mega_ext_add_emblem(NautilusFileInfo *file, FileState state)
+{
+    switch (state)
+    {
+        case FILE_SYNCED:
+            nautilus_file_info_add_emblem(file, "mega-synced");
+            break;
+        case FILE_PENDING:
+            nautilus_file_info_add_emblem(file, "mega-pending");
+            break;
+        case FILE_SYNCING:
+            nautilus_file_info_add_emblem(file, "mega-syncing");
+            break;
+        default:
+            break;
+    }
+}
+
+static void mega_ext_file_request_complete(MEGAExt *mega_ext, MEGAExtFileRequest *request, FileState state)
+{
+    if (!request->file) {
+        mega_ext_file_request_free(request);
+        return;
+    }
+
+    g_debug("mega_ext_update_file_info. File: %s  State: %s", request->path, file_state_to_str(state));
+
+    // items changed in the notify server were not requested by Nautilus
+    if (!request->update_complete)
+        nautilus_file_info_invalidate_extension_info(request->file);
+
+    mega_ext_add_emblem(request->file, state);
+
+    if (request->update_complete)
+        nautilus_info_provider_update_complete_invoke(request->update_complete, (NautilusInfoProvider*)mega_ext,
+                                                      (NautilusOperationHandle*)request, NAUTILUS_OPERATION_COMPLETE);
+
+    mega_ext_file_request_free(request);
+}
+
+// send the files waiting for their state, one batch at a time
+static gboolean mega_ext_send_path_states(gpointer user_data)
+{
+    MEGAExt *mega_ext = MEGA_EXT(user_data);
+    GPtrArray *paths;
+
+    mega_ext->batch_timer = 0;
+
+    // the rest are sent when the current batch is answered
+    if (mega_ext->requested_files->len)
+        return FALSE;
+
+    paths = g_ptr_array_new();
+    while (!g_queue_is_empty(mega_ext->pending_files) && paths->len < PATH_STATE_BATCH_MAX_FILES) {
+        MEGAExtFileRequest *request = g_queue_pop_head(mega_ext->pending_files);
+        g_ptr_array_add(mega_ext->requested_files, request);
+        g_ptr_array_add(paths, request->canonical_sent ? request->canonical_path : request->path);
+    }
+
+    if (paths->len && !mega_ext_client_request_path_states(mega_ext, paths, 0))
+        mega_ext_on_path_states(mega_ext, NULL);
+
+    g_ptr_array_free(paths, TRUE);
+
+    return FALSE;
+}
+
+// queue the file until its batch is sent
+static MEGAExtFileRequest *mega_ext_request_file_state(MEGAExt *mega_ext, NautilusFileInfo *file, const gchar *path,
+                                                       GClosure *update_complete)
+{
+    MEGAExtFileRequest *request = g_new0(MEGAExtFileRequest, 1);
+    char canonical[PATH_MAX];
+
+    request->file = g_object_ref(file);
+    request->update_complete = update_complete ? g_closure_ref(update_complete) : NULL;
+    request->path = g_strdup(path);
+    g_strlcpy(canonical, path, sizeof(canonical));
+    expanselocalpath(path, canonical);
+    request->canonical_path = g_strdup(canonical);
+    g_queue_push_tail(mega_ext->pending_files, request);
+
+    if (!mega_ext->batch_timer && !mega_ext->requested_files->len)
+        mega_ext->batch_timer = g_timeout_add(PATH_STATE_BATCH_DELAY_MS, mega_ext_send_path_states, mega_ext);
+
+    return request;
+}
+
+// received the answer of a path state batch, NULL if it failed
+void mega_ext_on_path_states(MEGAExt *mega_ext, const gchar *states)
+{
+    GPtrArray *requested = mega_ext->requested_files;
+    gsize num_states = states ? strlen(states) : 0;
+    guint i;
+
+    mega_ext->requested_files = g_ptr_array_new();
+    for (i = 0; i < requested->len; i++) {
+        MEGAExtFileRequest *request = g_ptr_array_index(requested, i);
+        FileState state = i < num_states ? (FileState)(states[i] - '0') : FILE_ERROR;
+
+        // syncs added through a symlink are only found by the canonical path, which is asked in the next batch
+        if (state == FILE_NOTFOUND && request->file && !request->canonical_sent
+                && strcmp(request->path, request->canonical_path)) {
+            request->canonical_sent = TRUE;
+            g_queue_push_tail(mega_ext->pending_files, request);
+            continue;
+        }
+
+        if (state != FILE_ERROR)
+            mega_ext_cache_insert(mega_ext->path_states, request->path, state);
+        mega_ext_file_request_complete(mega_ext, request, state);
+    }
+    g_ptr_array_free(requested, TRUE);
+
+    if (!states) {
+        // don't retry until new files are requested
+        while (!g_queue_is_empty(mega_ext->pending_files))
+            mega_ext_file_request_complete(mega_ext, g_queue_pop_head(mega_ext->pending_files), FILE_ERROR);
+        return;
+    }
+
+    if (!g_queue_is_empty(mega_ext->pending_files)) {
+        if (mega_ext->batch_timer) {
+            g_source_remove(mega_ext->batch_timer);
+            mega_ext->batch_timer = 0;
+        }
+        mega_ext_send_path_states(mega_ext);
+    }
+}
+
 // received path from notify server with the path to item which state was changed
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
 {
@@ -70,12 +230,39 @@ void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path)
     }
 
     NautilusFileInfo *file = nautilus_file_info_lookup(f);
+    g_object_unref(f);
     if (!file) {
         g_debug("No NautilusFileInfo found for %s!", path);
         return;
     }
     g_debug("Item changed: %s", path);
-    nautilus_info_provider_update_file_info((NautilusInfoProvider*)mega_ext, file, (void*)1, (void*)1);
+
+    // the file was found by this path, which is the key of its cached state
+    mega_ext_cache_remove(mega_ext->path_states, path);
+    mega_ext_request_file_state(mega_ext, file, path, NULL);
+    g_object_unref(file);
+}
+
+// received path from notify server of a folder with many items changed at once
+void mega_ext_on_folder_changed(MEGAExt *mega_ext, const gchar *path)
+{
+    GDir *dir;
+    const gchar *name;
+
+    g_debug("Folder changed: %s", path);
+    mega_ext_cache_remove_children(mega_ext->path_states, path);
+
+    dir = g_dir_open(path, 0, NULL);
+    if (!dir)
+        return;
+
+    // only the items known by Nautilus are requested, all of them in the same batch
+    while ((name = g_dir_read_name(dir))) {
+        gchar *child = g_build_filename(path, name, NULL);
+        mega_ext_on_item_changed(mega_ext, child);
+        g_free(child);
+    }
+    g_dir_close(dir);
 }
 
 // user clicked on "Upload to MEGA" menu item
@@ -120,12 +307,14 @@ void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path)
     if (!strcmp(path, "."))
         return;
     g_debug("New sync path: %s", path);
+    mega_ext_cache_clear(mega_ext->path_states);
     g_hash_table_insert(mega_ext->h_syncs, g_strdup(path), GINT_TO_POINTER(1));
 }
 
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path)
 {
     g_debug("Deleted sync path: %s", path);
+    mega_ext_cache_clear(mega_ext->path_states);
     g_hash_table_remove(mega_ext->h_syncs, path);
 }
 
@@ -481,12 +670,12 @@ static GList *mega_ext_get_file_items(NautilusMenuProvider *provider,
 }
 
 static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *provider,
-    NautilusFileInfo *file, G_GNUC_UNUSED GClosure *update_complete, G_GNUC_UNUSED NautilusOperationHandle **handle)
+    NautilusFileInfo *file, GClosure *update_complete, NautilusOperationHandle **handle)
 {
     MEGAExt *mega_ext = MEGA_EXT(provider);
     gchar *path;
     GFile *fp;
-    FileState state;
+    int cached_state;
 
     // invalidate current emblems.
     nautilus_file_info_invalidate_extension_info(file);
@@ -511,38 +700,37 @@ static NautilusOperationResult mega_ext_update_file_info(NautilusInfoProvider *p
     }
     g_debug("mega_ext_update_file_info %s", path);
 
-    state = mega_ext_client_get_path_state(mega_ext, path, 0);
-    if (state == FILE_NOTFOUND)
+    // states already answered are shown without asking the server
+    if (mega_ext_cache_lookup(mega_ext->path_states, path, &cached_state))
     {
-        char canonical[PATH_MAX];
-        expanselocalpath(path,canonical);
-        state = mega_ext_client_get_path_state(mega_ext, canonical, 0);
+        g_free(path);
+        mega_ext_add_emblem(file, cached_state);
+        return NAUTILUS_OPERATION_COMPLETE;
     }
 
-    g_debug("mega_ext_update_file_info. File: %s  State: %s", path, file_state_to_str(state));
+    // the state is requested with the other files shown, and the emblem added when it is received
+    *handle = (NautilusOperationHandle*)mega_ext_request_file_state(mega_ext, file, path, update_complete);
     g_free(path);
 
-    if (state == FILE_ERROR || state == FILE_NOTFOUND)
-    {
-        return NAUTILUS_OPERATION_COMPLETE;
-    }
+    return NAUTILUS_OPERATION_IN_PROGRESS;
+}
 
-    switch (state)
-    {
-        case FILE_SYNCED:
-            nautilus_file_info_add_emblem(file, "mega-synced");
-            break;
-        case FILE_PENDING:
-            nautilus_file_info_add_emblem(file, "mega-pending");
-            break;
-        case FILE_SYNCING:
-            nautilus_file_info_add_emblem(file, "mega-syncing");
-            break;
-        default:
-            break;
+static void mega_ext_cancel_update(NautilusInfoProvider *provider, NautilusOperationHandle *handle)
+{
+    MEGAExt *mega_ext = MEGA_EXT(provider);
+    MEGAExtFileRequest *request = (MEGAExtFileRequest*)handle;
+
+    if (g_queue_remove(mega_ext->pending_files, request)) {
+        mega_ext_file_request_free(request);
+        return;
     }
 
-    return NAUTILUS_OPERATION_COMPLETE;
+    // already sent, it is freed when its batch is answered
+    g_clear_object(&request->file);
+    if (request->update_complete) {
+        g_closure_unref(request->update_complete);
+        request->update_complete = NULL;
+    }
 }
 
 static void mega_ext_menu_provider_iface_init(
@@ -565,6 +753,7 @@ static void mega_ext_info_provider_iface_init(
         G_GNUC_UNUSED gpointer iface_data)
 {
     iface->update_file_info = mega_ext_update_file_info;
+    iface->cancel_update = mega_ext_cancel_update;
 }
 
 static GType mega_ext_type = 0;
@@ -2,6 +2,7 @@
 #define MEGASHELLEXT_H
 
 #include <glib-object.h>
+#include "mega_ext_cache.h"
 
 G_BEGIN_DECLS
 
@@ -16,8 +17,10 @@ struct _MEGAExt {
     GObject __parent;
     GIOChannel *chan;
     GIOChannel *notify_chan;
+    GIOChannel *batch_chan;
     int srv_sock;
     int notify_sock;
+    int batch_sock;
     gint num_retries; // reconnection retries
     gboolean syncs_received; // TRUE if the list with sync folders is received
 
@@ -27,6 +30,10 @@ struct _MEGAExt {
     gchar *string_viewonmega; // cached string
     gchar *string_viewprevious; // cached string
 
+    GQueue *pending_files; // files waiting to be sent in a path state batch
+    GPtrArray *requested_files; // files of the path state batch waiting for its answer
+    guint batch_timer; // source sending the next path state batch
+    MEGAExtCache *path_states; // states already answered by the server
 };
 
 struct _MEGAExtClass {
@@ -57,6 +64,8 @@ void  mega_ext_register_type(GTypeModule *module);
 G_END_DECLS
 
 void mega_ext_on_item_changed(MEGAExt *mega_ext, const gchar *path);
+void mega_ext_on_folder_changed(MEGAExt *mega_ext, const gchar *path);
+void mega_ext_on_path_states(MEGAExt *mega_ext, const gchar *states);
 void mega_ext_on_sync_add(MEGAExt *mega_ext, const gchar *path);
 void mega_ext_on_sync_del(MEGAExt *mega_ext, const gchar *path);
 void expanselocalpath(const char *path, char *absolutepath);
@@ -0,0 +1,142 @@
+#include "mega_ext_cache.h"
+
+// log the hit rate every STATS_INTERVAL lookups
+#define STATS_INTERVAL 1000
+
+typedef struct {
+    gchar *path;
+    int state;
+} MEGAExtCacheEntry;
+
+struct _MEGAExtCache {
+    GHashTable *h_entries; // path -> link in lru
+    GQueue lru; // most recently used first
+    guint max_paths;
+    guint64 hits;
+    guint64 misses;
+};
+
+static void mega_ext_cache_entry_free(MEGAExtCacheEntry *entry)
+{
+    g_free(entry->path);
+    g_free(entry);
+}
+
+MEGAExtCache *mega_ext_cache_new(guint max_paths)
+{
+    MEGAExtCache *cache = g_new0(MEGAExtCache, 1);
+    // keys are owned by the entries
+    cache->h_entries = g_hash_table_new(g_str_hash, g_str_equal);
+    g_queue_init(&cache->lru);
+    cache->max_paths = max_paths;
+    return cache;
+}
+
+void mega_ext_cache_free(MEGAExtCache *cache)
+{
+    mega_ext_cache_clear(cache);
+    g_hash_table_destroy(cache->h_entries);
+    g_free(cache);
+}
+
+gboolean mega_ext_cache_lookup(MEGAExtCache *cache, const gchar *path, int *state)
+{
+    GList *link = g_hash_table_lookup(cache->h_entries, path);
+
+    if (link) {
+        g_queue_unlink(&cache->lru, link);
+        g_queue_push_head_link(&cache->lru, link);
+        *state = ((MEGAExtCacheEntry *)link->data)->state;
+        cache->hits++;
+    }
+    else {
+        cache->misses++;
+    }
+
+    if ((cache->hits + cache->misses) % STATS_INTERVAL == 0)
+        g_debug("Path state cache: %" G_GUINT64_FORMAT " hits, %" G_GUINT64_FORMAT " misses",
+                cache->hits, cache->misses);
+
+    return link != NULL;
+}
+
+void mega_ext_cache_insert(MEGAExtCache *cache, const gchar *path, int state)
+{
+    GList *link = g_hash_table_lookup(cache->h_entries, path);
+    MEGAExtCacheEntry *entry;
+
+    if (link) {
+        ((MEGAExtCacheEntry *)link->data)->state = state;
+        g_queue_unlink(&cache->lru, link);
+        g_queue_push_head_link(&cache->lru, link);
+        return;
+    }
+
+    if (!cache->max_paths)
+        return;
+
+    if (g_queue_get_length(&cache->lru) >= cache->max_paths) {
+        entry = g_queue_pop_tail(&cache->lru);
+        g_hash_table_remove(cache->h_entries, entry->path);
+        mega_ext_cache_entry_free(entry);
+    }
+
+    entry = g_new(MEGAExtCacheEntry, 1);
+    entry->path = g_strdup(path);
+    entry->state = state;
+    g_queue_push_head(&cache->lru, entry);
+    g_hash_table_insert(cache->h_entries, entry->path, cache->lru.head);
+}
+
+void mega_ext_cache_remove(MEGAExtCache *cache, const gchar *path)
+{
+    GList *link = g_hash_table_lookup(cache->h_entries, path);
+    MEGAExtCacheEntry *entry;
+
+    if (!link)
+        return;
+
+    entry = link->data;
+    g_hash_table_remove(cache->h_entries, path);
+    g_queue_delete_link(&cache->lru, link);
+    mega_ext_cache_entry_free(entry);
+}
+
+// remove the items of the folder and of its subfolders
+void mega_ext_cache_remove_children(MEGAExtCache *cache, const gchar *folder)
+{
+    GHashTableIter iter;
+    gpointer path, link;
+    gchar *prefix = g_strconcat(folder, G_DIR_SEPARATOR_S, NULL);
+
+    g_hash_table_iter_init(&iter, cache->h_entries);
+    while (g_hash_table_iter_next(&iter, &path, &link)) {
+        if (g_str_has_prefix(path, prefix)) {
+            MEGAExtCacheEntry *entry = ((GList *)link)->data;
+            g_hash_table_iter_remove(&iter);
+            g_queue_delete_link(&cache->lru, link);
+            mega_ext_cache_entry_free(entry);
+        }
+    }
+
+    g_free(prefix);
+}
+
+void mega_ext_cache_clear(MEGAExtCache *cache)
+{
+    MEGAExtCacheEntry *entry;
+
+    g_hash_table_remove_all(cache->h_entries);
+    while ((entry = g_queue_pop_head(&cache->lru)))
+        mega_ext_cache_entry_free(entry);
+}
+
+guint64 mega_ext_cache_hits(MEGAExtCache *cache)
+{
+    return cache->hits;
+}
+
+guint64 mega_ext_cache_misses(MEGAExtCache *cache)
+{
+    return cache->misses;
+}
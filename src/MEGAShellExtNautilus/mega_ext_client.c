@@ -6,6 +6,7 @@
 #include <string.h>
 
 const gchar OP_PATH_STATE  = 'P'; //Path state
+const gchar OP_PATH_STATE_BATCH = 'B'; //Path states of several paths
 const gchar OP_INIT        = 'I'; //Init operation
 const gchar OP_END         = 'E'; //End operation
 const gchar OP_UPLOAD      = 'F'; //File-Folder upload
@@ -16,11 +17,15 @@ const gchar OP_STRING      = 'T'; //Get Translated String
 const gchar OP_VIEW        = 'V'; //View on MEGA
 const gchar OP_PREVIOUS    = 'R'; //View previous versions
 
+const gchar ASCII_FILE_SEP   = 0x1C;
+const gchar ASCII_RECORD_SEP = 0x1E;
+
 static void mega_ext_client_disconnect(MEGAExt *mega_ext);
+static void mega_ext_client_batch_disconnect(MEGAExt *mega_ext);
 
-// try to connect to the server
+// open a connection to the server
 // return TRUE if connection established
-static gboolean mega_ext_client_reconnect(MEGAExt *mega_ext)
+static gboolean mega_ext_client_connect(int *srv_sock, GIOChannel **chan)
 {
     int len;
     struct sockaddr_un remote;
@@ -29,9 +34,9 @@ static gboolean mega_ext_client_reconnect(MEGAExt *mega_ext)
     // XXX: current path MEGASync uses to store private data
     const gchar sock_path_hardcode[] = "data/Mega Limited/MEGAsync";
 
-    if ((mega_ext->srv_sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
+    if ((*srv_sock = socket(AF_UNIX, SOCK_STREAM, 0)) == -1) {
         g_warning("socket() failed");
-        goto failed;
+        return FALSE;
     }
 
     sock_path = g_build_filename(g_get_user_data_dir(), sock_path_hardcode, sock_file, NULL);
@@ -43,25 +48,33 @@ static gboolean mega_ext_client_reconnect(MEGAExt *mega_ext)
     g_debug("Connecting to: %s", remote.sun_path);
 
     len = strlen(remote.sun_path) + sizeof(remote.sun_family);
-    if (connect(mega_ext->srv_sock, (struct sockaddr *)&remote, len) == -1) {
+    if (connect(*srv_sock, (struct sockaddr *)&remote, len) == -1) {
         g_warning("connect() failed");
-        goto failed;
+        return FALSE;
     }
     g_debug("Connected to the server!");
 
-    mega_ext->chan = g_io_channel_unix_new(mega_ext->srv_sock);
-    if (!mega_ext->chan) {
+    *chan = g_io_channel_unix_new(*srv_sock);
+    if (!*chan) {
         g_warning("g_io_channel_unix_new() failed");
-        goto failed;
+        return FALSE;
     }
-    g_io_channel_set_close_on_unref(mega_ext->chan, TRUE);
-    g_io_channel_set_line_term(mega_ext->chan, "\n", -1);
+    g_io_channel_set_close_on_unref(*chan, TRUE);
+    g_io_channel_set_line_term(*chan, "\n", -1);
 
     return TRUE;
+}
 
-failed:
-    mega_ext_client_disconnect(mega_ext);
-    return FALSE;
+// try to connect to the server
+// return TRUE if connection established
+static gboolean mega_ext_client_reconnect(MEGAExt *mega_ext)
+{
+    if (!mega_ext_client_connect(&mega_ext->srv_sock, &mega_ext->chan)) {
+        mega_ext_client_disconnect(mega_ext);
+        return FALSE;
+    }
+
+    return TRUE;
 }
 
 // disconnect client
@@ -80,6 +93,53 @@ static void mega_ext_client_disconnect(MEGAExt *mega_ext)
     mega_ext->srv_sock = -1;
 }
 
+// disconnect the connection used for path state batches
+static void mega_ext_client_batch_disconnect(MEGAExt *mega_ext)
+{
+    g_debug("Batch client disconnected");
+
+    if (mega_ext->batch_chan) {
+        g_io_channel_shutdown(mega_ext->batch_chan, FALSE, NULL);
+        g_io_channel_unref(mega_ext->batch_chan);
+        mega_ext->batch_chan = NULL;
+    }
+
+    if (mega_ext->batch_sock > 0)
+        close(mega_ext->batch_sock);
+    mega_ext->batch_sock = -1;
+}
+
+// receive the answer of a path state batch: one state per path
+static gboolean mega_ext_client_on_path_states(GIOChannel *chan, GIOCondition condition, gpointer data)
+{
+    MEGAExt *mega_ext = (MEGAExt *)data;
+    gchar *out = NULL;
+    gsize term_pos = 0;
+    GError *error = NULL;
+    GIOStatus status = G_IO_STATUS_ERROR;
+
+    if (!(condition & (G_IO_HUP | G_IO_ERR)))
+        status = g_io_channel_read_line(chan, &out, NULL, &term_pos, &error);
+
+    if (status != G_IO_STATUS_NORMAL || error || !out) {
+        g_warning("Failed to read data!");
+        if (error)
+            g_error_free(error);
+        g_free(out);
+        mega_ext_client_batch_disconnect(mega_ext);
+        mega_ext_on_path_states(mega_ext, NULL);
+        return FALSE;
+    }
+
+    out[term_pos] = '\0';
+    g_debug("Batch responded: %s ", out);
+
+    mega_ext_on_path_states(mega_ext, out);
+    g_free(out);
+
+    return FALSE;
+}
+
 // send request and receive response from Extension server
 // Return newly-allocated response string
 static gchar *mega_ext_client_send_request(MEGAExt *mega_ext, gchar type, const gchar *in)
@@ -189,6 +249,58 @@ FileState mega_ext_client_get_path_state(MEGAExt *mega_ext, const gchar *path, i
     return st;
 }
 
+// send the paths in one request, which is answered to mega_ext_on_path_states() without blocking
+// paths are sent as queued: the path of the file, or its canonical path if the first was not found
+// return FALSE if the request could not be sent
+gboolean mega_ext_client_request_path_states(MEGAExt *mega_ext, GPtrArray *paths, int forceGetState)
+{
+    GString *request;
+    gsize bytes_written;
+    GError *error = NULL;
+    GIOStatus status;
+    guint i;
+
+    if (mega_ext->batch_sock < 0) {
+        if (!mega_ext_client_connect(&mega_ext->batch_sock, &mega_ext->batch_chan)) {
+            g_debug("Failed to connect!");
+            mega_ext_client_batch_disconnect(mega_ext);
+            return FALSE;
+        }
+    }
+
+    request = g_string_new(NULL);
+    g_string_append_printf(request, "%c:", OP_PATH_STATE_BATCH);
+    for (i = 0; i < paths->len; i++) {
+        if (i)
+            g_string_append_c(request, ASCII_RECORD_SEP);
+        g_string_append_printf(request, "%s%c%c", (const gchar*)g_ptr_array_index(paths, i), ASCII_FILE_SEP, forceGetState?'1':'0');
+    }
+    g_string_append_c(request, '\n');
+
+    g_debug("Sending batch of %u paths", paths->len);
+
+    status = g_io_channel_write_chars(mega_ext->batch_chan, request->str, request->len, &bytes_written, &error);
+    g_string_free(request, TRUE);
+    if (status == G_IO_STATUS_NORMAL && !error)
+        status = g_io_channel_flush(mega_ext->batch_chan, &error);
+
+    if (status != G_IO_STATUS_NORMAL || error) {
+        g_warning("Failed to write data!");
+        if (error)
+            g_error_free(error);
+        mega_ext_client_batch_disconnect(mega_ext);
+        return FALSE;
+    }
+
+    if (!g_io_add_watch(mega_ext->batch_chan, G_IO_IN | G_IO_HUP | G_IO_ERR, mega_ext_client_on_path_states, mega_ext)) {
+        g_warning("g_io_add_watch() failed!");
+        mega_ext_client_batch_disconnect(mega_ext);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
 gboolean mega_ext_client_paste_link(MEGAExt *mega_ext, const gchar *path)
 {
     gchar *out;
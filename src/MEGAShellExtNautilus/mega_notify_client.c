@@ -84,6 +84,8 @@ void mega_notify_client_destroy(MEGAExt *mega_ext)
         close(mega_ext->notify_sock);
     mega_ext->notify_sock = -1;
     mega_ext->syncs_received = FALSE;
+    // changes are not notified until it is connected again
+    mega_ext_cache_clear(mega_ext->path_states);
 }
 
 static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition condition, gpointer data)
@@ -134,6 +136,9 @@ static gboolean mega_notify_client_read(GIOChannel *notify_chan, GIOCondition co
         case 'P': // item state changed
             mega_ext_on_item_changed(mega_ext, p);
             break;
+        case 'R': // state of many items in the folder changed
+            mega_ext_on_folder_changed(mega_ext, p);
+            break;
         case 'A': // sync folder added
             mega_ext_on_sync_add(mega_ext, p);
             mega_ext->syncs_received = TRUE;
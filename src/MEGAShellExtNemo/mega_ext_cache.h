@@ -0,0 +1,24 @@
+#ifndef MEGA_EXT_CACHE_H
+#define MEGA_EXT_CACHE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+// least recently used path states
+// an entry is valid until the notify server reports a change of its path
+typedef struct _MEGAExtCache MEGAExtCache;
+
+MEGAExtCache *mega_ext_cache_new(guint max_paths);
+void mega_ext_cache_free(MEGAExtCache *cache);
+gboolean mega_ext_cache_lookup(MEGAExtCache *cache, const gchar *path, int *state);
+void mega_ext_cache_insert(MEGAExtCache *cache, const gchar *path, int state);
+void mega_ext_cache_remove(MEGAExtCache *cache, const gchar *path);
+void mega_ext_cache_remove_children(MEGAExtCache *cache, const gchar *folder);
+void mega_ext_cache_clear(MEGAExtCache *cache);
+guint64 mega_ext_cache_hits(MEGAExtCache *cache);
+guint64 mega_ext_cache_misses(MEGAExtCache *cache);
+
+G_END_DECLS
+
+#endif
@@ -6,7 +6,6 @@
 #include "control/Utilities.h"
 #include "control/CrashHandler.h"
 #include "control/ExportProcessor.h"
-#include "EventUpdater.h"
 #include "platform/Platform.h"
 #include "OverQuotaDialog.h"
 #include "ConnectivityChecker.h"
@@ -23,6 +22,10 @@
 #include "DialogOpener.h"
 #include "PowerOptions.h"
 #include "DateTimeFormatter.h"
+#include "node_selector/model/NodeTreeSnapshot.h"
+#include "node_selector/model/NodeSearchIndex.h"
+#include "node_selector/model/NodeSelectorModelItem.h"
+#include "LogBundleBuilder.h"
 
 #include "mega/types.h"
 
@@ -543,6 +546,7 @@ void MegaApplication::initialize()
     uploader = new MegaUploader(megaApi, mFolderTransferListener);
     downloader = new MegaDownloader(megaApi, mFolderTransferListener);
     connect(uploader, &MegaUploader::startingTransfers, this, &MegaApplication::startingUpload);
+    connect(uploader, &MegaUploader::uploadsSubmitted, this, &MegaApplication::onUploadsSubmitted, Qt::QueuedConnection);
     connect(downloader, &MegaDownloader::startingTransfers,
             &scanStageController, &ScanStageController::startDelayedScanStage);
     connect(downloader, &MegaDownloader::folderTransferUpdated, this, &MegaApplication::onFolderTransferUpdate);
@@ -606,13 +610,25 @@ void MegaApplication::initialize()
 
                         connect(logger.get(), &MegaSyncLogger::logReadyForReporting, context, [this, crashTimestamp]()
                         {
-                            crashReportFilePath = Utilities::joinLogZipFiles(megaApi, &crashTimestamp, CrashHandler::instance()->getLastCrashHash());
-                            if (!crashReportFilePath.isNull()
-                                    && megaApi && megaApi->isLoggedIn())
+                            auto logBundleBuilder = new LogBundleBuilder(Utilities::getLogsFolderPath(),
+                                                                         Utilities::getLogBundleFilePath(megaApi, CrashHandler::instance()->getLastCrashHash()),
+                                                                         this);
+                            logBundleBuilder->setTimeWindow(crashTimestamp);
+                            connect(logBundleBuilder, &LogBundleBuilder::finished, this, [this, logBundleBuilder](bool success)
                             {
-                                megaApi->startUploadForSupport(QDir::toNativeSeparators(crashReportFilePath).toUtf8().constData(), false);
-                                crashReportFilePath.clear();
-                            }
+                                logger->resumeAfterReporting();
+                                if (success)
+                                {
+                                    crashReportFilePath = logBundleBuilder->getBundlePath();
+                                    if (megaApi && megaApi->isLoggedIn())
+                                    {
+                                        megaApi->startUploadForSupport(QDir::toNativeSeparators(crashReportFilePath).toUtf8().constData(), false);
+                                        crashReportFilePath.clear();
+                                    }
+                                }
+                                logBundleBuilder->deleteLater();
+                            });
+                            logBundleBuilder->start();
                             context->deleteLater();
                         });
 
@@ -1611,29 +1627,23 @@ void MegaApplication::processUploadQueue(MegaHandle nodeHandle)
     noUploadedStarted = true;
 
     auto checkUploadNameDialog = new DuplicatedNodeDialog(node);
-    
-    auto counter(0);
-    EventUpdater checkUpdater(uploadQueue.size());
-    while (!uploadQueue.isEmpty())
-    {
-        QString nodePath = uploadQueue.dequeue();
-        checkUploadNameDialog->checkUpload(nodePath, node);
-
-        checkUpdater.update(counter);
-        counter++;
-    }
 
-    if(!checkUploadNameDialog->isEmpty())
-    {
-        DialogOpener::showDialog<DuplicatedNodeDialog>(checkUploadNameDialog, this, &MegaApplication::onUploadsCheckedAndReady);
-    }
-    else
+    //The paths are checked in the background, so dropping thousands of files does not block the GUI
+    connect(checkUploadNameDialog, &DuplicatedNodeDialog::uploadsChecked, this, [this, checkUploadNameDialog]()
     {
-        checkUploadNameDialog->accept();
-        onUploadsCheckedAndReady(checkUploadNameDialog);
-        checkUploadNameDialog->close();
-        checkUploadNameDialog->deleteLater();
-    }
+        if(!checkUploadNameDialog->isEmpty())
+        {
+            DialogOpener::showDialog<DuplicatedNodeDialog>(checkUploadNameDialog, this, &MegaApplication::onUploadsCheckedAndReady);
+        }
+        else
+        {
+            checkUploadNameDialog->accept();
+            onUploadsCheckedAndReady(checkUploadNameDialog);
+            checkUploadNameDialog->close();
+            checkUploadNameDialog->deleteLater();
+        }
+    });
+    checkUploadNameDialog->checkUploads(uploadQueue, node);
 }
 
 void MegaApplication::onUploadsCheckedAndReady(QPointer<DuplicatedNodeDialog> checkDialog)
@@ -1645,41 +1655,49 @@ void MegaApplication::onUploadsCheckedAndReady(QPointer<DuplicatedNodeDialog> ch
         auto data = TransferMetaDataContainer::createTransferMetaData<UploadTransferMetaData>(checkDialog->getNode()->getHandle());
         preferences->setOverStorageDismissExecution(0);
 
+        if (uploads.isEmpty())
+        {
+            data->remove();
+            return;
+        }
+
         auto batch = std::shared_ptr<TransferBatch>(new TransferBatch());
         mBlockingBatch.add(batch);
 
-        EventUpdater updater(uploads.size(),20);
-        mProcessingUploadQueue = true;
-
-        auto counter = 0;
-        data->setInitialPendingTransfers(uploads.size());
+        MegaUploader::Uploads batchUploads;
+        batchUploads.reserve(uploads.size());
         foreach(auto uploadInfo, uploads)
         {
-            QString filePath = uploadInfo->getLocalPath();
-            uploader->upload(filePath, uploadInfo->getNewName(), checkDialog->getNode(), data->getAppId(), batch);
-            
-            //Do not update the last items, leave Qt to do it in its natural way
-            //If you update them, the flag mProcessingUploadQueue will be false and the scanning widget
-            //will be stuck forever
-            if(uploadInfo != uploads.last())
-            {
-                updater.update(counter);
-                counter++;
-            }
+            batchUploads.append(MegaUploader::Upload{uploadInfo->getLocalPath(), uploadInfo->getNewName()});
         }
 
-        if (!batch->isEmpty())
-        {
-            QString logMessage = QString::fromUtf8("Added batch upload");
-            MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, logMessage.toUtf8().constData());
-        }
-        else
-        {
-            mBlockingBatch.removeBatch();
-            data->remove();
-        }
+        //Cleared by onUploadsSubmitted once the thread pool has started all of them
+        mProcessingUploadQueue++;
+        data->setInitialPendingTransfers(uploads.size());
+        uploader->upload(batchUploads, checkDialog->getNode(), data->getAppId(), batch);
+    }
+}
 
-        mProcessingUploadQueue = false;
+void MegaApplication::onUploadsSubmitted(std::shared_ptr<TransferBatch> transferBatch, int submitted, int total)
+{
+    mProcessingUploadQueue--;
+    if (!mBlockingBatch.isValid())
+    {
+        return;
+    }
+
+    //A newer batch may be the blocking one by now
+    auto isBlockingBatch = mBlockingBatch.getCancelToken() == transferBatch->getCancelToken();
+    if (isBlockingBatch && submitted < total && mBlockingBatch.isCancelled())
+    {
+        //The uploads which were not started will never be reported as finished
+        scanStageController.stopDelayedScanStage(true);
+        unblockBatch(mBlockingBatch);
+    }
+    else
+    {
+        //Every transfer could have finished while the others were being started
+        updateIfBlockingStageFinished(mBlockingBatch, false);
     }
 }
 
@@ -3455,7 +3473,7 @@ void MegaApplication::processUploads(const QStringList &uploads)
 
 bool MegaApplication::isQueueProcessingOngoing()
 {
-    return mProcessingUploadQueue || downloader->isQueueProcessingOngoing();
+    return mProcessingUploadQueue > 0 || downloader->isQueueProcessingOngoing();
 }
 
 void MegaApplication::processUpgradeSecurityEvent()
@@ -3631,6 +3649,8 @@ void MegaApplication::unlink(bool keepLogs)
     mRootNode.reset();
     mRubbishNode.reset();
     mVaultNode.reset();
+    NodeTreeSnapshot::instance().reset();
+    NodeSearchIndex::instance().reset();
     mFetchingNodes = false;
     mQueringWhyAmIBlocked = false;
     whyamiblockedPeriodicPetition = false;
@@ -7347,12 +7367,7 @@ void MegaApplication::onTransferStart(MegaApi *api, MegaTransfer *transfer)
 
     if (transfer->getType() == MegaTransfer::TYPE_DOWNLOAD)
     {
-        HTTPServer::onTransferDataUpdate(transfer->getNodeHandle(),
-                                             transfer->getState(),
-                                             transfer->getTransferredBytes(),
-                                             transfer->getTotalBytes(),
-                                             transfer->getSpeed(),
-                                             QString::fromUtf8(transfer->getPath()));
+        HTTPServer::onTransferDataUpdate(transfer);
     }
 
 
@@ -7408,12 +7423,7 @@ void MegaApplication::onTransferFinish(MegaApi* , MegaTransfer *transfer, MegaEr
 
     if (transfer->getType() == MegaTransfer::TYPE_DOWNLOAD)
     {
-        HTTPServer::onTransferDataUpdate(transfer->getNodeHandle(),
-                                             transfer->getState(),
-                                             transfer->getTransferredBytes(),
-                                             transfer->getTotalBytes(),
-                                             transfer->getSpeed(),
-                                             QString::fromUtf8(transfer->getPath()));
+        HTTPServer::onTransferDataUpdate(transfer);
     }
 
     if (blockState)
@@ -7521,12 +7531,7 @@ void MegaApplication::onTransferUpdate(MegaApi*, MegaTransfer* transfer)
     int type = transfer->getType();
     if (type == MegaTransfer::TYPE_DOWNLOAD)
     {
-        HTTPServer::onTransferDataUpdate(transfer->getNodeHandle(),
-                                             transfer->getState(),
-                                             transfer->getTransferredBytes(),
-                                             transfer->getTotalBytes(),
-                                             transfer->getSpeed(),
-                                             QString::fromUtf8(transfer->getPath()));
+        HTTPServer::onTransferDataUpdate(transfer);
     }
 
     if (firstTransferTimer && !firstTransferTimer->isActive())
@@ -7716,6 +7721,10 @@ void MegaApplication::onUsersUpdate(MegaApi *, MegaUserList *userList)
 //Called when nodes have been updated in MEGA
 void MegaApplication::onNodesUpdate(MegaApi* , MegaNodeList *nodes)
 {
+    NodeTreeSnapshot::instance().onNodesUpdate(nodes);
+    NodeSearchIndex::instance().onNodesUpdate(nodes);
+    NodeSelectorModelItem::onNodesUpdate(nodes);
+
     if (appfinished || !infoDialog || !nodes || !preferences->logged())
     {
         return;
@@ -344,6 +344,7 @@ private slots:
 
 protected slots:
     void onUploadsCheckedAndReady(QPointer<DuplicatedNodeDialog> checkDialog);
+    void onUploadsSubmitted(std::shared_ptr<TransferBatch> transferBatch, int submitted, int total);
     void onPasteMegaLinksDialogFinish(QPointer<PasteMegaLinksDialog>);
     void onDownloadFromMegaFinished(QPointer<DownloadFromMegaDialog> dialog);
 
@@ -588,7 +589,7 @@ private:
     void updateFreedCancelToken(mega::MegaTransfer* transfer);
 
     bool noUploadedStarted = true;
-    bool mProcessingUploadQueue = false;
+    int mProcessingUploadQueue = 0;
     int mProcessingShellNotifications = 0;
 
     void ConnectServerSignals(HTTPServer* server);
@@ -0,0 +1,86 @@
+#include "CollationKeyCache.h"
+
+#include <QtConcurrent/QtConcurrent>
+
+#include <memory>
+#include <vector>
+
+CollationKeyCache::CollationKeyCache(const QCollator& collator)
+    : mCollator(collator)
+{
+    //The collator is initialized on its first use, which must not happen in several threads at once
+    mCollator.compare(QString(), QString());
+}
+
+int CollationKeyCache::compare(quint64 leftId, const std::function<QString()>& leftName,
+                               quint64 rightId, const std::function<QString()>& rightName)
+{
+    return key(leftId, leftName).compare(key(rightId, rightName));
+}
+
+void CollationKeyCache::build(const QVector<quint64>& ids, const NameGetter& name)
+{
+    struct MissingKey
+    {
+        int position;
+        std::unique_ptr<QCollatorSortKey> key;
+    };
+
+    std::vector<MissingKey> missing;
+    {
+        QReadLocker lock(&mLock);
+        for(int position = 0; position < ids.size(); ++position)
+        {
+            if(!mKeys.contains(ids.at(position)))
+            {
+                missing.push_back(MissingKey{position, nullptr});
+            }
+        }
+    }
+
+    QtConcurrent::blockingMap(missing, [this, &name](MissingKey& missingKey)
+    {
+        missingKey.key.reset(new QCollatorSortKey(mCollator.sortKey(name(missingKey.position))));
+    });
+
+    QWriteLocker lock(&mLock);
+    mKeys.reserve(mKeys.size() + static_cast<int>(missing.size()));
+    for(const auto& missingKey : missing)
+    {
+        mKeys.insert(ids.at(missingKey.position), *missingKey.key);
+    }
+}
+
+void CollationKeyCache::remove(quint64 id)
+{
+    QWriteLocker lock(&mLock);
+    mKeys.remove(id);
+}
+
+void CollationKeyCache::clear()
+{
+    QWriteLocker lock(&mLock);
+    mKeys.clear();
+}
+
+int CollationKeyCache::size() const
+{
+    QReadLocker lock(&mLock);
+    return mKeys.size();
+}
+
+QCollatorSortKey CollationKeyCache::key(quint64 id, const std::function<QString()>& name)
+{
+    {
+        QReadLocker lock(&mLock);
+        auto keyIt = mKeys.constFind(id);
+        if(keyIt != mKeys.constEnd())
+        {
+            return keyIt.value();
+        }
+    }
+
+    auto sortKey = mCollator.sortKey(name());
+    QWriteLocker lock(&mLock);
+    return mKeys.insert(id, sortKey).value();
+}
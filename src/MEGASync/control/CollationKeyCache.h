@@ -0,0 +1,41 @@
+#ifndef COLLATIONKEYCACHE_H
+#define COLLATIONKEYCACHE_H
+
+#include <QCollator>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+//Sort keys of the names shown by sorted views, by the id of the row. Comparing two keys is much cheaper than
+//comparing the names with the collator, which also needs the name of both rows for every comparison.
+//Keys are not updated by themselves: the owner removes the ones whose name changes. It can be used from any thread.
+class CollationKeyCache
+{
+public:
+    using NameGetter = std::function<QString(int)>;
+
+    explicit CollationKeyCache(const QCollator& collator);
+
+    //Compares the names of both ids. The name is only requested when its key is not cached yet
+    int compare(quint64 leftId, const std::function<QString()>& leftName,
+                quint64 rightId, const std::function<QString()>& rightName);
+
+    //Computes the missing keys of the ids in parallel. The name getter receives the position of the id
+    void build(const QVector<quint64>& ids, const NameGetter& name);
+
+    void remove(quint64 id);
+    void clear();
+    int size() const;
+
+private:
+    QCollatorSortKey key(quint64 id, const std::function<QString()>& name);
+
+    QCollator mCollator;
+    mutable QReadWriteLock mLock;
+    QHash<quint64, QCollatorSortKey> mKeys;
+};
+
+#endif // COLLATIONKEYCACHE_H
@@ -1,9 +1,19 @@
 #include "EncryptedSettings.h"
 #include "platform/Platform.h"
 
+namespace
+{
+// Minimum time between two writes of the settings file
+const int SYNC_INTERVAL_MS = 1000;
+}
+
 EncryptedSettings::EncryptedSettings(QString file) :
     QSettings(file, QSettings::IniFormat)
 {
+    mSyncTimer.setSingleShot(true);
+    connect(&mSyncTimer, &QTimer::timeout, this, &EncryptedSettings::onSyncTimeout);
+    connect(this, &EncryptedSettings::syncScheduled, this, &EncryptedSettings::onSyncScheduled, Qt::QueuedConnection);
+
 #ifdef _WIN32
     // On Win, LocalStorageKey can change after an OS update, so don't fetch it every time from the OS.
     // Use the cached one if available, and only get it from the OS if not.
@@ -27,83 +37,160 @@ EncryptedSettings::EncryptedSettings(QString file) :
     setValue(keyTag, bkp.toHex());
     encryptionKey = bkp; // switch back to the real encryptionKey
 #endif
+
+    // values read with the previous key are not valid anymore
+    mValues.clear();
+}
+
+EncryptedSettings::~EncryptedSettings()
+{
+    flush();
 }
 
 void EncryptedSettings::setValue(const QString &key, const QVariant &value)
 {
-    QSettings::setValue(hash(key), encrypt(key, value.toString()));
+    QMutexLocker lock(&mMutex);
+    QString id = cacheKey(key);
+    QString text = value.toString();
+    auto cachedIt = mValues.constFind(id);
+    if (cachedIt != mValues.constEnd() && cachedIt->exists && cachedIt->value == text)
+    {
+        return;
+    }
+
+    QSettings::setValue(hash(key), encrypt(key, text));
+    mValues.insert(id, CachedValue{true, text});
 }
 
 QVariant EncryptedSettings::value(const QString &key, const QVariant &defaultValue)
 {
-    return QVariant(decrypt(key, QSettings::value(hash(key), encrypt(key, defaultValue.toString())).toString()));
+    QMutexLocker lock(&mMutex);
+    QString id = cacheKey(key);
+    auto cachedIt = mValues.constFind(id);
+    if (cachedIt == mValues.constEnd())
+    {
+        QString hashedKey = hash(key);
+        CachedValue cached{QSettings::contains(hashedKey), QString()};
+        if (cached.exists)
+        {
+            cached.value = decrypt(key, QSettings::value(hashedKey).toString());
+        }
+        cachedIt = mValues.insert(id, cached);
+    }
+
+    return QVariant(cachedIt->exists ? cachedIt->value : defaultValue.toString());
 }
 
 void EncryptedSettings::beginGroup(const QString &prefix)
 {
+    QMutexLocker lock(&mMutex);
     QSettings::beginGroup(hash(prefix));
 }
 
 void EncryptedSettings::beginGroup(int numGroup)
 {
-     QSettings::beginGroup(QSettings::childGroups().at(numGroup));
+    QMutexLocker lock(&mMutex);
+    QSettings::beginGroup(QSettings::childGroups().at(numGroup));
 }
 
 void EncryptedSettings::endGroup()
 {
+    QMutexLocker lock(&mMutex);
     QSettings::endGroup();
 }
 
 int EncryptedSettings::numChildGroups()
 {
+    QMutexLocker lock(&mMutex);
     return QSettings::childGroups().size();
 }
 
 bool EncryptedSettings::containsGroup(QString groupName)
 {
+    QMutexLocker lock(&mMutex);
     return QSettings::childGroups().contains(hash(groupName));
 }
 
 bool EncryptedSettings::isGroupEmpty()
 {
+    QMutexLocker lock(&mMutex);
     return QSettings::group().isEmpty();
 }
 
 void EncryptedSettings::remove(const QString &key)
 {
+    QMutexLocker lock(&mMutex);
+    QString removedGroup;
     if (!key.length())
     {
+        removedGroup = group();
         QSettings::remove(QString::fromAscii(""));
     }
     else
     {
-        QSettings::remove(hash(key));
+        // the key may be a child group too
+        QString hashedKey = hash(key);
+        mValues.remove(cacheKey(key));
+        removedGroup = group().isEmpty() ? hashedKey : group() + QLatin1Char('/') + hashedKey;
+        QSettings::remove(hashedKey);
+    }
+
+    if (removedGroup.isEmpty())
+    {
+        mValues.clear();
+        return;
+    }
+
+    removedGroup.append(QLatin1Char('/'));
+    for (auto cachedIt = mValues.begin(); cachedIt != mValues.end();)
+    {
+        cachedIt = cachedIt.key().startsWith(removedGroup) ? mValues.erase(cachedIt) : std::next(cachedIt);
     }
 }
 
 void EncryptedSettings::clear()
 {
+    QMutexLocker lock(&mMutex);
     QSettings::clear();
+    mValues.clear();
 }
 
 void EncryptedSettings::sync()
 {
+    QMutexLocker lock(&mMutex);
     if (mDeferSyncEnableCount > 0)
     {
         mSyncDeferred = true;
     }
+    else if (mLastSync.isValid() && !mLastSync.hasExpired(SYNC_INTERVAL_MS))
+    {
+        // the syncs received until the end of the interval are written at once
+        mSyncDeferred = true;
+        if (!mSyncScheduled)
+        {
+            mSyncScheduled = true;
+            int remainingMs = static_cast<int>(qMax<qint64>(0, SYNC_INTERVAL_MS - mLastSync.elapsed()));
+            emit syncScheduled(remainingMs);
+        }
+    }
     else
     {
-        QSettings::sync();
-        mSyncDeferred = false;
+        writeToDisk();
+    }
+}
 
-        QFile::remove(this->fileName().append(QString::fromUtf8(".bak")));
-        QFile::copy(this->fileName(), this->fileName().append(QString::fromUtf8(".bak")));
+void EncryptedSettings::flush()
+{
+    QMutexLocker lock(&mMutex);
+    if (mSyncDeferred)
+    {
+        writeToDisk();
     }
 }
 
 void EncryptedSettings::deferSyncs(bool b)
 {
+    QMutexLocker lock(&mMutex);
     if (b)
     {
         mDeferSyncEnableCount += 1;
@@ -116,8 +203,34 @@ void EncryptedSettings::deferSyncs(bool b)
 
 bool EncryptedSettings::needsDeferredSync()
 {
+    QMutexLocker lock(&mMutex);
     return mSyncDeferred;
 }
+
+void EncryptedSettings::onSyncScheduled(int remainingMs)
+{
+    mSyncTimer.start(remainingMs);
+}
+
+void EncryptedSettings::onSyncTimeout()
+{
+    QMutexLocker lock(&mMutex);
+    mSyncScheduled = false;
+    if (mSyncDeferred && mDeferSyncEnableCount == 0)
+    {
+        writeToDisk();
+    }
+}
+
+void EncryptedSettings::writeToDisk()
+{
+    QSettings::sync();
+    mSyncDeferred = false;
+    mLastSync.start();
+
+    QFile::remove(this->fileName().append(QString::fromUtf8(".bak")));
+    QFile::copy(this->fileName(), this->fileName().append(QString::fromUtf8(".bak")));
+}
  
 //Simplified XOR fun
 QByteArray EncryptedSettings::XOR(const QByteArray& key, const QByteArray& data) const
@@ -170,6 +283,11 @@ QString EncryptedSettings::decrypt(const QString key, const QString value) const
     return QString::fromUtf8(xDecrypted);
 }
 
+QString EncryptedSettings::cacheKey(const QString &key) const
+{
+    return group().isEmpty() ? key : group() + QLatin1Char('/') + key;
+}
+
 QString EncryptedSettings::hash(const QString key) const
 {
     QByteArray xPath = XOR(encryptionKey, (key+group()).toUtf8());
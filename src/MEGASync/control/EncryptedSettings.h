@@ -5,6 +5,10 @@
 #include <QVariant>
 #include <QStringList>
 #include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QTimer>
 
 class EncryptedSettings : protected QSettings
 {
@@ -12,6 +16,7 @@ class EncryptedSettings : protected QSettings
 
 public:
     explicit EncryptedSettings(QString file);
+    ~EncryptedSettings();
 
     void setValue(const QString & key, const QVariant & value);
     QVariant value(const QString & key, const QVariant & defaultValue = QVariant());
@@ -23,19 +28,43 @@ public:
     bool isGroupEmpty();
     void remove(const QString & key);
     void clear();
-    void sync();
+    void sync();        // writes to disk at most once per interval, later calls are coalesced into one write
+    void flush();       // writes to disk now, if there are changes
 
     void deferSyncs(bool b);  // this must receive balanced calls with true and false, as it maintains a count (to support threads).
     bool needsDeferredSync();
 
+signals:
+    void syncScheduled(int remainingMs);
+
+private slots:
+    void onSyncScheduled(int remainingMs);
+    void onSyncTimeout();
+
 protected:
+    struct CachedValue
+    {
+        bool exists;
+        QString value;
+    };
+
     QByteArray XOR(const QByteArray &key, const QByteArray& data) const;
     QString encrypt(const QString key, const QString value) const;
     QString decrypt(const QString key, const QString value) const;
     QString hash(const QString key) const;
+    QString cacheKey(const QString& key) const;
+    void writeToDisk();
     QByteArray encryptionKey;
     int mDeferSyncEnableCount = 0;
     bool mSyncDeferred = false;
+
+    // decrypted values, by group and key, so each one is decrypted once
+    QHash<QString, CachedValue> mValues;
+    QElapsedTimer mLastSync;
+    // lives in the thread of the settings, which has an event loop, unlike the threads which may call sync()
+    QTimer mSyncTimer;
+    bool mSyncScheduled = false;
+    QMutex mMutex;
 };
 
 #endif // ENCRYPTEDSETTINGS_H
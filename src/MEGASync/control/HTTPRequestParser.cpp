@@ -0,0 +1,477 @@
+#include "HTTPRequestParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+const char HEADERS_END[] = "\r\n\r\n";
+const int HEADERS_END_SIZE = 4;
+const char CONTENT_LENGTH[] = "content-length:";
+}
+
+HTTPRequestParser::HTTPRequestParser()
+    : mState(READING_HEADERS),
+      mHeaderScanPos(0),
+      mContentLength(-1),
+      mBytesReceived(0)
+{
+}
+
+HTTPRequestParser::State HTTPRequestParser::feed(const QByteArray& data)
+{
+    mBytesReceived += data.size();
+
+    switch (mState)
+    {
+    case READING_HEADERS:
+        mHeaderData.append(data);
+        readHeaders();
+        break;
+    case READING_BODY:
+        readBody(data.constData(), data.size());
+        break;
+    case COMPLETE:
+        mRemaining.append(data);
+        break;
+    case INVALID:
+        break;
+    }
+
+    return mState;
+}
+
+HTTPRequestParser::State HTTPRequestParser::state() const
+{
+    return mState;
+}
+
+long long HTTPRequestParser::bytesReceived() const
+{
+    return mBytesReceived;
+}
+
+const QStringList& HTTPRequestParser::headers() const
+{
+    return mHeaders;
+}
+
+bool HTTPRequestParser::hasContentLength() const
+{
+    return mContentLength >= 0;
+}
+
+int HTTPRequestParser::contentLength() const
+{
+    return std::max(mContentLength, 0);
+}
+
+QByteArray HTTPRequestParser::takeBody()
+{
+    QByteArray body;
+    body.swap(mBody);
+    return body;
+}
+
+const QByteArray& HTTPRequestParser::remaining() const
+{
+    return mRemaining;
+}
+
+void HTTPRequestParser::readHeaders()
+{
+    //Only the new bytes (and the last 3 old ones, in case the separator was split) are searched
+    int end = mHeaderData.indexOf(HEADERS_END, mHeaderScanPos);
+    if (end < 0)
+    {
+        if (mHeaderData.size() > MAX_HEADER_BYTES)
+        {
+            mState = INVALID;
+        }
+        mHeaderScanPos = std::max(0, mHeaderData.size() - (HEADERS_END_SIZE - 1));
+        return;
+    }
+
+    int lineStart = 0;
+    while (lineStart <= end)
+    {
+        int lineEnd = mHeaderData.indexOf("\r\n", lineStart);
+        if (lineEnd < 0 || lineEnd > end)
+        {
+            lineEnd = end;
+        }
+
+        const char* line = mHeaderData.constData() + lineStart;
+        int lineSize = lineEnd - lineStart;
+        int prefixSize = static_cast<int>(sizeof(CONTENT_LENGTH)) - 1;
+        if (lineSize > prefixSize && !qstrnicmp(line, CONTENT_LENGTH, static_cast<uint>(prefixSize)))
+        {
+            bool ok = false;
+            mContentLength = QByteArray(line + prefixSize, lineSize - prefixSize).trimmed().toInt(&ok);
+            if (!ok || mContentLength < 0 || mContentLength > MAX_BODY_BYTES)
+            {
+                mState = INVALID;
+                return;
+            }
+        }
+
+        mHeaders.append(QString::fromUtf8(line, lineSize));
+        lineStart = lineEnd + 2;
+    }
+
+    int bodyStart = end + HEADERS_END_SIZE;
+    mState = READING_BODY;
+    readBody(mHeaderData.constData() + bodyStart, mHeaderData.size() - bodyStart);
+    mHeaderData.clear();
+}
+
+void HTTPRequestParser::readBody(const char* data, int size)
+{
+    int taken = std::min(contentLength() - mBody.size(), size);
+
+    //The buffer grows with the received bytes instead of being reserved from Content-Length,
+    //so a request rejected by its headers has not allocated its announced size
+    if (mBody.size() + taken > mBody.capacity())
+    {
+        mBody.reserve(std::min(contentLength(), std::max(mBody.size() + taken, 2 * mBody.capacity())));
+    }
+    mBody.append(data, taken);
+    if (taken < size)
+    {
+        mRemaining.append(data + taken, size - taken);
+    }
+
+    if (mBody.size() == contentLength())
+    {
+        mState = COMPLETE;
+    }
+}
+
+JsonTokenizer::JsonTokenizer(const char* data, int size)
+    : mPos(data),
+      mEnd(data + size),
+      mTokenBegin(data),
+      mTokenSize(0),
+      mDepth(0)
+{
+}
+
+JsonTokenizer::Token JsonTokenizer::next()
+{
+    skipWhitespace();
+    mTokenBegin = mPos;
+    mTokenSize = 0;
+    if (mPos >= mEnd)
+    {
+        return END;
+    }
+
+    char c = *mPos;
+    switch (c)
+    {
+    case '{':
+        ++mPos;
+        ++mDepth;
+        return OBJECT_BEGIN;
+    case '}':
+        ++mPos;
+        --mDepth;
+        return OBJECT_END;
+    case '[':
+        ++mPos;
+        ++mDepth;
+        return ARRAY_BEGIN;
+    case ']':
+        ++mPos;
+        --mDepth;
+        return ARRAY_END;
+    case '"':
+    {
+        const char* begin = ++mPos;
+        while (mPos < mEnd && *mPos != '"')
+        {
+            mPos += (*mPos == '\\') ? 2 : 1;
+        }
+        if (mPos >= mEnd)
+        {
+            return ERROR;
+        }
+
+        mTokenBegin = begin;
+        mTokenSize = static_cast<int>(mPos - begin);
+        ++mPos;
+
+        //A string followed by ':' is the key of an object member
+        const char* after = mPos;
+        while (after < mEnd && (*after == ' ' || *after == '\t' || *after == '\r' || *after == '\n'))
+        {
+            ++after;
+        }
+        if (after < mEnd && *after == ':')
+        {
+            mPos = after + 1;
+            return KEY;
+        }
+        return STRING;
+    }
+    default:
+        break;
+    }
+
+    if (c == '-' || (c >= '0' && c <= '9'))
+    {
+        while (mPos < mEnd && ((*mPos >= '0' && *mPos <= '9') || *mPos == '-' || *mPos == '+' || *mPos == '.' || *mPos == 'e' || *mPos == 'E'))
+        {
+            ++mPos;
+        }
+        mTokenSize = static_cast<int>(mPos - mTokenBegin);
+        return NUMBER;
+    }
+
+    if (c >= 'a' && c <= 'z')
+    {
+        while (mPos < mEnd && *mPos >= 'a' && *mPos <= 'z')
+        {
+            ++mPos;
+        }
+        mTokenSize = static_cast<int>(mPos - mTokenBegin);
+        return LITERAL;
+    }
+
+    return ERROR;
+}
+
+bool JsonTokenizer::skipValue()
+{
+    int depth = mDepth;
+    do
+    {
+        Token token = next();
+        if (token == END || token == ERROR || mDepth < depth)
+        {
+            return false;
+        }
+    }
+    while (mDepth > depth);
+
+    return true;
+}
+
+bool JsonTokenizer::tokenIs(const char* text) const
+{
+    return static_cast<int>(strlen(text)) == mTokenSize && !memcmp(mTokenBegin, text, static_cast<size_t>(mTokenSize));
+}
+
+QByteArray JsonTokenizer::text() const
+{
+    return QByteArray(mTokenBegin, mTokenSize);
+}
+
+long long JsonTokenizer::number() const
+{
+    const char* pos = mTokenBegin;
+    const char* end = mTokenBegin + mTokenSize;
+    bool negative = pos < end && *pos == '-';
+    if (negative)
+    {
+        ++pos;
+    }
+
+    long long value = 0;
+    while (pos < end && *pos >= '0' && *pos <= '9')
+    {
+        value = value * 10 + (*pos++ - '0');
+    }
+    return negative ? -value : value;
+}
+
+int JsonTokenizer::depth() const
+{
+    return mDepth;
+}
+
+void JsonTokenizer::skipWhitespace()
+{
+    //Separators carry no information for a tokenizer which does not validate the structure
+    while (mPos < mEnd && (*mPos == ' ' || *mPos == '\t' || *mPos == '\r' || *mPos == '\n' || *mPos == ',' || *mPos == ':'))
+    {
+        ++mPos;
+    }
+}
+
+WebclientDownloadParser::WebclientDownloadParser(const QByteArray& body)
+    : mTokenizer(body.constData(), body.size()),
+      mError(false)
+{
+}
+
+bool WebclientDownloadParser::readHeader()
+{
+    if (mTokenizer.next() != JsonTokenizer::OBJECT_BEGIN)
+    {
+        mError = true;
+        return false;
+    }
+
+    while (true)
+    {
+        auto token = mTokenizer.next();
+        if (token == JsonTokenizer::OBJECT_END || token == JsonTokenizer::END)
+        {
+            return false;
+        }
+        else if (token != JsonTokenizer::KEY)
+        {
+            mError = true;
+            return false;
+        }
+
+        if (mTokenizer.tokenIs("f"))
+        {
+            mError = mTokenizer.next() != JsonTokenizer::ARRAY_BEGIN;
+            return !mError;
+        }
+
+        QByteArray* field = nullptr;
+        if (mTokenizer.tokenIs("esid"))
+        {
+            field = &mPrivateAuth;
+        }
+        else if (mTokenizer.tokenIs("en"))
+        {
+            field = &mPublicAuth;
+        }
+        else if (mTokenizer.tokenIs("cauth"))
+        {
+            field = &mChatAuth;
+        }
+        else if (mTokenizer.tokenIs("auth"))
+        {
+            field = &mAuth;
+        }
+
+        if (field ? !readString(*field) : !mTokenizer.skipValue())
+        {
+            mError = true;
+            return false;
+        }
+    }
+}
+
+const QByteArray& WebclientDownloadParser::privateAuth() const
+{
+    return mPrivateAuth;
+}
+
+const QByteArray& WebclientDownloadParser::publicAuth() const
+{
+    return mPublicAuth;
+}
+
+const QByteArray& WebclientDownloadParser::chatAuth() const
+{
+    return mChatAuth;
+}
+
+const QByteArray& WebclientDownloadParser::auth() const
+{
+    return mAuth;
+}
+
+bool WebclientDownloadParser::nextNode(WebclientNode& node)
+{
+    node = WebclientNode();
+
+    auto token = mTokenizer.next();
+    if (token == JsonTokenizer::ARRAY_END)
+    {
+        return false;
+    }
+    else if (token != JsonTokenizer::OBJECT_BEGIN)
+    {
+        mError = true;
+        return false;
+    }
+
+    while (true)
+    {
+        token = mTokenizer.next();
+        if (token == JsonTokenizer::OBJECT_END)
+        {
+            return true;
+        }
+        else if (token != JsonTokenizer::KEY)
+        {
+            mError = true;
+            return false;
+        }
+
+        bool ok = true;
+        if (mTokenizer.tokenIs("t"))
+        {
+            ok = readNumber(node.type);
+        }
+        else if (mTokenizer.tokenIs("h"))
+        {
+            ok = readString(node.handle);
+        }
+        else if (mTokenizer.tokenIs("n"))
+        {
+            ok = readString(node.name);
+        }
+        else if (mTokenizer.tokenIs("p"))
+        {
+            ok = readString(node.parent);
+        }
+        else if (mTokenizer.tokenIs("k"))
+        {
+            ok = readString(node.key);
+        }
+        else if (mTokenizer.tokenIs("s"))
+        {
+            ok = readNumber(node.size);
+        }
+        else if (mTokenizer.tokenIs("ts"))
+        {
+            ok = readNumber(node.mtime);
+        }
+        else
+        {
+            ok = mTokenizer.skipValue();
+        }
+
+        if (!ok)
+        {
+            mError = true;
+            return false;
+        }
+    }
+}
+
+bool WebclientDownloadParser::hasError() const
+{
+    return mError;
+}
+
+bool WebclientDownloadParser::readString(QByteArray& value)
+{
+    //Values of other types are ignored, as long as they are scalars
+    auto token = mTokenizer.next();
+    if (token == JsonTokenizer::STRING)
+    {
+        value = mTokenizer.text();
+        return true;
+    }
+    return token == JsonTokenizer::NUMBER || token == JsonTokenizer::LITERAL;
+}
+
+bool WebclientDownloadParser::readNumber(long long& value)
+{
+    auto token = mTokenizer.next();
+    if (token == JsonTokenizer::NUMBER)
+    {
+        value = mTokenizer.number();
+        return true;
+    }
+    return token == JsonTokenizer::STRING || token == JsonTokenizer::LITERAL;
+}
@@ -0,0 +1,136 @@
+#ifndef HTTPREQUESTPARSER_H
+#define HTTPREQUESTPARSER_H
+
+#include <QByteArray>
+#include <QStringList>
+
+//Incremental parser for the HTTP requests of the webclient.
+//Each chunk read from the socket is fed once: the end of the headers is searched only in the new bytes,
+//and the body is copied into a buffer which doubles as bytes arrive, up to Content-Length.
+class HTTPRequestParser
+{
+public:
+    enum State
+    {
+        READING_HEADERS = 0,
+        READING_BODY,
+        COMPLETE,
+        INVALID,
+    };
+
+    static const int MAX_HEADER_BYTES = 64 * 1024;
+    static const int MAX_BODY_BYTES = 512 * 1024 * 1024;
+
+    HTTPRequestParser();
+
+    State feed(const QByteArray& data);
+    State state() const;
+    long long bytesReceived() const;
+
+    //Header lines, the request line first. Available once the headers are read.
+    const QStringList& headers() const;
+    bool hasContentLength() const;
+    int contentLength() const;
+
+    //Takes the body of a complete request
+    QByteArray takeBody();
+    //Bytes received after the end of the body
+    const QByteArray& remaining() const;
+
+private:
+    void readHeaders();
+    void readBody(const char* data, int size);
+
+    State mState;
+    QByteArray mHeaderData;
+    int mHeaderScanPos;
+    QStringList mHeaders;
+    int mContentLength;
+    QByteArray mBody;
+    QByteArray mRemaining;
+    long long mBytesReceived;
+};
+
+//Single pass JSON tokenizer over a complete buffer, so big requests can be walked without copying them
+//into a QString or building a document. String tokens are returned raw: escape sequences are skipped, not decoded.
+class JsonTokenizer
+{
+public:
+    enum Token
+    {
+        OBJECT_BEGIN = 0,
+        OBJECT_END,
+        ARRAY_BEGIN,
+        ARRAY_END,
+        KEY,
+        STRING,
+        NUMBER,
+        LITERAL,
+        END,
+        ERROR,
+    };
+
+    JsonTokenizer(const char* data, int size);
+
+    Token next();
+    //Skips the value of the last KEY token
+    bool skipValue();
+
+    bool tokenIs(const char* text) const;
+    QByteArray text() const;
+    long long number() const;
+    int depth() const;
+
+private:
+    void skipWhitespace();
+
+    const char* mPos;
+    const char* mEnd;
+    const char* mTokenBegin;
+    int mTokenSize;
+    int mDepth;
+};
+
+//One node of the "f" array of a webclient download request
+struct WebclientNode
+{
+    long long type = -1;
+    QByteArray handle;
+    QByteArray name;
+    QByteArray parent;
+    QByteArray key;
+    long long size = 0;
+    long long mtime = 0;
+};
+
+//Walks a webclient download request: the auth fields found before the node list, then the nodes one by one
+class WebclientDownloadParser
+{
+public:
+    //The body must outlive the parser
+    explicit WebclientDownloadParser(const QByteArray& body);
+
+    //Reads up to the node list. Returns false if the request has no node list.
+    bool readHeader();
+    const QByteArray& privateAuth() const;
+    const QByteArray& publicAuth() const;
+    const QByteArray& chatAuth() const;
+    const QByteArray& auth() const;
+
+    //Reads the next node. Returns false at the end of the list or if the request is malformed.
+    bool nextNode(WebclientNode& node);
+    bool hasError() const;
+
+private:
+    bool readString(QByteArray& value);
+    bool readNumber(long long& value);
+
+    JsonTokenizer mTokenizer;
+    QByteArray mPrivateAuth;
+    QByteArray mPublicAuth;
+    QByteArray mChatAuth;
+    QByteArray mAuth;
+    bool mError;
+};
+
+#endif // HTTPREQUESTPARSER_H
@@ -12,12 +12,75 @@
 using namespace mega;
 
 const unsigned int HTTPServer::MAX_REQUEST_TIME_SECS = 1800;
+const int HTTPServer::KEEP_ALIVE_TIMEOUT_SECS = 30;
+const int HTTPServer::MAX_KEEP_ALIVE_REQUESTS = 1000;
+
+namespace
+{
+//Download requests can be tens of MB
+const int MAX_LOGGED_REQUEST_BYTES = 4096;
+//The UI is kept responsive while big download requests are parsed
+const int NODES_BETWEEN_PROCESS_EVENTS = 100;
+}
 
 bool ts_comparator(RequestData* i, RequestData *j)
 {
     return i->tsStart < j->tsStart;
 }
 
+void TransferUpdateCoalescer::add(MegaTransfer* transfer)
+{
+    auto it = mUpdates.find(transfer->getNodeHandle());
+    if (it == mUpdates.end())
+    {
+        it = mUpdates.insert(transfer->getNodeHandle(), Update());
+    }
+    else
+    {
+        mCoalesced++;
+    }
+
+    auto& update = it.value();
+    update.state = transfer->getState();
+    update.progress = transfer->getTransferredBytes();
+    update.size = transfer->getTotalBytes();
+    update.speed = transfer->getSpeed();
+
+    const char* localPath = transfer->getPath();
+    if (localPath && update.localPath != localPath)
+    {
+        update.localPath = localPath;
+    }
+}
+
+bool TransferUpdateCoalescer::take(MegaHandle handle, Update& update)
+{
+    auto it = mUpdates.find(handle);
+    if (it == mUpdates.end())
+    {
+        return false;
+    }
+
+    update = it.value();
+    mUpdates.erase(it);
+    return true;
+}
+
+void TransferUpdateCoalescer::remove(MegaHandle handle)
+{
+    mUpdates.remove(handle);
+}
+
+int TransferUpdateCoalescer::size() const
+{
+    return mUpdates.size();
+}
+
+long long TransferUpdateCoalescer::coalesced() const
+{
+    return mCoalesced;
+}
+
 RequestData::RequestData()
 {
     files = -1;
@@ -41,6 +104,7 @@ RequestTransferData::RequestTransferData()
 bool HTTPServer::isFirstWebDownloadDone = false;
 QMultiMap<QString, RequestData*> HTTPServer::webDataRequests;
 QMap<mega::MegaHandle, RequestTransferData*> HTTPServer::webTransferStateRequests;
+TransferUpdateCoalescer HTTPServer::pendingTransferUpdates;
 
 HTTPServer::HTTPServer(MegaApi *megaApi, quint16 port, bool sslEnabled)
     : QTcpServer(), disabled(false)
@@ -67,7 +131,6 @@ void HTTPServer::incomingConnection(qintptr socket)
     }
 
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Incoming webclient connection");
-    auto preferences = Preferences::instance();
     QTcpSocket* s = NULL;
     QSslSocket *sslSocket = NULL;
 
@@ -88,17 +151,40 @@ void HTTPServer::incomingConnection(qintptr socket)
     connect(s, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(error(QAbstractSocket::SocketError)));
 
     s->setSocketDescriptor(socket);
-    requests.insert(s, new HTTPRequest());
+
+    //Persistent connections are closed after some time without requests
+    HTTPRequest* request = new HTTPRequest();
+    request->idleTimer = new QTimer(s);
+    request->idleTimer->setSingleShot(true);
+    request->idleTimer->setInterval(KEEP_ALIVE_TIMEOUT_SECS * 1000);
+    connect(request->idleTimer, &QTimer::timeout, s, &QAbstractSocket::disconnectFromHost);
+    requests.insert(s, request);
 
     if (sslSocket)
     {
-        sslSocket->setPeerVerifyMode(QSslSocket::VerifyNone);
+        QSslConfiguration configuration = getSslConfiguration();
+        if (configuration.isNull())
+        {
+            s->disconnectFromHost();
+            return;
+        }
 
+        sslSocket->setSslConfiguration(configuration);
+        sslSocket->startServerEncryption();
+    }
+}
+
+QSslConfiguration HTTPServer::getSslConfiguration()
+{
+    //The key and certificates are parsed once per server, not once per connection.
+    //The server is recreated when the certificate is renewed.
+    if (mSslConfiguration.isNull())
+    {
+        auto preferences = Preferences::instance();
         QSslKey key(preferences->getHttpsKey().toUtf8(), QSsl::Rsa, QSsl::Pem, QSsl::PrivateKey);
         if (key.isNull())
         {
-            s->disconnectFromHost();
-            return;
+            return QSslConfiguration();
         }
 
         QList<QSslCertificate> certificates;
@@ -108,10 +194,14 @@ void HTTPServer::incomingConnection(qintptr socket)
         {
             certificates.append(QSslCertificate(intermediates.at(i).toUtf8(), QSsl::Pem));
         }
-        sslSocket->setLocalCertificateChain(certificates);
-        sslSocket->setPrivateKey(key);
-        sslSocket->startServerEncryption();
+
+        QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+        configuration.setPeerVerifyMode(QSslSocket::VerifyNone);
+        configuration.setLocalCertificateChain(certificates);
+        configuration.setPrivateKey(key);
+        mSslConfiguration = configuration;
     }
+    return mSslConfiguration;
 }
 
 void HTTPServer::pause()
@@ -149,6 +239,7 @@ void HTTPServer::checkAndPurgeRequests()
              || transferData->state == MegaTransfer::STATE_FAILED)
                 && (((QDateTime::currentMSecsSinceEpoch() / 1000) - transferData->tsEnd) > MAX_REQUEST_TIME_SECS))
         {
+            pendingTransferUpdates.remove(it.key());
             webTransferStateRequests.erase(it++);
             delete transferData;
         }
@@ -193,6 +284,9 @@ void HTTPServer::onTransferDataUpdate(MegaHandle handle, int state, long long pr
         return;
     }
 
+    //A direct update supersedes any coalesced one
+    pendingTransferUpdates.remove(handle);
+
     #ifdef WIN32
     if (localPath.startsWith(QString::fromAscii("\\\\?\\")))
     {
@@ -219,6 +313,61 @@ void HTTPServer::onTransferDataUpdate(MegaHandle handle, int state, long long pr
     }
 }
 
+void HTTPServer::onTransferDataUpdate(MegaTransfer* transfer)
+{
+    //Nothing to do if the webclient is not waiting for any transfer
+    if (webTransferStateRequests.isEmpty())
+    {
+        return;
+    }
+
+    MegaHandle handle = transfer->getNodeHandle();
+    if (!webTransferStateRequests.contains(handle))
+    {
+        return;
+    }
+
+    int state = transfer->getState();
+    if (state == MegaTransfer::STATE_CANCELLED
+            || state == MegaTransfer::STATE_COMPLETED
+            || state == MegaTransfer::STATE_FAILED)
+    {
+        //Finished transfers are published at once, their end time is used to purge them
+        onTransferDataUpdate(handle, state, transfer->getTransferredBytes(), transfer->getTotalBytes(),
+                             transfer->getSpeed(), QString::fromUtf8(transfer->getPath()));
+        return;
+    }
+
+    pendingTransferUpdates.add(transfer);
+}
+
+long long HTTPServer::getCoalescedTransferUpdates()
+{
+    return pendingTransferUpdates.coalesced();
+}
+
+void HTTPServer::publishTransferDataUpdate(MegaHandle handle)
+{
+    TransferUpdateCoalescer::Update update;
+    if (pendingTransferUpdates.take(handle, update))
+    {
+        onTransferDataUpdate(handle, update.state, update.progress, update.size, update.speed,
+                             QString::fromUtf8(update.localPath));
+    }
+}
+
+void HTTPServer::removeTransferRequest(MegaHandle handle)
+{
+    pendingTransferUpdates.remove(handle);
+
+    QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(handle);
+    if (it != webTransferStateRequests.end())
+    {
+        delete it.value();
+        webTransferStateRequests.erase(it);
+    }
+}
+
 void HTTPServer::readClient()
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Processing webclient request via %1").arg(QString::fromUtf8(sslEnabled ? "HTTPS" : "HTTP")).toUtf8().constData());
@@ -231,13 +380,30 @@ void HTTPServer::readClient()
         return;
     }
 
-    QByteArray socketData = socket->readAll();
-    request->data.append(QString::fromUtf8(socketData.data()));
-    if (request->data.contains(QString::fromUtf8("\r\n\r\n")))
+    parseClientData(socket, request, socket->readAll());
+}
+
+void HTTPServer::parseClientData(QAbstractSocket* socket, HTTPRequest* request, const QByteArray& data)
+{
+    request->idleTimer->stop();
+    request->receivedData |= !data.isEmpty();
+
+    auto previousState = request->parser.state();
+    auto state = request->parser.feed(data);
+    if (state == HTTPRequestParser::INVALID)
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Unable to parse webclient request");
+        rejectRequest(socket, QString::fromUtf8("400 Bad Request"));
+        return;
+    }
+
+    if (state != HTTPRequestParser::READING_HEADERS && !request->headersChecked)
     {
-        QStringList tokens = request->data.split(QString::fromUtf8("\r\n\r\n"));
-        QStringList headers = tokens[0].split(QString::fromUtf8("\r\n"));
+        request->headersChecked = true;
+        const QStringList& headers = request->parser.headers();
         bool requestIsPost = isRequestOfType(headers, "POST");
+        request->keepAlive = headers.size() && request->servedRequests + 1 < MAX_KEEP_ALIVE_REQUESTS
+                && isKeepAliveRequest(headers);
         bool requestIsOption = isRequestOfType(headers, "OPTION");
 
         if (!headers.size() || (!requestIsPost && !requestIsOption))
@@ -262,16 +428,54 @@ void HTTPServer::readClient()
             }
         }
 
-        if (requestIsPost)
+        if (requestIsOption)
         {
-            processPostRequest(socket, request, headers, tokens[1]);
+            processOptionRequest(socket, request, headers);
+            return;
         }
-        else // requestIsOption
+
+        if (!checkPostRequest(socket, request))
         {
-            processOptionRequest(socket, request, headers);
+            return;
         }
     }
+
+    if (state == HTTPRequestParser::COMPLETE && previousState != HTTPRequestParser::COMPLETE)
+    {
+        processPostRequest(socket, request);
+    }
 }
+
+void HTTPServer::readNextRequest(QPointer<QAbstractSocket> socket)
+{
+    //Queued, so a long pipeline of requests does not recurse through processRequest
+    QTimer::singleShot(0, this, [this, socket]()
+    {
+        HTTPRequest* request = socket ? requests.value(socket) : nullptr;
+        if (!request || disabled)
+        {
+            return;
+        }
+
+        QByteArray pipelined = request->parser.remaining();
+        QPointer<QTimer> idleTimer = request->idleTimer;
+        int servedRequests = request->servedRequests + 1;
+        *request = HTTPRequest();
+        request->idleTimer = idleTimer;
+        request->servedRequests = servedRequests;
+        request->receivedData = true;
+
+        pipelined.append(socket->readAll());
+        if (pipelined.isEmpty())
+        {
+            request->idleTimer->start();
+            return;
+        }
+
+        parseClientData(socket, request, pipelined);
+    });
+}
+
 void HTTPServer::discardClient()
 {
     QAbstractSocket* socket = (QSslSocket*)sender();
@@ -305,8 +509,14 @@ void HTTPServer::processRequest(QPointer<QAbstractSocket> socket, HTTPRequest re
 {
     QString response;
 
-    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Webclient request received: %1").arg(request.data).toUtf8().constData());
-    switch(GetRequestType(request))
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Webclient request received: %1").arg(getLoggableRequest(request)).toUtf8().constData());
+    auto requestType = GetRequestType(request);
+    if (requestType != EXTERNAL_DOWNLOAD_REQUEST_START)
+    {
+        request.data = QString::fromUtf8(request.body);
+    }
+
+    switch(requestType)
     {
     case VERSION_COMMAND:
         //Version command is taken using QtConcurrent, this is why the case is broken, as the response is received later
@@ -339,6 +549,9 @@ void HTTPServer::processRequest(QPointer<QAbstractSocket> socket, HTTPRequest re
     case EXTERNAL_TRANSFER_QUERY_PROGRESS_START:
         externalTransferQueryProgress(response, request);
         break;
+    case EXTERNAL_TRANSFER_BATCH_QUERY_PROGRESS_START:
+        externalTransferBatchQueryProgress(response, request);
+        break;
     case EXTERNAL_SHOW_IN_FOLDER:
         externalShowInFolder(response, request);
         break;
@@ -347,7 +560,7 @@ void HTTPServer::processRequest(QPointer<QAbstractSocket> socket, HTTPRequest re
         break;
     case UNKNOWN_REQUEST:
     default:
-        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Unknown webclient request: %1").arg(request.data).toUtf8().constData());
+        MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Unknown webclient request: %1").arg(getLoggableRequest(request)).toUtf8().constData());
         break;
     }
 
@@ -362,7 +575,7 @@ void HTTPServer::endProcessRequest(QPointer<QAbstractSocket> socket,const HTTPRe
 
         if (!response.size())
         {
-            MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Invalid webclient request: %1").arg(request.data).toUtf8().constData());
+            MegaApi::log(MegaApi::LOG_LEVEL_ERROR, QString::fromUtf8("Invalid webclient request: %1").arg(getLoggableRequest(request)).toUtf8().constData());
             response = QString::number(MegaError::API_EARGS);
         }
         else
@@ -370,18 +583,30 @@ void HTTPServer::endProcessRequest(QPointer<QAbstractSocket> socket,const HTTPRe
             MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Response to HTTP request: %1").arg(response).toUtf8().constData());
         }
 
-        QString fullResponse = QString::fromUtf8("HTTP/1.0 200 Ok\r\n"
-                                                 "Access-Control-Allow-Origin: %1\r\n"
+        QByteArray content = response.toUtf8();
+        QString fullResponse = QString::fromUtf8("%1 200 Ok\r\n"
+                                                 "Access-Control-Allow-Origin: %2\r\n"
                                                  "Content-Type: text/html; charset=\"utf-8\"\r\n"
-                                                 "Content-Length: %2\r\n"
-                                                 "\r\n"
-                                                 "%3").arg(request.origin).arg(response.size()).arg(response);
+                                                 "Content-Length: %3\r\n"
+                                                 "%4"
+                                                 "\r\n")
+                .arg(QString::fromUtf8(request.keepAlive ? "HTTP/1.1" : "HTTP/1.0"))
+                .arg(request.origin)
+                .arg(content.size())
+                .arg(request.keepAlive ? getKeepAliveHeaders() : QString());
         if (safeServer && socket)
         {
-            socket->write(fullResponse.toUtf8());
+            socket->write(fullResponse.toUtf8() + content);
             socket->flush();
-            socket->disconnectFromHost();
-            socket->deleteLater();
+            if (request.keepAlive)
+            {
+                readNextRequest(socket);
+            }
+            else
+            {
+                socket->disconnectFromHost();
+                socket->deleteLater();
+            }
         }
     }
 }
@@ -392,7 +617,7 @@ void HTTPServer::error(QAbstractSocket::SocketError)
     {
         QAbstractSocket *socket = (QAbstractSocket*)sender();
         HTTPRequest *request = requests.value(socket);
-        if (request && !request->data.size())
+        if (request && !request->receivedData)
         {
             MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Webclient failed to connect using HTTPS");
             emit onConnectionError();
@@ -466,11 +691,7 @@ void HTTPServer::openLinkRequest(QString &response, const HTTPRequest& request)
         auto preferences = Preferences::instance();
         QString defaultPath = preferences->downloadFolder();
         MegaHandle megaHandle = megaApi->base64ToHandle(handle.toUtf8().constData());
-        QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(megaHandle);
-        if (it != webTransferStateRequests.end())
-        {
-            delete it.value();
-        }
+        removeTransferRequest(megaHandle);
         webTransferStateRequests.insert(megaHandle, new RequestTransferData());
 
         if (preferences->hasDefaultDownloadFolder() && QFile(defaultPath).exists())
@@ -497,16 +718,16 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
     QPointer<HTTPServer> safeServer = this;
 
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "ExternalDownload command received from the webclient");
-    int start = request.data.indexOf(QString::fromUtf8("\"f\":[")) + 5;
-    if (start > 0)
+    WebclientDownloadParser parser(request.body);
+    if (parser.readHeader())
     {
-        QString privateAuth = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("esid"));
-        QString publicAuth  = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("en"));
-        QString chatAuth    = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("cauth"));
+        QString privateAuth = QString::fromUtf8(parser.privateAuth());
+        QString publicAuth  = QString::fromUtf8(parser.publicAuth());
+        QString chatAuth    = QString::fromUtf8(parser.chatAuth());
 
         if (privateAuth.isEmpty() && publicAuth.isEmpty())
         {
-            QString auth  = Utilities::extractJSONString(request.data.mid(0, start), QString::fromUtf8("auth"));
+            QString auth  = QString::fromUtf8(parser.auth());
             if (auth.length() == 8)
             {
                 publicAuth = auth;
@@ -520,27 +741,17 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
         if (privateAuth.size() || publicAuth.size())
         {
             QQueue<WrappedNode *> downloadQueue;
+            QByteArray privateAuthData = privateAuth.toUtf8();
+            QByteArray publicAuthData = publicAuth.toUtf8();
+            QByteArray chatAuthData = chatAuth.toUtf8();
 
-            int end;
+            WebclientNode file;
             bool firstnode = true;
+            int parsedNodes = 0;
 
-            while (request.data[start] == QChar::fromAscii('{'))
+            while (parser.nextNode(file))
             {
-                end = request.data.indexOf(QChar::fromAscii('}'), start);
-                if (end < 0)
-                {
-                    MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error parsing webclient request");
-                    qDeleteAll(downloadQueue);
-                    downloadQueue.clear();
-                    break;
-                }
-
-                end++;
-                QString file = request.data.mid(start, end - start);
-                start = end + 1;
-
-                long long type = Utilities::extractJSONNumber(file, QString::fromUtf8("t"));
-                if (type < 0)
+                if (file.type < 0)
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Node without type in webclient request");
                     qDeleteAll(downloadQueue);
@@ -548,8 +759,7 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     break;
                 }
 
-                QString handle = Utilities::extractJSONString(file, QString::fromUtf8("h"));
-                if (handle.isEmpty())
+                if (file.handle.isEmpty())
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Node without handle in webclient request");
                     qDeleteAll(downloadQueue);
@@ -557,11 +767,8 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     break;
                 }
 
-                QString name = Utilities::extractJSONString(file, QString::fromUtf8("n"));
-                name.replace(QString::fromUtf8("-"), QString::fromUtf8("+"));
-                name.replace(QString::fromUtf8("_"), QString::fromUtf8("/"));
-                name = QString::fromUtf8(QByteArray::fromBase64(name.toUtf8().constData()).constData());
-                if (name.isEmpty())
+                QByteArray name = QByteArray::fromBase64(file.name, QByteArray::Base64UrlEncoding);
+                if (name.isEmpty() || !name.at(0))
                 {
                     MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Node without name in webclient request");
                     qDeleteAll(downloadQueue);
@@ -569,17 +776,19 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     break;
                 }
 
-                MegaHandle h = megaApi->base64ToHandle(handle.toUtf8().constData());
+                MegaHandle h = megaApi->base64ToHandle(file.handle.constData());
                 MegaHandle p = INVALID_HANDLE;
 
                 if (!firstnode)
                 {
-                    QString parentHandle = Utilities::extractJSONString(file, QString::fromUtf8("p"));
-                    p = megaApi->base64ToHandle(parentHandle.toUtf8().constData());
-                    QApplication::processEvents();
-                    if (!safeServer || !safeSocket)
+                    p = megaApi->base64ToHandle(file.parent.constData());
+                    if (++parsedNodes % NODES_BETWEEN_PROCESS_EVENTS == 0)
                     {
-                        return;
+                        QApplication::processEvents();
+                        if (!safeServer || !safeSocket)
+                        {
+                            return;
+                        }
                     }
                 }
                 else
@@ -587,31 +796,23 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                     firstnode = false;
                 }
 
-                if (type != MegaNode::TYPE_FILE)
+                if (file.type != MegaNode::TYPE_FILE)
                 {
-                    MegaNode *node = megaApi->createForeignFolderNode(h, name.toUtf8().constData(), p,
-                                                                     privateAuth.toUtf8().constData(),
-                                                                     publicAuth.toUtf8().constData());
+                    MegaNode *node = megaApi->createForeignFolderNode(h, name.constData(), p,
+                                                                     privateAuthData.constData(),
+                                                                     publicAuthData.constData());
                     downloadQueue.append(new WrappedNode(WrappedNode::TransferOrigin::FROM_WEBSERVER, node));
                 }
                 else
                 {
-                    QString key = Utilities::extractJSONString(file, QString::fromUtf8("k"));
-                    if (key.size() == 43)
+                    if (file.key.size() == 43)
                     {
-                        long long size = Utilities::extractJSONNumber(file, QString::fromUtf8("s"));
-                        long long mtime = Utilities::extractJSONNumber(file, QString::fromUtf8("ts"));
-
-                        MegaNode *node = megaApi->createForeignFileNode(h, key.toUtf8().constData(),
-                                                         name.toUtf8().constData(), size, mtime,
-                                                         p, privateAuth.toUtf8().constData(),
-                                                         publicAuth.toUtf8().constData(), chatAuth.isEmpty() ? NULL : chatAuth.toUtf8().constData());
+                        MegaNode *node = megaApi->createForeignFileNode(h, file.key.constData(),
+                                                         name.constData(), file.size, file.mtime,
+                                                         p, privateAuthData.constData(),
+                                                         publicAuthData.constData(), chatAuth.isEmpty() ? NULL : chatAuthData.constData());
                         downloadQueue.append(new WrappedNode(WrappedNode::TransferOrigin::FROM_WEBSERVER, node));
-                        QMap<MegaHandle, RequestTransferData*>::iterator it = webTransferStateRequests.find(h);
-                        if (it != webTransferStateRequests.end())
-                        {
-                            delete it.value();
-                        }
+                        removeTransferRequest(h);
                         webTransferStateRequests.insert(h, new RequestTransferData());
                     }
                     else
@@ -621,6 +822,13 @@ void HTTPServer::externalDownloadRequest(QString &response, const HTTPRequest& r
                 }
             }
 
+            if (parser.hasError())
+            {
+                MegaApi::log(MegaApi::LOG_LEVEL_ERROR, "Error parsing webclient request");
+                qDeleteAll(downloadQueue);
+                downloadQueue.clear();
+            }
+
             if (downloadQueue.size())
             {
                 emit onExternalDownloadRequested(downloadQueue);
@@ -824,29 +1032,79 @@ void HTTPServer::externalTransferQueryProgress(QString &response, const HTTPRequ
     }
     else
     {
-        if (!webTransferStateRequests.contains(handle))
-        {
-            response = QString::number(MegaError::API_ENOENT);
-        }
-        else
+        response = getTransferProgress(handle);
+    }
+}
+
+void HTTPServer::externalTransferBatchQueryProgress(QString &response, const HTTPRequest& request)
+{
+    //{"a":"tb","h":["<handle>",...]} is answered with {"<handle>":<progress or error code>,...}
+    JsonTokenizer tokenizer(request.body.constData(), request.body.size());
+    if (tokenizer.next() != JsonTokenizer::OBJECT_BEGIN)
+    {
+        return;
+    }
+
+    while (tokenizer.next() == JsonTokenizer::KEY)
+    {
+        if (!tokenizer.tokenIs("h"))
         {
-            RequestTransferData* tData = webTransferStateRequests.value(handle);
-            if (tData->state == MegaTransfer::STATE_NONE)
+            if (!tokenizer.skipValue())
             {
-                response = QString::fromUtf8("{\"s\":%1}").arg(tData->state);
+                return;
             }
-            else
+            continue;
+        }
+
+        if (tokenizer.next() != JsonTokenizer::ARRAY_BEGIN)
+        {
+            return;
+        }
+
+        QStringList progress;
+        JsonTokenizer::Token token;
+        while ((token = tokenizer.next()) == JsonTokenizer::STRING)
+        {
+            MegaHandle handle = MegaApi::base64ToHandle(tokenizer.text().constData());
+            if (handle == mega::INVALID_HANDLE)
             {
-                response = QString::fromUtf8("{\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4}")
-                        .arg(tData->state)
-                        .arg(tData->progress)
-                        .arg(tData->size)
-                        .arg(tData->speed);
+                continue;
             }
+
+            char* base64Handle = MegaApi::handleToBase64(handle);
+            progress.append(QString::fromUtf8("\"%1\":%2").arg(QString::fromUtf8(base64Handle)).arg(getTransferProgress(handle)));
+            delete [] base64Handle;
         }
+
+        if (token == JsonTokenizer::ARRAY_END)
+        {
+            response = QString::fromUtf8("{%1}").arg(progress.join(QString::fromUtf8(",")));
+        }
+        return;
     }
 }
 
+QString HTTPServer::getTransferProgress(MegaHandle handle)
+{
+    if (!webTransferStateRequests.contains(handle))
+    {
+        return QString::number(MegaError::API_ENOENT);
+    }
+
+    publishTransferDataUpdate(handle);
+    RequestTransferData* tData = webTransferStateRequests.value(handle);
+    if (tData->state == MegaTransfer::STATE_NONE)
+    {
+        return QString::fromUtf8("{\"s\":%1}").arg(tData->state);
+    }
+
+    return QString::fromUtf8("{\"s\":%1,\"p\":%2,\"t\":%3,\"v\":%4}")
+            .arg(tData->state)
+            .arg(tData->progress)
+            .arg(tData->size)
+            .arg(tData->speed);
+}
+
 void HTTPServer::externalShowInFolder(QString &response, const HTTPRequest& request)
 {
     MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, "Show in folder command received from the webclient");
@@ -869,6 +1127,7 @@ void HTTPServer::externalShowInFolder(QString &response, const HTTPRequest& requ
         }
         else
         {
+            publishTransferDataUpdate(handle);
             RequestTransferData* tData = webTransferStateRequests.value(handle);
             if (!tData->tPath.isNull())
             {
@@ -926,70 +1185,85 @@ void HTTPServer::externalAddBackup(QString &response, const HTTPRequest& request
 
 HTTPServer::RequestType HTTPServer::GetRequestType(const HTTPRequest &request)
 {
-    static const QString openLinkRequestStart(QLatin1String("{\"a\":\"l\","));
-    static const QString externalDownloadRequestStart(QLatin1String("{\"a\":\"d\","));
-    static const QString externalFileUploadRequestStart(QLatin1String("{\"a\":\"ufi\","));
-    static const QString externalFolderUploadRequestStart(QLatin1String("{\"a\":\"ufo\","));
-    static const QString externalFolderSyncRequestStart(QLatin1String("{\"a\":\"s\","));
-    static const QString externalFolderSyncCheckStart(QLatin1String("{\"a\":\"sp\","));
-    static const QString externalOpenTransferManagerStart(QLatin1String("{\"a\":\"tm\","));
-    static const QString externalUploadSelectionStatusStart(QLatin1String("{\"a\":\"uss\","));
-    static const QString externalTransferQueryProgressStart(QLatin1String("{\"a\":\"t\","));
-    static const QString externalShowInFolder(QLatin1String("{\"a\":\"sf\","));
-    static const QString versionCommand(QLatin1String("{\"a\":\"v\"}"));
-    static const QString externalAddBackup(QLatin1String("{\"a\":\"ab\",\"u\":\""));
-
-    if(request.data == versionCommand)
+    static const QByteArray openLinkRequestStart(QByteArrayLiteral("{\"a\":\"l\","));
+    static const QByteArray externalDownloadRequestStart(QByteArrayLiteral("{\"a\":\"d\","));
+    static const QByteArray externalFileUploadRequestStart(QByteArrayLiteral("{\"a\":\"ufi\","));
+    static const QByteArray externalFolderUploadRequestStart(QByteArrayLiteral("{\"a\":\"ufo\","));
+    static const QByteArray externalFolderSyncRequestStart(QByteArrayLiteral("{\"a\":\"s\","));
+    static const QByteArray externalFolderSyncCheckStart(QByteArrayLiteral("{\"a\":\"sp\","));
+    static const QByteArray externalOpenTransferManagerStart(QByteArrayLiteral("{\"a\":\"tm\","));
+    static const QByteArray externalUploadSelectionStatusStart(QByteArrayLiteral("{\"a\":\"uss\","));
+    static const QByteArray externalTransferQueryProgressStart(QByteArrayLiteral("{\"a\":\"t\","));
+    static const QByteArray externalTransferBatchQueryProgressStart(QByteArrayLiteral("{\"a\":\"tb\","));
+    static const QByteArray externalShowInFolder(QByteArrayLiteral("{\"a\":\"sf\","));
+    static const QByteArray versionCommand(QByteArrayLiteral("{\"a\":\"v\"}"));
+    static const QByteArray externalAddBackup(QByteArrayLiteral("{\"a\":\"ab\",\"u\":\""));
+
+    if(request.body == versionCommand)
     {
         return VERSION_COMMAND;
     }
-    else if(request.data.startsWith(openLinkRequestStart))
+    else if(request.body.startsWith(openLinkRequestStart))
     {
         return OPEN_LINK_REQUEST_START;
     }
-    else if(request.data.startsWith(externalDownloadRequestStart))
+    else if(request.body.startsWith(externalDownloadRequestStart))
     {
         return EXTERNAL_DOWNLOAD_REQUEST_START;
     }
-    else if(request.data.startsWith(externalFileUploadRequestStart))
+    else if(request.body.startsWith(externalFileUploadRequestStart))
     {
         return EXTERNAL_FILE_UPLOAD_REQUEST_START;
     }
-    else if (request.data.startsWith(externalFolderUploadRequestStart))
+    else if (request.body.startsWith(externalFolderUploadRequestStart))
     {
         return EXTERNAL_FOLDER_UPLOAD_REQUEST_START;
     }
-    else if (request.data.startsWith(externalUploadSelectionStatusStart))
+    else if (request.body.startsWith(externalUploadSelectionStatusStart))
     {
         return EXTERNAL_UPLOAD_SELECTION_STATUS_START;
     }
-    else if (request.data.startsWith(externalFolderSyncRequestStart))
+    else if (request.body.startsWith(externalFolderSyncRequestStart))
     {
         return EXTERNAL_FOLDER_SYNC_REQUEST_START;
     }
-    else if (request.data.startsWith(externalFolderSyncCheckStart))
+    else if (request.body.startsWith(externalFolderSyncCheckStart))
     {
         return EXTERNAL_FOLDER_SYNC_CHECK_START;
     }
-    else if(request.data.startsWith(externalOpenTransferManagerStart))
+    else if(request.body.startsWith(externalOpenTransferManagerStart))
     {
         return EXTERNAL_OPEN_TRANSFER_MANAGER_START;
     }
-    else if(request.data.startsWith(externalShowInFolder))
+    else if(request.body.startsWith(externalShowInFolder))
     {
         return EXTERNAL_SHOW_IN_FOLDER;
     }
-    else if(request.data.startsWith(externalTransferQueryProgressStart))
+    else if(request.body.startsWith(externalTransferQueryProgressStart))
     {
         return EXTERNAL_TRANSFER_QUERY_PROGRESS_START;
     }
-    else if(request.data.startsWith(externalAddBackup))
+    else if(request.body.startsWith(externalTransferBatchQueryProgressStart))
+    {
+        return EXTERNAL_TRANSFER_BATCH_QUERY_PROGRESS_START;
+    }
+    else if(request.body.startsWith(externalAddBackup))
     {
         return EXTERNAL_ADD_BACKUP;
     }
     return UNKNOWN_REQUEST;
 }
 
+QString HTTPServer::getLoggableRequest(const HTTPRequest& request)
+{
+    if (request.body.size() > MAX_LOGGED_REQUEST_BYTES)
+    {
+        return QString::fromUtf8("%1... (%2 bytes)").arg(QString::fromUtf8(request.body.left(MAX_LOGGED_REQUEST_BYTES)))
+                                                    .arg(request.body.size());
+    }
+    return QString::fromUtf8(request.body);
+}
+
 QString HTTPServer::findCorrespondingAllowedOrigin(const QStringList& headers)
 {
     for (const QString& allowedOrigin : qAsConst(Preferences::HTTPS_ALLOWED_ORIGINS))
@@ -1007,42 +1281,32 @@ QString HTTPServer::findCorrespondingAllowedOrigin(const QStringList& headers)
     return QString();
 }
 
-void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* request,
-                                    const QStringList& headers, const QString& content)
+bool HTTPServer::checkPostRequest(QAbstractSocket *socket, HTTPRequest* request)
 {
-    QString contentLengthId = QString::fromUtf8("Content-length: ");
-    QStringList contentLengthHeader = headers.filter(QRegExp(contentLengthId, Qt::CaseInsensitive));
-    if (!contentLengthHeader.size())
+    //An unparseable Content-length makes the parser fail before this
+    if (!request->parser.hasContentLength())
     {
         MegaApi::log(MegaApi::LOG_LEVEL_WARNING, "Missing Content-length header");
         rejectRequest(socket);
-        return;
+        return false;
     }
 
-    bool ok;
-    request->contentLength = contentLengthHeader[0].mid(contentLengthId.size(), contentLengthHeader[0].size() - contentLengthId.size()).toInt(&ok);
-    if (!ok || request->contentLength < content.size())
-    {
-        if (!ok)
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Unable to parse Content-length header: %1")
-                         .arg(contentLengthHeader[0]).toUtf8().constData());
-        }
-        else
-        {
-            MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Invalid Content-length header. Header: %1 - Data: %2")
-                         .arg(request->contentLength).arg(content.size()).toUtf8().constData());
-        }
-        rejectRequest(socket);
-        return;
-    }
+    request->contentLength = request->parser.contentLength();
+    return true;
+}
 
-    if (request->contentLength > content.size())
+void HTTPServer::processPostRequest(QAbstractSocket *socket, HTTPRequest* request)
+{
+    //On persistent connections the bytes after the body are the next (pipelined) request
+    if (!request->keepAlive && !request->parser.remaining().isEmpty())
     {
+        MegaApi::log(MegaApi::LOG_LEVEL_WARNING, QString::fromUtf8("Invalid Content-length header. Header: %1 - Data: %2")
+                     .arg(request->contentLength).arg(request->contentLength + request->parser.remaining().size()).toUtf8().constData());
+        rejectRequest(socket);
         return;
     }
 
-    request->data = content;
+    request->body = request->parser.takeBody();
 
 
     QPointer<QAbstractSocket> safeSocket = socket;
@@ -1066,6 +1330,8 @@ void HTTPServer::sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* req
                                              ).arg(request->origin);
     if (sendPrivateNetworkField)
         fullResponse += QString::fromUtf8("Access-Control-Allow-Private-Network: true\r\n");
+    if (request->keepAlive)
+        fullResponse += getKeepAliveHeaders();
 
     fullResponse += QString::fromUtf8(   "Access-Control-Max-Age: 86400\r\n"
                                          "\r\n");
@@ -1074,8 +1340,15 @@ void HTTPServer::sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* req
     {
         safeSocket->write(fullResponse.toUtf8());
         safeSocket->flush();
-        safeSocket->disconnectFromHost();
-        safeSocket->deleteLater();
+        if (request->keepAlive)
+        {
+            readNextRequest(safeSocket);
+        }
+        else
+        {
+            safeSocket->disconnectFromHost();
+            safeSocket->deleteLater();
+        }
     }
 }
 
@@ -1119,6 +1392,33 @@ bool HTTPServer::hasFieldWithValue(const QStringList& headers, const char* field
     return isFieldAsExpected;
 }
 
+bool HTTPServer::isKeepAliveRequest(const QStringList& headers)
+{
+    //HTTP/1.1 connections are persistent unless the client asks to close them
+    static const QString connectionField(QLatin1String("Connection:"));
+    QString connection;
+    for (const QString& header : headers)
+    {
+        if (header.startsWith(connectionField, Qt::CaseInsensitive))
+        {
+            connection = header.mid(connectionField.size()).trimmed();
+            break;
+        }
+    }
+
+    if (headers[0].endsWith(QLatin1String("HTTP/1.1")))
+    {
+        return connection.compare(QLatin1String("close"), Qt::CaseInsensitive) != 0;
+    }
+    return connection.compare(QLatin1String("keep-alive"), Qt::CaseInsensitive) == 0;
+}
+
+QString HTTPServer::getKeepAliveHeaders()
+{
+    return QString::fromUtf8("Connection: keep-alive\r\n"
+                             "Keep-Alive: timeout=%1, max=%2\r\n").arg(KEEP_ALIVE_TIMEOUT_SECS).arg(MAX_KEEP_ALIVE_REQUESTS);
+}
+
 bool HTTPServer::isPreFlightCorsRequest(const QStringList& headers)
 {
     return hasFieldWithValue(headers, "Access-Control-Request-Method", "POST");
@@ -7,13 +7,43 @@
 #include <QFile>
 #include <QStringList>
 #include <QDateTime>
+#include <QHash>
 #include <QQueue>
 #include <QFutureWatcher>
 #include <QPointer>
+#include <QTimer>
+#include <QSslConfiguration>
 
 #include <megaapi.h>
 
 #include "Utilities.h"
+#include "HTTPRequestParser.h"
+
+//Keeps only the last progress update of each transfer until it is taken, so a transfer reporting
+//many updates between two webclient polls costs a single publication
+class TransferUpdateCoalescer
+{
+public:
+    struct Update
+    {
+        int state;
+        long long progress;
+        long long size;
+        long long speed;
+        QByteArray localPath;
+    };
+
+    void add(mega::MegaTransfer* transfer);
+    bool take(mega::MegaHandle handle, Update& update);
+    void remove(mega::MegaHandle handle);
+    int size() const;
+    //Updates which replaced a pending one instead of being published
+    long long coalesced() const;
+
+private:
+    QHash<mega::MegaHandle, Update> mUpdates;
+    long long mCoalesced = 0;
+};
 
 class RequestData
 {
@@ -49,10 +79,20 @@ public:
 class HTTPRequest
 {
 public:
-    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")) {}
+    HTTPRequest() : contentLength(0), origin(QString::fromUtf8("*")), headersChecked(false), keepAlive(false), servedRequests(0), receivedData(false) {}
     QString data;
+    //Raw request body. data is not filled for download requests, which are parsed from here.
+    QByteArray body;
     int contentLength;
     QString origin;
+    HTTPRequestParser parser;
+    bool headersChecked;
+    bool keepAlive;
+    //Connection state, kept between the requests of a persistent connection
+    int servedRequests;
+    //Any byte received on the connection, so errors after a request are not taken as failed HTTPS handshakes
+    bool receivedData;
+    QPointer<QTimer> idleTimer;
 };
 
 class HTTPServer: public QTcpServer
@@ -71,6 +111,7 @@ class HTTPServer: public QTcpServer
         EXTERNAL_OPEN_TRANSFER_MANAGER_START,
         EXTERNAL_UPLOAD_SELECTION_STATUS_START,
         EXTERNAL_TRANSFER_QUERY_PROGRESS_START,
+        EXTERNAL_TRANSFER_BATCH_QUERY_PROGRESS_START,
         EXTERNAL_SHOW_IN_FOLDER,
         EXTERNAL_ADD_BACKUP,
         UNKNOWN_REQUEST,
@@ -78,6 +119,8 @@ class HTTPServer: public QTcpServer
 
     public:
         static const unsigned int MAX_REQUEST_TIME_SECS;
+        static const int KEEP_ALIVE_TIMEOUT_SECS;
+        static const int MAX_KEEP_ALIVE_REQUESTS;
 
         HTTPServer(mega::MegaApi *megaApi, quint16 port, bool sslEnabled);
         ~HTTPServer();
@@ -91,6 +134,9 @@ class HTTPServer: public QTcpServer
         static void onUploadSelectionDiscarded();
         static void onTransferDataUpdate(mega::MegaHandle handle, int state, long long progress,
                                          long long size, long long speed, QString localPath);
+        //Keeps only the last update of each handle until the webclient asks for it
+        static void onTransferDataUpdate(mega::MegaTransfer* transfer);
+        static long long getCoalescedTransferUpdates();
 
     signals:
         void onLinkReceived(QString link, QString auth);
@@ -118,15 +164,24 @@ class HTTPServer: public QTcpServer
 
     private:
         QString findCorrespondingAllowedOrigin(const QStringList& headers);
+        QSslConfiguration getSslConfiguration();
 
-        void processPostRequest(QAbstractSocket* socket, HTTPRequest* request,
-                                const QStringList& headers, const QString& content);
+        void parseClientData(QAbstractSocket* socket, HTTPRequest* request, const QByteArray& data);
+        void readNextRequest(QPointer<QAbstractSocket> socket);
+        static bool isKeepAliveRequest(const QStringList& headers);
+        static QString getKeepAliveHeaders();
+
+        bool checkPostRequest(QAbstractSocket* socket, HTTPRequest* request);
+        void processPostRequest(QAbstractSocket* socket, HTTPRequest* request);
         void processOptionRequest(QAbstractSocket* socket, HTTPRequest* request, const QStringList& headers);
         void sendPreFlightResponse(QAbstractSocket* socket, HTTPRequest* request, bool sendPrivateNetworkField);
         bool hasFieldWithValue(const QStringList& headers, const char* fieldName, const char* value);
         bool isPreFlightCorsRequest(const QStringList& headers);
         bool isRequestOfType(const QStringList& headers, const char* typeName);
 
+        static void publishTransferDataUpdate(mega::MegaHandle handle);
+        static void removeTransferRequest(mega::MegaHandle handle);
+
         struct VersionCommandAnswer
         {
             QPointer<QAbstractSocket> socket;
@@ -144,12 +199,15 @@ class HTTPServer: public QTcpServer
         void externalOpenTransferManager(QString& response, const HTTPRequest& request);
         void externalUploadSelectionStatus(QString& response, const HTTPRequest& request);
         void externalTransferQueryProgress(QString& response, const HTTPRequest& request);
+        void externalTransferBatchQueryProgress(QString& response, const HTTPRequest& request);
+        static QString getTransferProgress(mega::MegaHandle handle);
         void externalShowInFolder(QString& response, const HTTPRequest& request);
         void externalAddBackup(QString& response, const HTTPRequest& request);
 
         void endProcessRequest(QPointer<QAbstractSocket> socket, const HTTPRequest &request, QString response);
 
         RequestType GetRequestType(const HTTPRequest& request);
+        static QString getLoggableRequest(const HTTPRequest& request);
         bool disabled;
         bool sslEnabled;
         mega::MegaApi *megaApi;
@@ -157,7 +215,9 @@ class HTTPServer: public QTcpServer
         static bool isFirstWebDownloadDone;
         static QMultiMap<QString, RequestData*> webDataRequests;
         static QMap<mega::MegaHandle, RequestTransferData*> webTransferStateRequests;
+        static TransferUpdateCoalescer pendingTransferUpdates;
         QFutureWatcher<VersionCommandAnswer> mVersionCommandWatcher;
+        QSslConfiguration mSslConfiguration;
 };
 
 #endif // HTTPSERVER_H
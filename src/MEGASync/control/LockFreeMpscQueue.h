@@ -0,0 +1,145 @@
+#ifndef LOCKFREEMPSCQUEUE_H
+#define LOCKFREEMPSCQUEUE_H
+
+#include <QThread>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+//Bounded multi-producer/single-consumer ring buffer.
+//Every slot carries a sequence number, so producers only compete for the write position
+//(one CAS) and the consumer never takes a lock. Capacity is rounded up to a power of two.
+template <typename T>
+class LockFreeMpscQueue
+{
+public:
+    explicit LockFreeMpscQueue(std::size_t capacity)
+        : mMask(roundUpPowerOfTwo(capacity) - 1),
+          mCells(new Cell[mMask + 1])
+    {
+        for(std::size_t index = 0; index <= mMask; ++index)
+        {
+            mCells[index].sequence.store(index, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeMpscQueue(const LockFreeMpscQueue&) = delete;
+    LockFreeMpscQueue& operator=(const LockFreeMpscQueue&) = delete;
+
+    //Producer side. Returns false if the ring is full.
+    bool tryPush(T&& value)
+    {
+        auto position = mEnqueuePos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            auto& cell = mCells[position & mMask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if(diff == 0)
+            {
+                if(mEnqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    //Producer side. Yields until the consumer makes room, so events are never dropped.
+    void push(T&& value)
+    {
+        while(!tryPush(std::move(value)))
+        {
+            mFullHits.fetch_add(1, std::memory_order_relaxed);
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    //Consumer side. Must only be called from one thread at a time.
+    bool tryPop(T& value)
+    {
+        auto& cell = mCells[mDequeuePos & mMask];
+        auto sequence = cell.sequence.load(std::memory_order_acquire);
+        if(static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(mDequeuePos + 1) < 0)
+        {
+            return false;
+        }
+
+        value = std::move(cell.value);
+        cell.value = T();
+        cell.sequence.store(mDequeuePos + mMask + 1, std::memory_order_release);
+        ++mDequeuePos;
+        return true;
+    }
+
+    //Consumer side. Pops everything published so far and returns the number of items consumed.
+    template <typename Consumer>
+    std::size_t drain(Consumer&& consumer)
+    {
+        std::size_t consumed(0);
+        T value;
+        while(tryPop(value))
+        {
+            consumer(std::move(value));
+            ++consumed;
+        }
+        return consumed;
+    }
+
+    std::size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+    //Number of times a producer found the ring full. Useful to size the ring.
+    unsigned long long fullHits() const
+    {
+        return mFullHits.load(std::memory_order_relaxed);
+    }
+
+private:
+    static std::size_t roundUpPowerOfTwo(std::size_t value)
+    {
+        std::size_t result(2);
+        while(result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    const std::size_t mMask;
+    std::unique_ptr<Cell[]> mCells;
+
+    //Kept on separate cache lines so producers and consumer do not false share. Padded by hand instead of
+    //using alignas, as queues are allocated with new, which does not honour over-alignment before C++17
+    char mPadding0[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> mEnqueuePos {0};
+    char mPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    std::size_t mDequeuePos {0};
+    char mPadding2[CACHE_LINE_SIZE - sizeof(std::size_t)];
+    std::atomic<unsigned long long> mFullHits {0};
+    char mPadding3[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned long long>)];
+};
+
+#endif // LOCKFREEMPSCQUEUE_H
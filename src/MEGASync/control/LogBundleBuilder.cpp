@@ -0,0 +1,224 @@
+#include "LogBundleBuilder.h"
+#include "MegaSyncLogger.h"
+#include "Utilities.h"
+#include "control/gzjoin.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegExp>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace mega;
+
+namespace
+{
+const QString LIVE_LOG_NAME = QString::fromUtf8("MEGAsync.log");
+const qint64 LIVE_LOG_COPY_BUFFER_BYTES = 1024 * 1024;
+
+void logBundleError(const QString& message)
+{
+    std::cerr << message.toUtf8().constData() << std::endl;
+    MegaApi::log(MegaApi::LOG_LEVEL_ERROR, message.toUtf8().constData());
+}
+
+//Copies what has been flushed to MEGAsync.log so far; the logger keeps appending to it meanwhile
+bool copyLiveLog(const QString& filename, const QString& destinationFilename)
+{
+    QFile file(filename);
+    QFile copy(destinationFilename);
+    if (!file.open(QIODevice::ReadOnly) || !copy.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    auto remaining = file.size();
+    QByteArray buffer;
+    while (remaining > 0)
+    {
+        buffer = file.read(std::min(remaining, LIVE_LOG_COPY_BUFFER_BYTES));
+        if (buffer.isEmpty() || copy.write(buffer) != buffer.size())
+        {
+            return false;
+        }
+        remaining -= buffer.size();
+    }
+    return true;
+}
+}
+
+LogBundleBuilder::LogBundleBuilder(const QString& logsPath, const QString& bundlePath, QObject* parent)
+    : QObject(parent),
+      mLogsPath(logsPath),
+      mBundlePath(bundlePath),
+      mCancelled(false),
+      mRunning(false)
+{
+}
+
+LogBundleBuilder::~LogBundleBuilder()
+{
+    //The pool thread emits signals from this object, so it must be done before it is destroyed
+    cancel();
+    std::unique_lock<std::mutex> lock(mRunningMutex);
+    mRunningCondition.wait(lock, [this]() { return !mRunning; });
+}
+
+void LogBundleBuilder::setTimeWindow(const QDateTime& since, const QDateTime& until)
+{
+    mSince = since;
+    mUntil = until;
+}
+
+void LogBundleBuilder::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mRunningMutex);
+        if (mRunning)
+        {
+            return;
+        }
+        mRunning = true;
+    }
+
+    mCancelled = false;
+    ThreadPoolSingleton::getInstance()->push([this]()
+    {
+        auto success = build([this](qint64 bytesDone, qint64 bytesTotal)
+        {
+            emit progress(bytesDone, bytesTotal);
+            return !mCancelled;
+        });
+        emit finished(success);
+
+        std::lock_guard<std::mutex> lock(mRunningMutex);
+        mRunning = false;
+        mRunningCondition.notify_all();
+    });
+}
+
+void LogBundleBuilder::cancel()
+{
+    mCancelled = true;
+}
+
+QString LogBundleBuilder::getBundlePath() const
+{
+    return mBundlePath;
+}
+
+bool LogBundleBuilder::build(const std::function<bool(qint64, qint64)>& progress) const
+{
+    QDir logDir(mLogsPath);
+    if (!logDir.exists())
+    {
+        return false;
+    }
+
+    //Oldest first
+    QFileInfoList logFiles = logDir.entryInfoList(QStringList() << QString::fromUtf8("MEGAsync.[0-9]*.log"), QDir::Files);
+    std::sort(logFiles.begin(), logFiles.end(), [](const QFileInfo &v1, const QFileInfo &v2){
+        return v1.fileName().remove(QRegExp(QString::fromUtf8("[^\\d]"))).toInt() > v2.fileName().remove(QRegExp(QString::fromUtf8("[^\\d]"))).toInt();} );
+
+    std::vector<QString> members;
+    qint64 bytesTotal(0);
+    for (const auto& logFile : logFiles)
+    {
+        auto range = readLogTimeRange(logFile.absoluteFilePath());
+        if (!range.isValid())
+        {
+            //Rotated before the range was stored
+            range.lastMs = logFile.lastModified().toMSecsSinceEpoch();
+        }
+
+        if ((mSince.isValid() && range.lastMs < mSince.toMSecsSinceEpoch())
+                || (mUntil.isValid() && range.firstMs > mUntil.toMSecsSinceEpoch()))
+        {
+            continue;
+        }
+
+        members.push_back(logFile.absoluteFilePath());
+        bytesTotal += logFile.size();
+    }
+
+    //The current log is always added, as the last member. It is the only one compressed here
+    auto liveLog = logDir.filePath(LIVE_LOG_NAME);
+    auto liveLogCopy = mBundlePath + QString::fromUtf8(".live");
+    auto liveLogGz = liveLogCopy + QString::fromUtf8(".gz");
+    if (QFileInfo(liveLog).size() > 0)
+    {
+        if (copyLiveLog(liveLog, liveLogCopy) && gzipCompressLogFile(liveLogCopy, liveLogGz))
+        {
+            members.push_back(liveLogGz);
+            bytesTotal += QFileInfo(liveLogGz).size();
+        }
+        else
+        {
+            QFile::remove(liveLogCopy);
+            logBundleError(QString::fromUtf8("Error compressing the current log for bug report: %1").arg(liveLog));
+        }
+    }
+
+    if (members.empty())
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    FILE * pFile = nullptr;
+    errno_t er = _wfopen_s(&pFile, mBundlePath.toStdWString().c_str(), L"wb");
+    if (er)
+    {
+        pFile = nullptr; //just in case
+    }
+#else
+    FILE * pFile = fopen(mBundlePath.toUtf8().constData(), "wb");
+#endif
+    if (!pFile)
+    {
+        logBundleError(QString::fromUtf8("Error opening file for joining log zip files: %1").arg(mBundlePath));
+        QFile::remove(liveLogGz);
+        return false;
+    }
+
+    unsigned long crc, tot;
+    gzinit(&crc, &tot, pFile);
+
+    bool success(true);
+    qint64 bytesDone(0);
+    for (size_t i = 0; i < members.size() && success; ++i)
+    {
+        try
+        {
+            auto isLast(i + 1 == members.size());
+#ifdef _WIN32
+            gzcopy(members[i].toStdWString().c_str(), !isLast, &crc, &tot, pFile);
+#else
+            gzcopy(members[i].toUtf8().constData(), !isLast, &crc, &tot, pFile);
+#endif
+        }
+        catch (const std::exception& e)
+        {
+            logBundleError(QString::fromUtf8("Error joining zip files for bug report : %1").arg(QString::fromUtf8(e.what())));
+            success = false;
+            break;
+        }
+
+        bytesDone += QFileInfo(members[i]).size();
+        if (progress && !progress(bytesDone, bytesTotal))
+        {
+            success = false;
+        }
+    }
+
+    fclose(pFile);
+    QFile::remove(liveLogGz);
+    if (!success)
+    {
+        QFile::remove(mBundlePath);
+    }
+    return success;
+}
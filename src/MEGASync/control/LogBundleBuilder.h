@@ -0,0 +1,52 @@
+#ifndef LOGBUNDLEBUILDER_H
+#define LOGBUNDLEBUILDER_H
+
+#include <QDateTime>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+//Joins the rotated logs of the logs folder, and what has been flushed to MEGAsync.log, into a single gzip
+//file for bug reports. Rotated logs are copied without recompressing them, and the ones outside the time
+//window are skipped using the time range stored in their header.
+class LogBundleBuilder : public QObject
+{
+    Q_OBJECT
+
+public:
+    LogBundleBuilder(const QString& logsPath, const QString& bundlePath, QObject* parent = nullptr);
+    ~LogBundleBuilder();
+
+    //Null times leave that side of the window open
+    void setTimeWindow(const QDateTime& since, const QDateTime& until = QDateTime());
+
+    //Builds the bundle in the thread pool. finished is emitted once it is done
+    void start();
+    void cancel();
+
+    QString getBundlePath() const;
+
+    //Builds the bundle in the calling thread. Returning false from progress cancels it
+    bool build(const std::function<bool(qint64, qint64)>& progress = nullptr) const;
+
+signals:
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+    void finished(bool success);
+
+private:
+    QString mLogsPath;
+    QString mBundlePath;
+    QDateTime mSince;
+    QDateTime mUntil;
+
+    std::atomic<bool> mCancelled;
+    std::mutex mRunningMutex;
+    std::condition_variable mRunningCondition;
+    bool mRunning;
+};
+
+#endif // LOGBUNDLEBUILDER_H
@@ -0,0 +1,110 @@
+#ifndef LOGRING_H
+#define LOGRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+//Bounded single-producer/single-consumer byte ring for formatted log lines.
+//The producer reserves room for a whole line, appends its parts and commits it, so the consumer
+//only ever sees complete lines. Neither side takes a lock. Capacity is rounded up to a power of two.
+class LogRing
+{
+public:
+    explicit LogRing(std::size_t capacity)
+        : mMask(roundUpPowerOfTwo(capacity) - 1),
+          mBuffer(new char[mMask + 1])
+    {
+    }
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    //Producer side. Returns false if the line does not fit in the free space.
+    bool reserve(std::size_t size)
+    {
+        auto writePos = mWritePos.load(std::memory_order_relaxed);
+        if(writePos - mReadPos.load(std::memory_order_acquire) + size > capacity())
+        {
+            return false;
+        }
+        mPendingPos = writePos;
+        return true;
+    }
+
+    //Producer side. Only after a successful reserve, and never more bytes than reserved.
+    void append(const char* data, std::size_t size)
+    {
+        auto offset = mPendingPos & mMask;
+        auto first = std::min(size, capacity() - offset);
+        memcpy(mBuffer.get() + offset, data, first);
+        memcpy(mBuffer.get(), data + first, size - first);
+        mPendingPos += size;
+    }
+
+    //Producer side. Publishes everything appended since reserve.
+    void commit()
+    {
+        mWritePos.store(mPendingPos, std::memory_order_release);
+    }
+
+    //Consumer side. Passes the published bytes in at most two contiguous spans and returns how many there were.
+    template <typename Consumer>
+    std::size_t drain(Consumer&& consumer)
+    {
+        auto readPos = mReadPos.load(std::memory_order_relaxed);
+        auto size = mWritePos.load(std::memory_order_acquire) - readPos;
+        if(size)
+        {
+            auto offset = readPos & mMask;
+            auto first = std::min(size, capacity() - offset);
+            consumer(mBuffer.get() + offset, first);
+            if(size > first)
+            {
+                consumer(mBuffer.get(), size - first);
+            }
+            mReadPos.store(readPos + size, std::memory_order_release);
+        }
+        return size;
+    }
+
+    //Bytes published and not drained yet. Only exact from the producer thread.
+    std::size_t used() const
+    {
+        return mWritePos.load(std::memory_order_relaxed) - mReadPos.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const
+    {
+        return mMask + 1;
+    }
+
+private:
+    static std::size_t roundUpPowerOfTwo(std::size_t value)
+    {
+        std::size_t result(2);
+        while(result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static const std::size_t CACHE_LINE_SIZE = 64;
+
+    const std::size_t mMask;
+    std::unique_ptr<char[]> mBuffer;
+    std::size_t mPendingPos {0};
+
+    //Kept on separate cache lines so producer and consumer do not false share. Padded by hand instead of
+    //using alignas, as rings are allocated with make_shared, which does not honour over-alignment before C++17
+    char mPadding0[CACHE_LINE_SIZE];
+    std::atomic<std::size_t> mWritePos {0};
+    char mPadding1[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> mReadPos {0};
+    char mPadding2[CACHE_LINE_SIZE - sizeof(std::atomic<std::size_t>)];
+};
+
+#endif // LOGRING_H
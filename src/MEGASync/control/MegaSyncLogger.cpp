@@ -1,4 +1,5 @@
 ﻿#include "MegaSyncLogger.h"
+#include "LogRing.h"
 #include "Utilities.h"
 
 #include <fstream>
@@ -12,10 +13,13 @@
 #include <QDesktopServices>
 #include <QDir>
 #include <QFile>
+#include <QDateTime>
 
 
 #include <chrono>
+#include <deque>
 #include <thread>
+#include <vector>
 #include <condition_variable>
 
 #include <zlib.h>
@@ -37,6 +41,9 @@
 #define MAX_LOG_FILESIZE_MB_DEFAULT 10    // 10MB of log usually compresses to about 850KB (was 450 before duplicate line detection)
 #define MAX_ROTATE_LOGS_DEFAULT 50   // So we expect to keep 42MB or so in compressed logs
 #define MAX_ROTATE_LOGS_TODELETE 50   // If ever reducing the number of logs, we should remove the older ones anyway. This number should be the historical maximum of that value
+#define LOG_RING_BYTES (128 * 1024)   // per logging thread. Longer lines, or lines logged while the ring is full, go through the locked list
+#define LOG_COMPRESSION_BUFFER_BYTES (1024 * 1024)
+#define LOG_TIME_RANGE_PREFIX "MEGAsync log "
 
 
 #ifdef _WIN32
@@ -46,50 +53,159 @@
 #endif
 
 
-void gzipCompressOnRotate(const QString filename, const QString destinationFilename)
+bool gzipCompressLogFile(const QString& filename, const QString& destinationFilename, const LogTimeRange& range)
 {
-#ifdef WIN32
-    std::ifstream file(filename.toStdWString().data(), std::ofstream::out);
-#else
-    std::ifstream file(filename.toUtf8().data(), std::ofstream::out);
-#endif
-    if (!file.is_open())
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
     {
         std::cerr << "Unable to open log file for reading: "; CERRQSTRING(filename) << std::endl;
-        return;
+        return false;
     }
 
-    auto gzdeleter = [](gzFile_s* f) { if (f) gzclose(f); };
+    QFile gzfile(destinationFilename);
+    if (!gzfile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        std::cerr << "Unable to open gzfile for writing: "; CERRQSTRING(destinationFilename) << std::endl;
+        return false;
+    }
 
-#ifdef _WIN32
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen_w(destinationFilename.toStdWString().data(), "wb"), gzdeleter};
-#else
-    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{ gzopen(destinationFilename.toUtf8().data(), "wb"), gzdeleter };
-#endif
-    if (!gzfile)
+    // windowBits 15 + 16 writes a gzip header, so the result is the same kind of file gzopen produced
+    z_stream stream{};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
     {
-        std::cerr << "Unable to open gzfile for writing: "; CERRQSTRING(filename) << std::endl;
-        return;
+        std::cerr << "Unable to initialize log compression: "; CERRQSTRING(filename) << std::endl;
+        return false;
     }
+    auto deflateDeleter = [](z_stream* s) { deflateEnd(s); };
+    std::unique_ptr<z_stream, decltype(deflateDeleter)> streamGuard{&stream, deflateDeleter};
 
-    std::string line;
-    while (std::getline(file, line))
+    // the time range goes in the header comment, so bug reports can filter logs without inflating them
+    QByteArray comment;
+    gz_header header{};
+    if (range.isValid())
     {
-        line.push_back('\n');
-        if (gzputs(gzfile.get(), line.c_str()) == -1)
+        comment = LOG_TIME_RANGE_PREFIX + QByteArray::number(range.firstMs) + '-' + QByteArray::number(range.lastMs);
+        header.time = static_cast<uLong>(range.lastMs / 1000);
+        header.os = 255;
+        header.comment = reinterpret_cast<Bytef*>(comment.data());
+        deflateSetHeader(&stream, &header);
+    }
+
+    std::vector<char> in(LOG_COMPRESSION_BUFFER_BYTES);
+    std::vector<char> out(LOG_COMPRESSION_BUFFER_BYTES);
+    bool success = true;
+    int flush = Z_NO_FLUSH;
+    while (success && flush != Z_FINISH)
+    {
+        auto read = file.read(in.data(), static_cast<qint64>(in.size()));
+        if (read < 0)
         {
-            std::cerr << "Unable to compress log file: "; CERRQSTRING(filename) << std::endl;
-            return;
+            success = false;
+            break;
         }
+        flush = read < static_cast<qint64>(in.size()) ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = reinterpret_cast<Bytef*>(in.data());
+        stream.avail_in = static_cast<uInt>(read);
+
+        do
+        {
+            stream.next_out = reinterpret_cast<Bytef*>(out.data());
+            stream.avail_out = static_cast<uInt>(out.size());
+            deflate(&stream, flush);
+            auto produced = static_cast<qint64>(out.size() - stream.avail_out);
+            if (gzfile.write(out.data(), produced) != produced)
+            {
+                success = false;
+                break;
+            }
+        } while (stream.avail_out == 0);
     }
 
-    gzfile.reset();
+    streamGuard.reset();
+    gzfile.close();
     file.close();
+    if (!success || gzfile.error() != QFileDevice::NoError)
+    {
+        std::cerr << "Unable to compress log file: "; CERRQSTRING(filename) << std::endl;
+        QFile::remove(destinationFilename);
+        return false;
+    }
+
     QFile::remove(filename);
+    return true;
+}
+
+LogTimeRange readLogTimeRange(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return LogTimeRange();
+    }
+
+    // fixed header: magic, method, flags, mtime, xfl, os
+    auto header = file.read(10);
+    if (header.size() != 10 || header.at(0) != '\x1f' || header.at(1) != '\x8b')
+    {
+        return LogTimeRange();
+    }
+    auto flags = static_cast<unsigned char>(header.at(3));
+
+    char c;
+    if (flags & 4) // extra field
+    {
+        auto extraLength = file.read(2);
+        if (extraLength.size() != 2 || !file.seek(file.pos() + static_cast<unsigned char>(extraLength.at(0))
+                                                  + (static_cast<unsigned char>(extraLength.at(1)) << 8)))
+        {
+            return LogTimeRange();
+        }
+    }
+    if (flags & 8) // file name
+    {
+        while (file.getChar(&c) && c) {}
+    }
+    if (!(flags & 16)) // no comment
+    {
+        return LogTimeRange();
+    }
+
+    QByteArray comment;
+    while (file.getChar(&c) && c && comment.size() < 256)
+    {
+        comment.append(c);
+    }
+    if (!comment.startsWith(LOG_TIME_RANGE_PREFIX))
+    {
+        return LogTimeRange();
+    }
+
+    auto times = comment.mid(static_cast<int>(strlen(LOG_TIME_RANGE_PREFIX))).split('-');
+    LogTimeRange range;
+    if (times.size() == 2)
+    {
+        range.firstMs = times.at(0).toLongLong();
+        range.lastMs = times.at(1).toLongLong();
+    }
+    return range;
 }
 
 using DirectLogFunction = std::function <void (std::ostream *)>;
 
+// Written before each line of the rings and of the locked list, so the logging thread can merge them in time order
+struct LogLineHeader
+{
+    long long timeUs;
+    size_t size; // bytes of the line after the header
+};
+
+long long readLogLineTime(const char* line)
+{
+    LogLineHeader header;
+    memcpy(&header, line, sizeof(header));
+    return header.timeUs;
+}
+
 struct LogLinkedList
 {
     LogLinkedList* next = nullptr;
@@ -98,6 +214,7 @@ struct LogLinkedList
     int lastmessage = -1;
     int lastmessageRepeats = 0;
     bool oomGap = false;
+    long long directTimeUs = 0;
     DirectLogFunction *mDirectLoggingFunction = nullptr; // we cannot use a non pointer due to the malloc allocation of new entries
     std::promise<void>* mCompletionPromise = nullptr; // we cannot use a unique_ptr due to the malloc allocation of new entries
     char message[1];
@@ -113,6 +230,7 @@ struct LogLinkedList
             entry->lastmessage = -1;
             entry->lastmessageRepeats = 0;
             entry->oomGap = false;
+            entry->directTimeUs = 0;
             entry->mDirectLoggingFunction = nullptr;
             entry->mCompletionPromise = nullptr;
             prev->next = entry;
@@ -130,6 +248,13 @@ struct LogLinkedList
         return mDirectLoggingFunction != nullptr;
     }
 
+    void appendHeader(const LogLineHeader& header)
+    {
+        assert(used + sizeof(header) < allocated);
+        memcpy(message + used, &header, sizeof(header));
+        used += unsigned(sizeof(header));
+    }
+
     void append(const char* s, unsigned int n = 0)
     {
         n = n ? n : unsigned(strlen(s));
@@ -150,6 +275,47 @@ struct LogLinkedList
 
 MegaSyncLogger *g_megaSyncLogger = nullptr;
 
+// Lines formatted by one thread, waiting for the logging thread to write them
+struct ThreadLogRing
+{
+    LogRing ring{LOG_RING_BYTES};
+    std::atomic<bool> producerGone{false};
+
+    // only used by the producer thread
+    std::string lastMessage;
+    unsigned lastMessageRepeats = 0;
+
+    // only used by the logging thread: the lines drained last, until they are written
+    std::string drained;
+};
+
+// Per thread state, so logging a line needs no lock once the thread has logged before
+struct ThreadLogCache
+{
+    time_t lastT = 0;
+    struct tm lastTm;
+    std::string threadName;
+    unsigned long long ringOwner = 0;
+    std::shared_ptr<ThreadLogRing> ring;
+
+    ~ThreadLogCache()
+    {
+        if (ring)
+        {
+            ring->producerGone = true;
+        }
+    }
+};
+
+thread_local ThreadLogCache threadLogCache;
+
+struct LogCompressionJob
+{
+    QString filename;
+    QString destinationFilename;
+    LogTimeRange range;
+};
+
 struct LoggingThread
 {
     std::unique_ptr<std::thread> logThread;
@@ -159,18 +325,37 @@ struct LoggingThread
     LogLinkedList logListFirst;
     LogLinkedList* logListLast = &logListFirst;
     bool logExit = false;
-    bool flushLog = false;
+    std::atomic<bool> flushLog{false};
     bool closeLog = false;
-    bool forceRotationForReporting = false;
+    bool flushForReporting = false;
+    std::atomic<bool> reporting{false}; // rotations and cleanings wait while the logs are read for a report
     bool forceRenew = false; //to force removal of all logs and create an empty MEGAsync.log
     bool logToDesktop = false;
     bool logToDesktopChanged = false;
     int flushOnLevel = mega::MegaApi::LOG_LEVEL_WARNING;
     std::chrono::seconds logFlushPeriod = std::chrono::seconds(10);
     std::chrono::steady_clock::time_point nextFlushTime = std::chrono::steady_clock::now() + logFlushPeriod;
+    const unsigned long long id = nextId++;
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<ThreadLogRing>> rings;
+    std::atomic<bool> ringsNeedDrain{false};
+
+    // rotated logs are compressed one at a time by a single worker
+    std::unique_ptr<std::thread> compressionThread;
+    std::condition_variable compressionConditionVariable;
+    std::mutex compressionMutex;
+    std::deque<LogCompressionJob> compressionJobs;
+    bool compressing = false;
+    bool compressionExit = false;
 
     void startLoggingThread(QString filename, QString desktopFilename)
     {
+        if (!compressionThread)
+        {
+            compressionThread.reset(new std::thread([this]() {
+                compressionThreadFunction();
+            }));
+        }
         if (!logThread)
         {
             logThread.reset(new std::thread([this, filename, desktopFilename]() {
@@ -179,9 +364,109 @@ struct LoggingThread
         }
     }
 
+    void stopCompressionThread()
+    {
+        if (compressionThread)
+        {
+            {
+                std::lock_guard<std::mutex> g(compressionMutex);
+                compressionExit = true;
+            }
+            compressionConditionVariable.notify_all();
+            compressionThread->join();
+            compressionThread.reset();
+        }
+    }
+
     void log(int loglevel, const char *message, const char **directMessages = nullptr, size_t *directMessagesSizes = nullptr, int numberMessages = 0);
 
 private:
+    static std::atomic<unsigned long long> nextId;
+
+    ThreadLogRing* currentThreadRing()
+    {
+        if (threadLogCache.ringOwner != id)
+        {
+            if (threadLogCache.ring)
+            {
+                threadLogCache.ring->producerGone = true;
+            }
+            threadLogCache.ring = std::make_shared<ThreadLogRing>();
+            threadLogCache.ringOwner = id;
+
+            std::lock_guard<std::mutex> g(ringsMutex);
+            rings.push_back(threadLogCache.ring);
+        }
+        return threadLogCache.ring.get();
+    }
+
+    bool logToRing(long long timeUs, const char* timebuf, const char* threadname, size_t threadnameLen, const char* loglevelstring,
+                   const char* message, size_t messageLen, unsigned& pendingRepeats);
+
+    // returns the rings with drained lines, which are kept alive until they are written
+    std::vector<std::shared_ptr<ThreadLogRing>> drainRings()
+    {
+        std::vector<std::shared_ptr<ThreadLogRing>> drainedRings;
+        std::lock_guard<std::mutex> g(ringsMutex);
+        for (auto it = rings.begin(); it != rings.end(); )
+        {
+            // check before draining, so everything a finished thread logged is drained before its ring is dropped
+            bool gone = (*it)->producerGone;
+            auto& drained = (*it)->drained;
+            drained.clear();
+            if ((*it)->ring.drain([&drained](const char* data, size_t size) { drained.append(data, size); }))
+            {
+                drainedRings.push_back(*it);
+            }
+            it = gone ? rings.erase(it) : it + 1;
+        }
+        return drainedRings;
+    }
+
+    void compressionThreadFunction()
+    {
+        std::unique_lock<std::mutex> lock(compressionMutex);
+        while (true)
+        {
+            compressionConditionVariable.wait(lock, [this]() { return compressionExit || !compressionJobs.empty(); });
+            if (compressionJobs.empty())
+            {
+                return; // pending jobs are finished before exiting, so no log is left uncompressed
+            }
+
+            auto job = compressionJobs.front();
+            compressionJobs.pop_front();
+            compressing = true;
+            lock.unlock();
+
+            {
+                std::lock_guard<std::mutex> g(logRotationMutex); // prevent another rotation while we work on this file (in case of unfortunate timing with bug report etc)
+                gzipCompressLogFile(job.filename, job.destinationFilename, job.range);
+            }
+
+            lock.lock();
+            compressing = false;
+            compressionConditionVariable.notify_all();
+        }
+    }
+
+    // The previous rotated log must be compressed before the numbered logs are renamed or removed again.
+    // This keeps a single job in flight, and slows down logging only if rotations come faster than compression
+    void waitForCompression()
+    {
+        std::unique_lock<std::mutex> lock(compressionMutex);
+        compressionConditionVariable.wait(lock, [this]() { return compressionJobs.empty() && !compressing; });
+    }
+
+    void queueCompression(LogCompressionJob job)
+    {
+        {
+            std::lock_guard<std::mutex> g(compressionMutex);
+            compressionJobs.push_back(std::move(job));
+        }
+        compressionConditionVariable.notify_all();
+    }
+
     QString numberedLogFilename(QString baseName, int logNumber)
     {
         QString newName = baseName;
@@ -213,13 +498,16 @@ private:
     #endif
         outputFile << "----------------------------- program start -----------------------------\n";
         long long outFileSize = outputFile.tellp();
+        // when appending to the log of a previous run, the time of its first line is not known
+        auto logStartMs = outFileSize > 0 ? 0 : QDateTime::currentMSecsSinceEpoch();
         std::ofstream logDesktopFile;
         bool logDesktopFileOpen = false;
 
         while (!logExit)
         {
-            if (forceRenew)
+            if (forceRenew && !reporting)
             {
+                waitForCompression();
                 std::lock_guard<std::mutex> g(logRotationMutex);
                 for (int i = logCountToClean; i--; )
                 {
@@ -246,6 +534,7 @@ private:
                 outputFile.open(filename.toUtf8().data(), std::ofstream::out);
     #endif
                 outFileSize = 0;
+                logStartMs = QDateTime::currentMSecsSinceEpoch();
 
                 forceRenew = false;
 
@@ -254,8 +543,9 @@ private:
                     emit g_megaSyncLogger->logCleaned();
                 }
             }
-            else if (forceRotationForReporting || outFileSize > logSizeBeforeCompressMb*1024*1024)
+            else if (outFileSize > logSizeBeforeCompressMb*1024*1024 && !reporting)
             {
+                waitForCompression();
                 std::lock_guard<std::mutex> g(logRotationMutex);
                 for (int i = logCountToClean; i--; )
                 {
@@ -287,18 +577,10 @@ private:
                 QFile::remove(newNameZipping);
                 QFile(filename).rename(newNameZipping);
 
-                bool report = forceRotationForReporting;
-                forceRotationForReporting = false;
-
-                std::thread t([=]() {
-                    std::lock_guard<std::mutex> g(logRotationMutex); // prevent another rotation while we work on this file (in case of unfortunate timing with bug report etc)
-                    gzipCompressOnRotate(newNameZipping, newNameDone);
-                    if (report && g_megaSyncLogger)
-                    {
-                        emit g_megaSyncLogger->logReadyForReporting();
-                    }
-                });
-                t.detach();
+                LogTimeRange range;
+                range.firstMs = logStartMs;
+                range.lastMs = logStartMs = QDateTime::currentMSecsSinceEpoch();
+                queueCompression({newNameZipping, newNameDone, range});
 
     #ifdef WIN32
                 outputFile.open(filename.toStdWString().data(), std::ofstream::out);
@@ -313,7 +595,7 @@ private:
             {
                 std::unique_lock<std::mutex> lock(logMutex);
                 logConditionVariable.wait_for(lock, std::chrono::milliseconds(500), [this, &newMessages, &topLevelMemoryGap]() {
-                        if (forceRenew || logListFirst.next || logExit || forceRotationForReporting || logToDesktopChanged || flushLog || closeLog)
+                        if ((forceRenew && !reporting) || logListFirst.next || ringsNeedDrain.exchange(false) || logExit || flushForReporting || logToDesktopChanged || flushLog || closeLog)
                         {
                             newMessages = logListFirst.next;
                             logListFirst.next = nullptr;
@@ -357,65 +639,117 @@ private:
                 }
             }
 
-            while (newMessages)
+            auto writeLine = [&](const char* data, size_t size)
             {
-                auto p = newMessages;
-                newMessages = newMessages->next;
                 if (outputFile)
                 {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&outputFile);
-                    }
-                    else
-                    {
-                        outputFile << p->message;
-                        outFileSize += p->used;
-                        if (p->oomGap)
-                        {
-                            outputFile << "<log gap - out of logging memory at this point>\n";
-                        }
-                    }
+                    outputFile.write(data, std::streamsize(size));
+                    outFileSize += static_cast<long long>(size);
                 }
                 if (logDesktopFile)
                 {
+                    logDesktopFile.write(data, std::streamsize(size));
+                }
+                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
+                {
+                    std::cout.write(data, std::streamsize(size));
+                }
+            };
+
+            // the lines of each ring and of the list are in time order, so they are merged by their timestamps
+            auto drainedRings = drainRings();
+            std::vector<std::pair<const char*, const char*>> ringLines; // next line and end of each drained ring
+            for (const auto& ring : drainedRings)
+            {
+                ringLines.emplace_back(ring->drained.data(), ring->drained.data() + ring->drained.size());
+            }
+            const char* listLine = newMessages ? newMessages->message : nullptr;
+            bool wroteLines = false;
+
+            while (true)
+            {
+                // list entries are released once written, keeping their gaps and waiters in place
+                while (newMessages && (newMessages->needsDirectOutput() || listLine == newMessages->message + newMessages->used))
+                {
+                    auto p = newMessages;
                     if (p->needsDirectOutput())
                     {
-                        (*p->mDirectLoggingFunction)(&logDesktopFile);
-                    }
-                    else
-                    {
-                        logDesktopFile << p->message;
-                        if (p->oomGap)
+                        // lines before it go first
+                        bool earlierRingLine = false;
+                        for (const auto& lines : ringLines)
+                        {
+                            earlierRingLine |= lines.first != lines.second && readLogLineTime(lines.first) < p->directTimeUs;
+                        }
+                        if (earlierRingLine)
+                        {
+                            break;
+                        }
+
+                        if (outputFile)
+                        {
+                            (*p->mDirectLoggingFunction)(&outputFile);
+                        }
+                        if (logDesktopFile)
                         {
-                            logDesktopFile << "<log gap - out of logging memory at this point>\n";
+                            (*p->mDirectLoggingFunction)(&logDesktopFile);
                         }
+                        if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
+                        {
+                            (*p->mDirectLoggingFunction)(&std::cout);
+                        }
+                        wroteLines = true;
                     }
-                    if (!newMessages)
+                    if (p->oomGap)
                     {
-                        logDesktopFile.flush(); //always flush in `active` logging
+                        static const char gap[] = "<log gap - out of logging memory at this point>\n";
+                        writeLine(gap, sizeof(gap) - 1);
                     }
+                    newMessages = p->next;
+                    listLine = newMessages ? newMessages->message : nullptr;
+                    p->notifyWaiter();
+                    free(p);
                 }
 
-                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
+                const char** next = nullptr;
+                long long nextTimeUs = 0;
+                if (newMessages && !newMessages->needsDirectOutput())
                 {
-                    if (p->needsDirectOutput())
-                    {
-                        (*p->mDirectLoggingFunction)(&std::cout);
-                    }
-                    else
-                    {
-                        std::cout << p->message;
-                    }
-                    if (!newMessages)
+                    next = &listLine;
+                    nextTimeUs = readLogLineTime(listLine);
+                }
+                for (auto& lines : ringLines)
+                {
+                    if (lines.first != lines.second && (!next || readLogLineTime(lines.first) < nextTimeUs))
                     {
-                        std::cout << std::flush; //always flush into stdout (DEBUG mode)
+                        next = &lines.first;
+                        nextTimeUs = readLogLineTime(lines.first);
                     }
                 }
-                p->notifyWaiter();
-                free(p);
+                if (!next)
+                {
+                    break;
+                }
+
+                LogLineHeader header;
+                memcpy(&header, *next, sizeof(header));
+                writeLine(*next + sizeof(header), header.size);
+                *next += sizeof(header) + header.size;
+                wroteLines = true;
+            }
+
+            if (wroteLines)
+            {
+                if (logDesktopFile)
+                {
+                    logDesktopFile.flush(); //always flush in `active` logging
+                }
+                if (g_megaSyncLogger && g_megaSyncLogger->mLogToStdout)
+                {
+                    std::cout << std::flush; //always flush into stdout (DEBUG mode)
+                }
             }
-            if (flushLog || forceRotationForReporting || nextFlushTime <= std::chrono::steady_clock::now())
+
+            if (flushLog || flushForReporting || nextFlushTime <= std::chrono::steady_clock::now())
             {
                 flushLog = false;
                 outputFile.flush();
@@ -428,6 +762,18 @@ private:
                     std::cout << std::flush;
                 }
                 nextFlushTime = std::chrono::steady_clock::now() + logFlushPeriod;
+
+                // reports read the rotated logs and what was flushed to MEGAsync.log, so no rotation is needed,
+                // only the last rotated log to be compressed
+                if (flushForReporting)
+                {
+                    flushForReporting = false;
+                    waitForCompression();
+                    if (g_megaSyncLogger)
+                    {
+                        emit g_megaSyncLogger->logReadyForReporting();
+                    }
+                }
             }
 
             if (closeLog)
@@ -444,6 +790,7 @@ private:
 
 };
 
+std::atomic<unsigned long long> LoggingThread::nextId{1};
 
 MegaSyncLogger::MegaSyncLogger(QObject *parent, const QString& dataPath, const QString& desktopPath, bool logToStdout)
 : QObject{parent}
@@ -481,6 +828,7 @@ MegaSyncLogger::~MegaSyncLogger()
     g_megaSyncLogger = nullptr;
     g_loggingThread->logThread->join();
     g_loggingThread->logThread.reset();
+    g_loggingThread->stopCompressionThread();
 }
 
 inline void twodigit(char*& s, int n)
@@ -516,39 +864,85 @@ char* filltime(char* s, struct tm*  gmt, int microsec)
     return s;
 }
 
-std::mutex threadNameMutex;
-std::map<std::thread::id, std::string> threadNames;
-struct tm lastTm;
-time_t lastT = 0;
-std::thread::id lastThreadId;
-const char* lastThreadName;
-
 void cacheThreadNameAndTimeT(time_t t, struct tm& gmt, const char*& threadname)
 {
-    std::lock_guard<std::mutex> g(threadNameMutex);
+    auto& cache = threadLogCache;
 
-    if (t != lastT)
+    if (t != cache.lastT)
     {
-        lastTm = *std::gmtime(&t);
-        lastT = t;
+#ifdef WIN32
+        gmtime_s(&cache.lastTm, &t);
+#else
+        gmtime_r(&t, &cache.lastTm);
+#endif
+        cache.lastT = t;
     }
-    gmt = lastTm;
+    gmt = cache.lastTm;
 
-    if (lastThreadId == std::this_thread::get_id())
+    if (cache.threadName.empty())
     {
-        threadname = lastThreadName;
-        return;
+        std::ostringstream s;
+        s << std::this_thread::get_id() << " ";
+        cache.threadName = s.str();
+    }
+    threadname = cache.threadName.c_str();
+}
+
+bool LoggingThread::logToRing(long long timeUs, const char* timebuf, const char* threadname, size_t threadnameLen, const char* loglevelstring,
+                              const char* message, size_t messageLen, unsigned& pendingRepeats)
+{
+    ThreadLogRing* threadRing = currentThreadRing();
+
+    if (messageLen && messageLen == threadRing->lastMessage.size() && !memcmp(message, threadRing->lastMessage.data(), messageLen))
+    {
+        ++threadRing->lastMessageRepeats;
+        return true;
     }
 
-    auto& entry = threadNames[std::this_thread::get_id()];
-    if (entry.empty())
+    char repeatbuf[31];
+    int repeatLen = 0;
+    if (threadRing->lastMessageRepeats)
     {
-        std::ostringstream s;
-        s << std::this_thread::get_id() << " ";
-        entry = s.str();
+        repeatLen = snprintf(repeatbuf, 30, "[repeated x%u]\n", threadRing->lastMessageRepeats);
     }
-    threadname = lastThreadName = entry.c_str();
-    lastThreadId = std::this_thread::get_id();
+
+    LogLineHeader header{timeUs, size_t(repeatLen) + LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen + 1};
+    if (!threadRing->ring.reserve(sizeof(header) + header.size))
+    {
+        // the locked list reports the repeats instead
+        pendingRepeats = threadRing->lastMessageRepeats;
+        threadRing->lastMessageRepeats = 0;
+        threadRing->lastMessage.clear();
+        return false;
+    }
+
+    threadRing->ring.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    threadRing->ring.append(repeatbuf, size_t(repeatLen));
+    threadRing->ring.append(timebuf, LOG_TIME_CHARS);
+    threadRing->ring.append(threadname, threadnameLen);
+    threadRing->ring.append(loglevelstring, LOG_LEVEL_CHARS);
+    threadRing->ring.append(message, messageLen);
+    threadRing->ring.append("\n", 1);
+    threadRing->ring.commit();
+
+#if defined(WIN32) && defined(DEBUG)
+    OutputDebugStringA(std::string(timebuf).c_str());
+    OutputDebugStringA(std::string(threadname).c_str());
+    OutputDebugStringA(std::string(loglevelstring).c_str());
+    OutputDebugStringA(std::string(message, messageLen).c_str());
+    OutputDebugStringA("\r\n");
+#endif
+
+    // assign reuses the string capacity, so this does not allocate once the thread has logged a long line
+    threadRing->lastMessage.assign(message, messageLen);
+    threadRing->lastMessageRepeats = 0;
+
+    // like the locked list, only wake the logging thread when the ring is getting full
+    if (threadRing->ring.used() > threadRing->ring.capacity() / 2 && !ringsNeedDrain.exchange(true))
+    {
+        logConditionVariable.notify_one();
+    }
+    return true;
 }
 
 void MegaSyncLogger::log(const char*, int loglevel, const char*, const char *message
@@ -616,6 +1010,17 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
     auto lineLen = LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen;
     bool notify = false;
 
+    auto timeUs = static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count());
+    unsigned ringRepeats = 0;
+    if (!direct && logToRing(timeUs, timebuf, threadname, threadnameLen, loglevelstring, message, messageLen, ringRepeats))
+    {
+        if (loglevel <= flushOnLevel)
+        {
+            flushLog = true;
+        }
+        return;
+    }
+
     {
         std::unique_ptr<std::lock_guard<std::mutex>> g(new std::lock_guard<std::mutex>(logMutex));
 
@@ -632,9 +1037,13 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
             unsigned reportRepeats = logListLast != &logListFirst ? logListLast->lastmessageRepeats : 0;
             if (reportRepeats)
             {
-                lineLen += 30;
                 logListLast->lastmessageRepeats = 0;
             }
+            reportRepeats += ringRepeats;
+            if (reportRepeats)
+            {
+                lineLen += 30;
+            }
 
 #if defined(WIN32) && defined(DEBUG)
             OutputDebugStringA(std::string(timebuf).c_str());
@@ -655,6 +1064,7 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
                 if (LogLinkedList* newentry = LogLinkedList::create(logListLast, 1 + sizeof(LogLinkedList))) //create a new "empty" element
                 {
                     logListLast = newentry;
+                    logListLast->directTimeUs = timeUs;
                     std::promise<void> promise;
                     logListLast->mCompletionPromise = &promise;
                     auto future = logListLast->mCompletionPromise->get_future();
@@ -687,6 +1097,7 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
             }
             else
             {
+                lineLen += sizeof(LogLineHeader);
                 if (logListLast == &logListFirst || logListLast->oomGap || !logListLast->messageFits(lineLen))
                 {
                     if (LogLinkedList* newentry = LogLinkedList::create(logListLast, std::max<size_t>(lineLen, 8192) + sizeof(LogLinkedList) + 10))
@@ -700,11 +1111,12 @@ void LoggingThread::log(int loglevel, const char *message, const char **directMe
                 }
                 if (!logListLast->oomGap)
                 {
-                    if (reportRepeats)
+                    char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
+                    int n = reportRepeats ? snprintf(repeatbuf, 30, "[repeated x%u]\n", reportRepeats) : 0;
+                    logListLast->appendHeader({timeUs, size_t(n) + LOG_TIME_CHARS + threadnameLen + LOG_LEVEL_CHARS + messageLen + 1});
+                    if (n)
                     {
-                        char repeatbuf[31]; // this one can occur very frequently with many in a row: cURL DEBUG: schannel: failed to decrypt data, need more data
-                        int n = snprintf(repeatbuf, 30, "[repeated x%u]\n", reportRepeats);
-                        logListLast->append(repeatbuf, n);
+                        logListLast->append(repeatbuf, unsigned(n));
                     }
                     logListLast->append(timebuf, LOG_TIME_CHARS);
                     logListLast->append(threadname, unsigned(threadnameLen));
@@ -748,7 +1160,8 @@ bool MegaSyncLogger::isDebug() const
 bool MegaSyncLogger::prepareForReporting()
 {
     std::lock_guard<std::mutex> g(g_loggingThread->logMutex);
-    g_loggingThread->forceRotationForReporting = true;
+    g_loggingThread->flushForReporting = true;
+    g_loggingThread->reporting = true;
     g_loggingThread->logConditionVariable.notify_one();
     return true;
 }
@@ -763,6 +1176,9 @@ bool MegaSyncLogger::cleanLogs()
 
 void MegaSyncLogger::resumeAfterReporting()
 {
+    std::lock_guard<std::mutex> g(g_loggingThread->logMutex);
+    g_loggingThread->reporting = false;
+    g_loggingThread->logConditionVariable.notify_one();
 }
 
 void MegaSyncLogger::flushAndClose()
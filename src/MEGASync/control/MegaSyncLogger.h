@@ -13,6 +13,21 @@
 #define LOGS_FOLDER_LEAFNAME_QSTRING QString::fromUtf8("logs")
 
 struct LoggingThread;
+
+// Time span of the lines of a rotated log, in ms since epoch. firstMs is 0 when it is not known
+struct LogTimeRange
+{
+    qint64 firstMs = 0;
+    qint64 lastMs = 0;
+
+    bool isValid() const { return lastMs > 0; }
+};
+
+// Compresses a rotated log into a gzip file and removes the original on success.
+// A valid range is stored in the gzip header, where readLogTimeRange finds it without inflating the file
+bool gzipCompressLogFile(const QString& filename, const QString& destinationFilename, const LogTimeRange& range = LogTimeRange());
+LogTimeRange readLogTimeRange(const QString& filename);
+
 class MegaSyncLogger : public QObject, public mega::MegaLogger
 {
     Q_OBJECT
@@ -34,8 +49,9 @@ public:
 
     /**
      * @brief prepareForReporting
-     * Prepare for reporting. Will pause logs and force a rotation.
-     * Once the logs are rotated, a logReadyForReporting signal will be emitted.
+     * Prepare for reporting. Will flush MEGAsync.log, so it can be added to the rotated logs.
+     * Once the log is flushed, a logReadyForReporting signal will be emitted.
+     * Logs are not rotated nor cleaned until resumeAfterReporting is called, so they can be read meanwhile.
      * Once logs are reported, call resumeAfterReporting.
      * @returns true if preparation went well (if false, there is no need for resumeAfterReporting)
      */
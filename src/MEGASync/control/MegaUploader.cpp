@@ -6,8 +6,11 @@
 #include <QtCore>
 #include <QApplication>
 #include <QPointer>
+#include <QElapsedTimer>
 #include <QFile>
 
+#include <algorithm>
+
 #if QT_VERSION >= 0x050000
 #include <QtConcurrent/QtConcurrent>
 #endif
@@ -23,36 +26,102 @@ MegaUploader::MegaUploader(MegaApi *megaApi, std::shared_ptr<FolderTransferListe
     : listener(_listener)
 {
     this->megaApi = megaApi;
+    qRegisterMetaType<std::shared_ptr<TransferBatch>>("std::shared_ptr<TransferBatch>");
 }
 
-void MegaUploader::upload(QString path, const QString& nodeName, std::shared_ptr<MegaNode> parent, unsigned long long appDataID, const std::shared_ptr<TransferBatch>& transferBatch)
+MegaUploader::~MegaUploader()
 {
-    QFileInfo info(path);
+    //The pool thread emits signals from this object. Every batch still being started is cancelled, so it stops early
+    std::unique_lock<std::mutex> lock(mSubmittingMutex);
+    for(auto& batch : mSubmittingBatches)
+    {
+        batch->cancel();
+    }
+    mSubmittingCondition.wait(lock, [this]() { return mSubmittingBatches.empty(); });
+}
 
-    QString currentPath = QDir::toNativeSeparators(info.absoluteFilePath());
-    QString msg = QString::fromLatin1("Starting upload : '%1' - '%2' - '%3'").arg(info.fileName(), currentPath).arg(appDataID);
-    megaApi->log(MegaApi::LOG_LEVEL_DEBUG, msg.toUtf8().constData());
-    transferBatch->add(info.absoluteFilePath(), QString());
-    startUpload(currentPath, nodeName, appDataID, parent.get(), transferBatch->getCancelTokenPtr());
+void MegaUploader::upload(const Uploads& uploads, std::shared_ptr<MegaNode> parent, unsigned long long appDataID, const std::shared_ptr<TransferBatch>& transferBatch)
+{
+    auto nativeUploads = prepareUploads(uploads, *transferBatch);
 
     emit startingTransfers();
+
+    {
+        std::lock_guard<std::mutex> lock(mSubmittingMutex);
+        mSubmittingBatches.push_back(transferBatch);
+    }
+
+    auto api(megaApi);
+    auto transferListener(listener);
+    ThreadPoolSingleton::getInstance()->push([this, nativeUploads, parent, appDataID, transferBatch, api, transferListener]()
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        auto submitted = submitUploads(nativeUploads, appDataID, transferBatch->getCancelTokenPtr(),
+                                       [parent, transferBatch, api, transferListener](const char* localPath, const char* nodeName, const char* appData)
+        {
+            const bool startFirst = false;
+            const int64_t mtime = ::mega::MegaApi::INVALID_CUSTOM_MOD_TIME;
+            const bool isSrcTemporary = false;
+            api->startUpload(localPath, parent.get(), nodeName, mtime, appData, isSrcTemporary, startFirst,
+                             transferBatch->getCancelTokenPtr(), transferListener.get());
+        });
+
+        QString msg = QString::fromLatin1("Started %1 of %2 uploads (%3) in %4 ms")
+                          .arg(submitted).arg(nativeUploads.size()).arg(appDataID).arg(timer.elapsed());
+        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, msg.toUtf8().constData());
+
+        emit uploadsSubmitted(transferBatch, submitted, nativeUploads.size());
+
+        std::lock_guard<std::mutex> lock(mSubmittingMutex);
+        mSubmittingBatches.erase(std::find(mSubmittingBatches.begin(), mSubmittingBatches.end(), transferBatch));
+        mSubmittingCondition.notify_all();
+    });
+}
+
+MegaUploader::Uploads MegaUploader::prepareUploads(const Uploads& uploads, TransferBatch& transferBatch)
+{
+    Uploads nativeUploads(uploads);
+    for(auto& upload : nativeUploads)
+    {
+        auto absolutePath = QFileInfo(upload.localPath).absoluteFilePath();
+        transferBatch.add(absolutePath, QString());
+        upload.localPath = QDir::toNativeSeparators(absolutePath);
+    }
+
+    return nativeUploads;
 }
 
-void MegaUploader::startUpload(const QString& localPath, const QString &nodeName, unsigned long long appDataID, MegaNode* parent, MegaCancelToken* cancelToken)
+int MegaUploader::submitUploads(const Uploads& uploads, unsigned long long appDataID, MegaCancelToken* cancelToken,
+                                const StartUploadFunction& startUpload)
 {
-    const bool startFirst = false;
-    QByteArray localPathArray = localPath.toUtf8();
+    //Every upload of the batch has the same app data
+    auto appData = createAppData(appDataID);
 
-    const char* fileName = nullptr;
-    QByteArray fileNameArray;
-    if(!nodeName.isEmpty())
+    int submitted(0);
+    for(const auto& upload : uploads)
     {
-        fileNameArray = nodeName.toUtf8();
-        fileName = fileNameArray.constData();
+        if(cancelToken && cancelToken->isCancelled())
+        {
+            break;
+        }
+
+        QByteArray localPathArray = upload.localPath.toUtf8();
+        QByteArray nodeNameArray;
+        if(!upload.nodeName.isEmpty())
+        {
+            nodeNameArray = upload.nodeName.toUtf8();
+        }
+
+        startUpload(localPathArray.constData(), nodeNameArray.isEmpty() ? nullptr : nodeNameArray.constData(), appData.constData());
+        submitted++;
     }
 
-    QByteArray appData = (QString::number(appDataID) + QString::fromUtf8("*")).toUtf8();
-    const int64_t mtime = ::mega::MegaApi::INVALID_CUSTOM_MOD_TIME;
-    const bool isSrcTemporary = false;
-    megaApi->startUpload(localPathArray.constData(), parent, fileName, mtime, appData.constData(), isSrcTemporary, startFirst, cancelToken, listener.get());
+    return submitted;
+}
+
+QByteArray MegaUploader::createAppData(unsigned long long appDataID)
+{
+    return (QString::number(appDataID) + QString::fromUtf8("*")).toUtf8();
 }
@@ -11,29 +11,62 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QQueue>
+#include <QVector>
 #include "FolderTransferListener.h"
 #include "Preferences.h"
 #include "megaapi.h"
 #include "QTMegaRequestListener.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 class MegaUploader : public QObject
 {
     Q_OBJECT
 
 public:
+    struct Upload
+    {
+        QString localPath;
+        QString nodeName;
+    };
+    using Uploads = QVector<Upload>;
+
+    //Called with the native path and the name of the node, or nullptr to keep the local name
+    using StartUploadFunction = std::function<void(const char* localPath, const char* nodeName, const char* appData)>;
+
     MegaUploader(mega::MegaApi *megaApi, std::shared_ptr<FolderTransferListener> _listener);
-    virtual ~MegaUploader() = default;
+    virtual ~MegaUploader();
+
+    //Adds the uploads to the batch and starts them in the thread pool. uploadsSubmitted is emitted once they are all
+    //started, or when the batch is cancelled
+    void upload(const Uploads& uploads, std::shared_ptr<mega::MegaNode> parent, unsigned long long appDataID, const std::shared_ptr<TransferBatch> &transferBatch);
+
+    //Adds the uploads to the batch, which must know every node before the SDK reports the first transfer.
+    //Returns them with absolute native paths
+    static Uploads prepareUploads(const Uploads& uploads, TransferBatch& transferBatch);
 
-    void upload(QString path, const QString &nodeName, std::shared_ptr<mega::MegaNode> parent, unsigned long long appDataID, const std::shared_ptr<TransferBatch> &transferBatch);
+    //Starts the uploads in the calling thread until the cancel token is cancelled. Returns how many were started
+    static int submitUploads(const Uploads& uploads, unsigned long long appDataID, mega::MegaCancelToken* cancelToken,
+                             const StartUploadFunction& startUpload);
+
+    static QByteArray createAppData(unsigned long long appDataID);
 
 signals:
     void startingTransfers();
+    void uploadsSubmitted(std::shared_ptr<TransferBatch> transferBatch, int submitted, int total);
 
 private:
-    void startUpload(const QString& localPath, const QString& nodeName, unsigned long long appDataID, mega::MegaNode* parent, mega::MegaCancelToken* cancelToken);
-
     mega::MegaApi *megaApi;
     std::shared_ptr<FolderTransferListener> listener;
+
+    std::mutex mSubmittingMutex;
+    std::condition_variable mSubmittingCondition;
+    std::vector<std::shared_ptr<TransferBatch>> mSubmittingBatches;
 };
 
+Q_DECLARE_METATYPE(std::shared_ptr<TransferBatch>)
+
 #endif // MEGAUPLOADER_H
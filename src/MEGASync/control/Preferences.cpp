@@ -692,11 +692,9 @@ void Preferences::setUsedStorage(long long value)
 
 long long Preferences::availableStorage()
 {
-    mutex.lock();
     assert(logged());
-    long long total = getValue<long long>(totalStorageKey);
-    long long used = getValue<long long>(usedStorageKey);
-    mutex.unlock();
+    long long total = getValueConcurrent<long long>(totalStorageKey);
+    long long used = getValueConcurrent<long long>(usedStorageKey);
     long long available = total - used;
     return available >= 0 ? available : 0;
 }
@@ -989,11 +987,11 @@ void Preferences::setTimePoint(const QString& key, const std::chrono::system_clo
 template<typename T>
 T Preferences::getValue(const QString &key)
 {
-    auto cf = cache.find(key);
-    if (cf != cache.end())
+    QVariant cached;
+    if (cache.find(key, cached))
     {
-        assert(cf->second.value<T>() == mSettings->value(key).value<T>());
-        return cf->second.value<T>();
+        assert(cached.value<T>() == mSettings->value(key).value<T>());
+        return cached.value<T>();
     }
     else return mSettings->value(key).value<T>();
 }
@@ -1001,11 +999,11 @@ T Preferences::getValue(const QString &key)
 template<typename T>
 T Preferences::getValue(const QString &key, const T &defaultValue)
 {
-    auto cf = cache.find(key);
-    if (cf != cache.end())
+    QVariant cached;
+    if (cache.find(key, cached))
     {
-        assert(cf->second.value<T>() == mSettings->value(key, defaultValue).template value<T>());
-        return cf->second.value<T>();
+        assert(cached.value<T>() == mSettings->value(key, defaultValue).template value<T>());
+        return cached.value<T>();
     }
     else return mSettings->value(key, defaultValue).template value<T>();
 }
@@ -1013,15 +1011,31 @@ T Preferences::getValue(const QString &key, const T &defaultValue)
 template<typename T>
 T Preferences::getValueConcurrent(const QString &key)
 {
+    QVariant cached;
+    if (cache.find(key, cached))
+    {
+        return cached.value<T>();
+    }
+
     QMutexLocker locker(&mutex);
-    return getValue<T>(key);
+    T value = getValue<T>(key);
+    cacheStoredValue(key);
+    return value;
 }
 
 template<typename T>
 T Preferences::getValueConcurrent(const QString &key, const T &defaultValue)
 {
+    QVariant cached;
+    if (cache.find(key, cached))
+    {
+        return cached.value<T>();
+    }
+
     QMutexLocker locker(&mutex);
-    return getValue<T>(key, defaultValue);
+    T value = getValue<T>(key, defaultValue);
+    cacheStoredValue(key);
+    return value;
 }
 
 void Preferences::setAndCachedValue(const QString &key, const QVariant &value)
@@ -1047,7 +1061,17 @@ void Preferences::setCachedValue(const QString &key, const QVariant &value)
 {
     if (!key.isEmpty())
     {
-        cache[key] = value;
+        cache.insert(key, value);
+    }
+}
+
+void Preferences::cacheStoredValue(const QString &key)
+{
+    //Missing values are not cached, as each getter may use a different default value
+    QVariant value = mSettings->value(key);
+    if (!value.toString().isEmpty())
+    {
+        setCachedValue(key, value);
     }
 }
 
@@ -1058,7 +1082,7 @@ void Preferences::cleanCache()
 
 void Preferences::removeFromCache(const QString &key)
 {
-    cache.erase(key);
+    cache.remove(key);
 }
 
 std::chrono::system_clock::time_point Preferences::getTransferOverQuotaDialogLastExecution()
@@ -2094,11 +2118,9 @@ void Preferences::removeAllFolders()
 
 QStringList Preferences::getExcludedSyncNames()
 {
-    mutex.lock();
     assert(logged());
-    QStringList value = excludedSyncNames;
-    mutex.unlock();
-    return value;
+    auto value = std::atomic_load(&mExcludedSyncNamesSnapshot);
+    return value ? *value : QStringList();
 }
 
 void Preferences::setExcludedSyncNames(QStringList names)
@@ -2106,6 +2128,7 @@ void Preferences::setExcludedSyncNames(QStringList names)
     mutex.lock();
     assert(logged());
     excludedSyncNames = names;
+    std::atomic_store(&mExcludedSyncNamesSnapshot, std::make_shared<const QStringList>(excludedSyncNames));
     if (!excludedSyncNames.size())
     {
         mSettings->remove(excludedSyncNamesKey);
@@ -2123,11 +2146,9 @@ void Preferences::setExcludedSyncNames(QStringList names)
 
 QStringList Preferences::getExcludedSyncPaths()
 {
-    mutex.lock();
     assert(logged());
-    QStringList value = excludedSyncPaths;
-    mutex.unlock();
-    return value;
+    auto value = std::atomic_load(&mExcludedSyncPathsSnapshot);
+    return value ? *value : QStringList();
 }
 
 void Preferences::setExcludedSyncPaths(QStringList paths)
@@ -2135,6 +2156,7 @@ void Preferences::setExcludedSyncPaths(QStringList paths)
     mutex.lock();
     assert(logged());
     excludedSyncPaths = paths;
+    std::atomic_store(&mExcludedSyncPathsSnapshot, std::make_shared<const QStringList>(excludedSyncPaths));
     if (!excludedSyncPaths.size())
     {
         mSettings->remove(excludedSyncPathsKey);
@@ -2580,6 +2602,7 @@ bool Preferences::enterUser(QString account)
     if (account.size() && mSettings->containsGroup(account))
     {
         mSettings->beginGroup(account);
+        cleanCache();
         readFolders();
         return true;
     }
@@ -2594,6 +2617,7 @@ void Preferences::enterUser(int i)
     if (i < mSettings->numChildGroups())
     {
         mSettings->beginGroup(i);
+        cleanCache();
     }
 
     readFolders();
@@ -2605,6 +2629,7 @@ void Preferences::leaveUser()
     mutex.lock();
     assert(logged());
     mSettings->endGroup();
+    cleanCache();
 
     mutex.unlock();
 }
@@ -2615,6 +2640,7 @@ void Preferences::unlink()
     assert(logged());
     mSettings->remove(sessionKey); // Remove session from specific account settings
     mSettings->endGroup();
+    cleanCache();
     mutex.unlock();
 
     resetGlobalSettings();
@@ -2743,10 +2769,7 @@ void Preferences::disableFileVersioning(bool value)
 
 bool Preferences::overlayIconsDisabled()
 {
-    mutex.lock();
-    bool result = getValue(disableOverlayIconsKey, false);
-    mutex.unlock();
-    return result;
+    return getValueConcurrent<bool>(disableOverlayIconsKey, false);
 }
 
 void Preferences::disableOverlayIcons(bool value)
@@ -3,6 +3,7 @@
 
 #include "megaapi.h"
 #include "control/EncryptedSettings.h"
+#include "control/PreferencesCache.h"
 #include "syncs/control/SyncInfo.h"
 
 #include <QLocale>
@@ -30,7 +31,8 @@ signals:
 private:
     Preferences();
 
-    std::map<QString, QVariant> cache;
+    //Readers of cached values do not lock the mutex
+    PreferencesCache cache;
 
 public:
     //NOT thread-safe. Must be called before creating threads.
@@ -547,6 +549,7 @@ protected:
     void setValueAndSyncConcurrent(const QString &key, const QVariant &value);
     void setValueConcurrent(const QString &key, const QVariant &value);
     void setCachedValue(const QString &key, const QVariant &value);
+    void cacheStoredValue(const QString &key);
     void cleanCache();
     void removeFromCache(const QString &key);
 
@@ -562,6 +565,9 @@ protected:
 
     QStringList excludedSyncNames;
     QStringList excludedSyncPaths;
+    //Copies published for the getters, which do not lock the mutex
+    std::shared_ptr<const QStringList> mExcludedSyncNamesSnapshot;
+    std::shared_ptr<const QStringList> mExcludedSyncPathsSnapshot;
     bool errorFlag;
     long long tempBandwidth;
     int tempBandwidthInterval;
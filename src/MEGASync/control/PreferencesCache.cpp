@@ -0,0 +1,59 @@
+#include "PreferencesCache.h"
+
+bool PreferencesCache::find(const QString& key, QVariant& value) const
+{
+    auto values(std::atomic_load(&shard(key).values));
+    if (!values)
+    {
+        return false;
+    }
+
+    auto valueIt = values->constFind(key);
+    if (valueIt == values->constEnd())
+    {
+        return false;
+    }
+
+    value = valueIt.value();
+    return true;
+}
+
+void PreferencesCache::insert(const QString& key, const QVariant& value)
+{
+    auto& keyShard(shard(key));
+    QMutexLocker lock(&keyShard.writeMutex);
+    auto values(keyShard.values ? std::make_shared<Values>(*keyShard.values) : std::make_shared<Values>());
+    values->insert(key, value);
+    std::atomic_store(&keyShard.values, std::shared_ptr<const Values>(values));
+}
+
+void PreferencesCache::remove(const QString& key)
+{
+    auto& keyShard(shard(key));
+    QMutexLocker lock(&keyShard.writeMutex);
+    if (keyShard.values && keyShard.values->contains(key))
+    {
+        auto values(std::make_shared<Values>(*keyShard.values));
+        values->remove(key);
+        std::atomic_store(&keyShard.values, std::shared_ptr<const Values>(values));
+    }
+}
+
+void PreferencesCache::clear()
+{
+    for (auto& keyShard : mShards)
+    {
+        QMutexLocker lock(&keyShard.writeMutex);
+        std::atomic_store(&keyShard.values, std::shared_ptr<const Values>());
+    }
+}
+
+const PreferencesCache::Shard& PreferencesCache::shard(const QString& key) const
+{
+    return mShards[qHash(key) % SHARDS];
+}
+
+PreferencesCache::Shard& PreferencesCache::shard(const QString& key)
+{
+    return mShards[qHash(key) % SHARDS];
+}
@@ -0,0 +1,40 @@
+#ifndef PREFERENCESCACHE_H
+#define PREFERENCESCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+
+#include <array>
+#include <memory>
+
+//Values of the preferences which can be read from any thread without the preferences lock.
+//Keys are spread among shards, and each write publishes a new copy of its shard, so readers
+//only load a pointer and never wait for writers.
+class PreferencesCache
+{
+public:
+    bool find(const QString& key, QVariant& value) const;
+    void insert(const QString& key, const QVariant& value);
+    void remove(const QString& key);
+    void clear();
+
+private:
+    using Values = QHash<QString, QVariant>;
+
+    struct Shard
+    {
+        QMutex writeMutex;
+        std::shared_ptr<const Values> values;
+    };
+
+    static const int SHARDS = 16;
+
+    const Shard& shard(const QString& key) const;
+    Shard& shard(const QString& key);
+
+    std::array<Shard, SHARDS> mShards;
+};
+
+#endif // PREFERENCESCACHE_H
@@ -9,13 +9,14 @@
 /*************************/
 
 TransferBatch::TransferBatch()
+    : mPendingCount(0)
 {
     mCancelToken = std::shared_ptr<mega::MegaCancelToken>(mega::MegaCancelToken::createInstance());
 }
 
 bool TransferBatch::isEmpty()
 {
-    return mPendingNodes.isEmpty();
+    return mPendingCount == 0;
 }
 
 void TransferBatch::add(const QString &nodePath, const QString& nodeName)
@@ -28,11 +29,11 @@ void TransferBatch::add(const QString &nodePath, const QString& nodeName)
             nodePathWithNativeSeparators = nodePathWithNativeSeparators + QDir::separator();
         }
 
-        std::unique_ptr<char[]> escapedChar(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(nodeName.toStdString().c_str()));
-        nodePathWithNativeSeparators = nodePathWithNativeSeparators + QString::fromUtf8(escapedChar.get());
+        nodePathWithNativeSeparators = nodePathWithNativeSeparators + unescapeFsIncompatible(nodeName);
     }
 
-    mPendingNodes.push_back(nodePathWithNativeSeparators.normalized(QString::NormalizationForm_C));
+    mPendingNodes[nodePathWithNativeSeparators.normalized(QString::NormalizationForm_C)]++;
+    mPendingCount++;
 }
 
 void TransferBatch::cancel()
@@ -42,20 +43,33 @@ void TransferBatch::cancel()
 
 void TransferBatch::onScanCompleted(const QString& nodePath)
 {
-    std::string nodePathCopy = nodePath.toStdString();
-    std::unique_ptr<char[]>  escapedChar(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(nodePathCopy.c_str()));
-    QString convertedNodePath = QDir::toNativeSeparators(QString::fromUtf8(escapedChar.get()));
+    if (mPendingCount == 0)
+    {
+        return;
+    }
+
+    QString convertedNodePath = QDir::toNativeSeparators(unescapeFsIncompatible(nodePath));
+
+    //Stored paths are normalized, so an exact match does not need to normalize the path
+    auto it = mPendingNodes.find(convertedNodePath);
+    if (it == mPendingNodes.end())
+    {
+        it = mPendingNodes.find(convertedNodePath.normalized(QString::NormalizationForm_C));
+    }
 
-    auto it = std::find(mPendingNodes.begin(), mPendingNodes.end(), convertedNodePath.normalized(QString::NormalizationForm_C));
     if (it != mPendingNodes.end())
     {
-        mPendingNodes.erase(it);
+        if (--it.value() == 0)
+        {
+            mPendingNodes.erase(it);
+        }
+        mPendingCount--;
     }
 }
 
 QString TransferBatch::description()
 {
-    return QString::fromLatin1("%1 nodes").arg(mPendingNodes.size());
+    return QString::fromLatin1("%1 nodes").arg(mPendingCount);
 }
 
 mega::MegaCancelToken* TransferBatch::getCancelTokenPtr()
@@ -68,6 +82,18 @@ std::shared_ptr<mega::MegaCancelToken> TransferBatch::getCancelToken()
     return mCancelToken;
 }
 
+QString TransferBatch::unescapeFsIncompatible(const QString& name)
+{
+    //Escaped characters are written as %xx, so there is nothing to unescape without them
+    if (!name.contains(QLatin1Char('%')))
+    {
+        return name;
+    }
+
+    std::unique_ptr<char[]> escapedChar(MegaSyncApp->getMegaApi()->unescapeFsIncompatible(name.toStdString().c_str()));
+    return QString::fromUtf8(escapedChar.get());
+}
+
 /*************************/
 /*** BlockingBatch *******/
 /*************************/
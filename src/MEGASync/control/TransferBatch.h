@@ -3,12 +3,15 @@
 
 #include "megaapi.h"
 
+#include <QHash>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 
 #include <memory>
 
+//Nodes of a batch whose scan has not finished yet. Paths are stored once, already normalized, in a hash with the
+//number of times they were added, so each completed scan is a single lookup however big the batch is.
 class TransferBatch
 {
 public:
@@ -30,7 +33,10 @@ public:
     std::shared_ptr<mega::MegaCancelToken> getCancelToken();
 
 private:
-    QStringList mPendingNodes;
+    static QString unescapeFsIncompatible(const QString& name);
+
+    QHash<QString, int> mPendingNodes;
+    int mPendingCount;
     std::shared_ptr<mega::MegaCancelToken> mCancelToken;
 };
 
@@ -4,9 +4,11 @@ INCLUDEPATH += $$PWD
 QT       += network
 
 SOURCES += $$PWD/HTTPServer.cpp \
+    $$PWD/HTTPRequestParser.cpp \
     $$PWD/DialogOpener.cpp \
     $$PWD/DownloadQueueController.cpp \
     $$PWD/Preferences.cpp \
+    $$PWD/PreferencesCache.cpp \
     $$PWD/LinkProcessor.cpp \
     $$PWD/MegaUploader.cpp \
     $$PWD/TransferRemainingTime.cpp \
@@ -19,16 +21,20 @@ SOURCES += $$PWD/HTTPServer.cpp \
     $$PWD/ThreadPool.cpp \
     $$PWD/MegaDownloader.cpp \
     $$PWD/MegaSyncLogger.cpp \
+    $$PWD/LogBundleBuilder.cpp \
+    $$PWD/CollationKeyCache.cpp \
     $$PWD/ConnectivityChecker.cpp \
     $$PWD/TransferBatch.cpp \
     $$PWD/TextDecorator.cpp \
     $$PWD/qrcodegen.c \
 
 HEADERS  +=  $$PWD/HTTPServer.h \
+    $$PWD/HTTPRequestParser.h \
     $$PWD/AppStatsEvents.h \
     $$PWD/DialogOpener.h \
     $$PWD/DownloadQueueController.h \
     $$PWD/Preferences.h \
+    $$PWD/PreferencesCache.h \
     $$PWD/LinkProcessor.h \
     $$PWD/MegaUploader.h \
     $$PWD/TransferRemainingTime.h \
@@ -39,8 +45,12 @@ HEADERS  +=  $$PWD/HTTPServer.h \
     $$PWD/UserAttributesManager.h \
     $$PWD/Utilities.h \
     $$PWD/ThreadPool.h \
+    $$PWD/LockFreeMpscQueue.h \
+    $$PWD/LogRing.h \
     $$PWD/MegaDownloader.h \
     $$PWD/MegaSyncLogger.h \
+    $$PWD/LogBundleBuilder.h \
+    $$PWD/CollationKeyCache.h \
     $$PWD/ConnectivityChecker.h \
     $$PWD/TransferBatch.h \
     $$PWD/TextDecorator.h \
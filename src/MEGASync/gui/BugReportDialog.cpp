@@ -47,6 +47,16 @@ BugReportDialog::~BugReportDialog()
     //Just in case the dialog is closed from an exit action
     cancelCurrentReportUpload();
 
+    //The logs may still be read for the bundle
+    if (mLogBundleBuilder)
+    {
+        delete mLogBundleBuilder;
+    }
+    if (preparing)
+    {
+        logger.resumeAfterReporting();
+    }
+
     delete ui;
     delete delegateTransferListener;
     delete delegateRequestListener;
@@ -273,29 +283,71 @@ void BugReportDialog::onReadyForReporting()
     //If send log file is enabled
     if (ui->cbAttachLogs->isChecked())
     {
-        QString pathToLogFile = Utilities::joinLogZipFiles(megaApi);
-        if (pathToLogFile.isNull())
+        //The logs are joined in the background, so the dialog keeps responding with many rotated logs
+        mLogBundleBuilder = new LogBundleBuilder(Utilities::getLogsFolderPath(), Utilities::getLogBundleFilePath(megaApi), this);
+        connect(mLogBundleBuilder.data(), &LogBundleBuilder::progress, this, &BugReportDialog::onLogBundleProgress);
+        connect(mLogBundleBuilder.data(), &LogBundleBuilder::finished, this, &BugReportDialog::onLogBundleFinished);
+
+        mPrepareProgress = new QProgressDialog(tr("Preparing bug report"), tr("Cancel"), 0, 1000, this);
+        mPrepareProgress->setMinimumDuration(0);
+        mPrepareProgress->setAutoClose(false);
+        mPrepareProgress->setAutoReset(false);
+        connect(mPrepareProgress.data(), &QProgressDialog::canceled, mLogBundleBuilder.data(), &LogBundleBuilder::cancel);
+        DialogOpener::showDialog(mPrepareProgress);
+
+        mLogBundleBuilder->start();
+    }
+    else
+    {
+        //The logs are not read
+        logger.resumeAfterReporting();
+
+        //Create support ticket
+        createSupportTicket();
+    }
+}
+
+void BugReportDialog::onLogBundleProgress(qint64 bytesDone, qint64 bytesTotal)
+{
+    if (mPrepareProgress && bytesTotal > 0)
+    {
+        mPrepareProgress->setValue(static_cast<int>((1000 * bytesDone) / bytesTotal));
+    }
+}
+
+void BugReportDialog::onLogBundleFinished(bool success)
+{
+    auto cancelled = !mPrepareProgress || mPrepareProgress->wasCanceled();
+    if (mPrepareProgress)
+    {
+        mPrepareProgress->close();
+        mPrepareProgress->deleteLater();
+    }
+
+    QString pathToLogFile = mLogBundleBuilder->getBundlePath();
+    mLogBundleBuilder->deleteLater();
+
+    //The bundle has been built, the logs can be rotated again
+    logger.resumeAfterReporting();
+
+    if (!success)
+    {
+        if (!cancelled)
         {
             showErrorMessage();
-            logger.resumeAfterReporting();
-            preparing = false;
-        }
-        else
-        {
-            QFileInfo joinLogsFile{pathToLogFile};
-            reportFileName = joinLogsFile.fileName();
-            if(Preferences::instance()->getGlobalPaused())
-            {
-                mHadGlobalPause = true;
-                MegaSyncApp->getTransfersModel()->setGlobalPause(false);
-            }
-            megaApi->startUploadForSupport(QDir::toNativeSeparators(pathToLogFile).toUtf8().constData(), true, delegateTransferListener);
         }
+        preparing = false;
     }
     else
     {
-        //Create support ticket
-        createSupportTicket();
+        QFileInfo joinLogsFile{pathToLogFile};
+        reportFileName = joinLogsFile.fileName();
+        if(Preferences::instance()->getGlobalPaused())
+        {
+            mHadGlobalPause = true;
+            MegaSyncApp->getTransfersModel()->setGlobalPause(false);
+        }
+        megaApi->startUploadForSupport(QDir::toNativeSeparators(pathToLogFile).toUtf8().constData(), true, delegateTransferListener);
     }
 }
 
@@ -4,6 +4,7 @@
 #include "megaapi.h"
 #include "QTMegaTransferListener.h"
 #include "MegaApplication.h"
+#include "LogBundleBuilder.h"
 
 #include <QDialog>
 #include <QProgressDialog>
@@ -32,6 +33,8 @@ private:
     Ui::BugReportDialog *ui;
     int currentTransfer;
     QPointer<QProgressDialog> mSendProgress;
+    QPointer<QProgressDialog> mPrepareProgress;
+    QPointer<LogBundleBuilder> mLogBundleBuilder;
 
     long long totalBytes;
     long long transferredBytes;
@@ -65,6 +68,8 @@ private slots:
     void cancelSendReport();
     void onDescriptionChanged();
     void onReadyForReporting();
+    void onLogBundleProgress(qint64 bytesDone, qint64 bytesTotal);
+    void onLogBundleFinished(bool success);
     void on_teDescribeBug_textChanged();
 };
 
@@ -44,18 +44,23 @@ public:
     {
         if(node)
         {
-            if(node->isNodeKeyDecrypted())
-            {
-                return QString::fromUtf8(node->getName());
-            }
-            else
-            {
-                return QCoreApplication::translate("MegaError", "Decryption error");
-            }
+            return getNodeName(QString::fromUtf8(node->getName()), node->isNodeKeyDecrypted());
         }
 
         return QString();
     }
+
+    static QString getNodeName(const QString& name, bool nodeKeyDecrypted)
+    {
+        if(nodeKeyDecrypted)
+        {
+            return name;
+        }
+        else
+        {
+            return QCoreApplication::translate("MegaError", "Decryption error");
+        }
+    }
 };
 
 #endif // MEGANODENAMES_H
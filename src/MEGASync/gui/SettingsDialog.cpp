@@ -1102,7 +1102,7 @@ void SettingsDialog::on_cOverlayIcons_toggled(bool checked)
     if (mLoadingSettings) return;
     mUi->cOverlayIcons->setEnabled(false);
     mPreferences->disableOverlayIcons(!checked);
-#ifdef Q_OS_MACOS
+#if defined(Q_OS_MACOS) || defined(Q_OS_LINUX)
     Platform::getInstance()->notifyRestartSyncFolders();
 #endif
     mApp->notifyChangeToAllFolders();
@@ -67,6 +67,8 @@ SOURCES += $$PWD/SettingsDialog.cpp \
     $$PWD/node_selector/model/NodeSelectorModel.cpp \
     $$PWD/node_selector/model/NodeSelectorModelSpecialised.cpp \
     $$PWD/node_selector/model/NodeSelectorModelItem.cpp \
+    $$PWD/node_selector/model/NodeTreeSnapshot.cpp \
+    $$PWD/node_selector/model/NodeSearchIndex.cpp \
     $$PWD/node_selector/gui/NodeSelectorTreeView.cpp \
     $$PWD/node_selector/gui/NodeSelectorTreeViewWidget.cpp \
     $$PWD/node_selector/gui/NodeSelectorTreeViewWidgetSpecializations.cpp \
@@ -146,6 +148,8 @@ HEADERS  += $$PWD/SettingsDialog.h \
     $$PWD/node_selector/model/NodeSelectorModel.h \
     $$PWD/node_selector/model/NodeSelectorModelSpecialised.h \
     $$PWD/node_selector/model/NodeSelectorModelItem.h \
+    $$PWD/node_selector/model/NodeTreeSnapshot.h \
+    $$PWD/node_selector/model/NodeSearchIndex.h \
     $$PWD/node_selector/gui/NodeSelectorTreeView.h \
     $$PWD/node_selector/gui/NodeSelectorTreeViewWidget.h \
     $$PWD/node_selector/gui/NodeSelectorTreeViewWidgetSpecializations.h \
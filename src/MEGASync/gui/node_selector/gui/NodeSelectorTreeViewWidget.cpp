@@ -67,6 +67,10 @@ void NodeSelectorTreeViewWidget::changeEvent(QEvent *event)
             ui->lFolderName->setText(getRootText());
         }
         ui->retranslateUi(this);
+        if(mProxyModel)
+        {
+            mProxyModel->clearSortKeys();
+        }
     }
     QWidget::changeEvent(event);
 }
@@ -673,7 +677,8 @@ QModelIndex NodeSelectorTreeViewWidget::getParentIncomingShareByIndex(QModelInde
     {        
         if(NodeSelectorModelItem *item = qvariant_cast<NodeSelectorModelItem*>(idx.data(toInt(NodeSelectorModelRoles::MODEL_ITEM_ROLE))))
         {
-            if(item->getNode()->isInShare())
+            auto node = item->getNode();
+            if(node && node->isInShare())
             {
                 return idx;
             }
@@ -770,7 +775,7 @@ bool SelectType::isAllowedToNavigateInside(const QModelIndex &index)
     {
         return false;
     }
-    return !(item->getNode()->isFile() || item->isCloudDrive());
+    return !(item->isFile() || item->isCloudDrive());
 }
 
 void DownloadType::init(NodeSelectorTreeViewWidget *wdg)
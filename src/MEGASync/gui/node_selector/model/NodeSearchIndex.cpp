@@ -0,0 +1,468 @@
+#include "NodeSearchIndex.h"
+#include "MegaApplication.h"
+#include "Utilities.h"
+
+#include <algorithm>
+#include <deque>
+
+using namespace mega;
+
+namespace
+{
+const int TRIGRAM_SIZE = 3;
+const int MAX_DEPTH = 10000;
+const int MIN_ENTRIES_TO_COMPACT = 1024;
+}
+
+NodeSearchIndex::NodeSearchIndex()
+    : mState(State::EMPTY),
+      mBuildId(0),
+      mRootHandle(INVALID_HANDLE),
+      mVaultHandle(INVALID_HANDLE),
+      mRubbishHandle(INVALID_HANDLE),
+      mRemovedEntries(0),
+      mGeneration(0)
+{
+}
+
+void NodeSearchIndex::build()
+{
+    {
+        QWriteLocker lock(&mLock);
+        if(mState != State::EMPTY)
+        {
+            return;
+        }
+        mState = State::BUILDING;
+    }
+
+    auto buildId(++mBuildId);
+    ThreadPoolSingleton::getInstance()->push([this, buildId]()
+    {
+        buildFromSdk(buildId);
+    });
+}
+
+bool NodeSearchIndex::isReady() const
+{
+    QReadLocker lock(&mLock);
+    return mState == State::READY;
+}
+
+bool NodeSearchIndex::search(const QString& text, Query& previous, std::vector<Result>& results) const
+{
+    auto needle(foldName(text));
+    results.clear();
+
+    QReadLocker lock(&mLock);
+    if(mState != State::READY)
+    {
+        return false;
+    }
+
+    std::vector<quint32> matches;
+    auto check = [this, &needle, &matches](quint32 id)
+    {
+        const auto& entry = mEntries[id];
+        if(!entry.removed && entry.name.contains(needle))
+        {
+            matches.push_back(id);
+        }
+    };
+
+    if(needle.isEmpty())
+    {
+        //Nothing matches an empty text
+    }
+    else if(previous.generation == mGeneration && !previous.text.isEmpty() && needle.contains(previous.text))
+    {
+        //Every name which contains the new text contains the previous one too
+        for(auto id : previous.ids)
+        {
+            check(id);
+        }
+    }
+    else if(needle.size() >= TRIGRAM_SIZE)
+    {
+        const std::vector<quint32>* candidates(nullptr);
+        for(int i = 0; i + TRIGRAM_SIZE <= needle.size(); ++i)
+        {
+            auto trigramIt = mTrigrams.constFind(trigram(needle.constData() + i));
+            if(trigramIt == mTrigrams.constEnd())
+            {
+                //No name has this trigram
+                candidates = nullptr;
+                break;
+            }
+            if(!candidates || trigramIt->size() < candidates->size())
+            {
+                candidates = &trigramIt.value();
+            }
+        }
+
+        if(candidates)
+        {
+            for(auto id : *candidates)
+            {
+                check(id);
+            }
+        }
+    }
+    else
+    {
+        for(quint32 id = 0; id < mEntries.size(); ++id)
+        {
+            check(id);
+        }
+    }
+
+    QHash<quint32, Result> resolved;
+    results.reserve(matches.size());
+    for(auto id : matches)
+    {
+        results.push_back(resolve(id, resolved));
+    }
+
+    previous.text = needle;
+    previous.ids = std::move(matches);
+    previous.generation = mGeneration;
+    return true;
+}
+
+void NodeSearchIndex::onNodesUpdate(MegaNodeList* nodes)
+{
+    //A null list means that the whole tree may have changed
+    if(!nodes)
+    {
+        reset();
+        return;
+    }
+
+    {
+        QReadLocker lock(&mLock);
+        if(mState == State::EMPTY)
+        {
+            return;
+        }
+    }
+
+    std::vector<PendingNode> updatedNodes;
+    updatedNodes.reserve(static_cast<size_t>(nodes->size()));
+    for(int i = 0; i < nodes->size(); ++i)
+    {
+        auto node(nodes->get(i));
+        auto inShareAccess(node->isInShare() ? MegaSyncApp->getMegaApi()->getAccess(node) : MegaShare::ACCESS_UNKNOWN);
+        updatedNodes.push_back(PendingNode{node->getHandle(), node->getParentHandle(), QString::fromUtf8(node->getName()), inShareAccess,
+                                           node->isFile(), node->isNodeKeyDecrypted(),
+                                           node->getChanges() & MegaNode::CHANGE_TYPE_REMOVED ? true : false});
+    }
+
+    QWriteLocker lock(&mLock);
+    if(mState == State::BUILDING)
+    {
+        //They are applied when the index is built, as the tree may have been read before them
+        mPendingNodes.insert(mPendingNodes.end(), updatedNodes.begin(), updatedNodes.end());
+    }
+    else if(mState == State::READY)
+    {
+        for(const auto& node : updatedNodes)
+        {
+            applyPendingNode(node);
+        }
+        mGeneration++;
+
+        if(mRemovedEntries > MIN_ENTRIES_TO_COMPACT && static_cast<size_t>(mRemovedEntries) > mEntries.size() / 2)
+        {
+            compact();
+        }
+    }
+}
+
+void NodeSearchIndex::reset()
+{
+    QWriteLocker lock(&mLock);
+    mBuildId++;
+    mState = State::EMPTY;
+    mPendingNodes.clear();
+    mRootHandle = INVALID_HANDLE;
+    mVaultHandle = INVALID_HANDLE;
+    mRubbishHandle = INVALID_HANDLE;
+    mEntries.clear();
+    mIds.clear();
+    mTrigrams.clear();
+    mRemovedEntries = 0;
+    mGeneration++;
+}
+
+void NodeSearchIndex::setRootHandles(MegaHandle rootHandle, MegaHandle vaultHandle, MegaHandle rubbishHandle)
+{
+    QWriteLocker lock(&mLock);
+    mRootHandle = rootHandle;
+    mVaultHandle = vaultHandle;
+    mRubbishHandle = rubbishHandle;
+}
+
+void NodeSearchIndex::addNode(MegaHandle handle, MegaHandle parentHandle, const QString& name, bool isFile,
+                              int inShareAccess, bool isNodeKeyDecrypted)
+{
+    QWriteLocker lock(&mLock);
+    remove(handle);
+    insert(handle, parentHandle, foldName(name), inShareAccess, isFile, isNodeKeyDecrypted);
+    mGeneration++;
+}
+
+void NodeSearchIndex::setReady()
+{
+    QWriteLocker lock(&mLock);
+    mState = State::READY;
+    mGeneration++;
+}
+
+int NodeSearchIndex::size() const
+{
+    QReadLocker lock(&mLock);
+    return mIds.size();
+}
+
+void NodeSearchIndex::buildFromSdk(unsigned long long buildId)
+{
+    auto megaApi(MegaSyncApp->getMegaApi());
+    std::unique_ptr<MegaNode> rootNode(megaApi ? megaApi->getRootNode() : nullptr);
+    if(!rootNode)
+    {
+        QWriteLocker lock(&mLock);
+        if(mBuildId == buildId)
+        {
+            mState = State::EMPTY;
+        }
+        return;
+    }
+
+    std::unique_ptr<MegaNode> vaultNode(megaApi->getVaultNode());
+    std::unique_ptr<MegaNode> rubbishNode(megaApi->getRubbishNode());
+
+    //The new index is filled without the lock, it replaces the current one when it is complete
+    NodeSearchIndex index;
+    index.mRootHandle = rootNode->getHandle();
+    index.mVaultHandle = vaultNode ? vaultNode->getHandle() : INVALID_HANDLE;
+    index.mRubbishHandle = rubbishNode ? rubbishNode->getHandle() : INVALID_HANDLE;
+
+    std::deque<std::unique_ptr<MegaNode>> folders;
+    auto addNode = [&index, &folders, megaApi](MegaNode* node)
+    {
+        auto inShareAccess(node->isInShare() ? megaApi->getAccess(node) : MegaShare::ACCESS_UNKNOWN);
+        index.insert(node->getHandle(), node->getParentHandle(), foldName(QString::fromUtf8(node->getName())),
+                     inShareAccess, node->isFile(), node->isNodeKeyDecrypted());
+        if(!node->isFile())
+        {
+            folders.emplace_back(node->copy());
+        }
+    };
+
+    addNode(rootNode.get());
+    if(vaultNode)
+    {
+        addNode(vaultNode.get());
+    }
+    if(rubbishNode)
+    {
+        addNode(rubbishNode.get());
+    }
+
+    std::unique_ptr<MegaNodeList> inShares(megaApi->getInShares());
+    for(int i = 0; inShares && i < inShares->size(); ++i)
+    {
+        addNode(inShares->get(i));
+    }
+
+    while(!folders.empty() && mBuildId == buildId)
+    {
+        auto folder(std::move(folders.front()));
+        folders.pop_front();
+
+        std::unique_ptr<MegaNodeList> children(megaApi->getChildren(folder.get()));
+        for(int i = 0; children && i < children->size(); ++i)
+        {
+            addNode(children->get(i));
+        }
+    }
+
+    QWriteLocker lock(&mLock);
+    if(mBuildId != buildId)
+    {
+        return;
+    }
+
+    mRootHandle = index.mRootHandle;
+    mVaultHandle = index.mVaultHandle;
+    mRubbishHandle = index.mRubbishHandle;
+    mEntries = std::move(index.mEntries);
+    mIds = std::move(index.mIds);
+    mTrigrams = std::move(index.mTrigrams);
+    mRemovedEntries = index.mRemovedEntries;
+
+    for(const auto& node : mPendingNodes)
+    {
+        applyPendingNode(node);
+    }
+    mPendingNodes.clear();
+
+    mState = State::READY;
+    mGeneration++;
+}
+
+void NodeSearchIndex::applyPendingNode(const PendingNode& node)
+{
+    if(node.removed)
+    {
+        remove(node.handle);
+        return;
+    }
+
+    auto name(foldName(node.name));
+    auto idIt = mIds.constFind(node.handle);
+    if(idIt != mIds.constEnd())
+    {
+        //Moves and attribute changes which keep the name do not need to index it again
+        auto& entry = mEntries[idIt.value()];
+        if(entry.name == name)
+        {
+            entry.parent = node.parent;
+            entry.inShareAccess = static_cast<qint8>(node.inShareAccess);
+            entry.isFile = node.isFile;
+            entry.isNodeKeyDecrypted = node.isNodeKeyDecrypted;
+            return;
+        }
+
+        remove(node.handle);
+    }
+
+    insert(node.handle, node.parent, name, node.inShareAccess, node.isFile, node.isNodeKeyDecrypted);
+}
+
+void NodeSearchIndex::insert(MegaHandle handle, MegaHandle parentHandle, const QByteArray& name, int inShareAccess,
+                             bool isFile, bool isNodeKeyDecrypted)
+{
+    auto id(static_cast<quint32>(mEntries.size()));
+    mEntries.push_back(Entry{handle, parentHandle, name, static_cast<qint8>(inShareAccess), isFile, isNodeKeyDecrypted, false});
+    mIds.insert(handle, id);
+
+    std::vector<quint32> trigrams;
+    for(int i = 0; i + TRIGRAM_SIZE <= name.size(); ++i)
+    {
+        trigrams.push_back(trigram(name.constData() + i));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+    //Ids are added in order, so every list stays sorted
+    for(auto key : trigrams)
+    {
+        mTrigrams[key].push_back(id);
+    }
+}
+
+void NodeSearchIndex::remove(MegaHandle handle)
+{
+    auto idIt = mIds.find(handle);
+    if(idIt == mIds.end())
+    {
+        return;
+    }
+
+    auto& entry = mEntries[idIt.value()];
+    entry.removed = true;
+    entry.name.clear();
+    mIds.erase(idIt);
+    mRemovedEntries++;
+}
+
+void NodeSearchIndex::compact()
+{
+    auto entries(std::move(mEntries));
+    mEntries.clear();
+    mIds.clear();
+    mTrigrams.clear();
+    mRemovedEntries = 0;
+
+    for(const auto& entry : entries)
+    {
+        if(!entry.removed)
+        {
+            insert(entry.handle, entry.parent, entry.name, entry.inShareAccess, entry.isFile, entry.isNodeKeyDecrypted);
+        }
+    }
+    mGeneration++;
+}
+
+NodeSearchIndex::Result NodeSearchIndex::resolve(quint32 id, QHash<quint32, Result>& resolved) const
+{
+    const auto& node = mEntries[id];
+    Result root{INVALID_HANDLE, RootType::UNKNOWN, MegaShare::ACCESS_UNKNOWN, false, false};
+
+    //The root and the access are the ones of the first ancestor which is a root or an incoming share
+    std::vector<quint32> path;
+    auto current(id);
+    for(int depth = 0; depth < MAX_DEPTH; ++depth)
+    {
+        auto resolvedIt = resolved.constFind(current);
+        if(resolvedIt != resolved.constEnd())
+        {
+            root = resolvedIt.value();
+            break;
+        }
+
+        const auto& entry = mEntries[current];
+        path.push_back(current);
+        if(entry.handle == mRootHandle)
+        {
+            root.rootType = RootType::CLOUD_DRIVE;
+            root.access = MegaShare::ACCESS_OWNER;
+            break;
+        }
+        else if(entry.handle == mVaultHandle)
+        {
+            root.rootType = RootType::VAULT;
+            root.access = MegaShare::ACCESS_OWNER;
+            break;
+        }
+        else if(entry.handle == mRubbishHandle)
+        {
+            root.rootType = RootType::RUBBISH;
+            root.access = MegaShare::ACCESS_OWNER;
+            break;
+        }
+        else if(entry.inShareAccess != MegaShare::ACCESS_UNKNOWN)
+        {
+            root.rootType = RootType::INCOMING_SHARE;
+            root.access = entry.inShareAccess;
+            break;
+        }
+
+        auto parentIt = mIds.constFind(entry.parent);
+        if(parentIt == mIds.constEnd())
+        {
+            break;
+        }
+        current = parentIt.value();
+    }
+
+    for(auto pathId : path)
+    {
+        resolved.insert(pathId, root);
+    }
+
+    return Result{node.handle, root.rootType, root.access, node.isFile, node.isNodeKeyDecrypted};
+}
+
+QByteArray NodeSearchIndex::foldName(const QString& name)
+{
+    return name.toCaseFolded().toUtf8();
+}
+
+quint32 NodeSearchIndex::trigram(const char* text)
+{
+    return (static_cast<quint32>(static_cast<uchar>(text[0])) << 16)
+            | (static_cast<quint32>(static_cast<uchar>(text[1])) << 8)
+            | static_cast<quint32>(static_cast<uchar>(text[2]));
+}
@@ -0,0 +1,131 @@
+#ifndef NODESEARCHINDEX_H
+#define NODESEARCHINDEX_H
+
+#include "megaapi.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+#include <atomic>
+#include <vector>
+
+//Name index of all the nodes of the account, used by the node selector search instead of MegaApi::search.
+//Names are indexed by their trigrams, so a search only checks the names which have the least common trigram of the text.
+//It is built once in the background and kept up to date with the node updates.
+class NodeSearchIndex
+{
+public:
+    enum class RootType
+    {
+        UNKNOWN = 0,
+        CLOUD_DRIVE,
+        VAULT,
+        RUBBISH,
+        INCOMING_SHARE,
+    };
+
+    struct Result
+    {
+        mega::MegaHandle handle;
+        RootType rootType;
+        int access;
+        bool isFile;
+        bool isNodeKeyDecrypted;
+    };
+
+    //Results of the previous search, so a longer text only checks them
+    struct Query
+    {
+        QByteArray text;
+        std::vector<quint32> ids;
+        unsigned long long generation = 0;
+    };
+
+    static NodeSearchIndex& instance()
+    {
+        static NodeSearchIndex instance;
+        return instance;
+    }
+
+    //Starts building the index in the background, if it is not built yet
+    void build();
+    bool isReady() const;
+
+    //Returns false if the index is not ready, so the caller has to search in the SDK
+    bool search(const QString& text, Query& previous, std::vector<Result>& results) const;
+
+    void onNodesUpdate(mega::MegaNodeList* nodes);
+    void reset();
+
+    //They are used to build the index
+    void setRootHandles(mega::MegaHandle rootHandle, mega::MegaHandle vaultHandle, mega::MegaHandle rubbishHandle);
+    void addNode(mega::MegaHandle handle, mega::MegaHandle parentHandle, const QString& name, bool isFile,
+                 int inShareAccess = mega::MegaShare::ACCESS_UNKNOWN, bool isNodeKeyDecrypted = true);
+    void setReady();
+
+    int size() const;
+
+private:
+    enum class State
+    {
+        EMPTY = 0,
+        BUILDING,
+        READY,
+    };
+
+    struct Entry
+    {
+        mega::MegaHandle handle;
+        mega::MegaHandle parent;
+        QByteArray name;
+        qint8 inShareAccess;
+        bool isFile;
+        bool isNodeKeyDecrypted;
+        bool removed;
+    };
+
+    struct PendingNode
+    {
+        mega::MegaHandle handle;
+        mega::MegaHandle parent;
+        QString name;
+        int inShareAccess;
+        bool isFile;
+        bool isNodeKeyDecrypted;
+        bool removed;
+    };
+
+    NodeSearchIndex();
+
+    void buildFromSdk(unsigned long long buildId);
+    void applyPendingNode(const PendingNode& node);
+    void insert(mega::MegaHandle handle, mega::MegaHandle parentHandle, const QByteArray& name, int inShareAccess,
+                bool isFile, bool isNodeKeyDecrypted);
+    void remove(mega::MegaHandle handle);
+    void compact();
+    Result resolve(quint32 id, QHash<quint32, Result>& resolved) const;
+
+    static QByteArray foldName(const QString& name);
+    static quint32 trigram(const char* text);
+
+    mutable QReadWriteLock mLock;
+    State mState;
+    std::atomic<unsigned long long> mBuildId;
+    std::vector<PendingNode> mPendingNodes;
+
+    mega::MegaHandle mRootHandle;
+    mega::MegaHandle mVaultHandle;
+    mega::MegaHandle mRubbishHandle;
+
+    std::vector<Entry> mEntries;
+    QHash<mega::MegaHandle, quint32> mIds;
+    QHash<quint32, std::vector<quint32>> mTrigrams;
+    int mRemovedEntries;
+
+    //Previous results are discarded when the index changes
+    unsigned long long mGeneration;
+};
+
+#endif // NODESEARCHINDEX_H
@@ -1,5 +1,7 @@
 #include "node_selector/model/NodeSelectorModel.h"
 #include "node_selector/model/NodeSelectorModelSpecialised.h"
+#include "node_selector/model/NodeTreeSnapshot.h"
+#include "node_selector/model/NodeSearchIndex.h"
 #include "MegaApplication.h"
 #include "Utilities.h"
 #include "Preferences.h"
@@ -14,8 +16,6 @@
 #include <QApplication>
 #include <QToolTip>
 
-const char* INDEX_PROPERTY = "INDEX";
-
 NodeRequester::NodeRequester(NodeSelectorModel *model)
     : QObject(nullptr),
       mModel(model),
@@ -47,27 +47,19 @@ void NodeRequester::requestNodeAndCreateChildren(NodeSelectorModelItem* item, co
     if(item)
     {
         auto node = item->getNode();
-        item->setProperty(INDEX_PROPERTY, parentIndex);
         if(!item->requestingChildren() && !item->areChildrenInitialized())
         {
             item->setRequestingChildren(true);
-            mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
 
-            auto childNodesFiltered = mega::MegaNodeList::createInstance();
-            mShowFiles ?
-                childNodesFiltered = megaApi->getChildren(node.get(), mega::MegaApi::ORDER_NONE, mCancelToken.get())
-                    : childNodesFiltered = megaApi->getChildrenFromType(item->getNode().get(), mega::MegaNode::TYPE_FOLDER, mega::MegaApi::ORDER_NONE, mCancelToken.get());
+            //Folders already listed by any node selector are not listed by the SDK again
+            auto childNodesFiltered = NodeTreeSnapshot::instance().getChildren(node.get(), mShowFiles, mCancelToken.get());
 
             if(!isAborted())
             {
                 lockDataMutex(true);
-                item->createChildItems(std::unique_ptr<mega::MegaNodeList>(childNodesFiltered));
+                item->createChildItems(childNodesFiltered);
                 lockDataMutex(false);
-                emit nodesReady(item);
-            }
-            else
-            {
-                delete childNodesFiltered;
+                emit nodesReady(item, parentIndex);
             }
         }
     }
@@ -89,59 +81,123 @@ void NodeRequester::search(const QString &text, NodeSelectorModelItemSearch::Typ
     mSearchCanceled = false;
     mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
 
-    auto nodeList = std::unique_ptr<mega::MegaNodeList>(megaApi->search(text.toUtf8().constData(), mCancelToken.get()));
     QList<NodeSelectorModelItem*> items;
     NodeSelectorModelItemSearch::Types searchedTypes = NodeSelectorModelItemSearch::Type::NONE;
 
-    for(int i = 0; i < nodeList->size(); i++)
+    std::vector<NodeSearchIndex::Result> results;
+    if(NodeSearchIndex::instance().search(text, mSearchQuery, results))
     {
-        auto node = nodeList->get(i);
-        if(isAborted() || mSearchCanceled)
-        {
-            break;
-        }
-        if((node->isFile() && !mShowFiles) || megaApi->isInRubbish(node))
-        {
-            continue;
-        }
-        else if(mSyncSetupMode)
+        for(const auto& result : results)
         {
-            int access = megaApi->getAccess(node);
-            if(access != mega::MegaShare::ACCESS_FULL && access != mega::MegaShare::ACCESS_OWNER)
+            if(isAborted() || mSearchCanceled)
+            {
+                break;
+            }
+            if((result.isFile && !mShowFiles)
+               || result.rootType == NodeSearchIndex::RootType::RUBBISH
+               || result.rootType == NodeSearchIndex::RootType::UNKNOWN)
             {
                 continue;
             }
+            else if(mSyncSetupMode)
+            {
+                if(result.access != mega::MegaShare::ACCESS_FULL && result.access != mega::MegaShare::ACCESS_OWNER)
+                {
+                    continue;
+                }
+            }
+            else if(!mShowReadOnlyFolders)
+            {
+                if(result.access == mega::MegaShare::ACCESS_READ
+                   || !result.isNodeKeyDecrypted)
+                {
+                    continue;
+                }
+            }
+
+            NodeSelectorModelItemSearch::Types type;
+
+            if(result.rootType == NodeSearchIndex::RootType::CLOUD_DRIVE)
+            {
+                type = NodeSelectorModelItemSearch::Type::CLOUD_DRIVE;
+            }
+            else if(result.rootType == NodeSearchIndex::RootType::VAULT)
+            {
+                type = NodeSelectorModelItemSearch::Type::BACKUP;
+            }
+            else
+            {
+                type = NodeSelectorModelItemSearch::Type::INCOMING_SHARE;
+            }
+
+            if(typesAllowed & type)
+            {
+                auto nodeUptr = std::unique_ptr<mega::MegaNode>(megaApi->getNodeByHandle(result.handle));
+                if(nodeUptr)
+                {
+                    searchedTypes |= type;
+                    auto item = new NodeSelectorModelItemSearch(std::move(nodeUptr), type);
+                    items.append(item);
+                }
+            }
         }
-        else if(!mShowReadOnlyFolders)
+    }
+    else
+    {
+        //The SDK is searched until the index is built
+        NodeSearchIndex::instance().build();
+
+        auto nodeList = std::unique_ptr<mega::MegaNodeList>(megaApi->search(text.toUtf8().constData(), mCancelToken.get()));
+        for(int i = 0; i < nodeList->size(); i++)
         {
-            if(megaApi->getAccess(node) == mega::MegaShare::ACCESS_READ
-               || !node->isNodeKeyDecrypted())
+            auto node = nodeList->get(i);
+            if(isAborted() || mSearchCanceled)
+            {
+                break;
+            }
+            if((node->isFile() && !mShowFiles) || megaApi->isInRubbish(node))
             {
                 continue;
             }
-        }
+            else if(mSyncSetupMode)
+            {
+                int access = megaApi->getAccess(node);
+                if(access != mega::MegaShare::ACCESS_FULL && access != mega::MegaShare::ACCESS_OWNER)
+                {
+                    continue;
+                }
+            }
+            else if(!mShowReadOnlyFolders)
+            {
+                if(megaApi->getAccess(node) == mega::MegaShare::ACCESS_READ
+                   || !node->isNodeKeyDecrypted())
+                {
+                    continue;
+                }
+            }
 
-        NodeSelectorModelItemSearch::Types type;
+            NodeSelectorModelItemSearch::Types type;
 
-        if(megaApi->isInCloud(node))
-        {
-            type = NodeSelectorModelItemSearch::Type::CLOUD_DRIVE;
-        }
-        else if(megaApi->isInVault(node))
-        {
-            type = NodeSelectorModelItemSearch::Type::BACKUP;
-        }
-        else
-        {
-            type = NodeSelectorModelItemSearch::Type::INCOMING_SHARE;
-        }
+            if(megaApi->isInCloud(node))
+            {
+                type = NodeSelectorModelItemSearch::Type::CLOUD_DRIVE;
+            }
+            else if(megaApi->isInVault(node))
+            {
+                type = NodeSelectorModelItemSearch::Type::BACKUP;
+            }
+            else
+            {
+                type = NodeSelectorModelItemSearch::Type::INCOMING_SHARE;
+            }
 
-        if(typesAllowed & type)
-        {
-            searchedTypes |= type;
-            auto nodeUptr = std::unique_ptr<mega::MegaNode>(node->copy());
-            auto item = new NodeSelectorModelItemSearch(std::move(nodeUptr), type);
-            items.append(item);
+            if(typesAllowed & type)
+            {
+                searchedTypes |= type;
+                auto nodeUptr = std::unique_ptr<mega::MegaNode>(node->copy());
+                auto item = new NodeSelectorModelItemSearch(std::move(nodeUptr), type);
+                items.append(item);
+            }
         }
     }
 
@@ -179,36 +235,27 @@ void NodeRequester::createIncomingSharesRootItems(std::shared_ptr<mega::MegaNode
             break;
         }
 
-        mega::MegaApi* megaApi = MegaSyncApp->getMegaApi();
         if(mSyncSetupMode)
         {
-            if(megaApi->getAccess(nodeList->get(i)) != mega::MegaShare::ACCESS_FULL)
+            if(NodeTreeSnapshot::instance().getAccess(nodeList->get(i)) != mega::MegaShare::ACCESS_FULL)
             {
                 continue;
             }
         }
         else if(!mShowReadOnlyFolders)
         {
-            if(megaApi->getAccess(nodeList->get(i)) == mega::MegaShare::ACCESS_READ
+            if(NodeTreeSnapshot::instance().getAccess(nodeList->get(i)) == mega::MegaShare::ACCESS_READ
                || !nodeList->get(i)->isNodeKeyDecrypted())
             {
                 continue;
             }
         }
 
+        //The item reads its owner, the model is notified when the owner attributes are ready
         auto node = std::unique_ptr<mega::MegaNode>(nodeList->get(i)->copy());
-        auto user = std::unique_ptr<mega::MegaUser>(megaApi->getUserFromInShare(node.get()));
         NodeSelectorModelItem* item = new NodeSelectorModelItemIncomingShare(std::move(node), mShowFiles);
 
         items.append(item);
-
-        auto incomingSharesModel = dynamic_cast<NodeSelectorModelIncomingShares*>(mModel);
-        if(incomingSharesModel)
-        {
-            item->setProperty(INDEX_PROPERTY, incomingSharesModel->index(0,i));
-            connect(item, &NodeSelectorModelItem::infoUpdated, incomingSharesModel, &NodeSelectorModelIncomingShares::onItemInfoUpdated);
-            item->setOwner(move(user));
-        }
     }
 
     if(isAborted())
@@ -252,12 +299,12 @@ void NodeRequester::onAddNodeRequested(std::shared_ptr<mega::MegaNode> newNode,
 {
     lockDataMutex(true);
     auto childItem = parentItem->addNode(newNode);
+    auto childIndex = mModel->index(parentItem->getNumChildren() -1 ,0, parentIndex);
     lockDataMutex(false);
-    childItem->setProperty(INDEX_PROPERTY, mModel->index(parentItem->getNumChildren() -1 ,0, parentIndex));
 
     if(!isAborted())
     {
-        emit nodeAdded(childItem);
+        emit nodeAdded(childItem, childIndex);
     }
     else
     {
@@ -268,14 +315,14 @@ void NodeRequester::onAddNodeRequested(std::shared_ptr<mega::MegaNode> newNode,
 void NodeRequester::removeItem(NodeSelectorModelItem* item)
 {
     QMutexLocker lock(&mDataMutex);
-    item->deleteLater();
+    delete item;
 }
 
 void NodeRequester::removeRootItem(NodeSelectorModelItem* item)
 {
     QMutexLocker lock(&mDataMutex);
-    item->deleteLater();
     mRootItems.removeOne(item);
+    delete item;
 }
 
 int NodeRequester::rootIndexSize() const
@@ -378,6 +425,7 @@ NodeSelectorModel::NodeSelectorModel(QObject *parent) :
     qRegisterMetaType<std::shared_ptr<mega::MegaNodeList>>("std::shared_ptr<mega::MegaNodeList>");
     qRegisterMetaType<std::shared_ptr<mega::MegaNode>>("std::shared_ptr<mega::MegaNode>");
     qRegisterMetaType<mega::MegaHandle>("mega::MegaHandle");
+    qRegisterMetaType<NodeSelectorModelItem*>("NodeSelectorModelItem*");
 }
 
 NodeSelectorModel::~NodeSelectorModel()
@@ -443,15 +491,15 @@ QVariant NodeSelectorModel::data(const QModelIndex &index, int role) const
             }
             case toInt(NodeSelectorModelRoles::DATE_ROLE):
             {
-                return QVariant::fromValue(item->getNode()->getCreationTime());
+                return QVariant::fromValue(item->getCreationTime());
             }
             case toInt(NodeSelectorModelRoles::IS_FILE_ROLE):
             {
-                return QVariant::fromValue(item->getNode()->isFile());
+                return QVariant::fromValue(item->isFile());
             }
             case toInt(NodeSelectorModelRoles::IS_SYNCABLE_FOLDER_ROLE):
             {
-                return QVariant::fromValue(item->isSyncable() && item->getNode()->isFolder());
+                return QVariant::fromValue(item->isSyncable() && !item->isFile());
             }
             case toInt(NodeSelectorModelRoles::STATUS_ROLE):
             {
@@ -459,9 +507,7 @@ QVariant NodeSelectorModel::data(const QModelIndex &index, int role) const
             }
             case toInt(NodeSelectorModelRoles::HANDLE_ROLE):
             {
-                return QVariant::fromValue(item->getNode() ?
-                                               item->getNode()->getHandle()
-                                             : mega::INVALID_HANDLE);
+                return QVariant::fromValue(item->getHandle());
             }
             case toInt(NodeSelectorModelRoles::MODEL_ITEM_ROLE):
             {
@@ -502,7 +548,7 @@ Qt::ItemFlags NodeSelectorModel::flags(const QModelIndex &index) const
         NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(index.internalPointer());
         if (item)
         {
-            if((mSyncSetupMode && !item->isSyncable()) || (item->getNode() && !item->getNode()->isNodeKeyDecrypted()))
+            if((mSyncSetupMode && !item->isSyncable()) || !item->isNodeKeyDecrypted())
             {
                 flags &= ~(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
             }
@@ -524,7 +570,7 @@ QModelIndex NodeSelectorModel::index(int row, int column, const QModelIndex &par
             NodeSelectorModelItem* item(static_cast<NodeSelectorModelItem*>(parent.internalPointer()));
             if(item)
             {
-                auto data = item->getChild(row).data();
+                auto data = item->getChild(row);
                 if(data)
                 {
                     index =  createIndex(row, column, data);
@@ -601,7 +647,7 @@ bool NodeSelectorModel::hasChildren(const QModelIndex &parent) const
     }
 
     NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(parent.internalPointer());
-    if(item && item->getNode())
+    if(item)
     {
         mNodeRequesterWorker->lockDataMutex(true);
         auto numChild = item->getNumChildren() > 0;
@@ -696,11 +742,10 @@ void NodeSelectorModel::addNode(std::shared_ptr<mega::MegaNode> node, const QMod
     }
 }
 
-void NodeSelectorModel::onNodeAdded(NodeSelectorModelItem* childItem)
+void NodeSelectorModel::onNodeAdded(NodeSelectorModelItem*, const QModelIndex& index)
 {
     endInsertRows();
 
-    auto index = childItem->property(INDEX_PROPERTY).toModelIndex();
     mIndexesActionInfo.indexesToBeExpanded.append(index);
 
     mIndexesActionInfo.needsToBeSelected = true;
@@ -708,9 +753,9 @@ void NodeSelectorModel::onNodeAdded(NodeSelectorModelItem* childItem)
     emit levelsAdded(mIndexesActionInfo.indexesToBeExpanded);
 }
 
-bool NodeSelectorModel::addToLoadingList(const std::shared_ptr<mega::MegaNode> node)
+bool NodeSelectorModel::addToLoadingList(const NodeTreeSnapshot::Folder&)
 {
-    return node != nullptr;
+    return true;
 }
 
 
@@ -720,30 +765,27 @@ void NodeSelectorModel::removeNode(const QModelIndex &index)
     {
         return;
     }
+    //The node may not exist anymore, so the row is found by the handle of the item
     auto item = static_cast<NodeSelectorModelItem*>(index.internalPointer());
     if(item)
     {
-        std::shared_ptr<mega::MegaNode> node = item->getNode();
-        if (node)
+        NodeSelectorModelItem* parent = static_cast<NodeSelectorModelItem*>(index.parent().internalPointer());
+        if(parent)
         {
-            NodeSelectorModelItem* parent = static_cast<NodeSelectorModelItem*>(index.parent().internalPointer());
-            if(parent)
-            {
-                int row = parent->indexOf(item);
-                beginRemoveRows(index.parent(), row, row);
-                mNodeRequesterWorker->lockDataMutex(true);
-                auto itemToRemove = parent->findChildNode(node);
-                mNodeRequesterWorker->lockDataMutex(false);
-                emit removeItem(itemToRemove);
-                endRemoveRows();
-            }
-            else
-            {
-                int row = index.row();
-                beginRemoveRows(index.parent(), row, row);
-                emit removeRootItem(item);
-                endRemoveRows();
-            }
+            int row = parent->indexOf(item);
+            beginRemoveRows(index.parent(), row, row);
+            mNodeRequesterWorker->lockDataMutex(true);
+            auto itemToRemove = parent->findChildNode(item->getHandle());
+            mNodeRequesterWorker->lockDataMutex(false);
+            emit removeItem(itemToRemove);
+            endRemoveRows();
+        }
+        else
+        {
+            int row = index.row();
+            beginRemoveRows(index.parent(), row, row);
+            emit removeRootItem(item);
+            endRemoveRows();
         }
     }
 }
@@ -796,7 +838,7 @@ QVariant NodeSelectorModel::getText(const QModelIndex &index, NodeSelectorModelI
             }
             else
             {
-                return MegaNodeNames::getNodeName(item->getNode().get());
+                return MegaNodeNames::getNodeName(item->getName(), item->isNodeKeyDecrypted());
             }
         }
         case COLUMN::DATE:
@@ -808,7 +850,7 @@ QVariant NodeSelectorModel::getText(const QModelIndex &index, NodeSelectorModelI
 
             const QString language = MegaSyncApp->getCurrentLanguageCode();
             QLocale locale(language);
-            QDateTime dateTime = dateTime.fromSecsSinceEpoch(item->getNode()->getCreationTime());
+            QDateTime dateTime = dateTime.fromSecsSinceEpoch(item->getCreationTime());
             QDateTime currentDate = currentDate.currentDateTime();
             QLatin1String dateFormat ("dd MMM yyyy");
             QString timeFormat = locale.timeFormat(QLocale::ShortFormat);
@@ -870,17 +912,19 @@ void NodeSelectorModel::loadTreeFromNode(const std::shared_ptr<mega::MegaNode> n
     mIndexesActionInfo.needsToBeSelected = true;
 
     mNodesToLoad.clear();
-    mNodesToLoad.append(node);
+    mNodesToLoad.append(node->getHandle());
 
-    auto p_node = std::shared_ptr<mega::MegaNode>(MegaSyncApp->getMegaApi()->getParentNode(node.get()));
+    //The path to the node is taken from the snapshot, only the folders not read yet are asked to the SDK
+    NodeTreeSnapshot::Folder parentFolder;
+    auto parentHandle(node->getParentHandle());
 
     //The vault node is not represented in the node selector, hence if the parent of a node is the vault
     //it doesn´t have to be added to the node list to load. If it is added the loading of a specific node
     //will stops working in backups screen.
-    while(addToLoadingList(p_node))
+    while(NodeTreeSnapshot::instance().getFolder(parentHandle, parentFolder) && addToLoadingList(parentFolder))
     {
-        mNodesToLoad.append(p_node);
-        p_node.reset(MegaSyncApp->getMegaApi()->getParentNode(p_node.get()));
+        mNodesToLoad.append(parentHandle);
+        parentHandle = parentFolder.parent;
     }
 
     if(!fetchMoreRecursively(QModelIndex()))
@@ -895,10 +939,10 @@ bool NodeSelectorModel::fetchMoreRecursively(const QModelIndex& parentIndex)
     auto result(false);
     if(!mNodesToLoad.isEmpty())
     {
-        auto node = mNodesToLoad.last();
-        if(node)
+        auto handle = mNodesToLoad.last();
+        if(handle != mega::INVALID_HANDLE)
         {
-            auto indexToCheck = getIndexFromNode(node, parentIndex);
+            auto indexToCheck = getIndexFromNode(handle, parentIndex);
             if(canFetchMore(indexToCheck))
             {
                 fetchMore(indexToCheck);
@@ -917,19 +961,21 @@ bool NodeSelectorModel::fetchMoreRecursively(const QModelIndex& parentIndex)
 
 QModelIndex NodeSelectorModel::getIndexFromNode(const std::shared_ptr<mega::MegaNode> node, const QModelIndex &parent)
 {
-    if(node)
+    return node ? getIndexFromNode(node->getHandle(), parent) : QModelIndex();
+}
+
+QModelIndex NodeSelectorModel::getIndexFromNode(mega::MegaHandle handle, const QModelIndex &parent)
+{
+    auto childrenCount = rowCount(parent);
+    for(int row = 0; row < childrenCount; ++row)
     {
-        auto childrenCount = rowCount(parent);
-        for(int row = 0; row < childrenCount; ++row)
+        auto indexToCheck = index(row,0,parent);
+        NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(indexToCheck.internalPointer());
+        if(item)
         {
-            auto indexToCheck = index(row,0,parent);
-            NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(indexToCheck.internalPointer());
-            if(item)
+            if(item->getHandle() == handle)
             {
-                if(item->getNode()->getHandle() == node->getHandle())
-                {
-                    return indexToCheck;
-                }
+                return indexToCheck;
             }
         }
     }
@@ -997,9 +1043,8 @@ void NodeSelectorModel::fetchItemChildren(const QModelIndex& parent)
     }
 }
 
-void NodeSelectorModel::onChildNodesReady(NodeSelectorModelItem* parent)
+void NodeSelectorModel::onChildNodesReady(NodeSelectorModelItem*, const QModelIndex& index)
 {
-    auto index = parent->property(INDEX_PROPERTY).value<QModelIndex>();
     mIndexesActionInfo.indexesToBeExpanded.append(index);
     continueWithNextItemToLoad(index);
 }
@@ -1039,7 +1084,7 @@ QModelIndex NodeSelectorModel::findItemByNodeHandle(const mega::MegaHandle& hand
         {
             if(NodeSelectorModelItem* chkItem = static_cast<NodeSelectorModelItem*>(idx.internalPointer()))
             {
-                if(chkItem->getNode()->isFolder() && chkItem->getNode()->getHandle() == handle)
+                if(!chkItem->isFile() && chkItem->getHandle() == handle)
                 {
                     return idx;
                 }
@@ -1066,6 +1111,11 @@ QIcon NodeSelectorModel::getFolderIcon(NodeSelectorModelItem *item) const
 {
     if(item)
     {
+        if(item->isFile())
+        {
+            return Utilities::getExtensionPixmapSmall(item->getName());
+        }
+
         auto node = item->getNode();
 
         if(node)
@@ -2,6 +2,8 @@
 #define NODESELECTORMODEL_H
 
 #include "NodeSelectorModelItem.h"
+#include "NodeTreeSnapshot.h"
+#include "NodeSearchIndex.h"
 #include "Utilities.h"
 #include <megaapi.h>
 
@@ -84,12 +86,12 @@ public slots:
     void abort();
 
 signals:
-     void nodesReady(NodeSelectorModelItem* parent);
+     void nodesReady(NodeSelectorModelItem* parent, const QModelIndex& parentIndex);
      void megaCloudDriveRootItemCreated();
      void megaIncomingSharesRootItemsCreated();
      void megaBackupRootItemsCreated();
      void searchItemsCreated(NodeSelectorModelItemSearch::Types searchedTypes);
-     void nodeAdded(NodeSelectorModelItem* item);
+     void nodeAdded(NodeSelectorModelItem* item, const QModelIndex& index);
 
 private:
      bool isAborted();
@@ -105,6 +107,7 @@ private:
      mutable QMutex mSearchMutex;
      std::shared_ptr<mega::MegaCancelToken> mCancelToken;
      NodeSelectorModelItemSearch::Types mSearchedTypes;
+     NodeSearchIndex::Query mSearchQuery;
 };
 
 class NodeSelectorModel : public QAbstractItemModel
@@ -157,6 +160,7 @@ public:
 
     void loadTreeFromNode(const std::shared_ptr<mega::MegaNode> node);
     QModelIndex getIndexFromNode(const std::shared_ptr<mega::MegaNode> node, const QModelIndex& parent);
+    QModelIndex getIndexFromNode(mega::MegaHandle handle, const QModelIndex& parent);
 
     virtual void firstLoad() = 0;
     void rootItemsLoaded();
@@ -193,16 +197,16 @@ protected:
     bool mSyncSetupMode;
     mutable IndexesActionInfo mIndexesActionInfo;
     NodeRequester* mNodeRequesterWorker;
-    QList<std::shared_ptr<mega::MegaNode>> mNodesToLoad;
+    QList<mega::MegaHandle> mNodesToLoad;
 
 private slots:
-    void onChildNodesReady(NodeSelectorModelItem *parent);
-    void onNodeAdded(NodeSelectorModelItem* childItem);
+    void onChildNodesReady(NodeSelectorModelItem *parent, const QModelIndex& parentIndex);
+    void onNodeAdded(NodeSelectorModelItem* childItem, const QModelIndex& index);
 
 private:
     virtual void createRootNodes() = 0;
     virtual int rootItemsCount() const = 0;
-    virtual bool addToLoadingList(const std::shared_ptr<mega::MegaNode> node);
+    virtual bool addToLoadingList(const NodeTreeSnapshot::Folder& folder);
     void createChildItems(std::shared_ptr<mega::MegaNodeList> childNodes, const QModelIndex& index, NodeSelectorModelItem* parent);
 
     QIcon getFolderIcon(NodeSelectorModelItem* item) const;
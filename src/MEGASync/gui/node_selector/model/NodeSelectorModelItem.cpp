@@ -1,4 +1,5 @@
 #include "NodeSelectorModelItem.h"
+#include "NodeTreeSnapshot.h"
 #include "QMegaMessageBox.h"
 #include "MegaApplication.h"
 #include "syncs/control/SyncInfo.h"
@@ -7,31 +8,169 @@
 
 #include "mega/utils.h"
 
+#include <QCache>
+#include <QMutex>
+
+#include <algorithm>
+
 const int NodeSelectorModelItem::ICON_SIZE = 17;
 
 using namespace mega;
 
+namespace
+{
+const int NODE_CACHE_SIZE = 4096;
+const int POOL_CHUNK_ITEMS = 4096;
+
+//Nodes of the items created or shown recently. Changed nodes are dropped when the SDK reports them
+class NodeCache
+{
+public:
+    NodeCache()
+        : mNodes(NODE_CACHE_SIZE)
+    {
+    }
+
+    std::shared_ptr<MegaNode> find(MegaHandle handle)
+    {
+        {
+            QMutexLocker lock(&mMutex);
+            if(auto node = mNodes.object(handle))
+            {
+                return *node;
+            }
+        }
+
+        auto megaApi(MegaSyncApp->getMegaApi());
+        std::shared_ptr<MegaNode> node(megaApi ? megaApi->getNodeByHandle(handle) : nullptr);
+        if(node)
+        {
+            insert(handle, node);
+        }
+        return node;
+    }
+
+    void insert(MegaHandle handle, std::shared_ptr<MegaNode> node)
+    {
+        QMutexLocker lock(&mMutex);
+        mNodes.insert(handle, new std::shared_ptr<MegaNode>(std::move(node)));
+    }
+
+    void remove(MegaHandle handle)
+    {
+        QMutexLocker lock(&mMutex);
+        mNodes.remove(handle);
+    }
+
+    void clear()
+    {
+        QMutexLocker lock(&mMutex);
+        mNodes.clear();
+    }
+
+private:
+    QMutex mMutex;
+    QCache<MegaHandle, std::shared_ptr<MegaNode>> mNodes;
+};
+
+NodeCache& nodeCache()
+{
+    static NodeCache cache;
+    return cache;
+}
+
+//Fixed size blocks for the items of every class. The chunks are released when there are no items left
+class ItemPool
+{
+public:
+    explicit ItemPool(size_t blockSize)
+        : mBlockSize(blockSize),
+          mFreeBlocks(nullptr),
+          mUsedBlocks(0)
+    {
+    }
+
+    size_t blockSize() const
+    {
+        return mBlockSize;
+    }
+
+    void* allocate()
+    {
+        QMutexLocker lock(&mMutex);
+        if(!mFreeBlocks)
+        {
+            std::unique_ptr<char[]> chunk(new char[mBlockSize * POOL_CHUNK_ITEMS]);
+            for(int i = POOL_CHUNK_ITEMS - 1; i >= 0; --i)
+            {
+                auto block = reinterpret_cast<FreeBlock*>(chunk.get() + mBlockSize * static_cast<size_t>(i));
+                block->next = mFreeBlocks;
+                mFreeBlocks = block;
+            }
+            mChunks.push_back(std::move(chunk));
+        }
+
+        auto block = mFreeBlocks;
+        mFreeBlocks = block->next;
+        mUsedBlocks++;
+        return block;
+    }
+
+    void release(void* item)
+    {
+        QMutexLocker lock(&mMutex);
+        auto block = static_cast<FreeBlock*>(item);
+        block->next = mFreeBlocks;
+        mFreeBlocks = block;
+
+        if(--mUsedBlocks == 0)
+        {
+            mFreeBlocks = nullptr;
+            mChunks.clear();
+        }
+    }
+
+    long long bytes()
+    {
+        QMutexLocker lock(&mMutex);
+        return static_cast<long long>(mChunks.size() * mBlockSize * POOL_CHUNK_ITEMS);
+    }
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    QMutex mMutex;
+    const size_t mBlockSize;
+    FreeBlock* mFreeBlocks;
+    long long mUsedBlocks;
+    std::vector<std::unique_ptr<char[]>> mChunks;
+};
+
+ItemPool& itemPool();
+}
+
 NodeSelectorModelItem::NodeSelectorModelItem(std::unique_ptr<MegaNode> node, bool showFiles, NodeSelectorModelItem *parentItem) :
-    QObject(parentItem),
-    mOwnerEmail(QString()),
+    mHandle(node->getHandle()),
+    mParentItem(parentItem),
+    mName(QString::fromUtf8(node->getName())),
+    mCreationTime(node->getCreationTime()),
+    mChildrenCounter(0),
     mStatus(Status::NONE),
     mRequestingChildren(false),
     mShowFiles(showFiles),
-    mMegaApi(MegaSyncApp->getMegaApi()),
-    mNode(std::move(node)),
-    mOwner(nullptr)
-{ 
-    mChildrenCounter = mShowFiles ? MegaSyncApp->getMegaApi()->getNumChildren(mNode.get())
-            : MegaSyncApp->getMegaApi()->getNumChildFolders(mNode.get());
+    mIsFile(node->isFile()),
+    mNodeKeyDecrypted(node->isNodeKeyDecrypted())
+{
+    mChildrenCounter = static_cast<int>(NodeTreeSnapshot::instance().getNumChildren(node.get(), mShowFiles));
 
     //If it has no children, the item does not need to be init
     mChildrenAreInit = mChildrenCounter > 0 ? false : true;
 
-    if(mNode->isFile() || mNode->isInShare())
-    {
-        mStatus = Status::NONE;
-        return;
-    }
+    //The subclasses read it again to calculate the sync status
+    nodeCache().insert(mHandle, std::shared_ptr<MegaNode>(node.release()));
 }
 
 NodeSelectorModelItem::~NodeSelectorModelItem()
@@ -40,19 +179,86 @@ NodeSelectorModelItem::~NodeSelectorModelItem()
     mChildItems.clear();
 }
 
+void* NodeSelectorModelItem::operator new(size_t size)
+{
+    if(size > itemPool().blockSize())
+    {
+        return ::operator new(size);
+    }
+
+    return itemPool().allocate();
+}
+
+void NodeSelectorModelItem::operator delete(void* item, size_t size)
+{
+    if(size > itemPool().blockSize())
+    {
+        ::operator delete(item);
+    }
+    else if(item)
+    {
+        itemPool().release(item);
+    }
+}
+
+long long NodeSelectorModelItem::getPoolBytes()
+{
+    return itemPool().bytes();
+}
+
+void NodeSelectorModelItem::onNodesUpdate(MegaNodeList* nodes)
+{
+    if(!nodes)
+    {
+        nodeCache().clear();
+        return;
+    }
+
+    for(int i = 0; i < nodes->size(); ++i)
+    {
+        nodeCache().remove(nodes->get(i)->getHandle());
+    }
+}
+
 std::shared_ptr<mega::MegaNode> NodeSelectorModelItem::getNode() const
 {
-    return mNode;
+    return nodeCache().find(mHandle);
 }
 
-void NodeSelectorModelItem::createChildItems(std::unique_ptr<mega::MegaNodeList> nodeList)
+MegaHandle NodeSelectorModelItem::getHandle() const
 {
-    if(!mNode->isFile())
+    return mHandle;
+}
+
+bool NodeSelectorModelItem::isFile() const
+{
+    return mIsFile;
+}
+
+const QString& NodeSelectorModelItem::getName() const
+{
+    return mName;
+}
+
+long long NodeSelectorModelItem::getCreationTime() const
+{
+    return mCreationTime;
+}
+
+bool NodeSelectorModelItem::isNodeKeyDecrypted() const
+{
+    return mNodeKeyDecrypted;
+}
+
+void NodeSelectorModelItem::createChildItems(std::shared_ptr<const mega::MegaNodeList> nodeList)
+{
+    if(!mIsFile)
     {
+        mChildItems.reserve(mChildItems.size() + static_cast<size_t>(nodeList->size()));
         for(int i = 0; i < nodeList->size(); i++)
         {
             auto node = std::unique_ptr<MegaNode>(nodeList->get(i)->copy());
-            mChildItems.append(createModelItem(move(node), mShowFiles, this));
+            mChildItems.push_back(createModelItem(move(node), mShowFiles, this));
         }
 
         mRequestingChildren = false;
@@ -76,7 +282,7 @@ bool NodeSelectorModelItem::canFetchMore()
         return false;
     }
 
-    return mChildItems.isEmpty();
+    return mChildItems.empty();
 }
 
 bool NodeSelectorModelItem::requestingChildren() const
@@ -89,24 +295,24 @@ void NodeSelectorModelItem::setRequestingChildren(bool newRequestingChildren)
     mRequestingChildren = newRequestingChildren;
 }
 
-QPointer<NodeSelectorModelItem> NodeSelectorModelItem::getParent()
+NodeSelectorModelItem* NodeSelectorModelItem::getParent()
 {
-    return dynamic_cast<NodeSelectorModelItem*>(parent());
+    return mParentItem;
 }
 
-QPointer<NodeSelectorModelItem> NodeSelectorModelItem::getChild(int i)
+NodeSelectorModelItem* NodeSelectorModelItem::getChild(int i)
 {
-    if(mChildItems.size() <= i)
+    if(i < 0 || static_cast<int>(mChildItems.size()) <= i)
     {
         return nullptr;
     }
 
-    return mChildItems.at(i);
+    return mChildItems.at(static_cast<size_t>(i));
 }
 
 int NodeSelectorModelItem::getNumChildren()
 {
-    if(mNode->isFile())
+    if(mIsFile)
     {
         return 0;
     }
@@ -115,27 +321,28 @@ int NodeSelectorModelItem::getNumChildren()
         return mChildrenCounter;
     }
 
-    return mChildItems.size();
+    return static_cast<int>(mChildItems.size());
 }
 
 int NodeSelectorModelItem::indexOf(NodeSelectorModelItem* item)
 {
-    return mChildItems.indexOf(item);
+    auto itemIt = std::find(mChildItems.begin(), mChildItems.end(), item);
+    return itemIt != mChildItems.end() ? static_cast<int>(itemIt - mChildItems.begin()) : -1;
 }
 
 QString NodeSelectorModelItem::getOwnerName()
 {
-    if(mFullNameAttribute && mFullNameAttribute->isAttributeReady())
+    if(mOwner && mOwner->fullNameAttribute && mOwner->fullNameAttribute->isAttributeReady())
     {
-        return mFullNameAttribute->getFullName();
+        return mOwner->fullNameAttribute->getFullName();
     }
 
-    return mOwnerEmail;
+    return getOwnerEmail();
 }
 
 QString NodeSelectorModelItem::getOwnerEmail()
 {
-    return mOwnerEmail;
+    return mOwner ? mOwner->email : QString();
 }
 
 void NodeSelectorModelItem::setOwner(std::unique_ptr<mega::MegaUser> user)
@@ -145,43 +352,28 @@ void NodeSelectorModelItem::setOwner(std::unique_ptr<mega::MegaUser> user)
         return;
     }
 
-    mOwner = std::move(user);
-    mOwnerEmail = QString::fromUtf8(mOwner->getEmail());
-    mFullNameAttribute = UserAttributes::FullName::requestFullName(mOwner->getEmail());
-    if(mFullNameAttribute)
-    {
-        connect(mFullNameAttribute.get(), &UserAttributes::FullName::fullNameReady, this, &NodeSelectorModelItem::onFullNameAttributeReady);
-        if(mFullNameAttribute->isAttributeReady())
-        {
-            onFullNameAttributeReady();
-        }
-    }
-    mAvatarAttribute = UserAttributes::Avatar::requestAvatar(mOwner->getEmail());
-    if(mAvatarAttribute)
-    {
-        connect(mAvatarAttribute.get(), &UserAttributes::Avatar::attributeReady, this, &NodeSelectorModelItem::onAvatarAttributeReady);
-        if(mAvatarAttribute->isAttributeReady())
-        {
-            onAvatarAttributeReady();
-        }
-    }
+    mOwner.reset(new Owner());
+    mOwner->user = std::move(user);
+    mOwner->email = QString::fromUtf8(mOwner->user->getEmail());
+    mOwner->fullNameAttribute = UserAttributes::FullName::requestFullName(mOwner->user->getEmail());
+    mOwner->avatarAttribute = UserAttributes::Avatar::requestAvatar(mOwner->user->getEmail());
 }
 
-void NodeSelectorModelItem::onFullNameAttributeReady()
+std::shared_ptr<const UserAttributes::FullName> NodeSelectorModelItem::getOwnerFullNameAttribute() const
 {
-    emit infoUpdated(Qt::DisplayRole);
+    return mOwner ? mOwner->fullNameAttribute : nullptr;
 }
 
-void NodeSelectorModelItem::onAvatarAttributeReady()
+std::shared_ptr<const UserAttributes::Avatar> NodeSelectorModelItem::getOwnerAvatarAttribute() const
 {
-    emit infoUpdated(Qt::DecorationRole);
+    return mOwner ? mOwner->avatarAttribute : nullptr;
 }
 
 QPixmap NodeSelectorModelItem::getOwnerIcon()
 {
-    if(mAvatarAttribute)
+    if(mOwner && mOwner->avatarAttribute)
     {
-        return mAvatarAttribute->getPixmap(ICON_SIZE);
+        return mOwner->avatarAttribute->getPixmap(ICON_SIZE);
     }
 
     return QPixmap();
@@ -191,7 +383,8 @@ QIcon NodeSelectorModelItem::getStatusIcons()
 {
     QIcon statusIcons; //first is selected state icon / second is normal state icon
 
-    if (mNode && !mNode->isNodeKeyDecrypted())
+    auto node = getNode();
+    if (node && !node->isNodeKeyDecrypted())
     {
         statusIcons.addFile(QLatin1String("://images/node_selector/alert-circle-hover.png"), QSize(), QIcon::Selected); //selected style icon
         statusIcons.addFile(QLatin1String("://images/node_selector/alert-circle-default.png"), QSize(), QIcon::Normal); //normal style icon
@@ -235,27 +428,26 @@ bool NodeSelectorModelItem::isSyncable()
             && mStatus != Status::BACKUP;
 }
 
-QPointer<NodeSelectorModelItem> NodeSelectorModelItem::addNode(std::shared_ptr<MegaNode>node)
+NodeSelectorModelItem* NodeSelectorModelItem::addNode(std::shared_ptr<MegaNode>node)
 {
     auto item = createModelItem(std::unique_ptr<MegaNode>(node->copy()), mShowFiles, this);
-    mChildItems.append(item);
+    mChildItems.push_back(item);
     return item;
 }
 
-QPointer<NodeSelectorModelItem> NodeSelectorModelItem::findChildNode(std::shared_ptr<MegaNode> node)
+NodeSelectorModelItem* NodeSelectorModelItem::findChildNode(MegaHandle handle)
 {
     NodeSelectorModelItem* returnNode(nullptr);
 
-    if (node)
+    auto itemIt = std::find_if(mChildItems.begin(), mChildItems.end(), [handle](NodeSelectorModelItem* item)
     {
-        for (int i = 0; i < mChildItems.size(); i++)
-        {
-            if (mChildItems[i]->getNode()->getHandle() == node->getHandle())
-            {
-                returnNode = mChildItems.takeAt(i);
-                break;
-            }
-        }
+        return item->getHandle() == handle;
+    });
+
+    if (itemIt != mChildItems.end())
+    {
+        returnNode = *itemIt;
+        mChildItems.erase(itemIt);
     }
 
     return returnNode;
@@ -270,39 +462,49 @@ int NodeSelectorModelItem::row()
 {
     if (NodeSelectorModelItem* parent = getParent())
     {
-        return parent->mChildItems.indexOf(const_cast<NodeSelectorModelItem*>(this));
+        return parent->indexOf(this);
     }
     return 0;
 }
 
 void NodeSelectorModelItem::updateNode(std::shared_ptr<mega::MegaNode> node)
 {
-    mNode = node;
+    if(node && node->getHandle() == mHandle)
+    {
+        mName = QString::fromUtf8(node->getName());
+        mCreationTime = node->getCreationTime();
+        mNodeKeyDecrypted = node->isNodeKeyDecrypted();
+        nodeCache().insert(mHandle, node);
+    }
 }
 
 void NodeSelectorModelItem::calculateSyncStatus()
 {
+    //Files do not show a sync status
+    auto node = getNode();
+    if(mIsFile || !node)
+    {
+        return;
+    }
+
     //if current item has a parent and the parent is already a sync or a sync_child, current item is also a sync_child
     //if not, continue checking. This avoid to block the mutex in the megaapi call below.
-    if(parent())
+    if(mParentItem)
     {
-        if(auto parent_item = qobject_cast<NodeSelectorModelItem*>(parent()))
+        switch(mParentItem->getStatus())
         {
-            switch(parent_item->getStatus())
-            {
-            case Status::SYNC:
-            case Status::SYNC_CHILD:
-            {
-                mStatus = Status::SYNC_CHILD;
-                return;
-            }
-            default:
-                break;
-            }
+        case Status::SYNC:
+        case Status::SYNC_CHILD:
+        {
+            mStatus = Status::SYNC_CHILD;
+            return;
+        }
+        default:
+            break;
         }
     }
 
-    std::unique_ptr<MegaError> err (MegaSyncApp->getMegaApi()->isNodeSyncableWithError(mNode.get()));
+    std::unique_ptr<MegaError> err (MegaSyncApp->getMegaApi()->isNodeSyncableWithError(node.get()));
     switch(err->getSyncError())
     {
     case mega::MegaSync::Error::ACTIVE_SYNC_ABOVE_PATH:
@@ -322,7 +524,7 @@ void NodeSelectorModelItem::calculateSyncStatus()
     }
     }
     auto syncedFolders = SyncInfo::instance()->getMegaFolderHandles(SyncInfo::AllHandledSyncTypes);
-    if(syncedFolders.contains(mNode->getHandle()))
+    if(syncedFolders.contains(mHandle))
     {
         mStatus = Status::SYNC;
         return;
@@ -331,7 +533,7 @@ void NodeSelectorModelItem::calculateSyncStatus()
 
 bool NodeSelectorModelItem::isCloudDrive()
 {
-    return mNode->getHandle() == MegaSyncApp->getRootNode()->getHandle();
+    return mHandle == MegaSyncApp->getRootNode()->getHandle();
 }
 
 bool NodeSelectorModelItem::isVault()
@@ -347,7 +549,7 @@ NodeSelectorModelItemSearch::NodeSelectorModelItemSearch(std::unique_ptr<mega::M
 
     if(mType & NodeSelectorModelItemSearch::Type::INCOMING_SHARE)
     {
-        auto user = std::unique_ptr<mega::MegaUser>(MegaSyncApp->getMegaApi()->getUserFromInShare(mNode.get(), true));
+        auto user = std::unique_ptr<mega::MegaUser>(MegaSyncApp->getMegaApi()->getUserFromInShare(getNode().get(), true));
         setOwner(move(user));
     }
 
@@ -376,7 +578,7 @@ NodeSelectorModelItemIncomingShare::NodeSelectorModelItemIncomingShare(std::uniq
 {
     if(!parentItem)
     {
-        auto user = std::unique_ptr<mega::MegaUser>(MegaSyncApp->getMegaApi()->getUserFromInShare(node.get()));
+        auto user = std::unique_ptr<mega::MegaUser>(MegaSyncApp->getMegaApi()->getUserFromInShare(getNode().get()));
         setOwner(move(user));
     }
     calculateSyncStatus();
@@ -411,7 +613,7 @@ bool NodeSelectorModelItemBackup::isSyncable()
 bool NodeSelectorModelItemBackup::isVault()
 {
     //if it is a backup item and it doesn´t have parent it is the root node in backups tree
-    return parent() == nullptr;
+    return mParentItem == nullptr;
 }
 
 NodeSelectorModelItem *NodeSelectorModelItemBackup::createModelItem(std::unique_ptr<mega::MegaNode> node, bool showFiles, NodeSelectorModelItem *parentItem)
@@ -434,3 +636,13 @@ NodeSelectorModelItem *NodeSelectorModelItemCloudDrive::createModelItem(std::uni
 {
     return new NodeSelectorModelItemCloudDrive(move(node), showFiles, parentItem);
 }
+
+namespace
+{
+ItemPool& itemPool()
+{
+    static ItemPool pool(std::max({sizeof(NodeSelectorModelItemCloudDrive), sizeof(NodeSelectorModelItemIncomingShare),
+                                   sizeof(NodeSelectorModelItemBackup), sizeof(NodeSelectorModelItemSearch)}));
+    return pool;
+}
+}
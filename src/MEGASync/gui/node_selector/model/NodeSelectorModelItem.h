@@ -1,26 +1,29 @@
 #ifndef MODELSELECTORMODELITEM_H
 #define MODELSELECTORMODELITEM_H
 
-#include <QList>
 #include <QIcon>
+#include <QMetaType>
 
 #include "megaapi.h"
 
 #include <memory>
+#include <vector>
 
 namespace UserAttributes{
 class FullName;
 class Avatar;
 }
 
-class NodeSelectorModelItem : public QObject
+//Items are not QObjects and are allocated from a shared pool, as a large folder may have hundreds of thousands.
+//They keep the handle of their node and the data shown in every row (name, creation time, key state),
+//the node is read again (and cached) only for the other uses.
+//The owner attributes changes are notified by the model, not by the items.
+class NodeSelectorModelItem
 {
-    Q_OBJECT
-
 public:
     static const int ICON_SIZE;
 
-    enum class Status{
+    enum class Status : quint8 {
         SYNC = 0,
         SYNC_PARENT,
         SYNC_CHILD,
@@ -29,30 +32,44 @@ public:
     };
 
     explicit NodeSelectorModelItem(std::unique_ptr<mega::MegaNode> node, bool showFiles, NodeSelectorModelItem *parentItem = 0);
-    ~NodeSelectorModelItem();
+    virtual ~NodeSelectorModelItem();
+
+    static void* operator new(size_t size);
+    static void operator delete(void* item, size_t size);
+    static long long getPoolBytes();
+    //Drops the cached nodes which changed, or all of them if the list is null
+    static void onNodesUpdate(mega::MegaNodeList* nodes);
 
+    //It may be null if the node does not exist anymore
     std::shared_ptr<mega::MegaNode> getNode() const;
+    mega::MegaHandle getHandle() const;
+    bool isFile() const;
+    const QString& getName() const;
+    long long getCreationTime() const;
+    bool isNodeKeyDecrypted() const;
 
-    void createChildItems(std::unique_ptr<mega::MegaNodeList> nodeList);
+    void createChildItems(std::shared_ptr<const mega::MegaNodeList> nodeList);
     bool areChildrenInitialized();
 
     bool canFetchMore();
 
-    QPointer<NodeSelectorModelItem> getParent();
-    QPointer<NodeSelectorModelItem> getChild(int i);
+    NodeSelectorModelItem* getParent();
+    NodeSelectorModelItem* getChild(int i);
     virtual int getNumChildren();
     int indexOf(NodeSelectorModelItem *item);
     QString getOwnerName();
     QString getOwnerEmail();
     void setOwner(std::unique_ptr<mega::MegaUser> user);
+    std::shared_ptr<const UserAttributes::FullName> getOwnerFullNameAttribute() const;
+    std::shared_ptr<const UserAttributes::Avatar> getOwnerAvatarAttribute() const;
     QPixmap getOwnerIcon();
     QIcon getStatusIcons();
     Status getStatus();
     virtual bool isSyncable();
     virtual bool isVault();
     bool isCloudDrive();
-    QPointer<NodeSelectorModelItem> addNode(std::shared_ptr<mega::MegaNode> node);
-    QPointer<NodeSelectorModelItem> findChildNode(std::shared_ptr<mega::MegaNode> node);
+    NodeSelectorModelItem* addNode(std::shared_ptr<mega::MegaNode> node);
+    NodeSelectorModelItem* findChildNode(mega::MegaHandle handle);
     void displayFiles(bool enable);
     void setChatFilesFolder();
     int row();
@@ -61,35 +78,38 @@ public:
     bool requestingChildren() const;
     void setRequestingChildren(bool newRequestingChildren);
 
-signals:
-    void infoUpdated(int role);
-
 protected:
     void calculateSyncStatus();
 
-    QString mOwnerEmail;
+    mega::MegaHandle mHandle;
+    NodeSelectorModelItem* mParentItem;
+    std::vector<NodeSelectorModelItem*> mChildItems;
+    QString mName;
+    long long mCreationTime;
+    int mChildrenCounter;
     Status mStatus;
     bool mRequestingChildren;
-    long long mChildrenCounter;
     bool mShowFiles;
     bool mChildrenAreInit;
-
-    mega::MegaApi* mMegaApi;
-    std::shared_ptr<mega::MegaNode> mNode;
-    QList<QPointer<NodeSelectorModelItem>> mChildItems;
-    std::unique_ptr<mega::MegaUser> mOwner;
-
-private slots:
-    void onFullNameAttributeReady();
-    void onAvatarAttributeReady();
+    bool mIsFile;
+    bool mNodeKeyDecrypted;
 
 private:
+    //Only incoming shares have an owner
+    struct Owner
+    {
+        QString email;
+        std::unique_ptr<mega::MegaUser> user;
+        std::shared_ptr<const UserAttributes::FullName> fullNameAttribute;
+        std::shared_ptr<const UserAttributes::Avatar> avatarAttribute;
+    };
+
     virtual NodeSelectorModelItem* createModelItem(std::unique_ptr<mega::MegaNode> node, bool showFiles, NodeSelectorModelItem *parentItem = 0) = 0;
-    std::shared_ptr<const UserAttributes::FullName> mFullNameAttribute;
-    std::shared_ptr<const UserAttributes::Avatar> mAvatarAttribute;
+    std::unique_ptr<Owner> mOwner;
 };
 
 Q_DECLARE_METATYPE(NodeSelectorModelItem::Status)
+Q_DECLARE_METATYPE(NodeSelectorModelItem*)
 
 class NodeSelectorModelItemCloudDrive : public NodeSelectorModelItem
 {
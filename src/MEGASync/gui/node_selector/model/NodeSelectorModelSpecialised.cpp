@@ -6,6 +6,8 @@
 #include "UserAttributesRequests/CameraUploadFolder.h"
 #include "UserAttributesRequests/MyChatFilesFolder.h"
 #include "UserAttributesRequests/MyBackupsHandle.h"
+#include "UserAttributesRequests/FullName.h"
+#include "UserAttributesRequests/Avatar.h"
 
 #include "mega/types.h"
 
@@ -70,24 +72,33 @@ NodeSelectorModelIncomingShares::NodeSelectorModelIncomingShares(QObject *parent
     mSharedNodeList = std::unique_ptr<MegaNodeList>(megaApi->getInShares());
 }
 
-void NodeSelectorModelIncomingShares::onItemInfoUpdated(int role)
+void NodeSelectorModelIncomingShares::onOwnerFullNameReady()
 {
-    if(NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(sender()))
+    onOwnerInfoUpdated(sender(), Qt::DisplayRole);
+}
+
+void NodeSelectorModelIncomingShares::onOwnerAvatarReady()
+{
+    onOwnerInfoUpdated(sender(), Qt::DecorationRole);
+}
+
+void NodeSelectorModelIncomingShares::onOwnerInfoUpdated(const QObject* ownerAttribute, int role)
+{
+    //The attributes are shared by all the shares of the same owner, so every current root item is checked
+    for(int i = 0; i < rowCount(); ++i)
     {
-        for(int i = 0; i < rowCount(); ++i)
+        QModelIndex idx = index(i, COLUMN::USER); //we only update this column because we retrieve the data in async mode
+        if(idx.isValid())                         //so it is possible that we doesn´t have the information from the start
         {
-            QModelIndex idx = index(i, COLUMN::USER); //we only update this column because we retrieve the data in async mode
-            if(idx.isValid())                         //so it is possible that we doesn´t have the information from the start
+            if(NodeSelectorModelItem* chkItem = static_cast<NodeSelectorModelItem*>(idx.internalPointer()))
             {
-                if(NodeSelectorModelItem* chkItem = static_cast<NodeSelectorModelItem*>(idx.internalPointer()))
+                auto fullName = chkItem->getOwnerFullNameAttribute();
+                auto avatar = chkItem->getOwnerAvatarAttribute();
+                if((fullName && fullName.get() == ownerAttribute) || (avatar && avatar.get() == ownerAttribute))
                 {
-                    if(chkItem == item)
-                    {
-                        QVector<int> roles;
-                        roles.append(role);
-                        emit dataChanged(idx, idx, roles);
-                        break;
-                    }
+                    QVector<int> roles;
+                    roles.append(role);
+                    emit dataChanged(idx, idx, roles);
                 }
             }
         }
@@ -98,6 +109,22 @@ void NodeSelectorModelIncomingShares::onRootItemsCreated()
 {
     rootItemsLoaded();
 
+    for(int i = 0; i < mNodeRequesterWorker->rootIndexSize(); ++i)
+    {
+        auto item = mNodeRequesterWorker->getRootItem(i);
+        //The attributes are shared, so they are connected once even if the root items are created again
+        if(auto fullName = item->getOwnerFullNameAttribute())
+        {
+            connect(fullName.get(), &UserAttributes::FullName::fullNameReady,
+                    this, &NodeSelectorModelIncomingShares::onOwnerFullNameReady, Qt::UniqueConnection);
+        }
+        if(auto avatar = item->getOwnerAvatarAttribute())
+        {
+            connect(avatar.get(), &UserAttributes::Avatar::attributeReady,
+                    this, &NodeSelectorModelIncomingShares::onOwnerAvatarReady, Qt::UniqueConnection);
+        }
+    }
+
     if(!mNodesToLoad.isEmpty())
     {
         auto index = getIndexFromNode(mNodesToLoad.last(), QModelIndex());
@@ -201,9 +228,9 @@ void NodeSelectorModelBackups::onMyBackupsHandleReceived(mega::MegaHandle handle
     }
 }
 
-bool NodeSelectorModelBackups::addToLoadingList(const std::shared_ptr<MegaNode> node)
+bool NodeSelectorModelBackups::addToLoadingList(const NodeTreeSnapshot::Folder& folder)
 {
-    return node && node->getType() != mega::MegaNode::TYPE_VAULT;
+    return folder.type != mega::MegaNode::TYPE_VAULT;
 }
 
 void NodeSelectorModelBackups::loadLevelFinished()
@@ -253,7 +280,7 @@ NodeSelectorModelSearch::NodeSelectorModelSearch(NodeSelectorModelItemSearch::Ty
     : NodeSelectorModel(parent),
       mAllowedTypes(allowedTypes)
 {
-
+    NodeSearchIndex::instance().build();
 }
 
 NodeSelectorModelSearch::~NodeSelectorModelSearch()
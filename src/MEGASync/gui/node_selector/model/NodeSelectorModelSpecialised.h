@@ -45,16 +45,17 @@ public:
     void fetchMore(const QModelIndex &parent) override;
     void firstLoad() override;
 
-public slots:
-    void onItemInfoUpdated(int role);
-
 signals:
     void requestIncomingSharesRootCreation(std::shared_ptr<mega::MegaNodeList> nodes);
 
 private slots:
     void onRootItemsCreated();
+    void onOwnerFullNameReady();
+    void onOwnerAvatarReady();
 
 private:
+    void onOwnerInfoUpdated(const QObject* ownerAttribute, int role);
+
     std::shared_ptr<mega::MegaNodeList> mSharedNodeList;
 };
 
@@ -84,7 +85,7 @@ private slots:
 private:
     std::shared_ptr<mega::MegaNodeList> mBackupsNodeList;
     mega::MegaHandle mBackupsHandle;
-    bool addToLoadingList(const std::shared_ptr<mega::MegaNode> node) override;
+    bool addToLoadingList(const NodeTreeSnapshot::Folder& folder) override;
     void loadLevelFinished() override;
     int mBackupDevicesSize;
 
@@ -5,20 +5,39 @@
 #include "QThread"
 #include <QDebug>
 
+namespace
+{
+QCollator createCollator()
+{
+    QCollator collator;
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    collator.setNumericMode(true);
+    collator.setIgnorePunctuation(false);
+    return collator;
+}
+
+//The shown name changes once the key of the node is decrypted, so both names have their own key
+const quint64 UNDECRYPTED_KEY_BIT = 1ULL << 63;
+
+quint64 sortKeyId(NodeSelectorModelItem* item)
+{
+    return item->isNodeKeyDecrypted() ? item->getHandle() : (item->getHandle() | UNDECRYPTED_KEY_BIT);
+}
+}
+
 NodeSelectorProxyModel::NodeSelectorProxyModel(QObject* parent) :
     QSortFilterProxyModel(parent),
+    mCollator(createCollator()),
+    mSortKeys(mCollator),
     mSortColumn(NodeSelectorModel::NODE),
     mOrder(Qt::AscendingOrder),
     mExpandMapped(true),
     mForceInvalidate(false)
 {
-    mCollator.setCaseSensitivity(Qt::CaseInsensitive);
-    mCollator.setNumericMode(true);
-    mCollator.setIgnorePunctuation(false);
-
     connect(&mFilterWatcher, &QFutureWatcher<void>::finished,
             this, &NodeSelectorProxyModel::onModelSortedFiltered);
-
+    connect(MegaSyncApp, &MegaApplication::nodeAttributesChanged,
+            this, &NodeSelectorProxyModel::onNodeAttributesChanged);
 }
 
 NodeSelectorProxyModel::~NodeSelectorProxyModel()
@@ -42,6 +61,10 @@ void NodeSelectorProxyModel::sort(int column, Qt::SortOrder order)
             {
                 blockSignals(true);
                 sourceModel()->blockSignals(true);
+                if(column == NodeSelectorModel::NODE)
+                {
+                    buildSortKeys();
+                }
                 invalidateFilter();
                 QSortFilterProxyModel::sort(column, order);
                 for (auto it = mItemsToMap.crbegin(); it != mItemsToMap.crend(); ++it)
@@ -168,6 +191,16 @@ bool NodeSelectorProxyModel::lessThan(const QModelIndex &left, const QModelIndex
         return mCollator.compare(left.data(Qt::ToolTipRole).toString(),
                                  right.data(Qt::ToolTipRole).toString()) < 0;
     }
+    if(left.column() == NodeSelectorModel::NODE && right.column() == NodeSelectorModel::NODE)
+    {
+        auto lItem = static_cast<NodeSelectorModelItem*>(left.internalPointer());
+        auto rItem = static_cast<NodeSelectorModelItem*>(right.internalPointer());
+        if(lItem && rItem)
+        {
+            return mSortKeys.compare(sortKeyId(lItem), [&left](){ return left.data(Qt::DisplayRole).toString(); },
+                                     sortKeyId(rItem), [&right](){ return right.data(Qt::DisplayRole).toString(); }) < 0;
+        }
+    }
 
 
     return mCollator.compare(left.data(Qt::DisplayRole).toString(),
@@ -177,10 +210,13 @@ bool NodeSelectorProxyModel::lessThan(const QModelIndex &left, const QModelIndex
 void NodeSelectorProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
     QSortFilterProxyModel::setSourceModel(sourceModel);
+    mSortKeys.clear();
 
     if(auto nodeSelectorModel = dynamic_cast<NodeSelectorModel*>(sourceModel))
     {
         connect(nodeSelectorModel, &NodeSelectorModel::levelsAdded, this, &NodeSelectorProxyModel::invalidateModel);
+        connect(nodeSelectorModel, &NodeSelectorModel::rowsAboutToBeRemoved, this, &NodeSelectorProxyModel::onSourceRowsAboutToBeRemoved);
+        connect(nodeSelectorModel, &NodeSelectorModel::modelReset, this, &NodeSelectorProxyModel::clearSortKeys);
         nodeSelectorModel->firstLoad();
     }
 }
@@ -198,7 +234,7 @@ QVector<QModelIndex> NodeSelectorProxyModel::forEach(std::shared_ptr<mega::MegaN
 
             if(NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(index.internalPointer()))
             {
-                if(handle == item->getNode()->getHandle())
+                if(handle == item->getHandle())
                 {
                     ret.append(mapFromSource(index));
 
@@ -241,6 +277,34 @@ QModelIndex NodeSelectorProxyModel::getIndexFromNode(const std::shared_ptr<mega:
     return QModelIndex();
 }
 
+//Keys of the rows sorted now, computed in parallel. Other keys are computed when they are compared
+void NodeSelectorProxyModel::buildSortKeys()
+{
+    QModelIndexList parents(mItemsToMap);
+    parents.append(QModelIndex());
+
+    QVector<quint64> handles;
+    QModelIndexList indexes;
+    for(const auto& parent : parents)
+    {
+        auto rows = sourceModel()->rowCount(parent);
+        for(int row = 0; row < rows; ++row)
+        {
+            auto index = sourceModel()->index(row, NodeSelectorModel::NODE, parent);
+            if(NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(index.internalPointer()))
+            {
+                handles.append(sortKeyId(item));
+                indexes.append(index);
+            }
+        }
+    }
+
+    mSortKeys.build(handles, [&indexes](int position)
+    {
+        return indexes.at(position).data(Qt::DisplayRole).toString();
+    });
+}
+
 NodeSelectorModel *NodeSelectorProxyModel::getMegaModel()
 {
     return dynamic_cast<NodeSelectorModel*>(sourceModel());
@@ -251,6 +315,25 @@ bool NodeSelectorProxyModel::isModelProcessing() const
     return mFilterWatcher.isRunning();
 }
 
+void NodeSelectorProxyModel::clearSortKeys()
+{
+    mSortKeys.clear();
+}
+
+//Keys of the item and of its loaded descendants, under both names
+void NodeSelectorProxyModel::removeSortKeys(NodeSelectorModelItem* item)
+{
+    mSortKeys.remove(item->getHandle());
+    mSortKeys.remove(item->getHandle() | UNDECRYPTED_KEY_BIT);
+    for(int i = 0; i < item->getNumChildren(); ++i)
+    {
+        if(NodeSelectorModelItem* child = item->getChild(i))
+        {
+            removeSortKeys(child);
+        }
+    }
+}
+
 bool NodeSelectorProxyModel::canBeDeleted() const
 {
     return dynamic_cast<NodeSelectorModel*>(sourceModel())->canBeDeleted();
@@ -263,6 +346,24 @@ void NodeSelectorProxyModel::invalidateModel(const QModelIndexList& parents, boo
     sort(mSortColumn, mOrder);
 }
 
+void NodeSelectorProxyModel::onNodeAttributesChanged(mega::MegaHandle handle)
+{
+    mSortKeys.remove(handle);
+    mSortKeys.remove(handle | UNDECRYPTED_KEY_BIT);
+}
+
+void NodeSelectorProxyModel::onSourceRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last)
+{
+    for(int row = first; row <= last; ++row)
+    {
+        auto index = sourceModel()->index(row, NodeSelectorModel::NODE, parent);
+        if(NodeSelectorModelItem* item = static_cast<NodeSelectorModelItem*>(index.internalPointer()))
+        {
+            removeSortKeys(item);
+        }
+    }
+}
+
 void NodeSelectorProxyModel::onModelSortedFiltered()
 {
     if(mForceInvalidate)
@@ -3,6 +3,7 @@
 
 #include "megaapi.h"
 #include "NodeSelectorModelItem.h"
+#include "CollationKeyCache.h"
 
 #include <QSortFilterProxyModel>
 #include <QCollator>
@@ -40,6 +41,8 @@ public:
     void setExpandMapped(bool value){mExpandMapped = value;}
     NodeSelectorModel* getMegaModel();
     bool isModelProcessing() const;
+    //Names of the nodes whose key is not decrypted are translated, so their keys are outdated on a language change
+    void clearSortKeys();
 
     virtual bool canBeDeleted() const;
 
@@ -50,7 +53,12 @@ signals:
 
 private:
     QVector<QModelIndex> forEach(std::shared_ptr<mega::MegaNodeList> parentNodeList, QModelIndex parent = QModelIndex());
+    void buildSortKeys();
+    void removeSortKeys(NodeSelectorModelItem* item);
     QCollator mCollator;
+    //Names are sorted by key, by node handle and whether the key of the node is decrypted. Keys of renamed
+    //nodes are removed when their attributes change, and the ones of removed rows when they are removed
+    mutable CollationKeyCache mSortKeys;
     int mSortColumn;
     Qt::SortOrder mOrder;
     QFutureWatcher<void> mFilterWatcher;
@@ -60,6 +68,8 @@ private:
 
 private slots:
     void invalidateModel(const QModelIndexList &parents, bool force = false);
+    void onNodeAttributesChanged(mega::MegaHandle handle);
+    void onSourceRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
     void onModelSortedFiltered();
 };
 
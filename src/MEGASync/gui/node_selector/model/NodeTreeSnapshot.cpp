@@ -0,0 +1,293 @@
+#include "NodeTreeSnapshot.h"
+#include "MegaApplication.h"
+
+#include <QSet>
+
+using namespace mega;
+
+NodeTreeSnapshot::NodeTreeSnapshot()
+    : mGeneration(0)
+{
+}
+
+bool NodeTreeSnapshot::getFolder(MegaNode* node, Folder& folder)
+{
+    if(!isFolder(node))
+    {
+        return false;
+    }
+
+    return find(node->getHandle(), folder) || readFolder(node, folder);
+}
+
+bool NodeTreeSnapshot::getFolder(MegaHandle handle, Folder& folder)
+{
+    if(handle == INVALID_HANDLE)
+    {
+        return false;
+    }
+
+    if(find(handle, folder))
+    {
+        return true;
+    }
+
+    std::unique_ptr<MegaNode> node(MegaSyncApp->getMegaApi()->getNodeByHandle(handle));
+    return getFolder(node.get(), folder);
+}
+
+long long NodeTreeSnapshot::getNumChildren(MegaNode* node, bool withFiles)
+{
+    auto generation(mGeneration.load());
+    Folder folder;
+    if(!getFolder(node, folder))
+    {
+        return 0;
+    }
+
+    int count(withFiles ? folder.children : folder.childFolders);
+    if(count == NOT_READ)
+    {
+        auto megaApi(MegaSyncApp->getMegaApi());
+        if(!megaApi)
+        {
+            return 0;
+        }
+
+        count = withFiles ? megaApi->getNumChildren(node) : megaApi->getNumChildFolders(node);
+        updateFolder(node->getHandle(), generation, [withFiles, count](Folder& cachedFolder)
+        {
+            if(withFiles)
+            {
+                cachedFolder.children = count;
+            }
+            else
+            {
+                cachedFolder.childFolders = count;
+            }
+        });
+    }
+
+    return count;
+}
+
+int NodeTreeSnapshot::getAccess(MegaNode* node)
+{
+    auto generation(mGeneration.load());
+    Folder folder;
+    bool known(getFolder(node, folder));
+    if(known && folder.access != NOT_READ)
+    {
+        return folder.access;
+    }
+
+    auto megaApi(MegaSyncApp->getMegaApi());
+    if(!node || !megaApi)
+    {
+        return MegaShare::ACCESS_UNKNOWN;
+    }
+
+    int access(megaApi->getAccess(node));
+    if(known)
+    {
+        updateFolder(node->getHandle(), generation, [access](Folder& cachedFolder)
+        {
+            cachedFolder.access = access;
+        });
+    }
+    return access;
+}
+
+std::shared_ptr<const MegaNodeList> NodeTreeSnapshot::getChildren(MegaNode* node, bool withFiles, MegaCancelToken* cancelToken)
+{
+    auto generation(mGeneration.load());
+    Folder folder;
+    if(getFolder(node, folder))
+    {
+        auto children(withFiles ? folder.childNodes : folder.childFolderNodes);
+        if(children)
+        {
+            return children;
+        }
+    }
+
+    auto megaApi(MegaSyncApp->getMegaApi());
+    if(!isFolder(node) || !megaApi)
+    {
+        return std::shared_ptr<const MegaNodeList>(MegaNodeList::createInstance());
+    }
+
+    std::shared_ptr<const MegaNodeList> children(withFiles ?
+        megaApi->getChildren(node, MegaApi::ORDER_NONE, cancelToken)
+      : megaApi->getChildrenFromType(node, MegaNode::TYPE_FOLDER, MegaApi::ORDER_NONE, cancelToken));
+
+    //A cancelled listing may be incomplete. Children listed before a node update may be outdated
+    if((!cancelToken || !cancelToken->isCancelled()) && generation == mGeneration)
+    {
+        updateChildren(node, children, withFiles);
+    }
+    return children;
+}
+
+void NodeTreeSnapshot::updateChildren(MegaNode* node, std::shared_ptr<const MegaNodeList> children, bool withFiles)
+{
+    if(!isFolder(node) || !children)
+    {
+        return;
+    }
+
+    int childFolders(0);
+    for(int i = 0; i < children->size(); ++i)
+    {
+        if(children->get(i)->isFolder())
+        {
+            childFolders++;
+        }
+    }
+
+    QWriteLocker lock(&mLock);
+    auto folderIt = mFolders.find(node->getHandle());
+    if(folderIt != mFolders.end())
+    {
+        folderIt->childFolders = childFolders;
+        if(withFiles)
+        {
+            folderIt->children = children->size();
+            folderIt->childNodes = children;
+        }
+        else
+        {
+            folderIt->childFolderNodes = children;
+        }
+    }
+}
+
+void NodeTreeSnapshot::onNodesUpdate(MegaNodeList* nodes)
+{
+    //A null list means that the whole tree may have changed
+    if(!nodes)
+    {
+        reset();
+        return;
+    }
+
+    QWriteLocker lock(&mLock);
+    mGeneration++;
+
+    QSet<MegaHandle> outdatedFolders;
+    QSet<MegaHandle> outdatedChildren;
+    for(int i = 0; i < nodes->size(); ++i)
+    {
+        auto node(nodes->get(i));
+        auto handle(node->getHandle());
+        auto changes(node->getChanges());
+
+        //The listed children keep a copy of each node, which is outdated by any change
+        outdatedChildren.insert(node->getParentHandle());
+
+        auto folderIt = mFolders.find(handle);
+        if(changes & (MegaNode::CHANGE_TYPE_NEW | MegaNode::CHANGE_TYPE_REMOVED | MegaNode::CHANGE_TYPE_PARENT))
+        {
+            //The child counts of the old and the new parent are read again when they are needed
+            outdatedFolders.insert(node->getParentHandle());
+            if(folderIt != mFolders.end())
+            {
+                outdatedFolders.insert(folderIt->parent);
+                if(changes & MegaNode::CHANGE_TYPE_REMOVED)
+                {
+                    outdatedFolders.insert(handle);
+                }
+                else
+                {
+                    folderIt->parent = node->getParentHandle();
+                }
+            }
+        }
+        else if(folderIt != mFolders.end())
+        {
+            if(changes & (MegaNode::CHANGE_TYPE_INSHARE | MegaNode::CHANGE_TYPE_OUTSHARE))
+            {
+                outdatedFolders.insert(handle);
+            }
+            else if(changes & MegaNode::CHANGE_TYPE_ATTRIBUTES)
+            {
+                folderIt->name = QString::fromUtf8(node->getName());
+            }
+        }
+    }
+
+    foreach(auto handle, outdatedFolders)
+    {
+        mFolders.remove(handle);
+    }
+
+    foreach(auto handle, outdatedChildren)
+    {
+        auto folderIt = mFolders.find(handle);
+        if(folderIt != mFolders.end())
+        {
+            folderIt->childFolderNodes.reset();
+            folderIt->childNodes.reset();
+        }
+    }
+}
+
+void NodeTreeSnapshot::reset()
+{
+    QWriteLocker lock(&mLock);
+    mGeneration++;
+    mFolders.clear();
+}
+
+int NodeTreeSnapshot::size() const
+{
+    QReadLocker lock(&mLock);
+    return mFolders.size();
+}
+
+bool NodeTreeSnapshot::find(MegaHandle handle, Folder& folder) const
+{
+    QReadLocker lock(&mLock);
+    auto folderIt = mFolders.constFind(handle);
+    if(folderIt != mFolders.constEnd())
+    {
+        folder = folderIt.value();
+        return true;
+    }
+
+    return false;
+}
+
+bool NodeTreeSnapshot::readFolder(MegaNode* node, Folder& folder)
+{
+    //Only what the node already has: the SDK is asked for the rest when it is needed
+    auto generation(mGeneration.load());
+    folder = Folder();
+    folder.parent = node->getParentHandle();
+    folder.type = node->getType();
+    folder.name = QString::fromUtf8(node->getName());
+
+    QWriteLocker lock(&mLock);
+    if(generation == mGeneration)
+    {
+        mFolders.insert(node->getHandle(), folder);
+    }
+
+    return true;
+}
+
+template <typename Update>
+void NodeTreeSnapshot::updateFolder(MegaHandle handle, unsigned long long generation, Update update)
+{
+    QWriteLocker lock(&mLock);
+    auto folderIt = mFolders.find(handle);
+    if(generation == mGeneration && folderIt != mFolders.end())
+    {
+        update(folderIt.value());
+    }
+}
+
+bool NodeTreeSnapshot::isFolder(MegaNode* node)
+{
+    return node && node->getType() >= MegaNode::TYPE_FOLDER;
+}
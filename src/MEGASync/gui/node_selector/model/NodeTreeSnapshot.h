@@ -0,0 +1,75 @@
+#ifndef NODETREESNAPSHOT_H
+#define NODETREESNAPSHOT_H
+
+#include "megaapi.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+
+//Folders already read from the SDK by any node selector, shared by all of them.
+//A folder is read from the SDK the first time it is needed and it is kept until a node update changes it,
+//so opening again a node selector, expanding a folder already listed or loading the path to a node
+//does not need to ask the SDK again.
+class NodeTreeSnapshot
+{
+public:
+    //Access and child counts are asked to the SDK the first time they are needed, one call each
+    static const int NOT_READ = -2;
+
+    struct Folder
+    {
+        mega::MegaHandle parent = mega::INVALID_HANDLE;
+        int type = mega::MegaNode::TYPE_UNKNOWN;
+        int access = NOT_READ;
+        QString name;
+        int childFolders = NOT_READ;
+        int children = NOT_READ;
+        //Child nodes as listed by the SDK, null until a node selector lists them
+        std::shared_ptr<const mega::MegaNodeList> childFolderNodes;
+        std::shared_ptr<const mega::MegaNodeList> childNodes;
+    };
+
+    static NodeTreeSnapshot& instance()
+    {
+        static NodeTreeSnapshot instance;
+        return instance;
+    }
+
+    //They return false if the folder does not exist
+    bool getFolder(mega::MegaNode* node, Folder& folder);
+    bool getFolder(mega::MegaHandle handle, Folder& folder);
+
+    long long getNumChildren(mega::MegaNode* node, bool withFiles);
+    int getAccess(mega::MegaNode* node);
+
+    //Children of the folder, listed by the SDK only if they are not in the snapshot yet. Never null
+    std::shared_ptr<const mega::MegaNodeList> getChildren(mega::MegaNode* node, bool withFiles,
+                                                          mega::MegaCancelToken* cancelToken = nullptr);
+    //Keeps the children just read from the SDK, and their counts
+    void updateChildren(mega::MegaNode* node, std::shared_ptr<const mega::MegaNodeList> children, bool withFiles);
+
+    void onNodesUpdate(mega::MegaNodeList* nodes);
+    void reset();
+
+    int size() const;
+
+private:
+    NodeTreeSnapshot();
+
+    bool find(mega::MegaHandle handle, Folder& folder) const;
+    bool readFolder(mega::MegaNode* node, Folder& folder);
+    template <typename Update>
+    void updateFolder(mega::MegaHandle handle, unsigned long long generation, Update update);
+    static bool isFolder(mega::MegaNode* node);
+
+    mutable QReadWriteLock mLock;
+    QHash<mega::MegaHandle, Folder> mFolders;
+    //Folders read before a node update are not stored, as they may be outdated
+    std::atomic<unsigned long long> mGeneration;
+};
+
+#endif // NODETREESNAPSHOT_H
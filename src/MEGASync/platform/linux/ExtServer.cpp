@@ -6,10 +6,16 @@
 #include "CommonMessages.h"
 #include "control/Utilities.h"
 
+#include <QtConcurrent/QtConcurrent>
+#include <QFutureWatcher>
+#include <QPointer>
+
 using namespace mega;
 using namespace std;
 
 constexpr char ASCII_FILE_SEP = 0x1C;
+constexpr char ASCII_RECORD_SEP = 0x1E;
+constexpr char OP_PATH_STATE_BATCH = 'B';
 constexpr int  BUFSIZE = 1024;
 constexpr char RESPONSE_DEFAULT[] = "9";
 constexpr char RESPONSE_ERROR[]   = "0";
@@ -23,6 +29,7 @@ ExtServer::ExtServer(MegaApplication *app): QObject(),
     connect(this, SIGNAL(newUploadQueue(QQueue<QString>)), app, SLOT(shellUpload(QQueue<QString>)),Qt::QueuedConnection);
     connect(this, SIGNAL(newExportQueue(QQueue<QString>)), app, SLOT(shellExport(QQueue<QString>)),Qt::QueuedConnection);
     connect(this, SIGNAL(viewOnMega(QByteArray, bool)), app, SLOT(shellViewOnMega(QByteArray, bool)), Qt::QueuedConnection);
+    connect(this, SIGNAL(pathStateChanged(QByteArray)), this, SLOT(onPathStateChanged(QByteArray)), Qt::QueuedConnection);
 
 
     // construct local socket path
@@ -81,6 +88,7 @@ void ExtServer::onClientDisconnected()
     if (!client)
         return;
     m_clients.removeAll(client);
+    mClientsWaitingForBatch.remove(client);
     client->deleteLater();
 
     //LOG_debug << "Client disconnected";
@@ -98,21 +106,169 @@ void ExtServer::onClientData()
         return;
     }
 
+    readClientRequests(client);
+}
+
+void ExtServer::readClientRequests(QLocalSocket *client)
+{
     static thread_local char buf[BUFSIZE] = {'\0'};
     qint64 count;
-    do
+    char op;
+
+    // answers are written in the same order as the requests were received
+    while (!mClientsWaitingForBatch.contains(client) && client->peek(&op, 1) == 1)
     {
-        count = client->readLine(buf, sizeof(buf));
-        if (count > 0)
+        if (op == OP_PATH_STATE_BATCH)
         {
-            const char *out = GetAnswerToRequest(buf);
-            if (out) {
-                client->write(out);
-                client->write("\n");
+            // batches can be longer than BUFSIZE and end with a new line
+            if (!client->canReadLine())
+            {
+                return;
             }
-            std::fill_n(buf, count, '\0');
+            requestPathStates(client, client->readLine());
+            continue;
         }
-    } while (count > 0);
+
+        count = client->readLine(buf, sizeof(buf));
+        if (count <= 0)
+        {
+            return;
+        }
+
+        const char *out = GetAnswerToRequest(buf);
+        if (out) {
+            client->write(out);
+            client->write("\n");
+        }
+        std::fill_n(buf, count, '\0');
+    }
+}
+
+// B:<path1><ASCII_FILE_SEP><0|1><ASCII_RECORD_SEP><path2>...
+// The answer has one state per path, in the same order, computed out of the GUI thread
+void ExtServer::requestPathStates(QLocalSocket *client, const QByteArray& request)
+{
+    QByteArray content = request.mid(2);
+    if (content.endsWith('\n'))
+    {
+        content.chop(1);
+    }
+
+    bool overlayIconsDisabled = Preferences::instance()->overlayIconsDisabled();
+    QByteArray states;
+    QList<int> uncachedIndexes;
+    QList<QByteArray> uncachedPaths;
+    for (const QByteArray& entry : content.split(ASCII_RECORD_SEP))
+    {
+        int possep = entry.indexOf(ASCII_FILE_SEP);
+        bool forceGetState = possep != -1
+                             && (possep + 1) < entry.size()
+                             && entry.at(possep + 1) == '1';
+
+        QByteArray path = entry.left(possep);
+        int state = MegaApi::STATE_NONE;
+        if ((forceGetState || !overlayIconsDisabled) && !path.isEmpty()
+                && !mPathStates.find(path, state))
+        {
+            uncachedIndexes.append(states.size());
+            uncachedPaths.append(path);
+        }
+        states.append(getPathStateResponse(state));
+    }
+
+    if (uncachedPaths.isEmpty())
+    {
+        client->write(states);
+        client->write("\n");
+        return;
+    }
+
+    mClientsWaitingForBatch.insert(client);
+
+    QPointer<QLocalSocket> clientPtr(client);
+    quint64 generation = mPathStates.generation();
+    auto watcher = new QFutureWatcher<QVector<int>>(this);
+    connect(watcher, &QFutureWatcher<QVector<int>>::finished, this,
+            [this, clientPtr, watcher, generation, states, uncachedIndexes, uncachedPaths]() mutable
+    {
+        watcher->deleteLater();
+
+        QVector<int> uncachedStates = watcher->result();
+        for (int i = 0; i < uncachedStates.size(); i++)
+        {
+            mPathStates.insert(uncachedPaths.at(i), uncachedStates.at(i), generation);
+            states[uncachedIndexes.at(i)] = getPathStateResponse(uncachedStates.at(i))[0];
+        }
+
+        if (!clientPtr || !mClientsWaitingForBatch.remove(clientPtr))
+        {
+            return;
+        }
+
+        clientPtr->write(states);
+        clientPtr->write("\n");
+        readClientRequests(clientPtr);
+    });
+    watcher->setFuture(QtConcurrent::run(&ExtServer::getSyncPathStates, MegaSyncApp->getMegaApi(), uncachedPaths));
+}
+
+QVector<int> ExtServer::getSyncPathStates(MegaApi *megaApi, const QList<QByteArray>& paths)
+{
+    QVector<int> states;
+    states.reserve(paths.size());
+    for (const QByteArray& path : paths)
+    {
+        string spath(path.constData(), static_cast<size_t>(path.size()));
+        states.append(megaApi->syncPathState(&spath));
+    }
+    return states;
+}
+
+int ExtServer::getSyncPathState(const string& path)
+{
+    QByteArray key(path.data(), static_cast<int>(path.size()));
+    int state = MegaApi::STATE_NONE;
+    if (!mPathStates.find(key, state))
+    {
+        string spath(path);
+        state = MegaSyncApp->getMegaApi()->syncPathState(&spath);
+        mPathStates.insert(key, state, mPathStates.generation());
+    }
+    return state;
+}
+
+void ExtServer::invalidatePathState(const QByteArray& path)
+{
+    emit pathStateChanged(path);
+}
+
+void ExtServer::onPathStateChanged(QByteArray path)
+{
+    mPathStates.invalidate(path);
+}
+
+void ExtServer::clearPathStates()
+{
+    MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Shell extension path state cache: %1 hits, %2 misses")
+                 .arg(mPathStates.hits()).arg(mPathStates.misses()).toUtf8().constData());
+    mPathStates.clear();
+}
+
+const char *ExtServer::getPathStateResponse(int state)
+{
+    switch(state)
+    {
+        case MegaApi::STATE_SYNCED:
+            return RESPONSE_SYNCED;
+        case MegaApi::STATE_SYNCING:
+            return RESPONSE_SYNCING;
+        case MegaApi::STATE_PENDING:
+            return RESPONSE_PENDING;
+        case MegaApi::STATE_NONE:
+        case MegaApi::STATE_IGNORED:
+        default:
+            return RESPONSE_DEFAULT;
+    }
 }
 
 // parse incoming request and send response back to client
@@ -200,27 +356,12 @@ const char *ExtServer::GetAnswerToRequest(const char *buf)
                 }
                 if (!scontent.empty())
                 {
-                    state = MegaSyncApp->getMegaApi()->syncPathState(&scontent);
+                    state = getSyncPathState(scontent);
                     mLastPath = scontent;
                 }
             }
 
-            switch(state)
-            {
-                case MegaApi::STATE_SYNCED:
-                    strncpy(out, RESPONSE_SYNCED, BUFSIZE);
-                    break;
-                case MegaApi::STATE_SYNCING:
-                    strncpy(out, RESPONSE_SYNCING, BUFSIZE);
-                    break;
-                case MegaApi::STATE_PENDING:
-                    strncpy(out, RESPONSE_PENDING, BUFSIZE);
-                    break;
-                case MegaApi::STATE_NONE:
-                case MegaApi::STATE_IGNORED:
-                default:
-                    strncpy(out, RESPONSE_DEFAULT, BUFSIZE);
-            }
+            strncpy(out, getPathStateResponse(state), BUFSIZE);
             break;
         }
         case 'E':
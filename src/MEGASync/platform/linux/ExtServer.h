@@ -4,6 +4,10 @@
 #include "MegaApplication.h"
 #include "megaapi.h"
 #include "control/Preferences.h"
+#include "PathStateCache.h"
+
+#include <QSet>
+#include <QVector>
 
 typedef enum {
    STRING_UPLOAD = 0,
@@ -22,6 +26,11 @@ class ExtServer: public QObject
     ExtServer(MegaApplication *app);
     virtual ~ExtServer();
 
+    // called for the paths notified by the NotifyServer, from any thread.
+    // The entry is dropped in the thread of the ExtServer
+    void invalidatePathState(const QByteArray& path);
+    void clearPathStates();
+
  protected:
     QLocalServer *m_localServer;
     QQueue<QString> uploadQueue;
@@ -31,11 +40,20 @@ class ExtServer: public QObject
     void acceptConnection();
     void onClientData();
     void onClientDisconnected();
+    void onPathStateChanged(QByteArray path);
  private:
     QString sockPath;
     QList<QLocalSocket *> m_clients;
+    //Clients waiting for a path state batch. Their next requests are read once it is answered
+    QSet<QLocalSocket *> mClientsWaitingForBatch;
     std::string mLastPath;
+    PathStateCache mPathStates;
 
+    void readClientRequests(QLocalSocket *client);
+    void requestPathStates(QLocalSocket *client, const QByteArray& request);
+    static QVector<int> getSyncPathStates(mega::MegaApi *megaApi, const QList<QByteArray>& paths);
+    int getSyncPathState(const std::string& path);
+    static const char *getPathStateResponse(int state);
     const char *GetAnswerToRequest(const char *buf);
     QString getActionName(const int actionId);
 
@@ -47,6 +65,7 @@ class ExtServer: public QObject
     void newUploadQueue(QQueue<QString> uploadQueue);
     void newExportQueue(QQueue<QString> exportQueue);
     void viewOnMega(QByteArray path, bool versions);
+    void pathStateChanged(QByteArray path);
 };
 
 #endif
@@ -7,9 +7,18 @@
 using namespace mega;
 using namespace std;
 
+constexpr int NOTIFY_INTERVAL_MS = 100;
+// from this number of changed items in the same folder, clients are asked to refresh the whole folder
+constexpr int FOLDER_REFRESH_THRESHOLD = 32;
+
 NotifyServer::NotifyServer(): QObject(),
-    m_localServer(0)
+    m_localServer(0),
+    mCoalescedItemChanges(0)
 {
+    mItemChangesTimer.setSingleShot(true);
+    mItemChangesTimer.setInterval(NOTIFY_INTERVAL_MS);
+    connect(&mItemChangesTimer, &QTimer::timeout, this, &NotifyServer::sendItemChanges);
+
     // construct local socket path
     sockPath = MegaApplication::applicationDataPath() + QDir::separator() + QString::fromAscii("notify.socket");
 
@@ -28,6 +37,7 @@ NotifyServer::NotifyServer(): QObject(),
     }
 
     connect(this, SIGNAL(sendToAll(const char *, QByteArray)), this, SLOT(doSendToAll(const char *, QByteArray)));
+    connect(this, SIGNAL(itemChanged(QByteArray)), this, SLOT(queueItemChange(QByteArray)));
     connect(m_localServer, SIGNAL(newConnection()), this, SLOT(acceptConnection()));
 }
 
@@ -54,21 +64,15 @@ void NotifyServer::acceptConnection()
         connect(client, SIGNAL(disconnected()), this, SLOT(onClientDisconnected()));
 
         // send the list of current synced folders to the new client
-        int localFolders = 0;
-        SyncInfo *model = SyncInfo::instance();
-        for (auto syncSetting : model->getAllSyncSettings())
+        QStringList localFolders = getSyncFolders();
+        for (const QString& c : localFolders)
         {
-            QString c = QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
-            if (!c.isEmpty() && syncSetting->isActive())
-            {
-                localFolders++;
-                client->write("A");
-                client->write(c.toUtf8().constData());
-                client->write("\n");
-            }
+            client->write("A");
+            client->write(c.toUtf8().constData());
+            client->write("\n");
         }
 
-        if (!localFolders)
+        if (localFolders.isEmpty())
         {
             // send an empty sync
             client->write("A");
@@ -92,21 +96,84 @@ void NotifyServer::onClientDisconnected()
     //LOG_debug << "Client disconnected";
 }
 
-// send string to all connected clients
+// send string to all connected clients, after the item changes queued before it
 void NotifyServer::doSendToAll(const char *type, QByteArray str)
+{
+    if (mItemChangesTimer.isActive())
+    {
+        mItemChangesTimer.stop();
+        sendItemChanges();
+    }
+
+    QByteArray buffer(type);
+    buffer.append(str).append('\n');
+    writeToAll(buffer);
+}
+
+void NotifyServer::writeToAll(const QByteArray& buffer)
 {
     foreach(QLocalSocket *socket, m_clients)
         if (socket && socket->state() == QLocalSocket::ConnectedState) {
-            socket->write(type);
-            socket->write(str.constData(), str.size());
-            socket->write("\n");
+            socket->write(buffer);
             socket->flush();
         }
 }
 
+void NotifyServer::queueItemChange(QByteArray path)
+{
+    if (mChangedPathSet.contains(path))
+    {
+        mCoalescedItemChanges++;
+        return;
+    }
+
+    mChangedPathSet.insert(path);
+    mChangedPaths.append(path);
+    if (!mItemChangesTimer.isActive())
+    {
+        mItemChangesTimer.start();
+    }
+}
+
+// P<path> for each changed item, or R<folder> when many items of a folder changed
+void NotifyServer::sendItemChanges()
+{
+    QHash<QByteArray, int> changesByFolder;
+    for (const QByteArray& path : mChangedPaths)
+    {
+        changesByFolder[path.left(path.lastIndexOf('/'))]++;
+    }
+
+    QByteArray buffer;
+    QSet<QByteArray> refreshedFolders;
+    for (const QByteArray& path : mChangedPaths)
+    {
+        QByteArray folder = path.left(path.lastIndexOf('/'));
+        if (folder.isEmpty() || changesByFolder.value(folder) < FOLDER_REFRESH_THRESHOLD)
+        {
+            buffer.append('P').append(path).append('\n');
+        }
+        else if (!refreshedFolders.contains(folder))
+        {
+            refreshedFolders.insert(folder);
+            buffer.append('R').append(folder).append('\n');
+        }
+    }
+
+    if (!refreshedFolders.isEmpty())
+    {
+        MegaApi::log(MegaApi::LOG_LEVEL_DEBUG, QString::fromUtf8("Shell notifications: %1 changed items, %2 refreshed folders, %3 duplicates ignored")
+                     .arg(mChangedPaths.size()).arg(refreshedFolders.size()).arg(mCoalescedItemChanges).toUtf8().constData());
+    }
+
+    mChangedPaths.clear();
+    mChangedPathSet.clear();
+    writeToAll(buffer);
+}
+
 void NotifyServer::notifyItemChange(string *localPath)
 {
-    emit sendToAll("P", QByteArray(localPath->data(), static_cast<int>(localPath->size())));
+    emit itemChanged(QByteArray(localPath->data(), static_cast<int>(localPath->size())));
 }
 
 void NotifyServer::notifySyncAdd(QString path)
@@ -119,3 +186,18 @@ void NotifyServer::notifySyncDel(QString path)
     emit sendToAll("D", path.toUtf8());
 }
 
+QStringList NotifyServer::getSyncFolders()
+{
+    QStringList localFolders;
+    SyncInfo *model = SyncInfo::instance();
+    for (auto syncSetting : model->getAllSyncSettings())
+    {
+        QString c = QDir::toNativeSeparators(QDir(syncSetting->getLocalFolder()).canonicalPath());
+        if (!c.isEmpty() && syncSetting->isActive())
+        {
+            localFolders.append(c);
+        }
+    }
+    return localFolders;
+}
+
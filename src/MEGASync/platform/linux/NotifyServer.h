@@ -5,6 +5,9 @@
 #include "megaapi.h"
 #include "control/Preferences.h"
 
+#include <QSet>
+#include <QTimer>
+
 class NotifyServer: public QObject
 {
     Q_OBJECT
@@ -16,6 +19,9 @@ class NotifyServer: public QObject
     void notifySyncAdd(QString path);
     void notifySyncDel(QString path);
 
+    // canonical paths of the active sync folders, as sent to the clients
+    static QStringList getSyncFolders();
+
  protected:
     QLocalServer *m_localServer;
 
@@ -23,14 +29,25 @@ class NotifyServer: public QObject
     void acceptConnection();
     void onClientDisconnected();
     void doSendToAll(const char *type, QByteArray str);
+    void queueItemChange(QByteArray path);
+    void sendItemChanges();
 
  private:
+    void writeToAll(const QByteArray& buffer);
+
     MegaApplication *app;
     QString sockPath;
     QList<QLocalSocket *> m_clients;
 
+    // changed paths are sent together every NOTIFY_INTERVAL_MS, once per path
+    QTimer mItemChangesTimer;
+    QList<QByteArray> mChangedPaths;
+    QSet<QByteArray> mChangedPathSet;
+    long long mCoalescedItemChanges;
+
 signals:
     void sendToAll(const char *type, QByteArray str);
+    void itemChanged(QByteArray path);
 
 };
 
@@ -0,0 +1,88 @@
+#include "PathStateCache.h"
+
+PathStateCache::PathStateCache(int maxPaths)
+    : mMaxPaths(maxPaths),
+      mGeneration(0),
+      mHits(0),
+      mMisses(0)
+{
+}
+
+bool PathStateCache::find(const QByteArray& path, int& state)
+{
+    auto it = mEntriesByPath.constFind(path);
+    if (it == mEntriesByPath.constEnd())
+    {
+        mMisses++;
+        return false;
+    }
+
+    mEntries.splice(mEntries.begin(), mEntries, it.value());
+    state = it.value()->state;
+    mHits++;
+    return true;
+}
+
+void PathStateCache::insert(const QByteArray& path, int state, quint64 generation)
+{
+    if (generation != mGeneration || mMaxPaths <= 0)
+    {
+        return;
+    }
+
+    auto it = mEntriesByPath.find(path);
+    if (it != mEntriesByPath.end())
+    {
+        it.value()->state = state;
+        mEntries.splice(mEntries.begin(), mEntries, it.value());
+        return;
+    }
+
+    if (mEntriesByPath.size() >= mMaxPaths)
+    {
+        mEntriesByPath.remove(mEntries.back().path);
+        mEntries.pop_back();
+    }
+
+    mEntries.push_front(Entry{path, state});
+    mEntriesByPath.insert(path, mEntries.begin());
+}
+
+void PathStateCache::invalidate(const QByteArray& path)
+{
+    mGeneration++;
+
+    auto it = mEntriesByPath.find(path);
+    if (it != mEntriesByPath.end())
+    {
+        mEntries.erase(it.value());
+        mEntriesByPath.erase(it);
+    }
+}
+
+void PathStateCache::clear()
+{
+    mGeneration++;
+    mEntries.clear();
+    mEntriesByPath.clear();
+}
+
+quint64 PathStateCache::generation() const
+{
+    return mGeneration;
+}
+
+int PathStateCache::size() const
+{
+    return mEntriesByPath.size();
+}
+
+long long PathStateCache::hits() const
+{
+    return mHits;
+}
+
+long long PathStateCache::misses() const
+{
+    return mMisses;
+}
@@ -0,0 +1,47 @@
+#ifndef PATHSTATECACHE_H
+#define PATHSTATECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+
+#include <list>
+
+//Least recently used sync states of the paths queried by the shell extensions.
+//The NotifyServer broadcasts every state change, so an entry is valid until its path is notified.
+class PathStateCache
+{
+public:
+    static const int DEFAULT_MAX_PATHS = 65536;
+
+    explicit PathStateCache(int maxPaths = DEFAULT_MAX_PATHS);
+
+    bool find(const QByteArray& path, int& state);
+    //The state is dropped if any path was invalidated after "generation" was read
+    void insert(const QByteArray& path, int state, quint64 generation);
+    void invalidate(const QByteArray& path);
+    void clear();
+
+    //Changes with every invalidation, so states computed out of the GUI thread can be discarded
+    quint64 generation() const;
+
+    int size() const;
+    long long hits() const;
+    long long misses() const;
+
+private:
+    struct Entry
+    {
+        QByteArray path;
+        int state;
+    };
+
+    //Most recently used first
+    std::list<Entry> mEntries;
+    QHash<QByteArray, std::list<Entry>::iterator> mEntriesByPath;
+    int mMaxPaths;
+    quint64 mGeneration;
+    long long mHits;
+    long long mMisses;
+};
+
+#endif // PATHSTATECACHE_H
@@ -28,6 +28,11 @@ void PlatformImplementation::notifyItemChange(const QString& path, int)
 {
     if (!path.isEmpty())
     {
+        if (ext_server)
+        {
+            ext_server->invalidatePathState(path.toUtf8());
+        }
+
         if (notify_server && !Preferences::instance()->overlayIconsDisabled())
         {
             std::string stdPath = path.toStdString();
@@ -157,6 +162,11 @@ void PlatformImplementation::syncFolderAdded(QString syncPath, QString /*syncNam
 
     }
 
+    if (ext_server)
+    {
+        ext_server->clearPathStates();
+    }
+
     if (notify_server)
     {
         notify_server->notifySyncAdd(syncPath);
@@ -172,25 +182,44 @@ void PlatformImplementation::syncFolderRemoved(QString syncPath, QString /*syncN
     }
     delete folder;
 
+    if (ext_server)
+    {
+        ext_server->clearPathStates();
+    }
+
     if (notify_server)
     {
         notify_server->notifySyncDel(syncPath);
     }
 }
 
+// the shell extensions drop their cached path states when the sync folders are notified again
 void PlatformImplementation::notifyRestartSyncFolders()
 {
-
+    notifyAllSyncFoldersRemoved();
+    notifyAllSyncFoldersAdded();
 }
 
 void PlatformImplementation::notifyAllSyncFoldersAdded()
 {
-
+    if (notify_server)
+    {
+        for (const QString& syncPath : NotifyServer::getSyncFolders())
+        {
+            notify_server->notifySyncAdd(syncPath);
+        }
+    }
 }
 
 void PlatformImplementation::notifyAllSyncFoldersRemoved()
 {
-
+    if (notify_server)
+    {
+        for (const QString& syncPath : NotifyServer::getSyncFolders())
+        {
+            notify_server->notifySyncDel(syncPath);
+        }
+    }
 }
 
 QString PlatformImplementation::getDefaultFileBrowserApp()
@@ -55,11 +55,13 @@ unix:!macx {
     SOURCES += $$PWD/linux/PlatformImplementation.cpp \
         $$PWD/linux/ExtServer.cpp \
         $$PWD/linux/NotifyServer.cpp \
+        $$PWD/linux/PathStateCache.cpp \
         $$PWD/linux/PowerOptions.cpp \
         $$PWD/linux/PlatformStrings.cpp
     HEADERS += $$PWD/linux/PlatformImplementation.h \
         $$PWD/linux/ExtServer.h \
-        $$PWD/linux/NotifyServer.h
+        $$PWD/linux/NotifyServer.h \
+        $$PWD/linux/PathStateCache.h
 
     LIBS += -lssl -lcrypto -ldl -lxcb
     DEFINES += USE_DBUS
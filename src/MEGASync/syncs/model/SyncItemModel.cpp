@@ -10,6 +10,22 @@
 const int SyncItemModel::ICON_SIZE = 24;
 const int SyncItemModel::WARNING_ICON_SIZE = 18;
 
+namespace
+{
+QCollator createSortCollator()
+{
+    QCollator collator;
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    return collator;
+}
+
+quint64 sortKeyId(const QModelIndex& index)
+{
+    return (static_cast<quint64>(index.row()) << 8) | static_cast<quint64>(index.column());
+}
+}
+
 
 SyncItemModel::SyncItemModel(QObject *parent)
     : QAbstractItemModel(parent),
@@ -166,7 +182,7 @@ bool SyncItemModel::setData(const QModelIndex &index, const QVariant &value, int
             emit enableSync(sync);
         else if (value.toInt() == Qt::Unchecked)
             emit disableSync(sync);
-        emit dataChanged(index, index, QVector<int>(role));
+        emit dataChanged(index, index, QVector<int>() << role);
         return true;
     }
 
@@ -262,10 +278,42 @@ mega::MegaSync::SyncType SyncItemModel::getMode()
     return mSyncType;
 }
 
-SyncItemSortModel::SyncItemSortModel(QObject *parent) : QSortFilterProxyModel(parent)
+SyncItemSortModel::SyncItemSortModel(QObject *parent) : QSortFilterProxyModel(parent),
+    mQCollator(createSortCollator()),
+    mSortKeys(mQCollator)
+{
+}
+
+void SyncItemSortModel::setSourceModel(QAbstractItemModel *sourceModel)
 {
-    mQCollator.setNumericMode(true);
-    mQCollator.setCaseSensitivity(Qt::CaseInsensitive);
+    for(const auto& connection : mSourceConnections)
+    {
+        disconnect(connection);
+    }
+    mSourceConnections.clear();
+    mSortKeys.clear();
+
+    //Connected before the proxy connects itself, so the keys are cleared before it sorts the rows again
+    if(sourceModel)
+    {
+        auto clearKeys = [this]() { mSortKeys.clear(); };
+        auto clearChangedKeys = [this](const QModelIndex&, const QModelIndex&, const QVector<int>& roles)
+        {
+            //Other roles, like the check state, do not change the names
+            if(roles.isEmpty() || roles.contains(Qt::DisplayRole))
+            {
+                mSortKeys.clear();
+            }
+        };
+        mSourceConnections << connect(sourceModel, &QAbstractItemModel::dataChanged, this, clearChangedKeys)
+                           << connect(sourceModel, &QAbstractItemModel::rowsInserted, this, clearKeys)
+                           << connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, clearKeys)
+                           << connect(sourceModel, &QAbstractItemModel::rowsMoved, this, clearKeys)
+                           << connect(sourceModel, &QAbstractItemModel::layoutChanged, this, clearKeys)
+                           << connect(sourceModel, &QAbstractItemModel::modelReset, this, clearKeys);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
 }
 
 bool SyncItemSortModel::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
@@ -282,6 +330,6 @@ bool SyncItemSortModel::lessThan(const QModelIndex &source_left, const QModelInd
         }
     }
 
-    return mQCollator.compare(source_left.data(Qt::DisplayRole).toString(),
-                              source_right.data(Qt::DisplayRole).toString()) < 0;
+    return mSortKeys.compare(sortKeyId(source_left), [&source_left](){ return source_left.data(Qt::DisplayRole).toString(); },
+                             sortKeyId(source_right), [&source_right](){ return source_right.data(Qt::DisplayRole).toString(); }) < 0;
 }
@@ -2,6 +2,7 @@
 #define SYNCITEMMODEL_H
 
 #include "syncs/control/SyncController.h"
+#include "control/CollationKeyCache.h"
 
 #include <QSortFilterProxyModel>
 #include <QAbstractItemModel>
@@ -74,9 +75,16 @@ class SyncItemSortModel : public QSortFilterProxyModel
 public:
     explicit SyncItemSortModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
 protected:
     bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const override;
     QCollator mQCollator;
+    //Keys by source row and column, cleared when the shown names or the rows of the source change, before the rows are sorted again
+    mutable CollationKeyCache mSortKeys;
+
+private:
+    QList<QMetaObject::Connection> mSourceConnections;
 };
 
 #endif // SYNCITEMMODEL_H
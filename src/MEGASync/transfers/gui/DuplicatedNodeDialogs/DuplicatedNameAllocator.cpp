@@ -0,0 +1,97 @@
+#include "DuplicatedNameAllocator.h"
+
+#include <MegaApplication.h>
+
+#include <memory>
+
+namespace
+{
+//Larger numbers are never handed out, so they do not need to be tracked
+const int MAX_NUMBER_DIGITS = 9;
+}
+
+bool DuplicatedNameAllocator::Key::operator==(const Key& other) const
+{
+    return parentHandle == other.parentHandle && isFile == other.isFile
+           && baseName == other.baseName && suffix == other.suffix;
+}
+
+uint qHash(const DuplicatedNameAllocator::Key& key, uint seed)
+{
+    return qHash(key.parentHandle, seed) ^ qHash(key.baseName, seed) ^ (qHash(key.suffix, seed) * 31) ^ (key.isFile ? 1u : 0u);
+}
+
+QString DuplicatedNameAllocator::nextName(mega::MegaNode* parentNode, const QString& baseName, const QString& suffix, bool isFile)
+{
+    auto parentHandle(parentNode ? parentNode->getHandle() : mega::INVALID_HANDLE);
+    if(!mParsedParents.contains(parentHandle))
+    {
+        auto megaApi(MegaSyncApp ? MegaSyncApp->getMegaApi() : nullptr);
+        if(megaApi && parentNode)
+        {
+            std::unique_ptr<mega::MegaNodeList> children(megaApi->getChildren(parentNode));
+            addChildren(parentHandle, children.get());
+        }
+        mParsedParents.insert(parentHandle);
+    }
+
+    auto& used = mUsedNumbers[Key{parentHandle, isFile, baseName, suffix}];
+    while(used.numbers.contains(used.next))
+    {
+        used.numbers.remove(used.next);
+        used.next++;
+    }
+
+    //Numbers below next are never checked again
+    return numberedName(baseName, used.next++, suffix);
+}
+
+void DuplicatedNameAllocator::addChildren(mega::MegaHandle parentHandle, mega::MegaNodeList* children)
+{
+    mParsedParents.insert(parentHandle);
+    if(!children)
+    {
+        return;
+    }
+
+    for(int i = 0; i < children->size(); ++i)
+    {
+        auto child = children->get(i);
+        addName(parentHandle, child->getType() == mega::MegaNode::TYPE_FILE, QString::fromUtf8(child->getName()));
+    }
+}
+
+QString DuplicatedNameAllocator::numberedName(const QString& baseName, int number, const QString& suffix)
+{
+    return baseName + QString(QLatin1Literal("(%1)")).arg(QString::number(number)) + suffix;
+}
+
+void DuplicatedNameAllocator::addName(mega::MegaHandle parentHandle, bool isFile, const QString& name)
+{
+    //Every "(N)" of the name could be the number of a different base name, as in "a(1)(2).txt"
+    for(auto open = name.indexOf(QLatin1Char('(')); open >= 0; open = name.indexOf(QLatin1Char('('), open + 1))
+    {
+        auto close = name.indexOf(QLatin1Char(')'), open + 1);
+        if(close < 0)
+        {
+            break;
+        }
+
+        auto digits = name.midRef(open + 1, close - open - 1);
+        bool isNumber = !digits.isEmpty() && digits.size() <= MAX_NUMBER_DIGITS && digits.at(0) != QLatin1Char('0');
+        for(int i = 0; isNumber && i < digits.size(); ++i)
+        {
+            isNumber = digits.at(i) >= QLatin1Char('0') && digits.at(i) <= QLatin1Char('9');
+        }
+
+        if(isNumber)
+        {
+            auto& used = mUsedNumbers[Key{parentHandle, isFile, name.left(open), name.mid(close + 1)}];
+            auto number = digits.toInt();
+            if(number >= used.next)
+            {
+                used.numbers.insert(number);
+            }
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef DUPLICATEDNAMEALLOCATOR_H
+#define DUPLICATEDNAMEALLOCATOR_H
+
+#include <megaapi.h>
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+//Hands out the "name(N).suffix" names proposed for duplicated uploads. The children of a parent are parsed
+//once into the numbers used for every name and suffix, so the next free number is found without SDK lookups.
+//Numbers handed out are reserved too, so every conflict of the same dialog gets a different name.
+class DuplicatedNameAllocator
+{
+public:
+    QString nextName(mega::MegaNode* parentNode, const QString& baseName, const QString& suffix, bool isFile);
+
+    //Children of the parent, when they are known before the first name is requested. Does not take ownership
+    void addChildren(mega::MegaHandle parentHandle, mega::MegaNodeList* children);
+
+    static QString numberedName(const QString& baseName, int number, const QString& suffix);
+
+private:
+    struct Key
+    {
+        mega::MegaHandle parentHandle;
+        bool isFile;
+        QString baseName;
+        QString suffix;
+
+        bool operator==(const Key& other) const;
+    };
+    friend uint qHash(const Key& key, uint seed);
+
+    struct UsedNumbers
+    {
+        QSet<int> numbers;
+        int next = 1;
+    };
+
+    void addName(mega::MegaHandle parentHandle, bool isFile, const QString& name);
+
+    QSet<mega::MegaHandle> mParsedParents;
+    QHash<Key, UsedNumbers> mUsedNumbers;
+};
+
+#endif // DUPLICATEDNAMEALLOCATOR_H
@@ -25,6 +25,9 @@ DuplicatedNodeDialog::DuplicatedNodeDialog(std::shared_ptr<mega::MegaNode> node)
     connect(&mFileCheck, &DuplicatedUploadBase::selectionDone, this, [this](){
         onConflictProcessed();
     });
+    connect(&mUploadPreflight, &DuplicatedUploadPreflight::childrenListed, this, &DuplicatedNodeDialog::onUploadChildrenListed);
+    connect(&mUploadPreflight, &DuplicatedUploadPreflight::entriesChecked, this, &DuplicatedNodeDialog::onUploadEntriesChecked);
+    connect(&mUploadPreflight, &DuplicatedUploadPreflight::finished, this, &DuplicatedNodeDialog::uploadsChecked);
 
     QIcon warningIcon(QString::fromLatin1(":/images/icon_warning.png"));
     ui->lIcon->setPixmap(warningIcon.pixmap(ui->lIcon->size()));
@@ -39,18 +42,38 @@ DuplicatedNodeDialog::~DuplicatedNodeDialog()
     delete ui;
 }
 
-void DuplicatedNodeDialog::checkUpload(const QString &nodePath, std::shared_ptr<mega::MegaNode> parentNode)
+void DuplicatedNodeDialog::checkUploads(QQueue<QString>& nodePaths, std::shared_ptr<mega::MegaNode> parentNode)
 {
-    QFileInfo fileInfo(nodePath);
-    if(fileInfo.isFile())
+    QStringList localPaths;
+    localPaths.reserve(nodePaths.size());
+    while(!nodePaths.isEmpty())
     {
-        auto conflict = mFileCheck.checkUpload(nodePath, parentNode);
-        conflict->hasConflict() ? mFileConflicts.append(conflict) : mResolvedUploads.append(conflict);
+        localPaths.append(nodePaths.dequeue());
     }
-    else
+
+    mUploadPreflight.start(localPaths, parentNode);
+}
+
+void DuplicatedNodeDialog::onUploadChildrenListed(std::shared_ptr<DuplicatedNameAllocator> nameAllocator)
+{
+    //The children were listed and parsed by the preflight, so the new names are not listed again in this thread
+    mNameAllocator = std::move(*nameAllocator);
+}
+
+void DuplicatedNodeDialog::onUploadEntriesChecked(std::shared_ptr<DuplicatedUploadPreflight::Entries> entries)
+{
+    for(const auto& entry : *entries)
     {
-        auto conflict = mFolderCheck.checkUpload(nodePath, parentNode);
-        conflict->hasConflict() ? mFolderConflicts.append(conflict) : mResolvedUploads.append(conflict);
+        if(entry.isFile)
+        {
+            auto conflict = mFileCheck.checkUpload(entry, mNode, &mNameAllocator);
+            conflict->hasConflict() ? mFileConflicts.append(conflict) : mResolvedUploads.append(conflict);
+        }
+        else
+        {
+            auto conflict = mFolderCheck.checkUpload(entry, mNode, &mNameAllocator);
+            conflict->hasConflict() ? mFolderConflicts.append(conflict) : mResolvedUploads.append(conflict);
+        }
     }
 }
 
@@ -3,9 +3,11 @@
 
 #include "DuplicatedNodeDialogs/DuplicatedNodeItem.h"
 #include "DuplicatedNodeDialogs/DuplicatedUploadChecker.h"
+#include "DuplicatedNodeDialogs/DuplicatedUploadPreflight.h"
 
 #include <QDialog>
 #include <QPointer>
+#include <QQueue>
 
 namespace Ui {
 class DuplicatedNodeDialog;
@@ -19,7 +21,8 @@ public:
     explicit DuplicatedNodeDialog(std::shared_ptr<mega::MegaNode> node);
     ~DuplicatedNodeDialog();
 
-    void checkUpload(const QString& nodePath, std::shared_ptr<mega::MegaNode> parentNode);
+    //Checks the paths in the background, taking them from the queue. uploadsChecked is emitted once all are checked
+    void checkUploads(QQueue<QString>& nodePaths, std::shared_ptr<mega::MegaNode> parentNode);
 
     void addNodeItem(DuplicatedNodeItem* item);
     void setHeader(const QString& baseText, const QString &nodeName);
@@ -31,6 +34,9 @@ public:
     const QList<std::shared_ptr<DuplicatedNodeInfo>>& getResolvedConflicts();
     bool isEmpty() const;
 
+signals:
+    void uploadsChecked();
+
 protected:
     bool eventFilter(QObject *watched, QEvent *event) override;
 
@@ -47,10 +53,14 @@ private:
     void startWithNewCategoryOfConflicts();
 
     void updateHeader();
+    void onUploadChildrenListed(std::shared_ptr<DuplicatedNameAllocator> nameAllocator);
+    void onUploadEntriesChecked(std::shared_ptr<DuplicatedUploadPreflight::Entries> entries);
 
     Ui::DuplicatedNodeDialog *ui;
     DuplicatedUploadFolder mFolderCheck;
     DuplicatedUploadFile mFileCheck;
+    DuplicatedUploadPreflight mUploadPreflight;
+    DuplicatedNameAllocator mNameAllocator;
 
     QList<std::shared_ptr<DuplicatedNodeInfo>> mConflictsBeingProcessed;
     DuplicatedUploadBase* mChecker;
@@ -23,13 +23,13 @@ const std::shared_ptr<mega::MegaNode> &DuplicatedNodeInfo::getRemoteConflictNode
     return mRemoteConflictNode;
 }
 
-void DuplicatedNodeInfo::setRemoteConflictNode(const std::shared_ptr<mega::MegaNode> &newRemoteConflictNode)
+void DuplicatedNodeInfo::setRemoteConflictNode(const std::shared_ptr<mega::MegaNode> &newRemoteConflictNode, DuplicatedNameAllocator* nameAllocator)
 {
     mRemoteConflictNode = newRemoteConflictNode;
 
     mName = QString::fromUtf8(mRemoteConflictNode->getName()).toHtmlEscaped();
 
-    initNewName();
+    initNewName(nameAllocator);
 
     auto time = newRemoteConflictNode->isFile() ? mRemoteConflictNode->getModificationTime()
                                                 : mRemoteConflictNode->getCreationTime();
@@ -49,17 +49,15 @@ void DuplicatedNodeInfo::setLocalPath(const QString &newLocalPath)
     mIsLocalFile = localNode.exists() && localNode.isFile();
 }
 
-NodeItemType DuplicatedNodeInfo::getSolution() const
+void DuplicatedNodeInfo::setLocalPath(const QString &newLocalPath, bool isLocalFile)
 {
-    return mSolution;
+    mLocalPath = newLocalPath;
+    mIsLocalFile = isLocalFile;
 }
 
-std::shared_ptr<mega::MegaNode> DuplicatedNodeInfo::checkNameNode(const QString &nodeName, std::shared_ptr<mega::MegaNode> parentNode)
+NodeItemType DuplicatedNodeInfo::getSolution() const
 {
-    auto node = std::shared_ptr<mega::MegaNode>(MegaSyncApp->getMegaApi()->getChildNodeOfType(parentNode.get(), nodeName.toStdString().c_str(),
-                                                              isLocalFile() ? mega::MegaNode::TYPE_FILE : mega::MegaNode::TYPE_FOLDER));
-
-    return node;
+    return mSolution;
 }
 
 void DuplicatedNodeInfo::setSolution(NodeItemType newSolution)
@@ -123,7 +121,7 @@ bool DuplicatedNodeInfo::haveDifferentType() const
     return mHaveDifferentType;
 }
 
-void DuplicatedNodeInfo::initNewName()
+void DuplicatedNodeInfo::initNewName(DuplicatedNameAllocator* nameAllocator)
 {
     QString nodeName;
     QString suffix;
@@ -148,26 +146,12 @@ void DuplicatedNodeInfo::initNewName()
         nodeName = mName;
     }
 
-    bool nameFound(false);
-    int counter(1);
-    while(!nameFound)
+    DuplicatedNameAllocator localAllocator;
+    if(!nameAllocator)
     {
-        QString repeatedName = nodeName + QString(QLatin1Literal("(%1)")).arg(QString::number(counter));
-        if(mRemoteConflictNode)
-        {
-            if(mRemoteConflictNode->isFile() && !suffix.isEmpty())
-            {
-                repeatedName.append(suffix);
-            }
-        }
-
-        auto foundNode = checkNameNode(repeatedName, mParentNode);
-        if(!foundNode)
-        {
-            mNewName = repeatedName;
-            nameFound = true;
-        }
-
-        counter++;
+        nameAllocator = &localAllocator;
     }
+
+    //Children of the same type as the local node are the ones which would conflict with the new name
+    mNewName = nameAllocator->nextName(mParentNode.get(), nodeName, suffix, isLocalFile());
 }
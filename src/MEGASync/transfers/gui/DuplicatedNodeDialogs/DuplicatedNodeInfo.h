@@ -1,6 +1,8 @@
 #ifndef DUPLICATEDNODEINFO_H
 #define DUPLICATEDNODEINFO_H
 
+#include "DuplicatedNameAllocator.h"
+
 #include <megaapi.h>
 
 #include <QObject>
@@ -27,16 +29,16 @@ class DuplicatedNodeInfo : public QObject
 public:
     DuplicatedNodeInfo();
 
-    std::shared_ptr<mega::MegaNode> checkNameNode(const QString& nodeName, std::shared_ptr<mega::MegaNode> parentNode);
-
     const std::shared_ptr<mega::MegaNode> &getParentNode() const;
     void setParentNode(const std::shared_ptr<mega::MegaNode> &newParentNode);
 
     const std::shared_ptr<mega::MegaNode> &getRemoteConflictNode() const;
-    void setRemoteConflictNode(const std::shared_ptr<mega::MegaNode> &newRemoteConflictNode);
+    //The allocator is shared by the conflicts of the same dialog, so they are not proposed the same new name
+    void setRemoteConflictNode(const std::shared_ptr<mega::MegaNode> &newRemoteConflictNode, DuplicatedNameAllocator* nameAllocator = nullptr);
 
     const QString &getLocalPath() const;
     void setLocalPath(const QString &newLocalPath);
+    void setLocalPath(const QString &newLocalPath, bool isLocalFile);
 
     NodeItemType getSolution() const;
     void setSolution(NodeItemType newSolution);
@@ -73,7 +75,7 @@ private:
     QDateTime mNodeModifiedTime;
     QDateTime mLocalModifiedTime;
 
-    void initNewName();
+    void initNewName(DuplicatedNameAllocator* nameAllocator);
 };
 
 #endif // DUPLICATEDNODEINFO_H
@@ -18,18 +18,16 @@ void DuplicatedUploadBase::onNodeItemSelected()
     }
 }
 
-std::shared_ptr<DuplicatedNodeInfo> DuplicatedUploadBase::checkUpload(const QString &localPath, std::shared_ptr<mega::MegaNode> parentNode)
+std::shared_ptr<DuplicatedNodeInfo> DuplicatedUploadBase::checkUpload(const DuplicatedUploadPreflight::Entry& entry, std::shared_ptr<mega::MegaNode> parentNode,
+                                                                      DuplicatedNameAllocator* nameAllocator)
 {
-    QDir dir(localPath);
-
     auto info = std::make_shared<DuplicatedNodeInfo>();
-    info->setLocalPath(localPath);
+    info->setLocalPath(entry.localPath, entry.isFile);
     info->setParentNode(parentNode);
 
-    auto conflictNode = info->checkNameNode(dir.dirName(), parentNode);
-    if(conflictNode)
+    if(entry.conflictNode)
     {
-        info->setRemoteConflictNode(conflictNode);
+        info->setRemoteConflictNode(entry.conflictNode, nameAllocator);
         info->setHasConflict(true);
     }
 
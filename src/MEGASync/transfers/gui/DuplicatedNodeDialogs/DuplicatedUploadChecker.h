@@ -2,6 +2,7 @@
 #define DUPLICATEDUPLOADFILE_H
 
 #include <DuplicatedNodeDialogs/DuplicatedNodeItem.h>
+#include <DuplicatedNodeDialogs/DuplicatedUploadPreflight.h>
 #include <megaapi.h>
 
 #include <QObject>
@@ -16,7 +17,8 @@ public:
      DuplicatedUploadBase(){}
     virtual ~DuplicatedUploadBase(){}
 
-    virtual std::shared_ptr<DuplicatedNodeInfo> checkUpload(const QString& localPath, std::shared_ptr<mega::MegaNode> parentNode);
+    virtual std::shared_ptr<DuplicatedNodeInfo> checkUpload(const DuplicatedUploadPreflight::Entry& entry, std::shared_ptr<mega::MegaNode> parentNode,
+                                                            DuplicatedNameAllocator* nameAllocator);
     virtual void fillUi(DuplicatedNodeDialog* dialog, std::shared_ptr<DuplicatedNodeInfo> conflict) = 0;
 
      QString getHeader(bool isFile);
@@ -0,0 +1,136 @@
+#include "DuplicatedUploadPreflight.h"
+
+#include <MegaApplication.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrent>
+
+const int DuplicatedUploadPreflight::BLOCK_SIZE = 1000;
+
+///CHILD NAME INDEX
+ChildNameIndex::ChildNameIndex()
+{
+}
+
+ChildNameIndex::ChildNameIndex(mega::MegaNodeList* children)
+    : mChildren(children)
+{
+    if(!mChildren)
+    {
+        return;
+    }
+
+    for(int i = 0; i < mChildren->size(); ++i)
+    {
+        auto child = mChildren->get(i);
+        auto& names = child->getType() == mega::MegaNode::TYPE_FILE ? mFiles : mFolders;
+        auto name = QString::fromUtf8(child->getName());
+        if(!names.contains(name))
+        {
+            names.insert(name, i);
+        }
+    }
+}
+
+void ChildNameIndex::build(mega::MegaApi* megaApi, mega::MegaNode* parentNode)
+{
+    *this = ChildNameIndex(megaApi && parentNode ? megaApi->getChildren(parentNode) : nullptr);
+}
+
+std::shared_ptr<mega::MegaNode> ChildNameIndex::find(const QString& name, bool isFile) const
+{
+    const auto& names = isFile ? mFiles : mFolders;
+    auto nameIt = names.constFind(name);
+    if(nameIt == names.constEnd())
+    {
+        return nullptr;
+    }
+
+    return std::shared_ptr<mega::MegaNode>(mChildren->get(nameIt.value())->copy());
+}
+
+int ChildNameIndex::size() const
+{
+    return mChildren ? mChildren->size() : 0;
+}
+
+mega::MegaNodeList* ChildNameIndex::children() const
+{
+    return mChildren.get();
+}
+
+///PREFLIGHT
+DuplicatedUploadPreflight::DuplicatedUploadPreflight(QObject* parent)
+    : QObject(parent),
+      mCancelled(false)
+{
+    qRegisterMetaType<std::shared_ptr<DuplicatedUploadPreflight::Entries>>("std::shared_ptr<DuplicatedUploadPreflight::Entries>");
+    qRegisterMetaType<std::shared_ptr<DuplicatedNameAllocator>>("std::shared_ptr<DuplicatedNameAllocator>");
+}
+
+DuplicatedUploadPreflight::~DuplicatedUploadPreflight()
+{
+    //The worker emits signals from this object
+    cancel();
+    mFuture.waitForFinished();
+}
+
+void DuplicatedUploadPreflight::start(const QStringList& localPaths, std::shared_ptr<mega::MegaNode> parentNode)
+{
+    if(isRunning())
+    {
+        return;
+    }
+
+    mCancelled = false;
+    mFuture = QtConcurrent::run([this, localPaths, parentNode]()
+    {
+        ChildNameIndex index;
+        index.build(MegaSyncApp->getMegaApi(), parentNode.get());
+        emit childrenListed(createNameAllocator(parentNode ? parentNode->getHandle() : mega::INVALID_HANDLE, index));
+
+        for(int begin = 0; begin < localPaths.size() && !mCancelled; begin += BLOCK_SIZE)
+        {
+            auto entries = std::make_shared<Entries>(check(localPaths.mid(begin, BLOCK_SIZE), index));
+            emit entriesChecked(entries);
+        }
+
+        emit finished();
+    });
+}
+
+void DuplicatedUploadPreflight::cancel()
+{
+    mCancelled = true;
+}
+
+bool DuplicatedUploadPreflight::isRunning() const
+{
+    return mFuture.isRunning();
+}
+
+DuplicatedUploadPreflight::Entries DuplicatedUploadPreflight::check(const QStringList& localPaths, const ChildNameIndex& index)
+{
+    Entries entries(static_cast<size_t>(localPaths.size()));
+    for(int i = 0; i < localPaths.size(); ++i)
+    {
+        entries[static_cast<size_t>(i)].localPath = localPaths.at(i);
+    }
+
+    QtConcurrent::blockingMap(entries, [&index](Entry& entry)
+    {
+        QFileInfo fileInfo(entry.localPath);
+        entry.isFile = fileInfo.isFile();
+        entry.conflictNode = index.find(QDir(entry.localPath).dirName(), entry.isFile);
+    });
+
+    return entries;
+}
+
+std::shared_ptr<DuplicatedNameAllocator> DuplicatedUploadPreflight::createNameAllocator(mega::MegaHandle parentHandle, const ChildNameIndex& index)
+{
+    auto nameAllocator = std::make_shared<DuplicatedNameAllocator>();
+    nameAllocator->addChildren(parentHandle, index.children());
+    return nameAllocator;
+}
@@ -0,0 +1,83 @@
+#ifndef DUPLICATEDUPLOADPREFLIGHT_H
+#define DUPLICATEDUPLOADPREFLIGHT_H
+
+#include "DuplicatedNameAllocator.h"
+
+#include <megaapi.h>
+
+#include <QFuture>
+#include <QHash>
+#include <QMetaType>
+#include <QObject>
+#include <QStringList>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//Children of an upload destination by name, so every dropped path is checked without asking the SDK
+class ChildNameIndex
+{
+public:
+    ChildNameIndex();
+    //Takes ownership of the list
+    explicit ChildNameIndex(mega::MegaNodeList* children);
+
+    void build(mega::MegaApi* megaApi, mega::MegaNode* parentNode);
+
+    std::shared_ptr<mega::MegaNode> find(const QString& name, bool isFile) const;
+    int size() const;
+    //Null if the index has not been built
+    mega::MegaNodeList* children() const;
+
+private:
+    std::unique_ptr<mega::MegaNodeList> mChildren;
+    //Position of the first child with each name in mChildren, like getChildNodeOfType would find it
+    QHash<QString, int> mFiles;
+    QHash<QString, int> mFolders;
+};
+
+//Checks dropped paths against the children of the destination in a worker thread, and streams
+//the results back in blocks, so the GUI thread never waits for thousands of stats and lookups
+class DuplicatedUploadPreflight : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry
+    {
+        QString localPath;
+        bool isFile = false;
+        std::shared_ptr<mega::MegaNode> conflictNode;
+    };
+    using Entries = std::vector<Entry>;
+
+    explicit DuplicatedUploadPreflight(QObject* parent = nullptr);
+    ~DuplicatedUploadPreflight();
+
+    void start(const QStringList& localPaths, std::shared_ptr<mega::MegaNode> parentNode);
+    void cancel();
+    bool isRunning() const;
+
+    //Local paths are stat in parallel
+    static Entries check(const QStringList& localPaths, const ChildNameIndex& index);
+    //Allocator for the new names of the conflicts, from the same children listing
+    static std::shared_ptr<DuplicatedNameAllocator> createNameAllocator(mega::MegaHandle parentHandle, const ChildNameIndex& index);
+
+    static const int BLOCK_SIZE;
+
+signals:
+    //Emitted before the first block of entries
+    void childrenListed(std::shared_ptr<DuplicatedNameAllocator> nameAllocator);
+    void entriesChecked(std::shared_ptr<DuplicatedUploadPreflight::Entries> entries);
+    void finished();
+
+private:
+    QFuture<void> mFuture;
+    std::atomic<bool> mCancelled;
+};
+
+Q_DECLARE_METATYPE(std::shared_ptr<DuplicatedUploadPreflight::Entries>)
+Q_DECLARE_METATYPE(std::shared_ptr<DuplicatedNameAllocator>)
+
+#endif // DUPLICATEDUPLOADPREFLIGHT_H
@@ -28,6 +28,8 @@ MegaTransferDelegate::MegaTransferDelegate(TransfersSortFilterProxyBaseModel* mo
                         mProxyModel->sourceModel())),
       mView (view)
 {
+    //Cached rows are translated, they are rendered again when the language changes
+    mView->installEventFilter(this);
 }
 
 MegaTransferDelegate::~MegaTransferDelegate()
@@ -37,60 +39,99 @@ MegaTransferDelegate::~MegaTransferDelegate()
 
 void MegaTransferDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
 {   
-    auto row (index.row());
-
     if (index.isValid())
     {
-        auto pos (option.rect.topLeft());
-        auto height (option.rect.height());
+        auto rect (rowRect(option.rect));
         auto transferItem (qvariant_cast<TransferItem>(index.data(Qt::DisplayRole)));
         auto data = transferItem.getTransferData();
 
-        TransferBaseDelegateWidget* w (getTransferItemWidget(index, option.rect.size()));
-        if(!w)
+        //The hovered row is rendered live, as its actions react to the mouse
+        if(data && !(option.state & QStyle::State_MouseOver))
         {
-            return;
+            paintCachedRow(painter, option, index, rect, *data);
         }
-
-#ifdef __APPLE__
-        auto width = mView->width();
-        width -= mView->contentsMargins().left();
-        width -= mView->contentsMargins().right();
-        if(mView->verticalScrollBar() && mView->verticalScrollBar()->isVisible())
+        else
         {
-            width -= mView->verticalScrollBar()->width();
-        }
-#else
-        auto width (option.rect.width());
-#endif
+            TransferBaseDelegateWidget* w (getTransferItemWidget(index, rect));
+            if(!w)
+            {
+                return;
+            }
 
-        // Move if position changed
-        if (w->pos() != pos)
-        {
-            w->move(pos);
+            painter->save();
+            painter->translate(rect.topLeft());
+            w->render(option, painter, QRegion(0, 0, rect.width(), rect.height()));
+            painter->restore();
         }
+    }
+    else
+    {
+        QStyledItemDelegate::paint(painter, option, index);
+    }
+}
 
-        // Resize if window resized
-        if (w->width() != width)
-        {
-            w->resize(width, height);
-        }
+void MegaTransferDelegate::paintCachedRow(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index,
+                                          const QRect& rect, const TransferData& data) const
+{
+    auto devicePixelRatio (mView->devicePixelRatioF());
+    QSize pixmapSize(qRound(rect.width() * devicePixelRatio), qRound(rect.height() * devicePixelRatio));
+    auto contentKey (TransferRowPixmapCache::contentKey(data));
 
-        if(data)
+    TransferBaseDelegateWidget* w (nullptr);
+    QPixmap rendered;
+
+    auto pixmap (mRowCache.find(data.mTag, contentKey, pixmapSize));
+    if(pixmap)
+    {
+        //The background only depends on the view state, any widget of the pool can draw it
+        w = getPooledItemWidget(index, rect.height());
+    }
+    else
+    {
+        w = getTransferItemWidget(index, rect);
+        if(w)
         {
-            w->updateUi(data, row);
+            rendered = QPixmap(pixmapSize);
+            rendered.setDevicePixelRatio(devicePixelRatio);
+            rendered.fill(Qt::transparent);
+
+            QPainter pixmapPainter(&rendered);
+            w->renderContent(&pixmapPainter, QRegion(0, 0, rect.width(), rect.height()));
+            pixmapPainter.end();
+
+            pixmap = mRowCache.insert(data.mTag, contentKey, rendered);
+            if(!pixmap)
+            {
+                pixmap = &rendered;
+            }
         }
+    }
 
+    if(w && pixmap)
+    {
         painter->save();
-        painter->translate(pos);
-        w->render(option, painter, QRegion(0, 0, width, height));
-
+        painter->translate(rect.topLeft());
+        w->renderBackground(option, painter);
+        painter->drawPixmap(0, 0, *pixmap);
         painter->restore();
     }
-    else
+}
+
+QRect MegaTransferDelegate::rowRect(const QRect& optionRect) const
+{
+#ifdef __APPLE__
+    auto width = mView->width();
+    width -= mView->contentsMargins().left();
+    width -= mView->contentsMargins().right();
+    if(mView->verticalScrollBar() && mView->verticalScrollBar()->isVisible())
     {
-        QStyledItemDelegate::paint(painter, option, index);
+        width -= mView->verticalScrollBar()->width();
     }
+#else
+    auto width (optionRect.width());
+#endif
+
+    return QRect(optionRect.topLeft(), QSize(width, optionRect.height()));
 }
 
 bool MegaTransferDelegate::event(QEvent *event)
@@ -122,16 +163,60 @@ bool MegaTransferDelegate::event(QEvent *event)
     return QStyledItemDelegate::event(event);
 }
 
-TransferBaseDelegateWidget *MegaTransferDelegate::getTransferItemWidget(const QModelIndex& index, const QSize& size) const
+bool MegaTransferDelegate::eventFilter(QObject *watched, QEvent *event)
+{
+    if(watched == mView)
+    {
+        if(event->type() == QEvent::LanguageChange)
+        {
+            mRowCache.clear();
+        }
+        return false;
+    }
+
+    return QStyledItemDelegate::eventFilter(watched, event);
+}
+
+//Returns the row widget laid out and updated with the row transfer
+TransferBaseDelegateWidget *MegaTransferDelegate::getTransferItemWidget(const QModelIndex& index, const QRect& rect) const
 { 
+    TransferBaseDelegateWidget* item(getPooledItemWidget(index, rect.height()));
+
+    if(item)
+    {
+        // Move if position changed
+        if (item->pos() != rect.topLeft())
+        {
+            item->move(rect.topLeft());
+        }
+
+        // Resize if window resized
+        if (item->width() != rect.width())
+        {
+            item->resize(rect.width(), rect.height());
+        }
+
+        auto transferItem (qvariant_cast<TransferItem>(index.data(Qt::DisplayRole)));
+        auto data = transferItem.getTransferData();
+        if(data)
+        {
+            item->updateUi(data, index.row());
+        }
+    }
+
+    return item;
+}
+
+TransferBaseDelegateWidget *MegaTransferDelegate::getPooledItemWidget(const QModelIndex& index, int rowHeight) const
+{
     TransferBaseDelegateWidget* item(nullptr);
 
     if(index.isValid())
     {
         auto nbRowsMaxInView(1);
-        if(size.height() > 0)
+        if(rowHeight > 0)
         {
-            nbRowsMaxInView = mView->height() / size.height() + 1;
+            nbRowsMaxInView = mView->height() / rowHeight + 1;
         }
         auto row (index.row() % nbRowsMaxInView);
 
@@ -169,7 +254,7 @@ bool MegaTransferDelegate::editorEvent(QEvent* event, QAbstractItemModel*,
                 QMouseEvent* me = static_cast<QMouseEvent*>(event);
                 if( me->button() == Qt::LeftButton )
                 {
-                    TransferBaseDelegateWidget* currentRow (getTransferItemWidget(index, option.rect.size()));
+                    TransferBaseDelegateWidget* currentRow (getTransferItemWidget(index, rowRect(option.rect)));
                     auto w (currentRow->childAt(me->pos() - currentRow->pos()));
                     if (w)
                     {
@@ -187,7 +272,7 @@ bool MegaTransferDelegate::editorEvent(QEvent* event, QAbstractItemModel*,
                 QMouseEvent* me = static_cast<QMouseEvent*>(event);
                 if( me->button() == Qt::LeftButton )
                 {
-                    TransferBaseDelegateWidget* currentRow (getTransferItemWidget(index, option.rect.size()));
+                    TransferBaseDelegateWidget* currentRow (getTransferItemWidget(index, rowRect(option.rect)));
                     if (currentRow)
                     {
                         QApplication::postEvent(currentRow, new QEvent(QEvent::MouseButtonDblClick));
@@ -208,7 +293,7 @@ bool MegaTransferDelegate::helpEvent(QHelpEvent* event, QAbstractItemView* view,
 {
     if (event->type() == QEvent::ToolTip && index.isValid())
     {
-        auto currentRow (getTransferItemWidget(index, option.rect.size()));
+        auto currentRow (getTransferItemWidget(index, rowRect(option.rect)));
         auto widget (currentRow->childAt(event->pos() - currentRow->pos()));
         if (widget)
         {
@@ -226,7 +311,7 @@ QSize MegaTransferDelegate::sizeHint(const QStyleOptionViewItem&,
 
 void MegaTransferDelegate::onHoverLeave(const QModelIndex& index, const QRect& rect)
 {
-    auto currentRow (getTransferItemWidget(index, rect.size()));
+    auto currentRow (getTransferItemWidget(index, rowRect(rect)));
     if(currentRow)
     {
         currentRow->mouseHoverTransfer(false, QPoint());
@@ -235,7 +320,7 @@ void MegaTransferDelegate::onHoverLeave(const QModelIndex& index, const QRect& r
 
 void MegaTransferDelegate::onHoverEnter(const QModelIndex& index, const QRect& rect)
 {
-    auto currentRow (getTransferItemWidget(index, rect.size()));
+    auto currentRow (getTransferItemWidget(index, rowRect(rect)));
     if(currentRow)
     {
         currentRow->mouseHoverTransfer(true, QPoint());
@@ -244,7 +329,7 @@ void MegaTransferDelegate::onHoverEnter(const QModelIndex& index, const QRect& r
 
 void MegaTransferDelegate::onHoverMove(const QModelIndex &index, const QRect &rect, const QPoint& pos)
 {
-    auto currentRow (getTransferItemWidget(index, rect.size()));
+    auto currentRow (getTransferItemWidget(index, rowRect(rect)));
     if(currentRow)
     {
         auto hoverType = currentRow->mouseHoverTransfer(true, pos);
@@ -3,6 +3,7 @@
 
 #include "TransferItem.h"
 #include "TransfersModel.h"
+#include "TransferRowPixmapCache.h"
 
 #include <QStyledItemDelegate>
 #include <QAbstractItemView>
@@ -23,6 +24,7 @@ public:
 protected:
     void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
     bool event(QEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
     bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index) override;
     bool helpEvent(QHelpEvent *event, QAbstractItemView *view, const QStyleOptionViewItem &option, const QModelIndex &index) override;
 
@@ -32,11 +34,16 @@ protected slots:
     void onHoverMove(const QModelIndex& index, const QRect& rect, const QPoint& point);
 
 private:
-    TransferBaseDelegateWidget *getTransferItemWidget(const QModelIndex &index, const QSize &size) const;
+    TransferBaseDelegateWidget *getTransferItemWidget(const QModelIndex &index, const QRect &rect) const;
+    TransferBaseDelegateWidget *getPooledItemWidget(const QModelIndex &index, int rowHeight) const;
+    void paintCachedRow(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index,
+                        const QRect& rect, const TransferData& data) const;
+    QRect rowRect(const QRect& optionRect) const;
 
     TransfersSortFilterProxyBaseModel* mProxyModel;
     TransfersModel* mSourceModel;
     mutable QVector<TransferBaseDelegateWidget*> mTransferItems;
+    mutable TransferRowPixmapCache mRowCache;
     QAbstractItemView* mView;
 };
 
@@ -55,7 +55,13 @@ void TransferBaseDelegateWidget::setCurrentIndex(const QModelIndex &currentIndex
     mCurrentIndex = currentIndex;
 }
 
-void TransferBaseDelegateWidget::render(const QStyleOptionViewItem&, QPainter *painter, const QRegion &sourceRegion)
+void TransferBaseDelegateWidget::render(const QStyleOptionViewItem& option, QPainter *painter, const QRegion &sourceRegion)
+{
+    renderBackground(option, painter);
+    renderContent(painter, sourceRegion);
+}
+
+void TransferBaseDelegateWidget::renderContent(QPainter *painter, const QRegion &sourceRegion)
 {
     QWidget::render(painter,QPoint(0,0),sourceRegion);
 }
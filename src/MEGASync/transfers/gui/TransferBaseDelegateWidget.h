@@ -54,7 +54,10 @@ public:
     QModelIndex getCurrentIndex() const;
     void setCurrentIndex(const QModelIndex &currentIndex);
 
-    virtual void render(const QStyleOptionViewItem &, QPainter *painter, const QRegion &sourceRegion);
+    virtual void render(const QStyleOptionViewItem &option, QPainter *painter, const QRegion &sourceRegion);
+    //Row decoration which depends on the view state (hover, selection...) and not on the transfer
+    virtual void renderBackground(const QStyleOptionViewItem &, QPainter *){}
+    void renderContent(QPainter *painter, const QRegion &sourceRegion);
 
 signals:
     void retryTransfer();
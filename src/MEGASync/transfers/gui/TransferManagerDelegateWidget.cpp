@@ -441,7 +441,7 @@ TransferBaseDelegateWidget::ActionHoverType TransferManagerDelegateWidget::mouse
     return hoverType;
 }
 
-void TransferManagerDelegateWidget::render(const QStyleOptionViewItem &option, QPainter *painter, const QRegion &sourceRegion)
+void TransferManagerDelegateWidget::renderBackground(const QStyleOptionViewItem &option, QPainter *painter)
 {
     bool isDragging(false);
 
@@ -498,8 +498,6 @@ void TransferManagerDelegateWidget::render(const QStyleOptionViewItem &option, Q
             painter->drawPath(path);
         }
     }
-
-    TransferBaseDelegateWidget::render(option, painter, sourceRegion);
 }
 
 void TransferManagerDelegateWidget::mouseDoubleClickEvent(QMouseEvent *event)
@@ -21,7 +21,7 @@ public:
 
     ActionHoverType mouseHoverTransfer(bool isHover, const QPoint &pos) override;
 
-    void render(const QStyleOptionViewItem &option, QPainter *painter, const QRegion &sourceRegion) override;
+    void renderBackground(const QStyleOptionViewItem &option, QPainter *painter) override;
 
 protected:
     void mouseDoubleClickEvent(QMouseEvent *event) override;
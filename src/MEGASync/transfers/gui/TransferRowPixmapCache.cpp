@@ -0,0 +1,104 @@
+#include "TransferRowPixmapCache.h"
+
+namespace
+{
+const long long SECS_IN_1_MINUTE = 60;
+const long long SECS_IN_1_HOUR = 3600;
+
+//Finished rows may show the elapsed time ("2 minutes ago"), so the key changes when that text can change
+long long finishedTimeBucket(const TransferData& data)
+{
+    if(!data.isFinished())
+    {
+        return -1;
+    }
+
+    auto secs(data.getSecondsSinceFinished());
+    if(secs < SECS_IN_1_MINUTE)
+    {
+        return secs;
+    }
+    else if(secs < SECS_IN_1_HOUR)
+    {
+        return SECS_IN_1_MINUTE + secs / SECS_IN_1_MINUTE;
+    }
+
+    return SECS_IN_1_HOUR + secs / SECS_IN_1_HOUR;
+}
+}
+
+TransferRowPixmapCache::TransferRowPixmapCache(int maxBytes)
+    : mRows(maxBytes),
+      mHits(0),
+      mMisses(0)
+{
+}
+
+uint TransferRowPixmapCache::contentKey(const TransferData& data)
+{
+    uint key(qHash(data.mFilename));
+    key = qHash(static_cast<int>(data.getState()), key);
+    key = qHash(static_cast<int>(data.mType), key);
+    key = qHash(data.mTransferredBytes, key);
+    key = qHash(data.mTotalSize, key);
+    key = qHash(data.mSpeed, key);
+    key = qHash(static_cast<qint64>(data.mRemainingTime), key);
+    key = qHash(static_cast<qint64>(data.getRawFinishedTime()), key);
+    key = qHash(finishedTimeBucket(data), key);
+    key = qHash(data.mErrorCode, key);
+    key = qHash(data.mErrorValue, key);
+    key = qHash((data.isFailed() ? 1 : 0) | (data.canBeRetried() ? 2 : 0), key);
+    return key;
+}
+
+const QPixmap* TransferRowPixmapCache::find(TransferTag tag, uint contentKey, const QSize& pixmapSize)
+{
+    auto row = mRows.object(tag);
+    if(row && row->contentKey == contentKey && row->pixmap.size() == pixmapSize)
+    {
+        mHits++;
+        return &row->pixmap;
+    }
+
+    mMisses++;
+    return nullptr;
+}
+
+const QPixmap* TransferRowPixmapCache::insert(TransferTag tag, uint contentKey, const QPixmap& pixmap)
+{
+    auto cost(pixmap.width() * pixmap.height() * pixmap.depth() / 8);
+    auto row = new Row{contentKey, pixmap};
+
+    //QCache deletes the row if it is bigger than the whole cache
+    if(mRows.insert(tag, row, cost))
+    {
+        return &row->pixmap;
+    }
+
+    return nullptr;
+}
+
+void TransferRowPixmapCache::remove(TransferTag tag)
+{
+    mRows.remove(tag);
+}
+
+void TransferRowPixmapCache::clear()
+{
+    mRows.clear();
+}
+
+int TransferRowPixmapCache::size() const
+{
+    return mRows.size();
+}
+
+long long TransferRowPixmapCache::hits() const
+{
+    return mHits;
+}
+
+long long TransferRowPixmapCache::misses() const
+{
+    return mMisses;
+}
@@ -0,0 +1,43 @@
+#ifndef TRANSFERROWPIXMAPCACHE_H
+#define TRANSFERROWPIXMAPCACHE_H
+
+#include "TransferItem.h"
+
+#include <QCache>
+#include <QPixmap>
+
+//Transfer rows already rendered by their delegate widget.
+//A row is rendered again only when what it shows (its content key) or its size change, so scrolling
+//or repainting rows which did not change just draws a pixmap. The least recently used rows are dropped first.
+class TransferRowPixmapCache
+{
+public:
+    static const int DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+    explicit TransferRowPixmapCache(int maxBytes = DEFAULT_MAX_BYTES);
+
+    //Key of the values shown by a transfer row
+    static uint contentKey(const TransferData& data);
+
+    const QPixmap* find(TransferTag tag, uint contentKey, const QSize& pixmapSize);
+    const QPixmap* insert(TransferTag tag, uint contentKey, const QPixmap& pixmap);
+    void remove(TransferTag tag);
+    void clear();
+
+    int size() const;
+    long long hits() const;
+    long long misses() const;
+
+private:
+    struct Row
+    {
+        uint contentKey;
+        QPixmap pixmap;
+    };
+
+    QCache<TransferTag, Row> mRows;
+    long long mHits;
+    long long mMisses;
+};
+
+#endif // TRANSFERROWPIXMAPCACHE_H
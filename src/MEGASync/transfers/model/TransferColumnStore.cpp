@@ -0,0 +1,276 @@
+#include "TransferColumnStore.h"
+
+namespace
+{
+template <typename T>
+void eraseRows(std::vector<T>& column, int row, int count)
+{
+    column.erase(column.begin() + row, column.begin() + row + count);
+}
+
+template <typename T>
+size_t columnMemory(const std::vector<T>& column)
+{
+    return column.capacity() * sizeof(T);
+}
+
+size_t stringMemory(const QString& string)
+{
+    //QArrayData header + UTF-16 payload + null terminator
+    return string.isEmpty() ? 0 : 24 + static_cast<size_t>(string.capacity() + 1) * sizeof(QChar);
+}
+}
+
+void TransferColumnStore::append(const TransferData& data)
+{
+    mTags.emplace_back();
+    mStates.emplace_back();
+    mTypes.emplace_back();
+    mFileTypes.emplace_back();
+    mFlags.emplace_back();
+    mTotalSizes.emplace_back();
+    mSpeeds.emplace_back();
+    mPriorities.emplace_back();
+    mRemainingTimes.emplace_back();
+    mFinishedTimes.emplace_back();
+    mNameIds.push_back(intern(data.mFilename));
+    mPathIds.push_back(intern(data.path()));
+
+    set(mTags.size() - 1, data);
+}
+
+TransferColumnStore::SortKeys TransferColumnStore::update(int row, const TransferData& data)
+{
+    SortKeys changedKeys(0);
+
+    if(row >= 0 && row < size())
+    {
+        if(mStrings[mNameIds[row]] != data.mFilename)
+        {
+            release(mNameIds[row]);
+            mNameIds[row] = intern(data.mFilename);
+            changedKeys |= sortKey(SortCriterion::NAME);
+        }
+
+        auto path(data.path());
+        if(mStrings[mPathIds[row]] != path)
+        {
+            release(mPathIds[row]);
+            mPathIds[row] = intern(path);
+        }
+
+        if(mTotalSizes[row] != data.mTotalSize)
+        {
+            changedKeys |= sortKey(SortCriterion::TOTAL_SIZE);
+        }
+        if(mSpeeds[row] != data.mSpeed)
+        {
+            changedKeys |= sortKey(SortCriterion::SPEED);
+        }
+        if(mPriorities[row] != data.mPriority)
+        {
+            changedKeys |= sortKey(SortCriterion::PRIORITY);
+        }
+        //The state decides if the remaining or the finished time is compared
+        if(mStates[row] != static_cast<uint16_t>(data.getState())
+                || mRemainingTimes[row] != data.mRemainingTime
+                || mFinishedTimes[row] != data.getRawFinishedTime())
+        {
+            changedKeys |= sortKey(SortCriterion::TIME);
+        }
+
+        set(static_cast<size_t>(row), data);
+    }
+
+    return changedKeys;
+}
+
+void TransferColumnStore::remove(int row, int count)
+{
+    if(row >= 0 && count > 0 && row + count <= size())
+    {
+        for(auto index = row; index < row + count; ++index)
+        {
+            release(mNameIds[index]);
+            release(mPathIds[index]);
+        }
+
+        eraseRows(mTags, row, count);
+        eraseRows(mStates, row, count);
+        eraseRows(mTypes, row, count);
+        eraseRows(mFileTypes, row, count);
+        eraseRows(mFlags, row, count);
+        eraseRows(mTotalSizes, row, count);
+        eraseRows(mSpeeds, row, count);
+        eraseRows(mPriorities, row, count);
+        eraseRows(mRemainingTimes, row, count);
+        eraseRows(mFinishedTimes, row, count);
+        eraseRows(mNameIds, row, count);
+        eraseRows(mPathIds, row, count);
+    }
+}
+
+void TransferColumnStore::clear()
+{
+    mTags.clear();
+    mStates.clear();
+    mTypes.clear();
+    mFileTypes.clear();
+    mFlags.clear();
+    mTotalSizes.clear();
+    mSpeeds.clear();
+    mPriorities.clear();
+    mRemainingTimes.clear();
+    mFinishedTimes.clear();
+    mNameIds.clear();
+    mPathIds.clear();
+
+    mStrings.clear();
+    mStringRefs.clear();
+    mFreeStringIds.clear();
+    mStringIds.clear();
+}
+
+void TransferColumnStore::reserve(int rows)
+{
+    auto capacity(static_cast<size_t>(rows));
+    mTags.reserve(capacity);
+    mStates.reserve(capacity);
+    mTypes.reserve(capacity);
+    mFileTypes.reserve(capacity);
+    mFlags.reserve(capacity);
+    mTotalSizes.reserve(capacity);
+    mSpeeds.reserve(capacity);
+    mPriorities.reserve(capacity);
+    mRemainingTimes.reserve(capacity);
+    mFinishedTimes.reserve(capacity);
+    mNameIds.reserve(capacity);
+    mPathIds.reserve(capacity);
+}
+
+TransferColumnStore::Row TransferColumnStore::row(int row) const
+{
+    Row result;
+    result.tag = mTags[row];
+    result.state = static_cast<TransferData::TransferState>(mStates[row]);
+    result.type = TransferData::TransferTypes(QFlag(mTypes[row]));
+    result.fileType = static_cast<Utilities::FileType>(mFileTypes[row]);
+    result.flags = mFlags[row];
+    return result;
+}
+
+bool TransferColumnStore::lessThan(SortCriterion criterion, int leftRow, int rightRow, bool& comparable) const
+{
+    comparable = true;
+
+    switch (criterion)
+    {
+        case SortCriterion::PRIORITY:
+        {
+            return mPriorities[leftRow] > mPriorities[rightRow];
+        }
+        case SortCriterion::TOTAL_SIZE:
+        {
+            return mTotalSizes[leftRow] < mTotalSizes[rightRow];
+        }
+        case SortCriterion::NAME:
+        {
+            return QString::compare(name(leftRow), name(rightRow), Qt::CaseInsensitive) < 0;
+        }
+        case SortCriterion::SPEED:
+        {
+            return mSpeeds[leftRow] < mSpeeds[rightRow];
+        }
+        case SortCriterion::TIME:
+        {
+            int leftState(mStates[leftRow]);
+            int rightState(mStates[rightRow]);
+
+            if((TransferData::PROCESSING_STATES_MASK & leftState) || (TransferData::PROCESSING_STATES_MASK & rightState))
+            {
+                return mRemainingTimes[leftRow] < mRemainingTimes[rightRow];
+            }
+            else if((TransferData::FINISHED_STATES_MASK & leftState) && (TransferData::FINISHED_STATES_MASK & rightState))
+            {
+                return mFinishedTimes[leftRow] < mFinishedTimes[rightRow];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    comparable = false;
+    return false;
+}
+
+size_t TransferColumnStore::memoryUsage() const
+{
+    size_t result(columnMemory(mTags) + columnMemory(mStates) + columnMemory(mTypes)
+                  + columnMemory(mFileTypes) + columnMemory(mFlags) + columnMemory(mTotalSizes)
+                  + columnMemory(mSpeeds) + columnMemory(mPriorities) + columnMemory(mRemainingTimes)
+                  + columnMemory(mFinishedTimes) + columnMemory(mNameIds) + columnMemory(mPathIds)
+                  + columnMemory(mStrings) + columnMemory(mStringRefs) + columnMemory(mFreeStringIds));
+
+    for(const auto& string : mStrings)
+    {
+        result += stringMemory(string);
+    }
+
+    //QHash node: next pointer + hash + key + value, plus the bucket pointer
+    result += static_cast<size_t>(mStringIds.size()) * (sizeof(void*) * 2 + sizeof(uint) + sizeof(QString) + sizeof(uint32_t));
+
+    return result;
+}
+
+uint32_t TransferColumnStore::intern(const QString& string)
+{
+    auto it = mStringIds.constFind(string);
+    if(it != mStringIds.constEnd())
+    {
+        mStringRefs[it.value()]++;
+        return it.value();
+    }
+
+    uint32_t id;
+    if(!mFreeStringIds.empty())
+    {
+        id = mFreeStringIds.back();
+        mFreeStringIds.pop_back();
+        mStrings[id] = string;
+        mStringRefs[id] = 1;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(mStrings.size());
+        mStrings.push_back(string);
+        mStringRefs.push_back(1);
+    }
+
+    mStringIds.insert(string, id);
+    return id;
+}
+
+void TransferColumnStore::release(uint32_t id)
+{
+    if(--mStringRefs[id] == 0)
+    {
+        mStringIds.remove(mStrings[id]);
+        mStrings[id].clear();
+        mFreeStringIds.push_back(id);
+    }
+}
+
+void TransferColumnStore::set(size_t row, const TransferData& data)
+{
+    mTags[row] = data.mTag;
+    mStates[row] = static_cast<uint16_t>(data.getState());
+    mTypes[row] = static_cast<uint8_t>(data.mType);
+    mFileTypes[row] = static_cast<uint8_t>(toInt(data.mFileType));
+    mFlags[row] = (data.isFailed() ? FAILED : 0) | (data.canBeRetried() ? CAN_BE_RETRIED : 0);
+    mTotalSizes[row] = data.mTotalSize;
+    mSpeeds[row] = data.mSpeed;
+    mPriorities[row] = data.mPriority;
+    mRemainingTimes[row] = data.mRemainingTime;
+    mFinishedTimes[row] = data.getRawFinishedTime();
+}
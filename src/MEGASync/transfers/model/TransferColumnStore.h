@@ -0,0 +1,92 @@
+#ifndef TRANSFERCOLUMNSTORE_H
+#define TRANSFERCOLUMNSTORE_H
+
+#include "TransferItem.h"
+
+#include <QHash>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+//Struct-of-arrays copy of the TransfersModel rows.
+//Each attribute used to sort or filter lives in its own contiguous array indexed by the model row,
+//so the proxy can sort and filter without dereferencing a TransferData per comparison.
+//Names and paths are interned: each distinct string is stored once and rows keep a 32 bits id.
+class TransferColumnStore
+{
+public:
+    enum RowFlag : uint8_t
+    {
+        FAILED          = 0x01, //TransferData::isFailed()
+        CAN_BE_RETRIED  = 0x02, //TransferData::canBeRetried()
+    };
+
+    //Scalar copy of a row, used by the proxy filter
+    struct Row
+    {
+        TransferTag tag = 0;
+        TransferData::TransferState state = TransferData::TRANSFER_NONE;
+        TransferData::TransferTypes type;
+        Utilities::FileType fileType = Utilities::FileType::TYPE_OTHER;
+        uint8_t flags = 0;
+
+        bool isSyncTransfer() const {return type & TransferData::TRANSFER_SYNC;}
+        bool isActiveOrPending() const {return state & TransferData::PENDING_STATES_MASK;}
+        bool isPaused() const {return state & TransferData::TRANSFER_PAUSED;}
+        bool isCompleted() const {return state & TransferData::TRANSFER_COMPLETED;}
+        bool isCompleting() const {return state & TransferData::TRANSFER_COMPLETING;}
+        bool isFailed() const {return flags & FAILED;}
+        bool canBeRetried() const {return flags & CAN_BE_RETRIED;}
+    };
+
+    //One bit per SortCriterion, set when the value used to sort by that criterion changes
+    typedef uint8_t SortKeys;
+    static SortKeys sortKey(SortCriterion criterion) {return static_cast<SortKeys>(1 << static_cast<int>(criterion));}
+
+    void append(const TransferData& data);
+    //Returns the sort keys modified by the update
+    SortKeys update(int row, const TransferData& data);
+    void remove(int row, int count = 1);
+    void clear();
+    void reserve(int rows);
+
+    int size() const {return static_cast<int>(mTags.size());}
+
+    Row row(int row) const;
+    const QString& name(int row) const {return mStrings.at(mNameIds[row]);}
+    const QString& path(int row) const {return mStrings.at(mPathIds[row]);}
+
+    //Returns false in "comparable" when the rows can not be ordered by the criterion
+    //(i.e. TIME for a finished and a not finished transfer)
+    bool lessThan(SortCriterion criterion, int leftRow, int rightRow, bool& comparable) const;
+
+    //Approximate heap bytes used by the store (arrays + interned strings)
+    size_t memoryUsage() const;
+
+private:
+    uint32_t intern(const QString& string);
+    void release(uint32_t id);
+    void set(size_t row, const TransferData& data);
+
+    std::vector<TransferTag> mTags;
+    std::vector<uint16_t> mStates;
+    std::vector<uint8_t> mTypes;
+    std::vector<uint8_t> mFileTypes;
+    std::vector<uint8_t> mFlags;
+    std::vector<unsigned long long> mTotalSizes;
+    std::vector<unsigned long long> mSpeeds;
+    std::vector<unsigned long long> mPriorities;
+    std::vector<int64_t> mRemainingTimes;
+    std::vector<int64_t> mFinishedTimes;
+    std::vector<uint32_t> mNameIds;
+    std::vector<uint32_t> mPathIds;
+
+    //Interned strings
+    std::vector<QString> mStrings;
+    std::vector<uint32_t> mStringRefs;
+    std::vector<uint32_t> mFreeStringIds;
+    QHash<QString, uint32_t> mStringIds;
+};
+
+#endif // TRANSFERCOLUMNSTORE_H
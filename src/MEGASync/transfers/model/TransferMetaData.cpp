@@ -69,6 +69,7 @@ bool TransferMetaData::isRetriedFolder(mega::MegaTransfer* transfer)
                 //Update id with new tag (retried tag)
                 TransferMetaDataItemId id(transfer->getTag(), folder->id.handle, folder->id.name, folder->id.path);
                 mFolders.insert(id, folder);
+                TransferMetaDataContainer::indexFolderTransferTag(id.tag, mAppId);
                 return true;
             }
         }
@@ -139,7 +140,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
             if(!nonExistError(transfer, e))
             {
                 //The folder has finished but it is empty, so it is added to the empty folders list
-                if(value->files.size() == 0)
+                if(value->fileCount == 0)
                 {
                     mEmptyFolders.insertItem(state, value);
                 }
@@ -154,7 +155,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                 auto nonExistData = TransferMetaDataContainer::getAppData(mNonExistsFailAppId);
                 if(nonExistData)
                 {
-                    if(value->files.size() == 0)
+                    if(value->fileCount == 0)
                     {
                         value->state = TransferData::TRANSFER_FAILED;
                         nonExistData->mEmptyFolders.nonExistFailedTransfers.insert(id, value);
@@ -162,6 +163,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
                     else
                     {
                         nonExistData->mFolders.insert(id, value);
+                        TransferMetaDataContainer::indexFolderTransferTag(id.tag, mNonExistsFailAppId);
                     }
                 }
             }
@@ -171,7 +173,7 @@ bool TransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaError* e)
     {
         TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
 
-        auto item = mFiles.pendingTransfers.value(id);
+        auto item = mFiles.pendingTransfers.value(id.tag);
         if(item)
         {
             item->id = id;
@@ -377,7 +379,7 @@ int TransferMetaData::getEmptyFolders(const QMap<TransferMetaDataItemId, std::sh
 
     foreach(auto& folder, folders)
     {
-       folder->files.size() == 0 ? counter++ : counter;
+       folder->fileCount == 0 ? counter++ : counter;
     }
 
     return counter;
@@ -392,7 +394,7 @@ void TransferMetaData::addFile(int tag)
 {
     TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
     auto fileItem = std::make_shared<TransferMetaDataItem>(id);
-    mFiles.pendingTransfers.insert(id, fileItem);
+    mFiles.pendingTransfers.insert(tag, fileItem);
 
     if(mCreatedFromOtherSession)
     {
@@ -405,7 +407,7 @@ void TransferMetaData::addFileFromFolder(int folderTag, int fileTag)
     TransferMetaDataItemId fileId(fileTag, mega::INVALID_HANDLE);
     auto fileItem = std::make_shared<TransferMetaDataItem>(fileId);
     fileItem->topLevelFolderId.tag = folderTag;
-    mFiles.pendingTransfers.insert(fileId, fileItem);
+    mFiles.pendingTransfers.insert(fileTag, fileItem);
 
     TransferMetaDataItemId folderId(folderTag, mega::INVALID_HANDLE);
     auto folderItem = mFolders.value(folderId, nullptr);
@@ -413,6 +415,7 @@ void TransferMetaData::addFileFromFolder(int folderTag, int fileTag)
     {
         folderItem = std::make_shared<TransferMetaDataFolderItem>(folderId);
         mFolders.insert(folderId,folderItem);
+        TransferMetaDataContainer::indexFolderTransferTag(folderTag, mAppId);
 
         if(mCreatedFromOtherSession)
         {
@@ -421,7 +424,7 @@ void TransferMetaData::addFileFromFolder(int folderTag, int fileTag)
         }
     }
 
-    folderItem->files.pendingTransfers.insert(fileId, fileItem);
+    folderItem->fileCount++;
 }
 
 void TransferMetaData::checkAndSendNotification()
@@ -565,6 +568,7 @@ void TransferMetaData::start(mega::MegaTransfer *transfer)
             TransferMetaDataItemId id(transfer->getTag(), transfer->getNodeHandle(), QString::fromUtf8(transfer->getFileName()), QString::fromUtf8(transfer->getPath()));
             auto folderItem = std::make_shared<TransferMetaDataFolderItem>(id);
             mFolders.insert(id,folderItem);
+            TransferMetaDataContainer::indexFolderTransferTag(id.tag, mAppId);
         }
         else
         {
@@ -888,8 +892,9 @@ bool UploadTransferMetaData::finish(mega::MegaTransfer *transfer, mega::MegaErro
 
 //////////CONTAINER AND MANAGER
 
-QHash<unsigned long long, std::shared_ptr<TransferMetaData>> TransferMetaDataContainer::transferAppData = QHash<unsigned long long, std::shared_ptr<TransferMetaData>>();
-QMutex TransferMetaDataContainer::mMutex;
+std::array<TransferMetaDataContainer::Shard, TransferMetaDataContainer::SHARDS> TransferMetaDataContainer::mShards;
+QHash<int, unsigned long long> TransferMetaDataContainer::mAppIdsByFolderTag;
+QReadWriteLock TransferMetaDataContainer::mFolderTagsLock;
 
 bool TransferMetaDataContainer::start(mega::MegaTransfer *transfer)
 {
@@ -952,7 +957,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
         {
             if(!transfer->isFolderTransfer())
             {
-                QMutexLocker lock(&mMutex);
+                QMutexLocker lock(&shard(data->getAppId()).mutex);
                 data->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
             }
 
@@ -962,7 +967,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 if(nonExistData)
                 {
                     {
-                        QMutexLocker lock(&mMutex);
+                        QMutexLocker lock(&shard(nonExistData->getAppId()).mutex);
                         nonExistData->retryFailingFile(transfer->getTag(), transfer->getNodeHandle());
                     }
 
@@ -982,7 +987,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
         if(data)
         {
             {
-                QMutexLocker lock(&mMutex);
+                QMutexLocker lock(&shard(data->getAppId()).mutex);
                 data->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(),transfer->getNodeHandle());
             }
 
@@ -992,7 +997,7 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
                 if(nonExistData)
                 {
                     {
-                        QMutexLocker lock(&mMutex);
+                        QMutexLocker lock(&shard(nonExistData->getAppId()).mutex);
                         nonExistData->retryFileFromFolderFailingItem(transfer->getTag(), transfer->getFolderTransferTag(), transfer->getNodeHandle());
                     }
 
@@ -1009,20 +1014,77 @@ void TransferMetaDataContainer::retryTransfer(mega::MegaTransfer *transfer, unsi
 
 bool TransferMetaDataContainer::addAppData(unsigned long long appId, std::shared_ptr<TransferMetaData> data)
 {
-    QMutexLocker lock(&mMutex);
-    return transferAppData.insert(appId, data) != transferAppData.end();
+    auto& appIdShard = shard(appId);
+    QMutexLocker lock(&appIdShard.mutex);
+    return appIdShard.appData.insert(appId, data) != appIdShard.appData.end();
 }
 
 void TransferMetaDataContainer::removeAppData(unsigned long long appId)
 {
-    auto data = TransferMetaDataContainer::getAppData(appId);
-    if(data)
+    auto& appIdShard = shard(appId);
+    QMutexLocker lock(&appIdShard.mutex);
+    appIdShard.appData.remove(appId);
+}
+
+void TransferMetaDataContainer::indexFolderTransferTag(int tag, unsigned long long appId)
+{
+    if(tag > 0)
     {
-        QMutexLocker lock(&mMutex);
-        transferAppData.remove(appId);
+        QWriteLocker lock(&mFolderTagsLock);
+        mAppIdsByFolderTag.insert(tag, appId);
     }
 }
 
+std::shared_ptr<TransferMetaData> TransferMetaDataContainer::findAppDataByFolderTransferTag(int tag)
+{
+    TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
+
+    unsigned long long indexedAppId(0);
+    {
+        QReadLocker lock(&mFolderTagsLock);
+        indexedAppId = mAppIdsByFolderTag.value(tag, 0);
+    }
+
+    if(indexedAppId != 0)
+    {
+        {
+            //The folders of the TransferMetaData are only read with its shard locked, like in the scan below
+            auto& appIdShard = shard(indexedAppId);
+            QMutexLocker lock(&appIdShard.mutex);
+            auto data = appIdShard.appData.value(indexedAppId);
+            if(data && data->isRetriedFolder(id))
+            {
+                return data;
+            }
+        }
+
+        //The TransferMetaData has been removed or it does not have the folder anymore
+        QWriteLocker lock(&mFolderTagsLock);
+        if(mAppIdsByFolderTag.value(tag, 0) == indexedAppId)
+        {
+            mAppIdsByFolderTag.remove(tag);
+        }
+    }
+
+    //Folders added before the index was updated are still found
+    for(auto& appIdShard : mShards)
+    {
+        QMutexLocker lock(&appIdShard.mutex);
+        foreach(auto& appdata, appIdShard.appData)
+        {
+            if(appdata->isRetriedFolder(id))
+            {
+                auto data = appdata;
+                lock.unlock();
+                indexFolderTransferTag(tag, data->getAppId());
+                return data;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
 bool TransferMetaDataContainer::finishFromFolderTransfer(mega::MegaTransfer *transfer, mega::MegaError *e)
 {
     auto folderTag = transfer->getFolderTransferTag();
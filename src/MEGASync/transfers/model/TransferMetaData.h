@@ -6,6 +6,9 @@
 #include <QPair>
 #include <QPointer>
 #include <QMutex>
+#include <QReadWriteLock>
+
+#include <array>
 
 #include <Preferences.h>
 #include "TransferItem.h"
@@ -62,7 +65,8 @@ struct TransferMetaDataItemsByState
 { 
     int size() const {return pendingTransfers.size() + completedTransfers.size() + failedTransfers.size() + cancelledTransfers.size() + nonExistFailedTransfers.size();}
 
-    QMap<TransferMetaDataItemId, std::shared_ptr<Type>> pendingTransfers;
+    //Pending transfers are always identified by their tag, so they keep the order of TransferMetaDataItemId
+    QMap<int, std::shared_ptr<Type>> pendingTransfers;
     QMap<TransferMetaDataItemId, std::shared_ptr<Type>> completedTransfers;
     QMultiMap<mega::MegaHandle, std::shared_ptr<Type>> completedTransfersByFolderHandle;
     QMap<TransferMetaDataItemId, std::shared_ptr<Type>> failedTransfers;
@@ -156,9 +160,9 @@ struct TransferMetaDataItemsByState
             {
                 if(!pendingTransfers.isEmpty())
                 {
-                    foreach(auto& item, pendingTransfers.keys())
+                    foreach(auto& item, pendingTransfers)
                     {
-                        ids.append(item);
+                        ids.append(item->id);
                     }
                 }
                 break;
@@ -207,7 +211,7 @@ private:
             }
             default:
             {
-                pendingTransfers.insert(item->id, item);
+                pendingTransfers.insert(item->id.tag, item);
                 break;
             }
         }
@@ -237,7 +241,7 @@ private:
             }
             default:
             {
-                pendingTransfers.remove(item->id);
+                pendingTransfers.remove(item->id.tag);
                 break;
             }
         }
@@ -247,9 +251,10 @@ private:
 struct TransferMetaDataFolderItem : public TransferMetaDataItem
 {
     TransferMetaDataFolderItem(const TransferMetaDataItemId& id)
-        : TransferMetaDataItem(id){}
+        : TransferMetaDataItem(id), fileCount(0){}
 
-    TransferMetaDataItemsByState<TransferMetaDataItem> files;
+    //Only the number of files is needed, the files are kept by the TransferMetaData
+    int fileCount;
 };
 
 class TransferMetaData
@@ -410,10 +415,13 @@ public:
     static void retryTransfer(mega::MegaTransfer* transfer, unsigned long long appDataId);
     static void retryAllPressed()
     {
-        QMutexLocker lock(&mMutex);
-        foreach(auto& appdata, transferAppData)
+        for(auto& shard : mShards)
         {
-            appdata->retryAllPressed();
+            QMutexLocker lock(&shard.mutex);
+            foreach(auto& appdata, shard.appData)
+            {
+                appdata->retryAllPressed();
+            }
         }
     }
 
@@ -439,30 +447,24 @@ public:
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppData(unsigned long long appId)
     {
-        QMutexLocker lock(&mMutex);
-        auto data = transferAppData.value(appId);
+        auto& appIdShard = shard(appId);
+        QMutexLocker lock(&appIdShard.mutex);
+        auto data = appIdShard.appData.value(appId);
         return std::dynamic_pointer_cast<TYPE>(data);
     }
 
     template <typename TYPE = TransferMetaData>
     static std::shared_ptr<TYPE> getAppDataByFolderTransferTag(int tag)
     {
-        QMutexLocker lock(&mMutex);
-        TransferMetaDataItemId id(tag, mega::INVALID_HANDLE);
-        foreach(auto& appdata, transferAppData)
-        {
-            if(appdata->isRetriedFolder(id))
-            {
-                return std::dynamic_pointer_cast<TYPE>(appdata);
-            }
-        }
-
-        return nullptr;
+        return std::dynamic_pointer_cast<TYPE>(findAppDataByFolderTransferTag(tag));
     }
 
     static bool addAppData(unsigned long long appId, std::shared_ptr<TransferMetaData> data);
     static void removeAppData(unsigned long long appId);
 
+    //Keeps which TransferMetaData has the top level folder of a tag, so the files of the folder find it without a scan
+    static void indexFolderTransferTag(int tag, unsigned long long appId);
+
     template <typename TYPE, typename... A>
     static std::shared_ptr<TYPE> createTransferMetaData(A &&...args)
     {
@@ -492,8 +494,24 @@ public:
     }
 
 private:
-    static QHash<unsigned long long, std::shared_ptr<TransferMetaData>> transferAppData;
-    static QMutex mMutex;
+    struct Shard
+    {
+        QMutex mutex;
+        QHash<unsigned long long, std::shared_ptr<TransferMetaData>> appData;
+    };
+
+    static const int SHARDS = 16;
+
+    static Shard& shard(unsigned long long appId)
+    {
+        return mShards[appId % SHARDS];
+    }
+
+    static std::shared_ptr<TransferMetaData> findAppDataByFolderTransferTag(int tag);
+
+    static std::array<Shard, SHARDS> mShards;
+    static QHash<int, unsigned long long> mAppIdsByFolderTag;
+    static QReadWriteLock mFolderTagsLock;
 };
 
 #endif // TRANSFERMETADATA_H
@@ -0,0 +1,147 @@
+#include "TransferTagIndex.h"
+
+namespace
+{
+//Slots are reassigned when the dead ones are more than the alive ones (and not too few to bother)
+const int MIN_DEAD_SLOTS_TO_COMPACT = 1024;
+
+inline int lowBit(int value)
+{
+    return value & (-value);
+}
+}
+
+TransferTagIndex::TransferTagIndex()
+    : mTree(1, 0),
+      mAliveCount(0)
+{
+}
+
+void TransferTagIndex::append(TransferTag tag)
+{
+    if(mSlotByTag.contains(tag))
+    {
+        remove(tag);
+    }
+
+    //Fenwick trees grow by one node: it covers (slot - lowBit(slot), slot]
+    int slot(static_cast<int>(mTree.size()));
+    int covered(1 + prefixSum(slot - 1) - prefixSum(slot - lowBit(slot)));
+
+    mTree.push_back(covered);
+    mTagBySlot.push_back(tag);
+    mAliveBySlot.push_back(1);
+    mSlotByTag.insert(tag, slot);
+    mAliveCount++;
+}
+
+void TransferTagIndex::remove(TransferTag tag)
+{
+    auto it = mSlotByTag.find(tag);
+    if(it != mSlotByTag.end())
+    {
+        auto slot(it.value());
+        mSlotByTag.erase(it);
+
+        mAliveBySlot[slot - 1] = 0;
+        add(slot, -1);
+        mAliveCount--;
+
+        auto deadSlots(static_cast<int>(mAliveBySlot.size()) - mAliveCount);
+        if(deadSlots > MIN_DEAD_SLOTS_TO_COMPACT && deadSlots > mAliveCount)
+        {
+            compact();
+        }
+    }
+}
+
+void TransferTagIndex::remove(const QList<TransferTag>& tags)
+{
+    for(auto tag : tags)
+    {
+        remove(tag);
+    }
+}
+
+void TransferTagIndex::clear()
+{
+    mSlotByTag.clear();
+    mTagBySlot.clear();
+    mAliveBySlot.clear();
+    mTree.assign(1, 0);
+    mAliveCount = 0;
+}
+
+int TransferTagIndex::row(TransferTag tag) const
+{
+    auto it = mSlotByTag.constFind(tag);
+    if(it != mSlotByTag.constEnd())
+    {
+        return prefixSum(it.value()) - 1;
+    }
+
+    return -1;
+}
+
+bool TransferTagIndex::contains(TransferTag tag) const
+{
+    return mSlotByTag.contains(tag);
+}
+
+int TransferTagIndex::size() const
+{
+    return mAliveCount;
+}
+
+void TransferTagIndex::add(int slot, int value)
+{
+    auto treeSize(static_cast<int>(mTree.size()));
+    for(; slot < treeSize; slot += lowBit(slot))
+    {
+        mTree[slot] += value;
+    }
+}
+
+int TransferTagIndex::prefixSum(int slot) const
+{
+    int result(0);
+    for(; slot > 0; slot -= lowBit(slot))
+    {
+        result += mTree[slot];
+    }
+    return result;
+}
+
+//Drops the dead slots keeping the order of the alive ones. O(n), amortized by the removals that triggered it
+void TransferTagIndex::compact()
+{
+    std::vector<TransferTag> aliveTags;
+    aliveTags.reserve(static_cast<size_t>(mAliveCount));
+    for(size_t slot = 0; slot < mTagBySlot.size(); ++slot)
+    {
+        if(mAliveBySlot[slot])
+        {
+            aliveTags.push_back(mTagBySlot[slot]);
+        }
+    }
+
+    mTagBySlot.swap(aliveTags);
+    mAliveBySlot.assign(mTagBySlot.size(), 1);
+    mTree.assign(mTagBySlot.size() + 1, 0);
+    mSlotByTag.clear();
+    mSlotByTag.reserve(static_cast<int>(mTagBySlot.size()));
+
+    auto treeSize(static_cast<int>(mTree.size()));
+    for(int slot = 1; slot < treeSize; ++slot)
+    {
+        mSlotByTag.insert(mTagBySlot[static_cast<size_t>(slot - 1)], slot);
+
+        //Linear Fenwick build: every node pushes its partial sum to its parent
+        mTree[slot] += 1;
+        auto parent(slot + lowBit(slot));
+        if(parent < treeSize)
+        {
+            mTree[parent] += mTree[slot];
+        }
+    }
+}
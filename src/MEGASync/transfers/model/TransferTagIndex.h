@@ -0,0 +1,42 @@
+#ifndef TRANSFERTAGINDEX_H
+#define TRANSFERTAGINDEX_H
+
+#include "TransferItem.h"
+
+#include <QHash>
+
+#include <cstdint>
+#include <vector>
+
+//Tag to row index for the TransfersModel rows.
+//Every appended tag gets a slot (its insertion order). A Fenwick tree counts the alive slots,
+//so the row of a tag is the number of alive slots before it: O(1) lookup of the slot + O(log n) prefix sum.
+//Removing k rows costs O(k log n) and, unlike QPersistentModelIndex, nothing is fixed up on each removal.
+class TransferTagIndex
+{
+public:
+    TransferTagIndex();
+
+    void append(TransferTag tag);
+    void remove(TransferTag tag);
+    void remove(const QList<TransferTag>& tags);
+    void clear();
+
+    int row(TransferTag tag) const;
+    bool contains(TransferTag tag) const;
+    int size() const;
+
+private:
+    void add(int slot, int value);
+    int prefixSum(int slot) const;
+    void compact();
+
+    QHash<TransferTag, int> mSlotByTag;
+    std::vector<TransferTag> mTagBySlot;
+    std::vector<uint8_t> mAliveBySlot;
+    //1-based Fenwick tree over mAliveBySlot
+    std::vector<int> mTree;
+    int mAliveCount;
+};
+
+#endif // TRANSFERTAGINDEX_H
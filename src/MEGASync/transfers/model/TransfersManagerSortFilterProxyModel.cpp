@@ -9,6 +9,7 @@
 #include <QElapsedTimer>
 #include <QRunnable>
 #include <QTimer>
+#include <QtAlgorithms>
 
 TransfersManagerSortFilterProxyModel::TransfersManagerSortFilterProxyModel(QObject* parent)
     : TransfersSortFilterProxyBaseModel(parent),
@@ -19,8 +20,11 @@ TransfersManagerSortFilterProxyModel::TransfersManagerSortFilterProxyModel(QObje
       mNextTransferTypes (mTransferTypes),
       mNextFileTypes (mFileTypes),
       mSortCriterion (SortCriterion::PRIORITY),
+      mTransfersModel (nullptr),
       mThreadPool (ThreadPoolSingleton::getInstance())
 {
+    mCounters.fill(0);
+
     connect(&mFilterWatcher, &QFutureWatcher<void>::finished,
             this, &TransfersManagerSortFilterProxyModel::onModelSortedFiltered);
 
@@ -58,11 +62,14 @@ void TransfersManagerSortFilterProxyModel::sort(int sortCriterion, Qt::SortOrder
     QFuture<void> sorting = QtConcurrent::run([this]()
     {
         startProcessingInOtherThread();
-        if(sortOrder() == mSortOrder)
+        enableDynamicSortFilter();
+        //Every criterion sorts by its own source column, see TransfersModel::sortColumn
+        auto column(TransfersModel::sortColumn(mSortCriterion));
+        if(sortColumn() == column && sortOrder() == mSortOrder)
         {
             QSortFilterProxyModel::sort(-1,mSortOrder);
         }
-        QSortFilterProxyModel::sort(0, mSortOrder);
+        QSortFilterProxyModel::sort(column, mSortOrder);
         finishProcessingInOtherThread();
     });
     mFilterWatcher.setFuture(sorting);
@@ -78,6 +85,7 @@ void TransfersManagerSortFilterProxyModel::setSourceModel(QAbstractItemModel *so
     connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved,
             this, &TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved, Qt::DirectConnection);
 
+    mTransfersModel = qobject_cast<TransfersModel*>(sourceModel);
     QSortFilterProxyModel::setSourceModel(sourceModel);
 }
 
@@ -108,11 +116,6 @@ void TransfersManagerSortFilterProxyModel::textSearchTypeChanged()
 
 void TransfersManagerSortFilterProxyModel::invalidateModel()
 {
-    if(!dynamicSortFilter())
-    {
-        setDynamicSortFilter(true);
-    }
-
     auto sourceM = qobject_cast<TransfersModel*>(sourceModel());
     if(sourceM)
     {
@@ -122,21 +125,33 @@ void TransfersManagerSortFilterProxyModel::invalidateModel()
     emit layoutAboutToBeChanged();
     QFuture<void> filtered = QtConcurrent::run([this](){
         startProcessingInOtherThread();
+        enableDynamicSortFilter();
 
         invalidate();
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
         invalidateFilter();
 #endif
-        if(sortOrder() == mSortOrder)
+        auto column(TransfersModel::sortColumn(mSortCriterion));
+        if(sortColumn() == column && sortOrder() == mSortOrder)
         {
             QSortFilterProxyModel::sort(-1,mSortOrder);
         }
-        QSortFilterProxyModel::sort(0, mSortOrder);
+        QSortFilterProxyModel::sort(column, mSortOrder);
         finishProcessingInOtherThread();
     });
     mFilterWatcher.setFuture(filtered);
 }
 
+//Once sorted, inserted rows and rows with a modified sort key are placed with a binary search,
+//instead of sorting the whole model again. Enabled here, as enabling it sorts the model
+void TransfersManagerSortFilterProxyModel::enableDynamicSortFilter()
+{
+    if(!dynamicSortFilter())
+    {
+        setDynamicSortFilter(true);
+    }
+}
+
 void TransfersManagerSortFilterProxyModel::startProcessingInOtherThread()
 {
     blockMutexesAndSignals(true);
@@ -151,6 +166,15 @@ void TransfersManagerSortFilterProxyModel::blockMutexesAndSignals(bool value)
 {
     auto sourceM = qobject_cast<TransfersModel*>(sourceModel());
     sourceM->lockModelMutex(value);
+    //The columns are locked once for the whole pass, so lessThan and filterAcceptsRow read them without locking
+    if(value)
+    {
+        sourceM->lockColumnsForRead();
+    }
+    else
+    {
+        sourceM->unlockColumns();
+    }
     sourceM->blockModelSignals(value);
     blockSignals(value);
 }
@@ -195,11 +219,11 @@ int  TransfersManagerSortFilterProxyModel::getNumberOfItems(TransferData::Transf
 
     if(transferType == TransferData::TransferType::TRANSFER_UPLOAD)
     {
-        nb = mUlNumber.size();
+        nb = counter(UPLOAD_SEARCH);
     }
     else if(transferType == TransferData::TransferType::TRANSFER_DOWNLOAD)
     {
-        nb = mDlNumber.size();
+        nb = counter(DOWNLOAD_SEARCH);
     }
 
     return nb;
@@ -207,19 +231,73 @@ int  TransfersManagerSortFilterProxyModel::getNumberOfItems(TransferData::Transf
 
 void TransfersManagerSortFilterProxyModel::resetAllCounters()
 {
-    mDlNumber.clear();
-    mUlNumber.clear();
-    resetTransfersStateCounters();
+    resetCounters(ALL_COUNTERS);
 }
 
 void TransfersManagerSortFilterProxyModel::resetTransfersStateCounters()
 {
-    mNoSyncTransfers.clear();
-    mActiveTransfers.clear();
-    mPausedTransfers.clear();
-    mCompletedTransfers.clear();
-    mFailedTransfers.clear();
-    mPermanentFailedTransfers.clear();
+    resetCounters(NO_SYNC | ACTIVE | PAUSED | COMPLETED | FAILED | PERMANENT_FAILED);
+}
+
+void TransfersManagerSortFilterProxyModel::resetCounters(uint16_t flags)
+{
+    if(flags == ALL_COUNTERS)
+    {
+        mCounterFlagsByTag.clear();
+    }
+    else
+    {
+        for(auto it = mCounterFlagsByTag.begin(); it != mCounterFlagsByTag.end();)
+        {
+            it.value() &= ~flags;
+            it = it.value() ? std::next(it) : mCounterFlagsByTag.erase(it);
+        }
+    }
+
+    for(int index = 0; index < COUNTERS; ++index)
+    {
+        if(flags & (1 << index))
+        {
+            mCounters[index] = 0;
+        }
+    }
+}
+
+int TransfersManagerSortFilterProxyModel::counter(CounterFlag flag) const
+{
+    return mCounters[qCountTrailingZeroBits(static_cast<uint>(flag))];
+}
+
+void TransfersManagerSortFilterProxyModel::updateCounters(TransferTag tag, uint16_t addFlags, uint16_t removeFlags) const
+{
+    auto it = mCounterFlagsByTag.find(tag);
+    uint16_t oldFlags(it != mCounterFlagsByTag.end() ? it.value() : 0);
+    uint16_t newFlags((oldFlags | addFlags) & ~removeFlags);
+
+    if(newFlags != oldFlags)
+    {
+        uint16_t changedFlags(oldFlags ^ newFlags);
+        for(int index = 0; changedFlags; ++index, changedFlags >>= 1)
+        {
+            if(changedFlags & 1)
+            {
+                mCounters[index] += (newFlags & (1 << index)) ? 1 : -1;
+            }
+        }
+
+        if(!newFlags)
+        {
+            mCounterFlagsByTag.erase(it);
+        }
+        else if(it != mCounterFlagsByTag.end())
+        {
+            it.value() = newFlags;
+        }
+        else
+        {
+            mCounterFlagsByTag.insert(tag, newFlags);
+        }
+    }
 }
 
 TransferBaseDelegateWidget *TransfersManagerSortFilterProxyModel::createTransferManagerItem(QWidget*)
@@ -251,100 +329,100 @@ void TransfersManagerSortFilterProxyModel::updateFilters()
     mFileTypes = mNextFileTypes;
 }
 
-bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
 {
     bool accept(false);
 
-    QModelIndex index = sourceModel()->index(sourceRow, 0, sourceParent);
-    const auto d (qvariant_cast<TransferItem>(index.data()).getTransferData());
-
-    if(d && d->mTag >= 0)
+    TransferColumnStore::Row d;
+    if(mTransfersModel && mTransfersModel->getColumnsRow(sourceRow, d) && d.tag >= 0)
     {
-        accept = (d->getState() & mTransferStates)
-                 && (d->mType & mTransferTypes)
-                 && (toInt(d->mFileType) & mFileTypes);
+        uint16_t addFlags(0);
+        uint16_t removeFlags(0);
+
+        accept = (d.state & mTransferStates)
+                 && (d.type & mTransferTypes)
+                 && (toInt(d.fileType) & mFileTypes);
 
         if(!mFilterText.isEmpty())
         {
-            auto containsText = d->mFilename.contains(mFilterText,Qt::CaseInsensitive);
+            auto containsText = mTransfersModel->getNameByRow(sourceRow).contains(mFilterText,Qt::CaseInsensitive);
             accept &= containsText;
 
             if(containsText)
             {
-                if (d->mType & TransferData::TRANSFER_UPLOAD && !mUlNumber.contains(d->mTag))
+                if (d.type & TransferData::TRANSFER_UPLOAD)
                 {
-                    mUlNumber.insert(d->mTag);
+                    addFlags |= UPLOAD_SEARCH;
                 }
-                else if (d->mType & TransferData::TRANSFER_DOWNLOAD && !mDlNumber.contains(d->mTag))
+                else if (d.type & TransferData::TRANSFER_DOWNLOAD)
                 {
-                    mDlNumber.insert(d->mTag);
+                    addFlags |= DOWNLOAD_SEARCH;
                 }
             }
         }
 
-        bool isActive(false);
-
         //Not needed to add the logic when the d is a sync transfer, as the sync state is permanent
-        if(accept && (!d->isCompleted() && !d->isCompleting()))
+        if(accept && (!d.isCompleted() && !d.isCompleting()))
         {
             //As the active state can change in time, add both logics to add or remove
-            if(d->isActiveOrPending())
+            if(d.isActiveOrPending())
             {
-                mActiveTransfers.insert(d->mTag);
-                isActive = true;
+                addFlags |= ACTIVE;
             }
 
             //As the No sync does not change in time, the remove logic is not added
-            if(!d->isSyncTransfer())
+            if(!d.isSyncTransfer())
             {
-                mNoSyncTransfers.insert(d->mTag);
+                addFlags |= NO_SYNC;
             }
         }
 
-        if(!isActive)
+        if(!(addFlags & ACTIVE))
         {
-            removeActiveTransferFromCounter(d->mTag);
+            removeFlags |= ACTIVE;
         }
 
-        if(accept && (d->isActiveOrPending() && d->isCompleting()))
+        if(accept && (d.isActiveOrPending() && d.isCompleting()))
         {
-            mCompletingTransfers.insert(d->mTag);
+            addFlags |= COMPLETING;
         }
         else
         {
-            removeCompletingTransferFromCounter(d->mTag);
+            removeFlags |= COMPLETING;
         }
 
-        if(accept && d->isPaused())
+        if(accept && d.isPaused())
         {
-            mPausedTransfers.insert(d->mTag);
+            addFlags |= PAUSED;
         }
         else
         {
-            removePausedTransferFromCounter(d->mTag);
+            removeFlags |= PAUSED;
         }
 
-        if(accept && ((d->isCompleted() && !d->isFailed())))
+        if(accept && ((d.isCompleted() && !d.isFailed())))
         {
-            mCompletedTransfers.insert(d->mTag);
+            addFlags |= COMPLETED;
         }
         else
         {
-            removeCompletedTransferFromCounter(d->mTag);
+            removeFlags |= COMPLETED;
         }
 
-        if(accept && d->isFailed())
+        if(accept && d.isFailed())
         {
-            mFailedTransfers.insert(d->mTag);
-            if(!d->canBeRetried())
+            addFlags |= FAILED;
+            if(!d.canBeRetried())
             {
-                mPermanentFailedTransfers.insert(d->mTag);
+                addFlags |= PERMANENT_FAILED;
             }
         }
         else
         {
-            removeFailedTransferFromCounter(d->mTag);
+            removeFlags |= FAILED | PERMANENT_FAILED;
         }
+
+        updateCounters(d.tag, addFlags, removeFlags);
     }
 
     return accept;
@@ -352,42 +430,13 @@ bool TransfersManagerSortFilterProxyModel::filterAcceptsRow(int sourceRow, const
 
 bool TransfersManagerSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
-    const auto leftItem (qvariant_cast<TransferItem>(left.data()).getTransferData());
-    const auto rightItem (qvariant_cast<TransferItem>(right.data()).getTransferData());
-
-    if(leftItem && rightItem)
+    if(mTransfersModel)
     {
-        switch (mSortCriterion)
-        {
-        case SortCriterion::PRIORITY:
-        {
-            return leftItem->mPriority > rightItem->mPriority;
-        }
-        case SortCriterion::TOTAL_SIZE:
-        {
-            return leftItem->mTotalSize < rightItem->mTotalSize;
-        }
-        case SortCriterion::NAME:
-        {
-            return QString::compare(leftItem->mFilename, rightItem->mFilename, Qt::CaseInsensitive) < 0;
-        }
-        case SortCriterion::SPEED:
-        {
-            return leftItem->mSpeed < rightItem->mSpeed;
-        }
-        case SortCriterion::TIME:
+        bool comparable(false);
+        auto result = mTransfersModel->lessThanByRow(mSortCriterion, left.row(), right.row(), comparable);
+        if(comparable)
         {
-            if(leftItem->isProcessing() || rightItem->isProcessing())
-            {
-                return leftItem->mRemainingTime < rightItem->mRemainingTime;
-            }
-            else if(leftItem->isFinished() && rightItem->isFinished())
-            {
-                return leftItem->getRawFinishedTime() < rightItem->getRawFinishedTime();
-            }
-        }
-        default:
-            break;
+            return result;
         }
     }
 
@@ -420,72 +469,10 @@ void TransfersManagerSortFilterProxyModel::onRowsAboutToBeRemoved(const QModelIn
 
 bool TransfersManagerSortFilterProxyModel::updateTransfersCounterFromTag(QExplicitlySharedDataPointer<TransferData> transfer) const
 {
-    bool searchRowsRemoved(false);
-
-    if(!mFilterText.isEmpty())
-    {
-        if (transfer->mType & TransferData::TRANSFER_UPLOAD)
-        {
-            mUlNumber.remove(transfer->mTag);
-        }
-        else
-        {
-            mDlNumber.remove(transfer->mTag);
-        }
-
-        searchRowsRemoved = true;
-    }
+    //The removed transfer leaves every counter, whatever its last state was
+    updateCounters(transfer->mTag, 0, ALL_COUNTERS);
 
-    if(!transfer->isSyncTransfer())
-    {
-       removeNonSyncedTransferFromCounter(transfer->mTag);
-    }
-
-    if(transfer->isCompleted())
-    {
-        removeCompletedTransferFromCounter(transfer->mTag);
-    }
-    else if(transfer->isFailed())
-    {
-        removeFailedTransferFromCounter(transfer->mTag);
-    }
-
-    removeActiveTransferFromCounter(transfer->mTag);
-    removePausedTransferFromCounter(transfer->mTag);
-    removeCompletingTransferFromCounter(transfer->mTag);
-
-    return searchRowsRemoved;
-}
-
-void TransfersManagerSortFilterProxyModel::removeActiveTransferFromCounter(TransferTag tag) const
-{
-    mActiveTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removePausedTransferFromCounter(TransferTag tag) const
-{
-    mPausedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeNonSyncedTransferFromCounter(TransferTag tag) const
-{
-    mNoSyncTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeCompletedTransferFromCounter(TransferTag tag) const
-{
-    mCompletedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeFailedTransferFromCounter(TransferTag tag) const
-{
-    mFailedTransfers.remove(tag);
-    mPermanentFailedTransfers.remove(tag);
-}
-
-void TransfersManagerSortFilterProxyModel::removeCompletingTransferFromCounter(TransferTag tag) const
-{
-    mCompletingTransfers.remove(tag);
+    return !mFilterText.isEmpty();
 }
 
 QMimeData *TransfersManagerSortFilterProxyModel::mimeData(const QModelIndexList &indexes) const
@@ -554,12 +541,12 @@ bool TransfersManagerSortFilterProxyModel::dropMimeData(const QMimeData *data, Q
 
 int TransfersManagerSortFilterProxyModel::getPausedTransfers() const
 {
-    return mPausedTransfers.size();
+    return counter(PAUSED);
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllPaused() const
 {
-    return mPausedTransfers.size() == mActiveTransfers.size();
+    return counter(PAUSED) == counter(ACTIVE);
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyCancellable() const
@@ -569,57 +556,57 @@ bool TransfersManagerSortFilterProxyModel::isAnyCancellable() const
 
 bool TransfersManagerSortFilterProxyModel::areAllCancellable() const
 {
-    return (mActiveTransfers.size() > 0 ||  mFailedTransfers.size() > 0) && (mPausedTransfers.isEmpty() && mCompletedTransfers.isEmpty());
+    return (counter(ACTIVE) > 0 ||  counter(FAILED) > 0) && (counter(PAUSED) == 0 && counter(COMPLETED) == 0);
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllSync() const
 {
-    return !isEmpty() && mNoSyncTransfers.isEmpty();
+    return !isEmpty() && counter(NO_SYNC) == 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnySync() const
 {
-    return mNoSyncTransfers.size() != transfersCount();
+    return counter(NO_SYNC) != transfersCount();
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllCompleted() const
 {
-    return mCompletedTransfers.size() > 0 && (mPausedTransfers.isEmpty() && mActiveTransfers.isEmpty() && mFailedTransfers.isEmpty());
+    return counter(COMPLETED) > 0 && (counter(PAUSED) == 0 && counter(ACTIVE) == 0 && counter(FAILED) == 0);
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyCompleted() const
 {
-    return !mCompletedTransfers.isEmpty();
+    return counter(COMPLETED) > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyActive() const
 {
-    return !mActiveTransfers.isEmpty();
+    return counter(ACTIVE) > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::isAnyFailed() const
 {
-    return !mFailedTransfers.isEmpty();
+    return counter(FAILED) > 0;
 }
 
 bool TransfersManagerSortFilterProxyModel::areAllFailsPermanent() const
 {
-    return mFailedTransfers.size() == mPermanentFailedTransfers.size();
+    return counter(FAILED) == counter(PERMANENT_FAILED);
 }
 
 bool TransfersManagerSortFilterProxyModel::isEmpty() const
 {
-    return mCompletedTransfers.isEmpty() && mPausedTransfers.isEmpty() && mActiveTransfers.isEmpty() && mFailedTransfers.isEmpty() && mCompletingTransfers.isEmpty();
+    return counter(COMPLETED) == 0 && counter(PAUSED) == 0 && counter(ACTIVE) == 0 && counter(FAILED) == 0 && counter(COMPLETING) == 0;
 }
 
 int TransfersManagerSortFilterProxyModel::transfersCount() const
 {
-    return mCompletedTransfers.size() + mActiveTransfers.size() + mFailedTransfers.size() + mCompletingTransfers.size();
+    return counter(COMPLETED) + counter(ACTIVE) + counter(FAILED) + counter(COMPLETING);
 }
 
 int TransfersManagerSortFilterProxyModel::activeTransfers() const
 {
-    return mActiveTransfers.size();
+    return counter(ACTIVE);
 }
 
 bool TransfersManagerSortFilterProxyModel::isModelProcessing() const
@@ -10,6 +10,8 @@
 #include <QMutex>
 #include <QPointer>
 
+#include <array>
+
 class TransferBaseDelegateWidget;
 class TransfersModel;
 
@@ -82,6 +84,23 @@ protected:
                                           int column, const QModelIndex& parent) override;
 
 protected:
+        //Counters a transfer belongs to. Each tag keeps its bitset, so refiltering a row is
+        //a single hash lookup and the counters sizes are kept up to date incrementally
+        enum CounterFlag : uint16_t
+        {
+            UPLOAD_SEARCH       = 1 << 0,
+            DOWNLOAD_SEARCH     = 1 << 1,
+            NO_SYNC             = 1 << 2,
+            ACTIVE              = 1 << 3,
+            PAUSED              = 1 << 4,
+            COMPLETED           = 1 << 5,
+            COMPLETING          = 1 << 6,
+            FAILED              = 1 << 7,
+            PERMANENT_FAILED    = 1 << 8,
+        };
+        static const int COUNTERS = 9;
+        static const uint16_t ALL_COUNTERS = (1 << COUNTERS) - 1;
+
         TransferData::TransferStates mTransferStates;
         TransferData::TransferTypes mTransferTypes;
         Utilities::FileTypes mFileTypes;
@@ -91,34 +110,26 @@ protected:
         SortCriterion mSortCriterion;
         Qt::SortOrder mSortOrder;
 
-        mutable QSet<int> mDlNumber;
-        mutable QSet<int> mUlNumber;
-        mutable QSet<int> mNoSyncTransfers;
-        mutable QSet<int> mActiveTransfers;
-        mutable QSet<int> mPausedTransfers;
-        mutable QSet<int> mCompletedTransfers;
-        mutable QSet<int> mCompletingTransfers;
-        mutable QSet<int> mFailedTransfers;
-        mutable QSet<int> mPermanentFailedTransfers;
+        mutable QHash<TransferTag, uint16_t> mCounterFlagsByTag;
+        mutable std::array<int, COUNTERS> mCounters;
 
 private slots:
         void onRowsAboutToBeRemoved(const QModelIndex& parent, int first, int last);
         void onModelSortedFiltered();
 
 private:
+        TransfersModel* mTransfersModel;
         ThreadPool* mThreadPool;
         QFutureWatcher<void> mFilterWatcher;
         QString mFilterText;
         mutable QPointer<QMimeData> mInternalMoveMimeData;
 
-        void removeActiveTransferFromCounter(TransferTag tag) const;
-        void removePausedTransferFromCounter(TransferTag tag) const;
-        void removeNonSyncedTransferFromCounter(TransferTag tag) const;
-        void removeCompletedTransferFromCounter(TransferTag tag) const;
-        void removeFailedTransferFromCounter(TransferTag tag) const;
-        void removeCompletingTransferFromCounter(TransferTag tag) const;
+        int counter(CounterFlag flag) const;
+        void updateCounters(TransferTag tag, uint16_t addFlags, uint16_t removeFlags) const;
+        void resetCounters(uint16_t flags);
         bool updateTransfersCounterFromTag(QExplicitlySharedDataPointer<TransferData> transfer) const;
 
+        void enableDynamicSortFilter();
         void startProcessingInOtherThread();
         void finishProcessingInOtherThread();
         void blockMutexesAndSignals(bool value);
@@ -24,46 +24,52 @@ const int START_THRESHOLD_THREAD = 50;
 const int FAILED_THRESHOLD_THREAD = 100;
 const int PAUSE_RESUME_THRESHOLD_THREAD = 300;
 const int CLEAR_THRESHOLD_THREAD = 300;
+const int EVENT_QUEUE_SIZE = 1 << 17;
 
 //LISTENER THREAD
-TransferThread::TransferThread() : mMaxTransfersToProcess(MAX_TRANSFERS)
+TransferThread::TransferThread() : mEventQueue(EVENT_QUEUE_SIZE), mMaxTransfersToProcess(MAX_TRANSFERS)
 {}
 
+void TransferThread::drainEvents()
+{
+    mEventQueue.drain([this](TransferEvent&& event){
+        cacheEvent(std::move(event));
+    });
+}
+
 TransferThread::TransfersToProcess TransferThread::processTransfers()
 {
-   TransfersToProcess transfers;
-   if(mCacheMutex.tryLock())
-   {
-       int spaceForTransfers(mMaxTransfersToProcess);
+    TransfersToProcess transfers;
+    drainEvents();
 
-       transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.canceledTransfersByTag.size();
+    int spaceForTransfers(mMaxTransfersToProcess);
 
-       transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
+    transfers.canceledTransfersByTag = extractFromCache(mTransfersToProcess.canceledTransfersByTag, spaceForTransfers);
+    spaceForTransfers -= transfers.canceledTransfersByTag.size();
 
-       transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.failedTransfersByTag.size();
+    transfers.failedFolderTransfersByTag = extractFromCache(mTransfersToProcess.failedFolderTransfersByTag, spaceForTransfers);
+    spaceForTransfers -= transfers.failedFolderTransfersByTag.size();
 
-       transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startTransfersByTag.size();
+    transfers.failedTransfersByTag = extractFromCache(mTransfersToProcess.failedTransfersByTag, spaceForTransfers);
+    spaceForTransfers -= transfers.failedTransfersByTag.size();
 
-       transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
-       spaceForTransfers -= transfers.startSyncTransfersByTag.size();
+    transfers.startTransfersByTag = extractFromCache(mTransfersToProcess.startTransfersByTag, spaceForTransfers);
+    spaceForTransfers -= transfers.startTransfersByTag.size();
 
-       transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
+    transfers.startSyncTransfersByTag = extractFromCache(mTransfersToProcess.startSyncTransfersByTag, spaceForTransfers);
+    spaceForTransfers -= transfers.startSyncTransfersByTag.size();
 
-       mCacheMutex.unlock();
-   }
+    transfers.updateTransfersByTag = extractFromCache(mTransfersToProcess.updateTransfersByTag, spaceForTransfers);
 
-   return transfers;
+    return transfers;
 }
 
 void TransferThread::clear()
 {
-    QMutexLocker lock(&mCacheMutex);
-
+    mEventQueue.drain([](TransferEvent&&){});
     mTransfersToProcess.clear();
+
+    QMutexLocker lock(&mCountersMutex);
     mTransfersCount.clear();
 }
 
@@ -107,21 +113,21 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::createData(MegaTransf
     return d;
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, QExplicitlySharedDataPointer<TransferData> data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    if(dataMap.contains(data->mTag))
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(transfer->getState() == mega::MegaTransfer::STATE_CANCELLED)
+        auto item = dataMap.value(data->mTag);
+        if(data->getState() == TransferData::TRANSFER_CANCELLED)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.remove(data->mTag);
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        if(item->mNotificationNumber < data->mNotificationNumber)
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            dataMap[data->mTag] = data;
+            return data;
         }
 
         return item;
@@ -130,15 +136,15 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSub
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, QExplicitlySharedDataPointer<TransferData> data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    if(dataMap.contains(data->mTag))
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        auto item = dataMap.value(data->mTag);
+        if(item->mNotificationNumber < data->mNotificationNumber)
         {
-            dataMap[transfer->getTag()] = createData(transfer, nullptr);
-            return dataMap[transfer->getTag()];
+            dataMap[data->mTag] = data;
+            return data;
         }
 
         return item;
@@ -147,14 +153,14 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndSub
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, MegaTransfer* transfer)
+QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, QExplicitlySharedDataPointer<TransferData> data)
 {
-    if(dataMap.contains(transfer->getTag()))
+    if(dataMap.contains(data->mTag))
     {
-        auto item = dataMap.value(transfer->getTag());
-        if(item->mNotificationNumber < transfer->getNotificationNumber())
+        auto item = dataMap.value(data->mTag);
+        if(item->mNotificationNumber < data->mNotificationNumber)
         {
-            dataMap.remove(transfer->getTag());
+            dataMap.remove(data->mTag);
             return QExplicitlySharedDataPointer<TransferData>();
         }
 
@@ -164,38 +170,101 @@ QExplicitlySharedDataPointer<TransferData> TransferThread::checkIfRepeatedAndRem
     return QExplicitlySharedDataPointer<TransferData>();
 }
 
-QExplicitlySharedDataPointer<TransferData> TransferThread::onTransferEvent(MegaTransfer *transfer, mega::MegaError* e)
+void TransferThread::pushEvent(QExplicitlySharedDataPointer<TransferData> data, CacheType type, bool temporaryError)
+{
+    TransferEvent event;
+    event.data = data;
+    event.type = type;
+    event.temporaryError = temporaryError;
+    mEventQueue.push(std::move(event));
+}
+
+//Run in the consumer thread. Coalesces the event with the cached one with the same tag (if any),
+//keeping the most recent data (by notification number)
+void TransferThread::cacheEvent(TransferEvent&& event)
 {
-    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, transfer);
+    auto& data = event.data;
+
+    auto result = checkIfRepeatedAndSubstituteInStartTransfers(mTransfersToProcess.startTransfersByTag, data);
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.startSyncTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.canceledTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedFolderTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, transfer);
+        result = checkIfRepeatedAndSubstitute(mTransfersToProcess.failedTransfersByTag, data);
     }
 
     if(!result)
     {
-        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, transfer);
+        result = checkIfRepeatedAndRemove(mTransfersToProcess.updateTransfersByTag, data);
+    }
+
+    if(result)
+    {
+        if(event.temporaryError)
+        {
+            //A temporary error only keeps the failed transfer copy when it creates a new cache entry
+            if(result == data && data->getState() != TransferData::TRANSFER_FAILED)
+            {
+                data->removeFailedTransfer();
+            }
+        }
+        else if(data->mFailedTransfer && !result->mFailedTransfer)
+        {
+            result->mFailedTransfer = data->mFailedTransfer;
+        }
+
+        return;
     }
 
-    updateFailedTransfer(result, transfer, e);
+    data->mTemporaryError = event.temporaryError;
 
-    return result;
+    switch(event.type)
+    {
+        case CacheType::START:
+        {
+            mTransfersToProcess.startTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+        case CacheType::START_SYNC:
+        {
+            mTransfersToProcess.startSyncTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+        case CacheType::CANCELED:
+        {
+            mTransfersToProcess.canceledTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+        case CacheType::FAILED_FOLDER:
+        {
+            mTransfersToProcess.failedFolderTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+        case CacheType::FAILED:
+        {
+            mTransfersToProcess.failedTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+        case CacheType::UPDATE:
+        {
+            mTransfersToProcess.updateTransfersByTag.insert(data->mTag, data);
+            break;
+        }
+    }
 }
 
 void TransferThread::updateFailedTransfer(QExplicitlySharedDataPointer<TransferData> data,
@@ -258,24 +327,8 @@ void TransferThread::onTransferStart(MegaApi *, MegaTransfer *transfer)
                 }
             }
 
-            {
-                QMutexLocker cacheLock(&mCacheMutex);
-                auto data = onTransferEvent(transfer,  nullptr);
-
-                if(!data)
-                {
-                    data = createData(transfer, nullptr);
-
-                    if(transfer->isSyncTransfer())
-                    {
-                        mTransfersToProcess.startSyncTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.startTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                }
-            }
+            pushEvent(createData(transfer, nullptr),
+                      transfer->isSyncTransfer() ? CacheType::START_SYNC : CacheType::START);
         }
 
 }
@@ -305,17 +358,7 @@ void TransferThread::onTransferUpdate(MegaApi *, MegaTransfer *transfer)
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-
-            if(!data)
-            {
-                data =  createData(transfer, nullptr);
-
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-            }
-        }
+        pushEvent(createData(transfer, nullptr), CacheType::UPDATE);
     }
 }
 
@@ -432,40 +475,32 @@ void TransferThread::onTransferFinish(MegaApi*, MegaTransfer *transfer, MegaErro
 
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, e);
+        auto data = createData(transfer, e);
 
-            if(!data)
+        if(transfer->isFolderTransfer())
+        {
+            if(transfer->getState() == MegaTransfer::STATE_FAILED
+                    || e->getErrorCode() != mega::MegaError::API_OK)
             {
-                data =  createData(transfer, e);
-
-                if(transfer->isFolderTransfer())
-                {
-                    if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        //In some scenarios, the error code can be different to API_OK but the state is not failed
-                        data->setState(TransferData::TRANSFER_FAILED);
-                        mTransfersToProcess.failedFolderTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                }
-                else
-                {
-                    if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
-                    {
-                        mTransfersToProcess.canceledTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else if(transfer->getState() == MegaTransfer::STATE_FAILED
-                            || e->getErrorCode() != mega::MegaError::API_OK)
-                    {
-                        mTransfersToProcess.failedTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                    else
-                    {
-                        mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                    }
-                }
+                //In some scenarios, the error code can be different to API_OK but the state is not failed
+                data->setState(TransferData::TRANSFER_FAILED);
+                pushEvent(data, CacheType::FAILED_FOLDER);
+            }
+        }
+        else
+        {
+            if(transfer->getState() == MegaTransfer::STATE_CANCELLED)
+            {
+                pushEvent(data, CacheType::CANCELED);
+            }
+            else if(transfer->getState() == MegaTransfer::STATE_FAILED
+                    || e->getErrorCode() != mega::MegaError::API_OK)
+            {
+                pushEvent(data, CacheType::FAILED);
+            }
+            else
+            {
+                pushEvent(data, CacheType::UPDATE);
             }
         }
     }
@@ -496,17 +531,7 @@ void TransferThread::onTransferTemporaryError(MegaApi*, MegaTransfer *transfer,
             }
         }
 
-        {
-            QMutexLocker cacheLock(&mCacheMutex);
-            auto data = onTransferEvent(transfer, nullptr);
-            if(!data)
-            {
-                data =  createData(transfer, e);
-
-                mTransfersToProcess.updateTransfersByTag.insert(transfer->getTag(), data);
-                data->mTemporaryError = true;
-            }
-        }
+        pushEvent(createData(transfer, e), CacheType::UPDATE, true);
     }
 }
 
@@ -762,6 +787,8 @@ TransfersModel::TransfersModel(QObject *parent) :
     mUiBlockedByCounter(0),
     mCancelledFrom(nullptr),
     mSyncsInRowsToCancel(false),
+    //Recursive, as the sort and filter passes hold it while they may read the transfers through data()
+    mDataMutex(QReadWriteLock::Recursive),
     mIgnoreMoveSignal(false),
     mInverseMoveSignal(false)
 {
@@ -855,11 +882,11 @@ int TransfersModel::rowCount(const QModelIndex& parent) const
 
 int TransfersModel::columnCount(const QModelIndex& parent) const
 {
-    //The same number of columns as sort criterions are needed
+    //The displayed column plus one column per sort criterion (check sortColumn)
     //However in the sort filter the column count WILL BE ALWAYS 1 (check columnCount on sort filter class)
     if (parent == DEFAULT_IDX)
     {
-        return static_cast<int>(SortCriterion::LAST);
+        return static_cast<int>(SortCriterion::LAST) + 1;
     }
     return 0;
 }
@@ -886,6 +913,9 @@ QModelIndex TransfersModel::index(int row, int column, const QModelIndex&) const
 
 void TransfersModel::onProcessTransfers()
 {
+    //Always empty the event ring, even if the previous batch is still being processed
+    mTransferEventWorker->drainEvents();
+
     if(mTransfersToProcess.isEmpty())
     {
         mTransfersToProcess = mTransferEventWorker->processTransfers();
@@ -1103,16 +1133,21 @@ void TransfersModel::startTransfer(QExplicitlySharedDataPointer<TransferData> tr
 
         //Otherwise when filtering there will be wrong result
         transfer->setPreviousState(TransferData::TRANSFER_NONE);
+
+        refreshColumns(rowCount(DEFAULT_IDX) - 1);
     }
 }
 
-void TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row)
+TransferColumnStore::SortKeys TransfersModel::updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row)
 {
     checkActiveTransfer(transfer->mTag, transfer->isActive());
 
     mDataMutex.lockForWrite();
     mTransfers[row] = transfer;
+    auto changedKeys(mColumns.update(row, *transfer));
     mDataMutex.unlock();
+
+    return changedKeys;
 }
 
 void TransfersModel::processUpdateTransfers()
@@ -1132,13 +1167,13 @@ void TransfersModel::processUpdateTransfers()
             if(!mCompletedTransfersByTag.contains(itValue->mNodeHandle))
             {
                 itValue->setPreviousState(d->getState());
-                updateTransfer(itValue, row);
-                sendDataChanged(row);
+                auto changedKeys(updateTransfer(itValue, row));
+                sendDataChanged(row, changedKeys);
                 itValue->resetStateHasChanged();
 
                 if(d->isCompleted())
                 {
-                    mCompletedTransfersByTag.insert(itValue->mNodeHandle, index(row,0));
+                    mCompletedTransfersByTag.insert(itValue->mNodeHandle);
                 }
             }
         }
@@ -1159,7 +1194,7 @@ void TransfersModel::processFailedTransfers()
         if(d)
         {
             (*it)->setPreviousState(d->getState());
-            updateTransfer((*it), row);
+            auto changedKeys(updateTransfer((*it), row));
 
             if(d->isSyncTransfer())
             {
@@ -1167,7 +1202,7 @@ void TransfersModel::processFailedTransfers()
             }
             else
             {
-                sendDataChanged(row);
+                sendDataChanged(row, changedKeys);
             }
 
             (*it)->resetStateHasChanged();
@@ -2247,7 +2282,8 @@ void TransfersModel::addTransfer(QExplicitlySharedDataPointer<TransferData> tran
 {
     mDataMutex.lockForWrite();
     mTransfers.append(transfer);
-    mTagByOrder.insert(transfer->mTag, QPersistentModelIndex(index(rowCount(DEFAULT_IDX) - 1,0)));
+    mColumns.append(*transfer);
+    mTagIndex.append(transfer->mTag);
     mDataMutex.unlock();
 }
 
@@ -2264,20 +2300,85 @@ QExplicitlySharedDataPointer<TransferData> TransfersModel::getTransferByTag(int
 int TransfersModel::getRowByTransferTag(int tag) const
 {
     mDataMutex.lockForRead();
-    auto result = mTagByOrder.contains(tag) ? mTagByOrder.value(tag).row() : -1;
+    auto result = mTagIndex.row(tag);
     mDataMutex.unlock();
     return result;
 }
 
-void TransfersModel::removeTransfer(int row)
+void TransfersModel::removeTransfers(int row, int count)
 {
+    mDataMutex.lockForWrite();
+    if(row >= 0  && count > 0 && row + count <= mTransfers.size())
+    {
+        auto first = mTransfers.begin() + row;
+        auto last = first + count;
+        for(auto it = first; it != last; ++it)
+        {
+            mTagIndex.remove((*it)->mTag);
+        }
+
+        mTransfers.erase(first, last);
+        mColumns.remove(row, count);
+    }
+    mDataMutex.unlock();
+}
+
+//Transfers modified in place (i.e. paused/resumed) need to copy their new values to the columns
+TransferColumnStore::SortKeys TransfersModel::refreshColumns(int row)
+{
+    TransferColumnStore::SortKeys changedKeys(0);
+
     mDataMutex.lockForWrite();
     if(row >= 0  && row < mTransfers.size())
     {
-        auto transfer = mTransfers.takeAt(row);
-        mTagByOrder.remove(transfer->mTag);
+        changedKeys = mColumns.update(row, *mTransfers.at(row));
     }
     mDataMutex.unlock();
+
+    return changedKeys;
+}
+
+void TransfersModel::lockColumnsForRead() const
+{
+    mDataMutex.lockForRead();
+}
+
+void TransfersModel::unlockColumns() const
+{
+    mDataMutex.unlock();
+}
+
+bool TransfersModel::lessThanByRow(SortCriterion criterion, int leftRow, int rightRow, bool& comparable) const
+{
+    if(leftRow >= 0 && rightRow >= 0 && leftRow < mColumns.size() && rightRow < mColumns.size())
+    {
+        return mColumns.lessThan(criterion, leftRow, rightRow, comparable);
+    }
+
+    comparable = false;
+    return false;
+}
+
+bool TransfersModel::getColumnsRow(int row, TransferColumnStore::Row& columnsRow) const
+{
+    if(row >= 0 && row < mColumns.size())
+    {
+        columnsRow = mColumns.row(row);
+        return true;
+    }
+
+    return false;
+}
+
+QString TransfersModel::getNameByRow(int row) const
+{
+    return (row >= 0 && row < mColumns.size()) ? mColumns.name(row) : QString();
+}
+
+size_t TransfersModel::getColumnsMemoryUsage() const
+{
+    QReadLocker lock(&mDataMutex);
+    return mColumns.memoryUsage();
 }
 
 void TransfersModel::sendDataChangedByTag(int tag)
@@ -2285,14 +2386,27 @@ void TransfersModel::sendDataChangedByTag(int tag)
     sendDataChanged(getRowByTransferTag(tag));
 }
 
-void TransfersModel::sendDataChanged(int row)
+void TransfersModel::sendDataChanged(int row, TransferColumnStore::SortKeys changedKeys)
 {
+    changedKeys |= refreshColumns(row);
+
     if(!signalsBlocked())
     {
         QModelIndex indexChanged (index(row, 0, DEFAULT_IDX));
         if(indexChanged.isValid())
         {
             emit dataChanged(indexChanged, indexChanged);
+
+            //Only the proxies sorted by a modified key move the row (with a binary search)
+            for(int criterion = 0; criterion < static_cast<int>(SortCriterion::LAST); ++criterion)
+            {
+                auto sortCriterion(static_cast<SortCriterion>(criterion));
+                if(changedKeys & TransferColumnStore::sortKey(sortCriterion))
+                {
+                    QModelIndex keyChanged (index(row, sortColumn(sortCriterion), DEFAULT_IDX));
+                    emit dataChanged(keyChanged, keyChanged);
+                }
+            }
         }
     }
 }
@@ -2471,12 +2585,7 @@ bool TransfersModel::removeRows(int row, int count, const QModelIndex& parent)
     if (parent == DEFAULT_IDX && count > 0 && row >= 0)
     {
         beginRemoveRows(DEFAULT_IDX, row, row + count - 1);
-
-        for (auto i (0); i < count; ++i)
-        {
-            removeTransfer(row);
-        }
-
+        removeTransfers(row, count);
         endRemoveRows();
 
         return true;
@@ -2597,7 +2706,8 @@ void TransfersModel::resetModel()
 
     mDataMutex.lockForWrite();
     mTransfers.clear();
-    mTagByOrder.clear();
+    mColumns.clear();
+    mTagIndex.clear();
     mDataMutex.unlock();
 
     endResetModel();
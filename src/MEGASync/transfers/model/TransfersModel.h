@@ -3,9 +3,12 @@
 
 #include "QTMegaTransferListener.h"
 #include "TransferItem.h"
+#include "TransferColumnStore.h"
+#include "TransferTagIndex.h"
 #include "TransferMetaData.h"
 #include "TransferRemainingTime.h"
 #include "control/Preferences.h"
+#include "control/LockFreeMpscQueue.h"
 
 #include <megaapi.h>
 
@@ -130,6 +133,7 @@ public:
 
     void setMaxTransfersToProcess(uint16_t max);
 
+    void drainEvents();
     TransfersToProcess processTransfers();
     void clear();
 
@@ -148,11 +152,30 @@ private:
                               mega::MegaError* e);
 
     QExplicitlySharedDataPointer<TransferData> createData(mega::MegaTransfer* transfer, mega::MegaError *e);
-    QExplicitlySharedDataPointer<TransferData> onTransferEvent(mega::MegaTransfer* transfer, mega::MegaError *e);
+
+    enum class CacheType
+    {
+        UPDATE,
+        START,
+        START_SYNC,
+        CANCELED,
+        FAILED_FOLDER,
+        FAILED
+    };
+
+    struct TransferEvent
+    {
+        QExplicitlySharedDataPointer<TransferData> data;
+        CacheType type = CacheType::UPDATE;
+        bool temporaryError = false;
+    };
+
+    void pushEvent(QExplicitlySharedDataPointer<TransferData> data, CacheType type, bool temporaryError = false);
+    void cacheEvent(TransferEvent&& event);
     QList<QExplicitlySharedDataPointer<TransferData>> extractFromCache(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, int spaceForTransfers);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, mega::MegaTransfer *transfer);
-    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, mega::MegaTransfer *transfer);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndRemove(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, QExplicitlySharedDataPointer<TransferData> data);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstitute(QMap<int, QExplicitlySharedDataPointer<TransferData>>& dataMap, QExplicitlySharedDataPointer<TransferData> data);
+    QExplicitlySharedDataPointer<TransferData> checkIfRepeatedAndSubstituteInStartTransfers(QMap<int, QExplicitlySharedDataPointer<TransferData> > &dataMap, QExplicitlySharedDataPointer<TransferData> data);
 
     struct cacheTransfers
     {
@@ -174,8 +197,10 @@ private:
         }
     };
 
+    //Filled by the SDK threads without locking, drained and coalesced by tag in the GUI thread
+    LockFreeMpscQueue<TransferEvent> mEventQueue;
+    //Only accessed by the consumer (GUI thread)
     cacheTransfers mTransfersToProcess;
-    QMutex mCacheMutex;
     QMutex mCountersMutex;
     TransfersCount mTransfersCount;
     LastTransfersCount mLastTransfersCount;
@@ -258,7 +283,7 @@ public:
     long long failedTransfers();
 
     void startTransfer(QExplicitlySharedDataPointer<TransferData> transfer);
-    void updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row);
+    TransferColumnStore::SortKeys updateTransfer(QExplicitlySharedDataPointer<TransferData> transfer, int row);
 
     void pauseModelProcessing(bool value);
 
@@ -270,6 +295,20 @@ public:
     int getRowByTransferTag(int tag) const;
     void sendDataChangedByTag(int tag);
 
+    //Columnar accessors used by the proxies to sort and filter without touching TransferData.
+    //They do not lock: a sort or filter pass in another thread holds lockColumnsForRead while it runs,
+    //and the model thread, the only one which writes the columns, reads them directly
+    void lockColumnsForRead() const;
+    void unlockColumns() const;
+    bool lessThanByRow(SortCriterion criterion, int leftRow, int rightRow, bool& comparable) const;
+    bool getColumnsRow(int row, TransferColumnStore::Row& columnsRow) const;
+    QString getNameByRow(int row) const;
+    size_t getColumnsMemoryUsage() const;
+
+    //Column 0 is the displayed one. Each sort criterion has its own column, which only receives
+    //dataChanged when its key changes, so a dynamic proxy sorted by it re-sorts only those rows
+    static int sortColumn(SortCriterion criterion) {return static_cast<int>(criterion) + 1;}
+
     void blockModelSignals(bool state);
 
     int hasActiveTransfers() const;
@@ -326,8 +365,9 @@ private:
     void removeRows(QModelIndexList &indexesToRemove);
     QExplicitlySharedDataPointer<TransferData> getTransfer(int row) const;
     void addTransfer(QExplicitlySharedDataPointer<TransferData>);
-    void removeTransfer(int row);
-    void sendDataChanged(int row);
+    void removeTransfers(int row, int count);
+    TransferColumnStore::SortKeys refreshColumns(int row);
+    void sendDataChanged(int row, TransferColumnStore::SortKeys changedKeys = 0);
 
     void retryTransfers(const QMultiMap<unsigned long long, std::shared_ptr<mega::MegaTransfer>>& transfersToRetry);
 
@@ -361,8 +401,9 @@ private:
     LastTransfersCount mLastTransfersCount;
 
     QList<QExplicitlySharedDataPointer<TransferData>> mTransfers;
+    TransferColumnStore mColumns;
     QHash<int,QExplicitlySharedDataPointer<TransferData>> mFailedFoldersByTag;
-    QHash<mega::MegaHandle,QPersistentModelIndex> mCompletedTransfersByTag;
+    QSet<mega::MegaHandle> mCompletedTransfersByTag;
 
     TransferThread::TransfersToProcess mTransfersToProcess;
     QFutureWatcher<void> mUpdateTransferWatcher;
@@ -376,7 +417,7 @@ private:
     int mUiBlockedByCounter;
     uint8_t  mUiBlockedByCounterSafety;
 
-    QHash<TransferTag, QPersistentModelIndex> mTagByOrder;
+    TransferTagIndex mTagIndex;
     QList<TransferTag> mRowsToCancel;
     QWidget* mCancelledFrom;
     bool mSyncsInRowsToCancel;
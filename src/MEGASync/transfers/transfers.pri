@@ -8,13 +8,18 @@ SOURCES += $$PWD/model/TransfersModel.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeInfo.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeItem.cpp \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedUploadChecker.cpp \
+           $$PWD/gui/DuplicatedNodeDialogs/DuplicatedUploadPreflight.cpp \
+           $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNameAllocator.cpp \
            $$PWD/gui/InfoDialogTransferLoadingItem.cpp \
            $$PWD/model/InfoDialogTransfersProxyModel.cpp \
            $$PWD/model/TransfersManagerSortFilterProxyModel.cpp \
            $$PWD/model/TransferMetaData.cpp \
+           $$PWD/model/TransferColumnStore.cpp \
+           $$PWD/model/TransferTagIndex.cpp \
            $$PWD/gui/InfoDialogTransferDelegateWidget.cpp \
            $$PWD/gui/InfoDialogTransfersWidget.cpp \
            $$PWD/gui/MegaTransferDelegate.cpp  \
+           $$PWD/gui/TransferRowPixmapCache.cpp \
            $$PWD/gui/MegaTransferView.cpp \
            $$PWD/gui/TransferBaseDelegateWidget.cpp \
            $$PWD/gui/TransferItem.cpp \
@@ -32,14 +37,19 @@ HEADERS += $$PWD/model/InfoDialogTransfersProxyModel.h \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeInfo.h \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNodeItem.h \
            $$PWD/gui/DuplicatedNodeDialogs/DuplicatedUploadChecker.h \
+           $$PWD/gui/DuplicatedNodeDialogs/DuplicatedUploadPreflight.h \
+           $$PWD/gui/DuplicatedNodeDialogs/DuplicatedNameAllocator.h \
            $$PWD/gui/InfoDialogTransferLoadingItem.h \
            $$PWD/model/TransfersManagerSortFilterProxyModel.h \
            $$PWD/model/TransfersSortFilterProxyBaseModel.h \
            $$PWD/model/TransfersModel.h \
            $$PWD/model/TransferMetaData.h \
+           $$PWD/model/TransferColumnStore.h \
+           $$PWD/model/TransferTagIndex.h \
            $$PWD/gui/InfoDialogTransferDelegateWidget.h \
            $$PWD/gui/InfoDialogTransfersWidget.h \
            $$PWD/gui/MegaTransferDelegate.h  \
+           $$PWD/gui/TransferRowPixmapCache.h \
            $$PWD/gui/MegaTransferView.h \
            $$PWD/gui/TransferBaseDelegateWidget.h \
            $$PWD/gui/TransferItem.h \
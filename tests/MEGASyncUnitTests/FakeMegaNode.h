@@ -0,0 +1,119 @@
+#ifndef FAKEMEGANODE_H
+#define FAKEMEGANODE_H
+
+#include <megaapi.h>
+
+#include <string>
+#include <vector>
+
+//Node with only the fields read by the models under test, so they can be tested without a session
+class FakeMegaNode : public mega::MegaNode
+{
+public:
+    FakeMegaNode(mega::MegaHandle handle, mega::MegaHandle parentHandle, const std::string& name, int type = TYPE_FOLDER, int changes = 0)
+        : mHandle(handle),
+          mParentHandle(parentHandle),
+          mName(name),
+          mType(type),
+          mChanges(changes)
+    {
+    }
+
+    mega::MegaNode* copy() override
+    {
+        return new FakeMegaNode(*this);
+    }
+
+    int getType() override
+    {
+        return mType;
+    }
+
+    const char* getName() override
+    {
+        return mName.c_str();
+    }
+
+    mega::MegaHandle getHandle() override
+    {
+        return mHandle;
+    }
+
+    mega::MegaHandle getParentHandle() override
+    {
+        return mParentHandle;
+    }
+
+    int getChanges() override
+    {
+        return mChanges;
+    }
+
+    bool isFile() override
+    {
+        return mType == TYPE_FILE;
+    }
+
+    bool isFolder() override
+    {
+        return mType != TYPE_FILE;
+    }
+
+    bool isInShare() override
+    {
+        return false;
+    }
+
+    bool isNodeKeyDecrypted() override
+    {
+        return true;
+    }
+
+private:
+    mega::MegaHandle mHandle;
+    mega::MegaHandle mParentHandle;
+    std::string mName;
+    int mType;
+    int mChanges;
+};
+
+class FakeMegaNodeList : public mega::MegaNodeList
+{
+public:
+    void add(const FakeMegaNode& node)
+    {
+        mNodes.push_back(node);
+    }
+
+    //Child without parent, with the next handle from 1
+    void add(const std::string& name, int type)
+    {
+        add(FakeMegaNode(static_cast<mega::MegaHandle>(mNodes.size() + 1), mega::INVALID_HANDLE, name, type));
+    }
+
+    //Children named after their handles
+    void addRange(mega::MegaHandle parentHandle, mega::MegaHandle firstHandle, int size, int type)
+    {
+        mNodes.reserve(mNodes.size() + static_cast<size_t>(size));
+        for(int i = 0; i < size; ++i)
+        {
+            auto handle(firstHandle + static_cast<mega::MegaHandle>(i));
+            add(FakeMegaNode(handle, parentHandle, std::to_string(handle), type));
+        }
+    }
+
+    mega::MegaNode* get(int i) const override
+    {
+        return const_cast<FakeMegaNode*>(&mNodes[static_cast<size_t>(i)]);
+    }
+
+    int size() const override
+    {
+        return static_cast<int>(mNodes.size());
+    }
+
+private:
+    std::vector<FakeMegaNode> mNodes;
+};
+
+#endif // FAKEMEGANODE_H
@@ -11,5 +11,41 @@ include(../3rdparty/trompeloeil/trompeloeil.pri)
 SOURCES += GuestWidgetTest.cpp \
            Utilities.test.cpp \
            control/TransferRemainingTime.Test.cpp \
+           control/EncryptedSettings.Test.cpp \
+           control/PreferencesCache.Test.cpp \
+           control/LockFreeMpscQueue.Test.cpp \
+           control/LogRing.Test.cpp \
+           control/LogCompression.Test.cpp \
+           control/LogBundleBuilder.Test.cpp \
+           control/CollationKeyCache.Test.cpp \
+           control/MegaUploader.Test.cpp \
+           control/TransferBatch.Test.cpp \
+           control/HTTPRequestParser.Test.cpp \
+           control/HTTPServer.Test.cpp \
+           transfers/TransferColumnStore.Test.cpp \
+           transfers/TransferTagIndex.Test.cpp \
+           transfers/TransferMetaData.Test.cpp \
+           transfers/DuplicatedUploadPreflight.Test.cpp \
+           transfers/DuplicatedNameAllocator.Test.cpp \
+           transfers/TransferRowPixmapCache.Test.cpp \
+           node_selector/NodeSelectorModelItem.Test.cpp \
+           node_selector/NodeSearchIndex.Test.cpp \
+           node_selector/NodeTreeSnapshot.Test.cpp \
            ScaleFactorManager.Test.cpp \
            main.cpp
+
+# fake SDK objects shared by the tests
+HEADERS += FakeMegaNode.h
+INCLUDEPATH += $$PWD
+
+unix:!macx {
+    SOURCES += platform/linux/PathStateCache.Test.cpp \
+               platform/linux/ShellExtPathStateCache.Test.cpp \
+               ../../src/MEGAShellExtNautilus/mega_ext_cache.c
+
+    # client side caches of the shell extensions. Nemo builds the same mega_ext_cache.c
+    INCLUDEPATH += $$PWD/../../src/MEGAShellExtNautilus \
+                   $$PWD/../../src/MEGAShellExtDolphin
+    CONFIG += link_pkgconfig
+    PKGCONFIG += glib-2.0
+}
@@ -0,0 +1,110 @@
+#include <catch.hpp>
+#include "CollationKeyCache.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace
+{
+QCollator createCollator()
+{
+    QCollator collator;
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    collator.setNumericMode(true);
+    return collator;
+}
+
+bool lessThan(CollationKeyCache& cache, const QStringList& names, int left, int right)
+{
+    return cache.compare(static_cast<quint64>(left), [&names, left](){ return names.at(left); },
+                         static_cast<quint64>(right), [&names, right](){ return names.at(right); }) < 0;
+}
+}
+
+TEST_CASE("Collation keys sort like the collator")
+{
+    CollationKeyCache cache(createCollator());
+    QStringList names;
+    names << QLatin1String("File 10") << QLatin1String("file 9") << QLatin1String("File 100");
+
+    REQUIRE(lessThan(cache, names, 1, 0));
+    REQUIRE(lessThan(cache, names, 0, 2));
+    REQUIRE_FALSE(lessThan(cache, names, 2, 1));
+    REQUIRE(cache.size() == 3);
+
+    SECTION("Keys are kept until they are removed")
+    {
+        names[1] = QLatin1String("file 99");
+        REQUIRE(lessThan(cache, names, 1, 0));
+
+        cache.remove(1);
+        REQUIRE_FALSE(lessThan(cache, names, 1, 0));
+        REQUIRE(lessThan(cache, names, 1, 2));
+    }
+
+    SECTION("Built keys are the same as the compared ones")
+    {
+        cache.clear();
+        cache.build(QVector<quint64>() << 0 << 1 << 2, [&names](int position) { return names.at(position); });
+        REQUIRE(cache.size() == 3);
+        REQUIRE(lessThan(cache, names, 1, 0));
+        REQUIRE(lessThan(cache, names, 0, 2));
+    }
+}
+
+TEST_CASE("Collation keys benchmark", "[.benchmark]")
+{
+    //A synthetic folder of 100k photos and documents, in no particular order
+    constexpr int items{100000};
+    QStringList names;
+    for(int item = 0; item < items; ++item)
+    {
+        names.append(item % 2 ? QString::fromLatin1("IMG_%1.jpg").arg(item) : QString::fromLatin1("Report %1 (final).pdf").arg(items - item));
+    }
+
+    std::vector<int> shuffled(items);
+    std::iota(shuffled.begin(), shuffled.end(), 0);
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(42));
+
+    //Comparing the names with the collator, as the proxy models did before
+    auto collator = createCollator();
+    auto rows(shuffled);
+    QElapsedTimer timer;
+    timer.start();
+    std::stable_sort(rows.begin(), rows.end(), [&names, &collator](int left, int right)
+    {
+        return collator.compare(names.at(left), names.at(right)) < 0;
+    });
+    auto collatorMs(timer.elapsed());
+    auto collatorRows(rows);
+
+    CollationKeyCache cache(collator);
+    rows = shuffled;
+    timer.start();
+    QVector<quint64> ids;
+    ids.reserve(items);
+    for(auto row : rows)
+    {
+        ids.append(static_cast<quint64>(row));
+    }
+    cache.build(ids, [&names, &rows](int position) { return names.at(rows[static_cast<size_t>(position)]); });
+    auto buildMs(timer.elapsed());
+
+    timer.start();
+    std::stable_sort(rows.begin(), rows.end(), [&names, &cache](int left, int right)
+    {
+        return lessThan(cache, names, left, right);
+    });
+    auto keysMs(timer.elapsed());
+
+    std::cout << "Sorted " << items << " names: " << collatorMs << " ms comparing them with the collator, "
+              << buildMs << " ms building the keys in parallel and " << keysMs << " ms comparing the keys" << std::endl;
+
+    REQUIRE(rows == collatorRows);
+}
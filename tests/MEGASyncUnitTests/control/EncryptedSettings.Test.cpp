@@ -0,0 +1,161 @@
+#include <catch.hpp>
+#include "EncryptedSettings.h"
+#include "platform/Platform.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+
+#include <iostream>
+#include <memory>
+#include <thread>
+
+namespace
+{
+void createPlatform()
+{
+    static bool created = false;
+    if (!created)
+    {
+        Platform::create();
+        created = true;
+    }
+}
+
+QString settingsFile(const QTemporaryDir& dir)
+{
+    return dir.path() + QLatin1String("/MEGAsync.cfg");
+}
+}
+
+TEST_CASE("Encrypted settings keep values by group and persist them")
+{
+    createPlatform();
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    {
+        EncryptedSettings settings(settingsFile(dir));
+        settings.setValue(QLatin1String("currentAccount"), QLatin1String("user@mega.nz"));
+        REQUIRE(settings.value(QLatin1String("currentAccount")).toString() == QLatin1String("user@mega.nz"));
+        REQUIRE(settings.value(QLatin1String("missing"), 5).toString() == QLatin1String("5"));
+        REQUIRE(settings.value(QLatin1String("missing")).toString().isEmpty());
+
+        settings.beginGroup(QLatin1String("user@mega.nz"));
+        REQUIRE(settings.value(QLatin1String("currentAccount")).toString().isEmpty());
+        settings.setValue(QLatin1String("uploadLimitKB"), 100);
+        settings.setValue(QLatin1String("uploadLimitKB"), 200);
+        settings.setValue(QLatin1String("session"), QLatin1String("abc"));
+        REQUIRE(settings.value(QLatin1String("uploadLimitKB")).toInt() == 200);
+
+        settings.remove(QLatin1String("session"));
+        REQUIRE(settings.value(QLatin1String("session"), QLatin1String("none")).toString() == QLatin1String("none"));
+        settings.endGroup();
+
+        REQUIRE(settings.containsGroup(QLatin1String("user@mega.nz")));
+        settings.sync();
+        settings.setValue(QLatin1String("lastExit"), 1234);
+        settings.sync();
+
+        //The second sync is written after the interval, or when the settings are destroyed
+        REQUIRE(settings.needsDeferredSync());
+    }
+
+    {
+        EncryptedSettings settings(settingsFile(dir));
+        REQUIRE(settings.value(QLatin1String("currentAccount")).toString() == QLatin1String("user@mega.nz"));
+        REQUIRE(settings.value(QLatin1String("lastExit")).toInt() == 1234);
+
+        settings.beginGroup(QLatin1String("user@mega.nz"));
+        REQUIRE(settings.value(QLatin1String("uploadLimitKB")).toInt() == 200);
+        REQUIRE(settings.value(QLatin1String("session")).toString().isEmpty());
+
+        //Removing the group drops its cached values too
+        settings.remove(QString());
+        REQUIRE(settings.value(QLatin1String("uploadLimitKB"), 0).toInt() == 0);
+        settings.endGroup();
+
+        REQUIRE_FALSE(settings.containsGroup(QLatin1String("user@mega.nz")));
+    }
+}
+
+TEST_CASE("Encrypted settings write a coalesced sync requested from a thread without event loop")
+{
+    createPlatform();
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    EncryptedSettings settings(settingsFile(dir));
+    settings.setValue(QLatin1String("currentAccount"), QLatin1String("user@mega.nz"));
+    settings.sync();
+
+    settings.setValue(QLatin1String("lastExit"), 1234);
+    std::thread([&settings]()
+    {
+        settings.sync();
+    }).join();
+    REQUIRE(settings.needsDeferredSync());
+
+    //The timer runs in the thread of the settings
+    QElapsedTimer timer;
+    timer.start();
+    while (settings.needsDeferredSync() && !timer.hasExpired(5000))
+    {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 100);
+    }
+    REQUIRE_FALSE(settings.needsDeferredSync());
+}
+
+TEST_CASE("Encrypted settings latency benchmark", "[.benchmark]")
+{
+    constexpr int keys{200};
+    constexpr int iterations{100};
+
+    createPlatform();
+    QTemporaryDir dir;
+    std::unique_ptr<EncryptedSettings> settings(new EncryptedSettings(settingsFile(dir)));
+    settings->beginGroup(QLatin1String("user@mega.nz"));
+    for (int i = 0; i < keys; ++i)
+    {
+        settings->setValue(QString::fromLatin1("key%1").arg(i), QString::fromLatin1("value %1").arg(i));
+    }
+    settings->endGroup();
+    settings->flush();
+    settings.reset();
+
+    //Each first read decrypts the value, like every read did before the cache
+    settings.reset(new EncryptedSettings(settingsFile(dir)));
+    settings->beginGroup(QLatin1String("user@mega.nz"));
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < keys; ++i)
+    {
+        settings->value(QString::fromLatin1("key%1").arg(i));
+    }
+    auto decryptNs(timer.nsecsElapsed() / keys);
+
+    timer.start();
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        for (int i = 0; i < keys; ++i)
+        {
+            settings->value(QString::fromLatin1("key%1").arg(i));
+        }
+    }
+    auto cachedNs(timer.nsecsElapsed() / (keys * iterations));
+
+    timer.start();
+    for (int iteration = 0; iteration < iterations; ++iteration)
+    {
+        settings->setValue(QLatin1String("lastExit"), iteration);
+        settings->sync();
+    }
+    auto setAndSyncNs(timer.nsecsElapsed() / iterations);
+    settings->endGroup();
+
+    std::cout << "Uncached value: " << decryptNs / 1000 << " us" << std::endl;
+    std::cout << "Cached value: " << cachedNs << " ns" << std::endl;
+    std::cout << "setValue + sync: " << setAndSyncNs / 1000 << " us" << std::endl;
+
+    REQUIRE(settings->needsDeferredSync());
+}
@@ -0,0 +1,170 @@
+#include <catch.hpp>
+#include "HTTPRequestParser.h"
+
+#include <QElapsedTimer>
+
+#include <iostream>
+
+namespace
+{
+QByteArray createRequest(const QByteArray& body)
+{
+    return QByteArray("POST / HTTP/1.1\r\n"
+                      "Host: localhost.megasync.nz:6342\r\n"
+                      "Origin: https://mega.nz\r\n"
+                      "Content-Length: ") + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+}
+
+QByteArray createNode(int index, bool first)
+{
+    QByteArray name = QByteArray("file_") + QByteArray::number(index) + ".jpg";
+    QByteArray node = QByteArray("{\"t\":0,\"h\":\"") + QByteArray::number(10000000 + index).left(8)
+            + "\",\"n\":\"" + name.toBase64(QByteArray::Base64UrlEncoding)
+            + "\",\"k\":\"" + QByteArray(43, 'k') + "\",\"s\":" + QByteArray::number(index * 1000)
+            + ",\"ts\":1600000000";
+    if (!first)
+    {
+        node += ",\"p\":\"AAAAAAAA\"";
+    }
+    return node + "}";
+}
+
+QByteArray createDownloadRequest(int minimumSize)
+{
+    QByteArray body("{\"a\":\"d\",\"esid\":\"privateAuthToken\",\"f\":[");
+    body.reserve(minimumSize + 1024);
+    for (int index = 0; body.size() < minimumSize; ++index)
+    {
+        if (index)
+        {
+            body += ',';
+        }
+        body += createNode(index, !index);
+    }
+    return body + "]}";
+}
+}
+
+TEST_CASE("HTTP request parser reads headers and body split across chunks")
+{
+    QByteArray body("{\"a\":\"v\"}");
+    QByteArray request = createRequest(body);
+
+    HTTPRequestParser parser;
+    for (int pos = 0; pos < request.size(); ++pos)
+    {
+        auto state = parser.feed(request.mid(pos, 1));
+        REQUIRE(state == (pos + 1 < request.size() ? (parser.headers().isEmpty() ? HTTPRequestParser::READING_HEADERS
+                                                                                  : HTTPRequestParser::READING_BODY)
+                                                   : HTTPRequestParser::COMPLETE));
+    }
+
+    REQUIRE(parser.headers().size() == 4);
+    REQUIRE(parser.headers().first() == QString::fromUtf8("POST / HTTP/1.1"));
+    REQUIRE(parser.contentLength() == body.size());
+    REQUIRE(parser.takeBody() == body);
+    REQUIRE(parser.remaining().isEmpty());
+}
+
+TEST_CASE("HTTP request parser keeps the bytes after the body")
+{
+    QByteArray body("{\"a\":\"v\"}");
+    HTTPRequestParser parser;
+    REQUIRE(parser.feed(createRequest(body) + "POST") == HTTPRequestParser::COMPLETE);
+    REQUIRE(parser.takeBody() == body);
+    REQUIRE(parser.remaining() == QByteArray("POST"));
+}
+
+TEST_CASE("HTTP request parser rejects invalid Content-Length headers")
+{
+    HTTPRequestParser parser;
+    REQUIRE(parser.feed("POST / HTTP/1.1\r\nContent-length: abc\r\n\r\n") == HTTPRequestParser::INVALID);
+
+    HTTPRequestParser withoutLength;
+    REQUIRE(withoutLength.feed("OPTIONS / HTTP/1.1\r\n\r\n") == HTTPRequestParser::COMPLETE);
+    REQUIRE_FALSE(withoutLength.hasContentLength());
+}
+
+TEST_CASE("HTTP request parser does not allocate the announced Content-Length up front")
+{
+    HTTPRequestParser parser;
+    REQUIRE(parser.feed("POST / HTTP/1.1\r\nContent-Length: 100000000\r\n\r\nabc") == HTTPRequestParser::READING_BODY);
+    REQUIRE(parser.takeBody().capacity() < 1024 * 1024);
+
+    HTTPRequestParser complete;
+    complete.feed("POST / HTTP/1.1\r\nContent-Length: 6\r\n\r\nabc");
+    REQUIRE(complete.feed("def") == HTTPRequestParser::COMPLETE);
+    REQUIRE(complete.takeBody() == "abcdef");
+}
+
+TEST_CASE("Webclient download parser reads auth and nodes")
+{
+    QByteArray body("{\"a\":\"d\",\"cauth\":\"chat\",\"auth\":\"ABCDEFGH\",\"f\":["
+                    "{\"t\":1,\"h\":\"AAAAAAAA\",\"n\":\"Zm9sZGVy\",\"x\":{\"y\":[1,2]}},"
+                    "{\"t\":0,\"h\":\"BBBBBBBB\",\"p\":\"AAAAAAAA\",\"n\":\"ZmlsZQ\",\"s\":1024,\"ts\":1600000000}]}");
+
+    WebclientDownloadParser parser(body);
+    REQUIRE(parser.readHeader());
+    REQUIRE(parser.auth() == QByteArray("ABCDEFGH"));
+    REQUIRE(parser.chatAuth() == QByteArray("chat"));
+    REQUIRE(parser.privateAuth().isEmpty());
+
+    WebclientNode node;
+    REQUIRE(parser.nextNode(node));
+    REQUIRE(node.type == 1);
+    REQUIRE(node.handle == QByteArray("AAAAAAAA"));
+    REQUIRE(QByteArray::fromBase64(node.name, QByteArray::Base64UrlEncoding) == QByteArray("folder"));
+
+    REQUIRE(parser.nextNode(node));
+    REQUIRE(node.type == 0);
+    REQUIRE(node.parent == QByteArray("AAAAAAAA"));
+    REQUIRE(node.size == 1024);
+    REQUIRE(node.mtime == 1600000000);
+
+    REQUIRE_FALSE(parser.nextNode(node));
+    REQUIRE_FALSE(parser.hasError());
+}
+
+TEST_CASE("Webclient download parser reports truncated requests")
+{
+    WebclientDownloadParser parser(QByteArray("{\"a\":\"d\",\"esid\":\"x\",\"f\":[{\"t\":0,\"h\":\"AAAA"));
+    REQUIRE(parser.readHeader());
+
+    WebclientNode node;
+    REQUIRE_FALSE(parser.nextNode(node));
+    REQUIRE(parser.hasError());
+}
+
+TEST_CASE("Webclient 50 MB download request parsing benchmark", "[.benchmark]")
+{
+    //Fed in socket sized chunks, as readClient receives it
+    constexpr int chunkSize{16 * 1024};
+    QByteArray request = createRequest(createDownloadRequest(50 * 1024 * 1024));
+
+    QElapsedTimer timer;
+    timer.start();
+
+    HTTPRequestParser httpParser;
+    for (int pos = 0; pos < request.size(); pos += chunkSize)
+    {
+        httpParser.feed(QByteArray::fromRawData(request.constData() + pos, std::min(chunkSize, request.size() - pos)));
+    }
+    REQUIRE(httpParser.state() == HTTPRequestParser::COMPLETE);
+    auto httpElapsed = timer.restart();
+
+    QByteArray body = httpParser.takeBody();
+    WebclientDownloadParser parser(body);
+    REQUIRE(parser.readHeader());
+
+    int nodes(0);
+    WebclientNode node;
+    while (parser.nextNode(node))
+    {
+        ++nodes;
+    }
+    auto jsonElapsed = timer.elapsed();
+    REQUIRE_FALSE(parser.hasError());
+
+    std::cout << "Webclient request: " << request.size() / (1024 * 1024) << " MB, " << nodes << " nodes. "
+              << "HTTP " << httpElapsed << " ms, JSON " << jsonElapsed << " ms" << std::endl;
+}
@@ -0,0 +1,231 @@
+#include <catch.hpp>
+#include "HTTPServer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTcpSocket>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace
+{
+const QByteArray RESPONSE_START("HTTP/1.");
+
+QByteArray createPost(const QByteArray& body, bool keepAlive)
+{
+    return QByteArray("POST / HTTP/1.1\r\n"
+                      "Host: localhost.megasync.nz\r\n"
+                      "Origin: https://mega.nz\r\n")
+            + (keepAlive ? QByteArray() : QByteArray("Connection: close\r\n"))
+            + "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body;
+}
+
+QByteArray createProgressQuery(int index)
+{
+    return QByteArray("{\"a\":\"t\",\"h\":\"") + QByteArray::number(10000000 + index % 1000) + "\"}";
+}
+
+//Runs the event loop, so the server in this same thread answers, until the condition holds or it times out
+template <typename Condition>
+bool processEventsUntil(Condition condition, int timeoutMs = 5000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (!condition() && timer.elapsed() < timeoutMs)
+    {
+        QCoreApplication::processEvents();
+    }
+    return condition();
+}
+
+int countResponses(const QByteArray& data)
+{
+    return data.count(RESPONSE_START);
+}
+
+class ProgressTransfer : public mega::MegaTransfer
+{
+public:
+    ProgressTransfer(mega::MegaHandle handle, long long transferredBytes)
+        : mHandle(handle),
+          mTransferredBytes(transferredBytes)
+    {
+    }
+
+    mega::MegaTransfer* copy() override
+    {
+        return new ProgressTransfer(*this);
+    }
+
+    mega::MegaHandle getNodeHandle() const override
+    {
+        return mHandle;
+    }
+
+    int getState() const override
+    {
+        return STATE_ACTIVE;
+    }
+
+    long long getTransferredBytes() const override
+    {
+        return mTransferredBytes;
+    }
+
+    long long getTotalBytes() const override
+    {
+        return 1000;
+    }
+
+    long long getSpeed() const override
+    {
+        return mTransferredBytes / 10;
+    }
+
+    const char* getPath() const override
+    {
+        return "/home/user/Downloads/file.txt";
+    }
+
+private:
+    mega::MegaHandle mHandle;
+    long long mTransferredBytes;
+};
+}
+
+TEST_CASE("Transfer updates are coalesced until they are taken")
+{
+    //Updates the SDK reports for two transfers between two polls of the webclient
+    TransferUpdateCoalescer coalescer;
+    for (long long progress = 1; progress <= 100; ++progress)
+    {
+        ProgressTransfer transfer(1, progress);
+        coalescer.add(&transfer);
+    }
+    ProgressTransfer other(2, 50);
+    coalescer.add(&other);
+    REQUIRE(coalescer.size() == 2);
+    REQUIRE(coalescer.coalesced() == 99);
+
+    //A single update is published for each transfer, with the last values
+    TransferUpdateCoalescer::Update update;
+    REQUIRE(coalescer.take(1, update));
+    REQUIRE(update.state == mega::MegaTransfer::STATE_ACTIVE);
+    REQUIRE(update.progress == 100);
+    REQUIRE(update.speed == 10);
+    REQUIRE(update.localPath == "/home/user/Downloads/file.txt");
+    REQUIRE_FALSE(coalescer.take(1, update));
+
+    coalescer.remove(2);
+    REQUIRE_FALSE(coalescer.take(2, update));
+    REQUIRE(coalescer.size() == 0);
+
+    //A taken update is not pending anymore, so the next one is not coalesced
+    ProgressTransfer next(1, 101);
+    coalescer.add(&next);
+    REQUIRE(coalescer.coalesced() == 99);
+}
+
+TEST_CASE("HTTP server answers pipelined requests on a persistent connection")
+{
+    HTTPServer server(nullptr, 0, false);
+    QTcpSocket client;
+    client.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    REQUIRE(processEventsUntil([&client](){ return client.state() == QAbstractSocket::ConnectedState; }));
+
+    QByteArray received;
+    QObject::connect(&client, &QTcpSocket::readyRead, [&client, &received](){ received += client.readAll(); });
+
+    client.write(createPost(createProgressQuery(0), true) + createPost(createProgressQuery(1), true));
+    REQUIRE(processEventsUntil([&received](){ return countResponses(received) == 2; }));
+    REQUIRE(received.count("Connection: keep-alive") == 2);
+
+    client.write(createPost("{\"a\":\"tb\",\"h\":[\"AAAAAAAA\",\"BBBBBBBB\"]}", false));
+    REQUIRE(processEventsUntil([&client](){ return client.state() == QAbstractSocket::UnconnectedState; }));
+    REQUIRE(countResponses(received) == 3);
+    REQUIRE(received.endsWith("{\"AAAAAAAA\":-9,\"BBBBBBBB\":-9}"));
+}
+
+TEST_CASE("Webclient progress polling benchmark", "[.benchmark]")
+{
+    //A stand-in webclient polls the progress of a transfer 1000 times per second for 3 seconds.
+    //The server runs without SSL, as the test has no certificate: the TLS handshake that a persistent
+    //connection also saves per poll is not measured, so the real difference is larger than reported here
+    constexpr int pollsPerSecond{1000};
+    constexpr int seconds{3};
+    constexpr int polls{pollsPerSecond * seconds};
+
+    HTTPServer server(nullptr, 0, false);
+
+    auto run = [&server](bool keepAlive)
+    {
+        std::vector<qint64> latencies;
+        std::vector<qint64> sentAt(polls, 0);
+        QByteArray received;
+        int answered(0);
+
+        QElapsedTimer timer;
+        timer.start();
+
+        std::unique_ptr<QTcpSocket> persistent;
+        std::vector<std::unique_ptr<QTcpSocket>> connections;
+        auto onAnswer = [&](QTcpSocket* socket)
+        {
+            received += socket->readAll();
+            int responses = countResponses(received);
+            for(int response = 0; response < responses; ++response, ++answered)
+            {
+                latencies.push_back(timer.nsecsElapsed() / 1000 - sentAt[static_cast<size_t>(answered)]);
+            }
+            if(responses)
+            {
+                received = received.mid(received.lastIndexOf(RESPONSE_START) + RESPONSE_START.size());
+            }
+        };
+
+        if(keepAlive)
+        {
+            persistent.reset(new QTcpSocket());
+            persistent->connectToHost(QHostAddress::LocalHost, server.serverPort());
+            QObject::connect(persistent.get(), &QTcpSocket::readyRead, [&](){ onAnswer(persistent.get()); });
+        }
+
+        int sent(0);
+        timer.restart();
+        processEventsUntil([&]()
+        {
+            while(sent < polls && timer.nsecsElapsed() >= static_cast<qint64>(sent) * 1000000000LL / pollsPerSecond)
+            {
+                QTcpSocket* socket = persistent.get();
+                if(!keepAlive)
+                {
+                    connections.emplace_back(new QTcpSocket());
+                    socket = connections.back().get();
+                    socket->connectToHost(QHostAddress::LocalHost, server.serverPort());
+                    QObject::connect(socket, &QTcpSocket::readyRead, [&, socket](){ onAnswer(socket); });
+                }
+                sentAt[static_cast<size_t>(sent)] = timer.nsecsElapsed() / 1000;
+                socket->write(createPost(createProgressQuery(sent), keepAlive));
+                ++sent;
+            }
+            return answered == polls;
+        }, (seconds + 10) * 1000);
+
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << (keepAlive ? "Persistent connection (HTTP): " : "Connection per poll (HTTP): ")
+                  << answered << "/" << polls << " answered in " << timer.elapsed() << " ms";
+        if(!latencies.empty())
+        {
+            std::cout << ", p50 " << latencies[latencies.size() / 2] << " us, p99 "
+                      << latencies[latencies.size() * 99 / 100] << " us";
+        }
+        std::cout << std::endl;
+        return answered;
+    };
+
+    REQUIRE(run(false) == polls);
+    REQUIRE(run(true) == polls);
+}
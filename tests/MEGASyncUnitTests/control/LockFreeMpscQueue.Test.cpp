@@ -0,0 +1,136 @@
+#include <catch.hpp>
+#include "LockFreeMpscQueue.h"
+
+#include <QMap>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct StormEvent
+{
+    int tag = 0;
+    std::chrono::steady_clock::time_point pushed;
+};
+}
+
+TEST_CASE("Lock-free MPSC queue delivers every item exactly once")
+{
+    constexpr int producers{8};
+    constexpr int itemsPerProducer{20000};
+    LockFreeMpscQueue<int> queue(1024);
+
+    std::vector<std::thread> threads;
+    for(int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&queue, producer](){
+            for(int item = 0; item < itemsPerProducer; ++item)
+            {
+                queue.push(producer * itemsPerProducer + item);
+            }
+        });
+    }
+
+    std::vector<int> received(producers * itemsPerProducer, 0);
+    int total(0);
+    while(total < producers * itemsPerProducer)
+    {
+        total += static_cast<int>(queue.drain([&received](int&& value){ received[value]++; }));
+    }
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(std::all_of(received.begin(), received.end(), [](int count){ return count == 1; }));
+
+    int value(0);
+    REQUIRE_FALSE(queue.tryPop(value));
+}
+
+TEST_CASE("Lock-free MPSC queue reports full when the consumer does not drain")
+{
+    LockFreeMpscQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for(int item = 0; item < 4; ++item)
+    {
+        REQUIRE(queue.tryPush(std::move(item)));
+    }
+    REQUIRE_FALSE(queue.tryPush(4));
+
+    int value(-1);
+    REQUIRE(queue.tryPop(value));
+    REQUIRE(value == 0);
+    REQUIRE(queue.tryPush(4));
+}
+
+TEST_CASE("Transfer event storm drain latency", "[.benchmark]")
+{
+    //Replays 100k transfers (start + 10 updates + finish each) from 4 SDK-like threads,
+    //drained every 100 ms tick and coalesced per tag as TransferThread does
+    constexpr int transfers{100000};
+    constexpr int updatesPerTransfer{10};
+    constexpr int producers{4};
+    constexpr auto tick = std::chrono::milliseconds(100);
+
+    LockFreeMpscQueue<StormEvent> queue(1 << 17);
+
+    std::vector<std::thread> threads;
+    for(int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([&queue, producer](){
+            for(int tag = producer; tag < transfers; tag += producers)
+            {
+                for(int event = 0; event < updatesPerTransfer + 2; ++event)
+                {
+                    StormEvent stormEvent;
+                    stormEvent.tag = tag;
+                    stormEvent.pushed = std::chrono::steady_clock::now();
+                    queue.push(std::move(stormEvent));
+                }
+            }
+        });
+    }
+
+    constexpr long long totalEvents{static_cast<long long>(transfers) * (updatesPerTransfer + 2)};
+    std::vector<long long> latenciesUs;
+    latenciesUs.reserve(totalEvents);
+    QMap<int, StormEvent> coalesced;
+    long long consumed(0);
+    int ticks(0);
+
+    while(consumed < totalEvents)
+    {
+        std::this_thread::sleep_for(tick);
+        consumed += static_cast<long long>(queue.drain([&](StormEvent&& event){
+            auto now = std::chrono::steady_clock::now();
+            latenciesUs.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - event.pushed).count());
+            coalesced[event.tag] = event;
+        }));
+        coalesced.clear();
+        ++ticks;
+    }
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    auto percentile = [&latenciesUs](double p){
+        return latenciesUs[static_cast<size_t>(p * static_cast<double>(latenciesUs.size() - 1))];
+    };
+
+    std::cout << "Transfer event storm: " << totalEvents << " events in " << ticks << " ticks, "
+              << "p50 drain latency " << percentile(0.50) << " us, "
+              << "p99 drain latency " << percentile(0.99) << " us, "
+              << "producer full-ring waits " << queue.fullHits() << std::endl;
+
+    REQUIRE(static_cast<long long>(latenciesUs.size()) == totalEvents);
+}
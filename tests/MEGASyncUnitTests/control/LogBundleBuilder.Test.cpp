@@ -0,0 +1,157 @@
+#include <catch.hpp>
+#include "LogBundleBuilder.h"
+#include "MegaSyncLogger.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <zlib.h>
+
+namespace
+{
+const qint64 HOUR_MS = 3600 * 1000;
+const qint64 START_MS = 1760000000000;
+
+QString logFile(const QTemporaryDir& dir, const QString& name)
+{
+    return dir.path() + QLatin1Char('/') + name;
+}
+
+void writeFile(const QString& filename, const QByteArray& content)
+{
+    QFile file(filename);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+    REQUIRE(file.write(content) == content.size());
+}
+
+//Rotated log number n holds the lines of hour n before the last one
+QByteArray writeRotatedLog(const QTemporaryDir& dir, int number, int lines = 10)
+{
+    QByteArray content;
+    for (int line = 0; line < lines; ++line)
+    {
+        content += "10/18-10:00:00.000000 7f0a1b2c DBG Log " + QByteArray::number(number)
+                + " line " + QByteArray::number(line) + " [file.cpp:1]\n";
+    }
+
+    auto rotated = logFile(dir, QString::fromLatin1("MEGAsync.%1.log").arg(number));
+    writeFile(rotated + QLatin1String(".zipping"), content);
+
+    LogTimeRange range;
+    range.firstMs = START_MS - (number + 1) * HOUR_MS;
+    range.lastMs = START_MS - number * HOUR_MS;
+    REQUIRE(gzipCompressLogFile(rotated + QLatin1String(".zipping"), rotated, range));
+    return content;
+}
+
+QByteArray readGzip(const QString& filename)
+{
+    auto gzdeleter = [](gzFile_s* f) { if (f) gzclose(f); };
+    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{gzopen(filename.toUtf8().constData(), "rb"), gzdeleter};
+    REQUIRE(gzfile);
+
+    QByteArray content;
+    char buffer[4096];
+    int read(0);
+    while ((read = gzread(gzfile.get(), buffer, sizeof(buffer))) > 0)
+    {
+        content.append(buffer, read);
+    }
+    return content;
+}
+}
+
+TEST_CASE("Rotated logs keep their time range in the gzip header")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto content = writeRotatedLog(dir, 3);
+
+    auto range = readLogTimeRange(logFile(dir, QLatin1String("MEGAsync.3.log")));
+    REQUIRE(range.isValid());
+    REQUIRE(range.firstMs == START_MS - 4 * HOUR_MS);
+    REQUIRE(range.lastMs == START_MS - 3 * HOUR_MS);
+    REQUIRE(readGzip(logFile(dir, QLatin1String("MEGAsync.3.log"))) == content);
+
+    //Logs compressed without a range, or which are not gzip files
+    writeFile(logFile(dir, QLatin1String("plain.log")), "not compressed");
+    REQUIRE_FALSE(readLogTimeRange(logFile(dir, QLatin1String("plain.log"))).isValid());
+    REQUIRE(gzipCompressLogFile(logFile(dir, QLatin1String("plain.log")), logFile(dir, QLatin1String("plain.log.gz"))));
+    REQUIRE_FALSE(readLogTimeRange(logFile(dir, QLatin1String("plain.log.gz"))).isValid());
+}
+
+TEST_CASE("Log bundles join the rotated logs and the current one")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto log2 = writeRotatedLog(dir, 2);
+    auto log1 = writeRotatedLog(dir, 1);
+    auto log0 = writeRotatedLog(dir, 0);
+    QByteArray live("10/18-11:00:00.000000 7f0a1b2c DBG Current log [file.cpp:1]\n");
+    writeFile(logFile(dir, QLatin1String("MEGAsync.log")), live);
+
+    auto bundle = logFile(dir, QLatin1String("bundle.gz"));
+    LogBundleBuilder builder(dir.path(), bundle);
+
+    SECTION("Every log, oldest first")
+    {
+        qint64 lastDone(0);
+        REQUIRE(builder.build([&lastDone](qint64 bytesDone, qint64 bytesTotal)
+        {
+            REQUIRE(bytesDone > lastDone);
+            REQUIRE(bytesDone <= bytesTotal);
+            lastDone = bytesDone;
+            return true;
+        }));
+        REQUIRE(readGzip(bundle) == log2 + log1 + log0 + live);
+        REQUIRE_FALSE(QFile::exists(bundle + QLatin1String(".live.gz")));
+    }
+
+    SECTION("Only the logs inside the time window")
+    {
+        builder.setTimeWindow(QDateTime::fromMSecsSinceEpoch(START_MS - 2 * HOUR_MS + 1),
+                              QDateTime::fromMSecsSinceEpoch(START_MS - HOUR_MS - 1));
+        REQUIRE(builder.build());
+        REQUIRE(readGzip(bundle) == log1 + live);
+    }
+
+    SECTION("Cancelled bundles are removed")
+    {
+        REQUIRE_FALSE(builder.build([](qint64, qint64) { return false; }));
+        REQUIRE_FALSE(QFile::exists(bundle));
+    }
+}
+
+TEST_CASE("Log bundle builder benchmark", "[.benchmark]")
+{
+    //The default maximum of rotated logs, of 10 MB each
+    constexpr int logs{50};
+    constexpr int linesPerLog{160000};
+
+    QTemporaryDir dir;
+    for (int number = 0; number < logs; ++number)
+    {
+        writeRotatedLog(dir, number, linesPerLog);
+    }
+    writeFile(logFile(dir, QLatin1String("MEGAsync.log")), "10/18-11:00:00.000000 7f0a1b2c DBG Current log [file.cpp:1]\n");
+
+    auto bundle = logFile(dir, QLatin1String("bundle.gz"));
+    LogBundleBuilder builder(dir.path(), bundle);
+    QElapsedTimer timer;
+    timer.start();
+    REQUIRE(builder.build());
+    auto allMs(timer.elapsed());
+
+    builder.setTimeWindow(QDateTime::fromMSecsSinceEpoch(START_MS - 5 * HOUR_MS));
+    timer.start();
+    REQUIRE(builder.build());
+    auto lastHoursMs(timer.elapsed());
+
+    std::cout << "Joined " << logs << " rotated logs in " << allMs << " ms ("
+              << QFile(bundle).size() / 1024 << " KB for the last 5 hours in " << lastHoursMs << " ms)" << std::endl;
+}
@@ -0,0 +1,126 @@
+#include <catch.hpp>
+#include "MegaSyncLogger.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <zlib.h>
+
+namespace
+{
+QString logFile(const QTemporaryDir& dir, const char* name)
+{
+    return dir.path() + QLatin1Char('/') + QLatin1String(name);
+}
+
+//Writes log lines like the ones of MEGAsync.log until the file has the requested size
+std::string writeLog(const QString& filename, long long bytes)
+{
+    std::string content;
+    std::ofstream file(filename.toUtf8().constData(), std::ofstream::out | std::ofstream::binary);
+    long long written(0);
+    for(long long line = 0; written < bytes; ++line)
+    {
+        auto text = "2026-10-18_10-00-00.123456 7f0a1b2c DBG Transfer (UPLOAD) starting. File: IMG_"
+                + std::to_string(line) + ".jpg [transfer.cpp:" + std::to_string(line % 997) + "]\n";
+        file << text;
+        written += static_cast<long long>(text.size());
+        if (bytes < 1024 * 1024)
+        {
+            content += text;
+        }
+    }
+    return content;
+}
+
+std::string readGzip(const QString& filename)
+{
+    auto gzdeleter = [](gzFile_s* f) { if (f) gzclose(f); };
+    std::unique_ptr<gzFile_s, decltype(gzdeleter)> gzfile{gzopen(filename.toUtf8().constData(), "rb"), gzdeleter};
+    REQUIRE(gzfile);
+
+    std::string content;
+    char buffer[4096];
+    int read(0);
+    while ((read = gzread(gzfile.get(), buffer, sizeof(buffer))) > 0)
+    {
+        content.append(buffer, static_cast<size_t>(read));
+    }
+    return content;
+}
+
+//The compression done on every rotation before the streaming one
+void compressByLines(const QString& filename, const QString& destinationFilename)
+{
+    std::ifstream file(filename.toUtf8().constData());
+    gzFile gzfile = gzopen(destinationFilename.toUtf8().constData(), "wb");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        line.push_back('\n');
+        gzputs(gzfile, line.c_str());
+    }
+    gzclose(gzfile);
+}
+}
+
+TEST_CASE("Rotated logs are compressed to gzip files")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    auto source = logFile(dir, "MEGAsync.0.log.zipping");
+    auto destination = logFile(dir, "MEGAsync.0.log");
+
+    SECTION("Small logs")
+    {
+        auto content = writeLog(source, 64 * 1024);
+        REQUIRE(gzipCompressLogFile(source, destination));
+        REQUIRE(readGzip(destination) == content);
+        REQUIRE_FALSE(QFile::exists(source));
+    }
+
+    SECTION("Empty logs")
+    {
+        writeLog(source, 0);
+        REQUIRE(gzipCompressLogFile(source, destination));
+        REQUIRE(readGzip(destination).empty());
+    }
+
+    SECTION("Missing logs are not compressed")
+    {
+        REQUIRE_FALSE(gzipCompressLogFile(source, destination));
+        REQUIRE_FALSE(QFile::exists(destination));
+    }
+}
+
+TEST_CASE("Log rotation compression benchmark", "[.benchmark]")
+{
+    //The size of a rotated log with MEGA_MAX_LOG_FILESIZE_MB=100
+    constexpr long long megabytes{100};
+
+    QTemporaryDir dir;
+    auto source = logFile(dir, "MEGAsync.0.log.zipping");
+    auto destination = logFile(dir, "MEGAsync.0.log");
+
+    writeLog(source, megabytes * 1024 * 1024);
+    QElapsedTimer timer;
+    timer.start();
+    compressByLines(source, destination);
+    auto byLinesMs(timer.elapsed());
+
+    timer.start();
+    REQUIRE(gzipCompressLogFile(source, destination));
+    auto streamingMs(timer.elapsed());
+
+    std::cout << "Compressed a " << megabytes << " MB log: "
+              << megabytes * 1000 / std::max(byLinesMs, 1LL) << " MB/s by lines, "
+              << megabytes * 1000 / std::max(streamingMs, 1LL) << " MB/s streaming ("
+              << QFile(destination).size() / 1024 << " KB)" << std::endl;
+}
@@ -0,0 +1,100 @@
+#include <catch.hpp>
+#include "LogRing.h"
+#include "MegaSyncLogger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Log ring delivers whole lines in order across the wrap point")
+{
+    constexpr int lines{100000};
+    LogRing ring(1000);
+    REQUIRE(ring.capacity() == 1024);
+
+    std::thread producer([&ring](){
+        for(int line = 0; line < lines; ++line)
+        {
+            auto text = std::to_string(line);
+            while(!ring.reserve(text.size() + 1))
+            {
+                std::this_thread::yield();
+            }
+            ring.append(text.data(), text.size());
+            ring.append("\n", 1);
+            ring.commit();
+        }
+    });
+
+    int expected(0);
+    bool inOrder(true);
+    std::string pending;
+    while(expected < lines)
+    {
+        ring.drain([&pending](const char* data, std::size_t size){ pending.append(data, size); });
+        std::string::size_type end;
+        while((end = pending.find('\n')) != std::string::npos)
+        {
+            inOrder = inOrder && std::stoi(pending.substr(0, end)) == expected;
+            ++expected;
+            pending.erase(0, end + 1);
+        }
+    }
+    producer.join();
+
+    REQUIRE(inOrder);
+    REQUIRE(pending.empty());
+    REQUIRE(ring.used() == 0);
+}
+
+TEST_CASE("Log ring refuses lines which do not fit until it is drained")
+{
+    LogRing ring(16);
+    REQUIRE(ring.reserve(10));
+    ring.append("0123456789", 10);
+    ring.commit();
+    REQUIRE_FALSE(ring.reserve(10));
+
+    std::size_t drained(0);
+    ring.drain([&drained](const char*, std::size_t size){ drained += size; });
+    REQUIRE(drained == 10);
+    REQUIRE(ring.reserve(16));
+}
+
+TEST_CASE("Logging throughput with 16 producer threads", "[.benchmark]")
+{
+    //Every producer logs distinct DTL lines, as the SDK does while transferring at LOG_LEVEL_MAX
+    constexpr int producers{16};
+    constexpr int linesPerProducer{200000};
+    REQUIRE(g_megaSyncLogger != nullptr);
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for(int producer = 0; producer < producers; ++producer)
+    {
+        threads.emplace_back([producer](){
+            char message[128];
+            for(int line = 0; line < linesPerProducer; ++line)
+            {
+                snprintf(message, sizeof(message), "Logging benchmark: producer %d, transfer chunk %d written", producer, line);
+                g_megaSyncLogger->log(nullptr, mega::MegaApi::LOG_LEVEL_MAX, nullptr, message
+#ifdef ENABLE_LOG_PERFORMANCE
+                                      , nullptr, nullptr, 0
+#endif
+                                      );
+            }
+        });
+    }
+
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Logging throughput: " << producers << " producers, "
+              << static_cast<double>(producers) * linesPerProducer / elapsed.count() << " lines/sec" << std::endl;
+}
@@ -0,0 +1,126 @@
+#include <catch.hpp>
+#include "MegaUploader.h"
+#include "TransferBatch.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+struct StartedUpload
+{
+    std::string localPath;
+    std::string nodeName;
+    std::string appData;
+};
+
+MegaUploader::Uploads createUploads(int count)
+{
+    MegaUploader::Uploads uploads;
+    for(int upload = 0; upload < count; ++upload)
+    {
+        auto name = QString::fromLatin1("IMG_%1.jpg").arg(upload, 6, 10, QLatin1Char('0'));
+        uploads.append(MegaUploader::Upload{QLatin1String("/home/user/Pictures/") + name,
+                                            upload % 10 == 0 ? name + QLatin1String("(1)") : QString()});
+    }
+    return uploads;
+}
+}
+
+TEST_CASE("Batched uploads share the app data and keep their names")
+{
+    std::vector<StartedUpload> started;
+    auto submitted = MegaUploader::submitUploads(createUploads(3), 42, nullptr,
+                                                 [&started](const char* localPath, const char* nodeName, const char* appData)
+    {
+        started.push_back(StartedUpload{localPath, nodeName ? nodeName : "<null>", appData});
+    });
+
+    REQUIRE(submitted == 3);
+    REQUIRE(started.size() == 3);
+    REQUIRE(started[0].localPath == "/home/user/Pictures/IMG_000000.jpg");
+    REQUIRE(started[0].nodeName == "IMG_000000.jpg(1)");
+    REQUIRE(started[1].nodeName == "<null>");
+    for(const auto& upload : started)
+    {
+        REQUIRE(upload.appData == "42*");
+    }
+}
+
+TEST_CASE("Batched uploads stop once the cancel token is cancelled")
+{
+    std::unique_ptr<mega::MegaCancelToken> cancelToken(mega::MegaCancelToken::createInstance());
+    int started(0);
+    auto submitted = MegaUploader::submitUploads(createUploads(10), 1, cancelToken.get(),
+                                                 [&started, &cancelToken](const char*, const char*, const char*)
+    {
+        if(++started == 4)
+        {
+            cancelToken->cancel();
+        }
+    });
+
+    REQUIRE(submitted == 4);
+    REQUIRE(started == 4);
+}
+
+TEST_CASE("Prepared uploads are added to the batch with absolute native paths")
+{
+    TransferBatch batch;
+    auto uploads = MegaUploader::prepareUploads(createUploads(3), batch);
+
+    REQUIRE(uploads.size() == 3);
+    REQUIRE(uploads[0].localPath == QDir::toNativeSeparators(QLatin1String("/home/user/Pictures/IMG_000000.jpg")));
+    REQUIRE(uploads[0].nodeName == QLatin1String("IMG_000000.jpg(1)"));
+    REQUIRE(batch.description() == QLatin1String("3 nodes"));
+    for(const auto& upload : uploads)
+    {
+        batch.onScanCompleted(upload.localPath);
+    }
+    REQUIRE(batch.isEmpty());
+}
+
+TEST_CASE("Batched uploads benchmark", "[.benchmark]")
+{
+    //Enqueueing 100k files from the tray, without the SDK call itself. Both ways fill a transfer batch on the GUI thread
+    constexpr int files{100000};
+    auto uploads = createUploads(files);
+    auto noUpload = [](const char*, const char*, const char*) {};
+
+    //One file after the other, as MegaUploader::upload did it before
+    TransferBatch serialBatch;
+    QElapsedTimer timer;
+    timer.start();
+    for(const auto& upload : uploads)
+    {
+        QFileInfo info(upload.localPath);
+        serialBatch.add(info.absoluteFilePath(), QString());
+        QString currentPath = QDir::toNativeSeparators(info.absoluteFilePath());
+        QString msg = QString::fromLatin1("Starting upload : '%1' - '%2' - '%3'").arg(info.fileName(), currentPath).arg(7);
+        auto msgArray = msg.toUtf8();
+        Q_UNUSED(msgArray)
+        QByteArray localPathArray = currentPath.toUtf8();
+        QByteArray nodeNameArray = upload.nodeName.toUtf8();
+        QByteArray appData = (QString::number(7) + QString::fromUtf8("*")).toUtf8();
+        noUpload(localPathArray.constData(), nodeNameArray.constData(), appData.constData());
+    }
+    auto serialMs(timer.elapsed());
+
+    TransferBatch batch;
+    timer.start();
+    auto nativeUploads = MegaUploader::prepareUploads(uploads, batch);
+    auto guiThreadMs(timer.elapsed());
+    auto submitted = MegaUploader::submitUploads(nativeUploads, 7, nullptr, noUpload);
+    auto batchMs(timer.elapsed());
+
+    std::cout << "Enqueued " << files << " uploads: " << files * 1000LL / std::max(serialMs, 1LL) << " files/s one by one, "
+              << files * 1000LL / std::max(batchMs, 1LL) << " files/s in a batch (" << guiThreadMs
+              << " ms of it on the GUI thread)" << std::endl;
+
+    REQUIRE(submitted == files);
+}
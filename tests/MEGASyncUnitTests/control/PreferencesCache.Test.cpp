@@ -0,0 +1,166 @@
+#include <catch.hpp>
+#include "PreferencesCache.h"
+#include "ThreadPool.h"
+
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace
+{
+const int KEYS = 64;
+
+QString keyName(int i)
+{
+    return QString::fromLatin1("key%1").arg(i);
+}
+
+//Runs the reader on every pool thread while the caller keeps writing, and returns the reads per second
+double measureReads(ThreadPool& pool, int readers, int readsPerThread,
+                    const std::function<void(int)>& read, const std::function<void(int)>& write)
+{
+    std::mutex finishedMutex;
+    std::condition_variable finishedCv;
+    int finished(0);
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int reader = 0; reader < readers; ++reader)
+    {
+        pool.push([&, reader]()
+        {
+            for (int i = 0; i < readsPerThread; ++i)
+            {
+                read((i + reader) % KEYS);
+            }
+
+            std::lock_guard<std::mutex> lock(finishedMutex);
+            finished++;
+            finishedCv.notify_one();
+        });
+    }
+
+    int writes(0);
+    std::unique_lock<std::mutex> lock(finishedMutex);
+    while (!finishedCv.wait_for(lock, std::chrono::microseconds(100), [&]() { return finished == readers; }))
+    {
+        lock.unlock();
+        write(writes++ % KEYS);
+        lock.lock();
+    }
+
+    return static_cast<double>(readers) * readsPerThread * 1e9 / static_cast<double>(timer.nsecsElapsed());
+}
+}
+
+TEST_CASE("Preferences cache publishes values to readers")
+{
+    PreferencesCache cache;
+    QVariant value;
+    REQUIRE_FALSE(cache.find(keyName(1), value));
+
+    for (int i = 0; i < KEYS; ++i)
+    {
+        cache.insert(keyName(i), i);
+    }
+    cache.insert(keyName(1), QLatin1String("updated"));
+
+    REQUIRE(cache.find(keyName(1), value));
+    REQUIRE(value.toString() == QLatin1String("updated"));
+    REQUIRE(cache.find(keyName(KEYS - 1), value));
+    REQUIRE(value.toInt() == KEYS - 1);
+
+    cache.remove(keyName(1));
+    REQUIRE_FALSE(cache.find(keyName(1), value));
+    REQUIRE(cache.find(keyName(2), value));
+
+    cache.clear();
+    REQUIRE_FALSE(cache.find(keyName(2), value));
+}
+
+TEST_CASE("Preferences cache readers see complete values while it is written")
+{
+    PreferencesCache cache;
+    std::atomic<bool> failed(false);
+
+    {
+        ThreadPool pool(4);
+        for (int reader = 0; reader < 4; ++reader)
+        {
+            pool.push([&cache, &failed]()
+            {
+                QVariant value;
+                for (int i = 0; i < 100000; ++i)
+                {
+                    //Values are always written as "<key>:<n>"
+                    if (cache.find(keyName(i % KEYS), value)
+                            && !value.toString().startsWith(keyName(i % KEYS) + QLatin1Char(':')))
+                    {
+                        failed = true;
+                    }
+                }
+            });
+        }
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            cache.insert(keyName(i % KEYS), keyName(i % KEYS) + QString::fromLatin1(":%1").arg(i));
+            if (i % 1000 == 0)
+            {
+                cache.clear();
+            }
+        }
+    }
+
+    REQUIRE_FALSE(failed);
+}
+
+TEST_CASE("Preferences cache contention benchmark", "[.benchmark]")
+{
+    constexpr int readsPerThread{1000000};
+    ThreadPool pool(8);
+
+    //The lock that every getter took before
+    QMutex mutex(QMutex::Recursive);
+    std::map<QString, QVariant> lockedValues;
+    PreferencesCache cache;
+    for (int i = 0; i < KEYS; ++i)
+    {
+        lockedValues[keyName(i)] = i;
+        cache.insert(keyName(i), i);
+    }
+
+    for (int readers : {1, 2, 4, 8})
+    {
+        auto locked = measureReads(pool, readers, readsPerThread, [&](int key)
+        {
+            QMutexLocker lock(&mutex);
+            auto valueIt = lockedValues.find(keyName(key));
+            (void)valueIt->second.toInt();
+        },
+        [&](int key)
+        {
+            QMutexLocker lock(&mutex);
+            lockedValues[keyName(key)] = key + 1;
+        });
+
+        auto sharded = measureReads(pool, readers, readsPerThread, [&](int key)
+        {
+            QVariant value;
+            cache.find(keyName(key), value);
+            (void)value.toInt();
+        },
+        [&](int key)
+        {
+            cache.insert(keyName(key), key + 1);
+        });
+
+        std::cout << readers << " readers: " << static_cast<long long>(locked) << " reads/s with the mutex, "
+                  << static_cast<long long>(sharded) << " reads/s with the cache" << std::endl;
+    }
+}
@@ -0,0 +1,105 @@
+#include <catch.hpp>
+#include "TransferBatch.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+QString nodePath(int node)
+{
+    return QDir::toNativeSeparators(QString::fromLatin1("/home/user/Pictures/%1/IMG_%2.jpg").arg(node % 100).arg(node));
+}
+}
+
+TEST_CASE("Transfer batch tracks pending nodes")
+{
+    TransferBatch batch;
+    REQUIRE(batch.isEmpty());
+
+    batch.add(QLatin1String("/home/user/a.txt"), QString());
+    batch.add(QLatin1String("/home/user/a.txt"), QString());
+    batch.add(QLatin1String("/home/user"), QLatin1String("b.txt"));
+    //Decomposed form of "ñ.txt"
+    batch.add(QLatin1String("/home/user"), QString::fromUtf8("n\xCC\x83.txt"));
+    REQUIRE(batch.description() == QLatin1String("4 nodes"));
+
+    SECTION("Each completed scan removes one of the added nodes")
+    {
+        batch.onScanCompleted(QLatin1String("/home/user/a.txt"));
+        REQUIRE(batch.description() == QLatin1String("3 nodes"));
+        batch.onScanCompleted(QLatin1String("/home/user/a.txt"));
+        batch.onScanCompleted(QLatin1String("/home/user/a.txt"));
+        REQUIRE(batch.description() == QLatin1String("2 nodes"));
+    }
+
+    SECTION("Paths are compared once normalized")
+    {
+        batch.onScanCompleted(QDir::toNativeSeparators(QString::fromUtf8("/home/user/\xC3\xB1.txt")));
+        batch.onScanCompleted(QDir::toNativeSeparators(QLatin1String("/home/user/b.txt")));
+        REQUIRE(batch.description() == QLatin1String("2 nodes"));
+    }
+
+    SECTION("Unknown nodes are ignored")
+    {
+        batch.onScanCompleted(QLatin1String("/home/user/c.txt"));
+        REQUIRE(batch.description() == QLatin1String("4 nodes"));
+
+        batch.onScanCompleted(QLatin1String("/home/user/a.txt"));
+        batch.onScanCompleted(QLatin1String("/home/user/a.txt"));
+        batch.onScanCompleted(QLatin1String("/home/user/b.txt"));
+        batch.onScanCompleted(QString::fromUtf8("/home/user/\xC3\xB1.txt"));
+        REQUIRE(batch.isEmpty());
+    }
+}
+
+TEST_CASE("Transfer batch benchmark", "[.benchmark]")
+{
+    constexpr int nodes{200000};
+    //The list is quadratic, so it is measured with fewer nodes
+    constexpr int listNodes{20000};
+
+    //A list searched and erased on every completed scan, as the batch did before
+    QStringList list;
+    for(int node = 0; node < listNodes; ++node)
+    {
+        list.push_back(nodePath(node).normalized(QString::NormalizationForm_C));
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    for(int node = listNodes - 1; node >= 0; --node)
+    {
+        auto it = std::find(list.begin(), list.end(), nodePath(node).normalized(QString::NormalizationForm_C));
+        if(it != list.end())
+        {
+            list.erase(it);
+        }
+    }
+    auto listMs(timer.elapsed());
+
+    TransferBatch batch;
+    timer.start();
+    for(int node = 0; node < nodes; ++node)
+    {
+        batch.add(nodePath(node), QString());
+    }
+    auto addMs(timer.elapsed());
+
+    timer.start();
+    for(int node = nodes - 1; node >= 0; --node)
+    {
+        batch.onScanCompleted(nodePath(node));
+    }
+    auto batchMs(timer.elapsed());
+
+    std::cout << "Completed scans: " << listNodes * 1000LL / std::max(listMs, 1LL) << " nodes/s with a list of " << listNodes
+              << ", " << nodes * 1000LL / std::max(batchMs, 1LL) << " nodes/s with the batch of " << nodes
+              << " (added in " << addMs << " ms)" << std::endl;
+
+    REQUIRE(list.isEmpty());
+    REQUIRE(batch.isEmpty());
+}
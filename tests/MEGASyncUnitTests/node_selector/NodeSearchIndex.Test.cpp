@@ -0,0 +1,201 @@
+#include <catch.hpp>
+#include "node_selector/model/NodeSearchIndex.h"
+#include "FakeMegaNode.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const mega::MegaHandle ROOT_HANDLE = 1;
+const mega::MegaHandle VAULT_HANDLE = 2;
+const mega::MegaHandle RUBBISH_HANDLE = 3;
+
+NodeSearchIndex& createIndex()
+{
+    auto& index(NodeSearchIndex::instance());
+    index.reset();
+    index.setRootHandles(ROOT_HANDLE, VAULT_HANDLE, RUBBISH_HANDLE);
+    index.addNode(ROOT_HANDLE, mega::INVALID_HANDLE, QLatin1String("Cloud Drive"), false);
+    index.addNode(VAULT_HANDLE, mega::INVALID_HANDLE, QLatin1String("Vault"), false);
+    index.addNode(RUBBISH_HANDLE, mega::INVALID_HANDLE, QLatin1String("Rubbish Bin"), false);
+    return index;
+}
+
+std::vector<mega::MegaHandle> search(NodeSearchIndex& index, const QString& text, NodeSearchIndex::Query& query)
+{
+    std::vector<NodeSearchIndex::Result> results;
+    REQUIRE(index.search(text, query, results));
+
+    std::vector<mega::MegaHandle> handles;
+    for(const auto& result : results)
+    {
+        handles.push_back(result.handle);
+    }
+    std::sort(handles.begin(), handles.end());
+    return handles;
+}
+
+std::vector<mega::MegaHandle> search(NodeSearchIndex& index, const QString& text)
+{
+    NodeSearchIndex::Query query;
+    return search(index, text, query);
+}
+}
+
+TEST_CASE("Node search index finds names by substring")
+{
+    auto& index(createIndex());
+    index.addNode(10, ROOT_HANDLE, QLatin1String("Reports"), false);
+    index.addNode(11, 10, QLatin1String("Annual Report.pdf"), true);
+    index.addNode(12, 10, QLatin1String("report-draft.txt"), true);
+    index.addNode(13, RUBBISH_HANDLE, QLatin1String("old report.doc"), true);
+    index.addNode(14, mega::INVALID_HANDLE, QLatin1String("Shared reports"), false, mega::MegaShare::ACCESS_READ);
+    index.addNode(15, VAULT_HANDLE, QLatin1String("Backup"), false);
+
+    std::vector<NodeSearchIndex::Result> results;
+    NodeSearchIndex::Query query;
+    REQUIRE_FALSE(index.search(QLatin1String("report"), query, results));
+
+    index.setReady();
+    REQUIRE(index.isReady());
+    REQUIRE(index.size() == 9);
+
+    SECTION("Matches ignore the case and include every root")
+    {
+        REQUIRE(search(index, QLatin1String("REPORT")) == std::vector<mega::MegaHandle>{10, 11, 12, 13, 14});
+        REQUIRE(search(index, QLatin1String("re")) == std::vector<mega::MegaHandle>{10, 11, 12, 13, 14});
+        REQUIRE(search(index, QLatin1String("xyz")).empty());
+        REQUIRE(search(index, QString()).empty());
+    }
+
+    SECTION("Results carry their root and access")
+    {
+        REQUIRE(index.search(QLatin1String("report"), query, results));
+        for(const auto& result : results)
+        {
+            switch(result.handle)
+            {
+            case 10:
+            case 11:
+            case 12:
+                REQUIRE(result.rootType == NodeSearchIndex::RootType::CLOUD_DRIVE);
+                REQUIRE(result.access == mega::MegaShare::ACCESS_OWNER);
+                break;
+            case 13:
+                REQUIRE(result.rootType == NodeSearchIndex::RootType::RUBBISH);
+                break;
+            case 14:
+                REQUIRE(result.rootType == NodeSearchIndex::RootType::INCOMING_SHARE);
+                REQUIRE(result.access == mega::MegaShare::ACCESS_READ);
+                break;
+            }
+            REQUIRE(result.isFile == (result.handle == 11 || result.handle == 12 || result.handle == 13));
+        }
+
+        REQUIRE(index.search(QLatin1String("backup"), query, results));
+        REQUIRE(results.size() == 1);
+        REQUIRE(results.front().rootType == NodeSearchIndex::RootType::VAULT);
+    }
+
+    SECTION("A longer text refines the previous results")
+    {
+        REQUIRE(search(index, QLatin1String("rep"), query) == std::vector<mega::MegaHandle>{10, 11, 12, 13, 14});
+        REQUIRE(search(index, QLatin1String("report."), query) == std::vector<mega::MegaHandle>{11, 13});
+        REQUIRE(search(index, QLatin1String("report.pdf"), query) == std::vector<mega::MegaHandle>{11});
+
+        //A different text searches the whole index again
+        REQUIRE(search(index, QLatin1String("draft"), query) == std::vector<mega::MegaHandle>{12});
+    }
+
+    SECTION("Node updates are applied to the index")
+    {
+        REQUIRE(search(index, QLatin1String("report"), query).size() == 5);
+
+        FakeMegaNodeList nodes;
+        nodes.add(FakeMegaNode(11, 10, "Annual Summary.pdf", mega::MegaNode::TYPE_FILE, mega::MegaNode::CHANGE_TYPE_ATTRIBUTES));
+        nodes.add(FakeMegaNode(12, RUBBISH_HANDLE, "report-draft.txt", mega::MegaNode::TYPE_FILE, mega::MegaNode::CHANGE_TYPE_PARENT));
+        nodes.add(FakeMegaNode(13, RUBBISH_HANDLE, "old report.doc", mega::MegaNode::TYPE_FILE, mega::MegaNode::CHANGE_TYPE_REMOVED));
+        nodes.add(FakeMegaNode(16, ROOT_HANDLE, "New report.xls", mega::MegaNode::TYPE_FILE, mega::MegaNode::CHANGE_TYPE_NEW));
+        index.onNodesUpdate(&nodes);
+
+        //The previous results are outdated, so they are not refined
+        REQUIRE(search(index, QLatin1String("report"), query) == std::vector<mega::MegaHandle>{10, 12, 14, 16});
+        REQUIRE(search(index, QLatin1String("summary")) == std::vector<mega::MegaHandle>{11});
+        REQUIRE(index.size() == 9);
+
+        REQUIRE(index.search(QLatin1String("draft"), query, results));
+        REQUIRE(results.size() == 1);
+        REQUIRE(results.front().rootType == NodeSearchIndex::RootType::RUBBISH);
+
+        index.onNodesUpdate(nullptr);
+        REQUIRE_FALSE(index.isReady());
+        REQUIRE(index.size() == 0);
+    }
+
+    index.reset();
+}
+
+TEST_CASE("Node search index latency benchmark", "[.benchmark]")
+{
+    //1M nodes in 1000 folders, with names like the ones of a camera uploads folder
+    constexpr int folders{1000};
+    constexpr int filesPerFolder{1000};
+    const QStringList words{QLatin1String("Camera"), QLatin1String("Report"), QLatin1String("Invoice"),
+                            QLatin1String("Holidays"), QLatin1String("Project"), QLatin1String("Scan")};
+
+    QElapsedTimer timer;
+    timer.start();
+
+    auto& index(createIndex());
+    mega::MegaHandle handle(100);
+    size_t holidays(0);
+    for(int folder = 0; folder < folders; ++folder)
+    {
+        auto folderHandle(handle++);
+        holidays += folder % words.size() == 3 ? 1 : 0;
+        index.addNode(folderHandle, ROOT_HANDLE, QString::fromLatin1("%1 %2").arg(words.at(folder % words.size())).arg(folder), false);
+        for(int file = 0; file < filesPerFolder; ++file)
+        {
+            auto number(folder * filesPerFolder + file);
+            holidays += number % words.size() == 3 ? 1 : 0;
+            index.addNode(handle++, folderHandle,
+                          QString::fromLatin1("IMG_%1 %2.jpg").arg(number, 7, 10, QLatin1Char('0')).arg(words.at(number % words.size())),
+                          true);
+        }
+    }
+    index.setReady();
+    std::cout << "Indexed " << index.size() << " nodes in " << timer.elapsed() << " ms" << std::endl;
+
+    //Text typed one character at a time, with and without refining the previous results
+    const QString text(QLatin1String("img_0123456"));
+    std::vector<NodeSearchIndex::Result> results;
+    NodeSearchIndex::Query typedQuery;
+    for(int length = 1; length <= text.size(); ++length)
+    {
+        auto typed(text.left(length));
+
+        timer.start();
+        NodeSearchIndex::Query query;
+        index.search(typed, query, results);
+        auto fromScratchUs(timer.nsecsElapsed() / 1000);
+
+        timer.start();
+        index.search(typed, typedQuery, results);
+        auto refinedUs(timer.nsecsElapsed() / 1000);
+
+        std::cout << "\"" << typed.toStdString() << "\": " << results.size() << " results, "
+                  << fromScratchUs << " us from scratch, " << refinedUs << " us refined" << std::endl;
+    }
+
+    timer.start();
+    index.search(QLatin1String("holidays"), typedQuery, results);
+    std::cout << "\"holidays\": " << results.size() << " results in " << timer.nsecsElapsed() / 1000 << " us" << std::endl;
+
+    REQUIRE(results.size() == holidays);
+    index.reset();
+}
@@ -0,0 +1,155 @@
+#include <catch.hpp>
+#include "node_selector/model/NodeSelectorModelItem.h"
+#include "FakeMegaNode.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+//Item without sync status, which would need a logged in session
+class SyntheticItem : public NodeSelectorModelItem
+{
+public:
+    SyntheticItem(std::unique_ptr<mega::MegaNode> node, NodeSelectorModelItem* parentItem = nullptr)
+        : NodeSelectorModelItem(std::move(node), true, parentItem)
+    {
+    }
+
+private:
+    NodeSelectorModelItem* createModelItem(std::unique_ptr<mega::MegaNode> node, bool, NodeSelectorModelItem* parentItem) override
+    {
+        return new SyntheticItem(std::move(node), parentItem);
+    }
+};
+
+std::unique_ptr<mega::MegaNode> createFolder(mega::MegaHandle handle, mega::MegaHandle parentHandle = mega::INVALID_HANDLE)
+{
+    return std::unique_ptr<mega::MegaNode>(new FakeMegaNode(handle, parentHandle, std::to_string(handle)));
+}
+
+std::unique_ptr<mega::MegaNodeList> createChildren(mega::MegaHandle parentHandle, mega::MegaHandle firstHandle, int size, int type)
+{
+    auto children = new FakeMegaNodeList();
+    children->addRange(parentHandle, firstHandle, size, type);
+    return std::unique_ptr<mega::MegaNodeList>(children);
+}
+
+long long residentBytes()
+{
+#ifdef Q_OS_LINUX
+    QFile statm(QLatin1String("/proc/self/statm"));
+    if(statm.open(QIODevice::ReadOnly))
+    {
+        auto pages = statm.readAll().split(' ');
+        if(pages.size() > 1)
+        {
+            return pages.at(1).toLongLong() * 4096;
+        }
+    }
+#endif
+    return 0;
+}
+}
+
+TEST_CASE("Node selector items keep their children in order and find them by handle")
+{
+    {
+        SyntheticItem root(createFolder(1));
+        root.createChildItems(createChildren(1, 100, 10, mega::MegaNode::TYPE_FILE));
+
+        REQUIRE(root.areChildrenInitialized());
+        REQUIRE(root.getNumChildren() == 10);
+        REQUIRE(root.getChild(10) == nullptr);
+
+        auto child(root.getChild(3));
+        REQUIRE(child->getHandle() == 103);
+        REQUIRE(child->isFile());
+        REQUIRE(child->getParent() == &root);
+        REQUIRE(child->row() == 3);
+        REQUIRE(child->getNode()->getHandle() == 103);
+
+        auto removed(root.findChildNode(103));
+        REQUIRE(removed == child);
+        REQUIRE(root.getNumChildren() == 9);
+        REQUIRE(root.getChild(3)->getHandle() == 104);
+        delete removed;
+
+        REQUIRE(NodeSelectorModelItem::getPoolBytes() > 0);
+    }
+
+    //The pool is released with its last item
+    REQUIRE(NodeSelectorModelItem::getPoolBytes() == 0);
+}
+
+TEST_CASE("Node selector items show their node data after it leaves the node cache")
+{
+    //More children than the node cache keeps: the first ones are evicted and, without a session, cannot be read again
+    constexpr int children{5000};
+
+    SyntheticItem root(createFolder(1));
+    root.createChildItems(createChildren(1, 100, children, mega::MegaNode::TYPE_FILE));
+
+    auto child(root.getChild(0));
+    REQUIRE(child->getNode() == nullptr);
+    REQUIRE(child->getName() == QLatin1String("100"));
+    REQUIRE(child->isFile());
+}
+
+TEST_CASE("Node selector items do not keep the nodes the SDK reports as changed")
+{
+    SyntheticItem root(createFolder(1));
+    root.createChildItems(createChildren(1, 100, 2, mega::MegaNode::TYPE_FOLDER));
+    REQUIRE(root.getChild(0)->getNode() != nullptr);
+    REQUIRE(root.getChild(1)->getNode() != nullptr);
+
+    //Without a session the changed node cannot be read again
+    FakeMegaNodeList changed;
+    changed.add(FakeMegaNode(100, 1, "renamed", mega::MegaNode::TYPE_FOLDER, mega::MegaNode::CHANGE_TYPE_ATTRIBUTES));
+    NodeSelectorModelItem::onNodesUpdate(&changed);
+    REQUIRE(root.getChild(0)->getNode() == nullptr);
+    REQUIRE(root.getChild(1)->getNode() != nullptr);
+
+    NodeSelectorModelItem::onNodesUpdate(nullptr);
+    REQUIRE(root.getChild(1)->getNode() == nullptr);
+}
+
+TEST_CASE("Node selector items memory benchmark", "[.benchmark]")
+{
+    //Expands a synthetic tree with 500 folders of 1000 files each
+    constexpr int folders{500};
+    constexpr int filesPerFolder{1000};
+
+    auto startBytes(residentBytes());
+    QElapsedTimer timer;
+    timer.start();
+
+    auto root = new SyntheticItem(createFolder(1));
+    root->createChildItems(createChildren(1, 1000, folders, mega::MegaNode::TYPE_FOLDER));
+    for(int folder = 0; folder < folders; ++folder)
+    {
+        auto folderItem(root->getChild(folder));
+        auto firstHandle(static_cast<mega::MegaHandle>(1000000 + folder * filesPerFolder));
+        folderItem->createChildItems(createChildren(folderItem->getHandle(), firstHandle, filesPerFolder, mega::MegaNode::TYPE_FILE));
+    }
+
+    auto items(1 + folders + folders * filesPerFolder);
+    auto expandMs(timer.elapsed());
+    auto usedBytes(residentBytes() - startBytes);
+
+    std::cout << "Expanded " << items << " items in " << expandMs << " ms" << std::endl;
+    std::cout << "Item pool: " << NodeSelectorModelItem::getPoolBytes() / items << " bytes/item" << std::endl;
+    if(usedBytes > 0)
+    {
+        std::cout << "Resident memory: " << usedBytes / items << " bytes/item" << std::endl;
+    }
+
+    timer.start();
+    delete root;
+    std::cout << "Deleted in " << timer.elapsed() << " ms" << std::endl;
+
+    REQUIRE(NodeSelectorModelItem::getPoolBytes() == 0);
+}
@@ -0,0 +1,111 @@
+#include <catch.hpp>
+#include "node_selector/model/NodeTreeSnapshot.h"
+#include "FakeMegaNode.h"
+
+namespace
+{
+//Root 1 with the folders 2 and 3, and the folder 4 inside 2
+void readTree(NodeTreeSnapshot& snapshot)
+{
+    snapshot.reset();
+    NodeTreeSnapshot::Folder folder;
+    for(auto node : {FakeMegaNode(1, mega::INVALID_HANDLE, "root"), FakeMegaNode(2, 1, "a"),
+                     FakeMegaNode(3, 1, "b"), FakeMegaNode(4, 2, "c")})
+    {
+        REQUIRE(snapshot.getFolder(&node, folder));
+    }
+    REQUIRE(snapshot.size() == 4);
+}
+
+void update(NodeTreeSnapshot& snapshot, const FakeMegaNode& node)
+{
+    FakeMegaNodeList nodes;
+    nodes.add(node);
+    snapshot.onNodesUpdate(&nodes);
+}
+
+//A folder missing from the snapshot is read again from a node named "not read"
+bool isCached(NodeTreeSnapshot& snapshot, mega::MegaHandle handle, NodeTreeSnapshot::Folder& folder)
+{
+    FakeMegaNode node(handle, mega::INVALID_HANDLE, "not read");
+    return snapshot.getFolder(&node, folder) && folder.name != QLatin1String("not read");
+}
+}
+
+TEST_CASE("Node tree snapshot renames a cached folder in place")
+{
+    auto& snapshot(NodeTreeSnapshot::instance());
+    readTree(snapshot);
+
+    update(snapshot, FakeMegaNode(2, 1, "renamed", mega::MegaNode::TYPE_FOLDER, mega::MegaNode::CHANGE_TYPE_ATTRIBUTES));
+
+    NodeTreeSnapshot::Folder folder;
+    REQUIRE(snapshot.size() == 4);
+    REQUIRE(isCached(snapshot, 2, folder));
+    REQUIRE(folder.name == QLatin1String("renamed"));
+    REQUIRE(folder.parent == 1);
+    snapshot.reset();
+}
+
+TEST_CASE("Node tree snapshot drops both parents of a moved folder")
+{
+    auto& snapshot(NodeTreeSnapshot::instance());
+    readTree(snapshot);
+
+    //4 moves from 2 to 3: the child counts of 2 and 3 are outdated
+    update(snapshot, FakeMegaNode(4, 3, "c", mega::MegaNode::TYPE_FOLDER, mega::MegaNode::CHANGE_TYPE_PARENT));
+
+    NodeTreeSnapshot::Folder folder;
+    REQUIRE(snapshot.size() == 2);
+    REQUIRE(isCached(snapshot, 1, folder));
+    REQUIRE(isCached(snapshot, 4, folder));
+    REQUIRE(folder.parent == 3);
+    snapshot.reset();
+}
+
+TEST_CASE("Node tree snapshot drops a removed folder and its parent")
+{
+    auto& snapshot(NodeTreeSnapshot::instance());
+    readTree(snapshot);
+
+    update(snapshot, FakeMegaNode(2, 1, "a", mega::MegaNode::TYPE_FOLDER, mega::MegaNode::CHANGE_TYPE_REMOVED));
+
+    NodeTreeSnapshot::Folder folder;
+    REQUIRE(snapshot.size() == 2);
+    REQUIRE(isCached(snapshot, 3, folder));
+    REQUIRE(isCached(snapshot, 4, folder));
+    snapshot.reset();
+}
+
+TEST_CASE("Node tree snapshot is cleared when the whole tree may have changed")
+{
+    auto& snapshot(NodeTreeSnapshot::instance());
+    readTree(snapshot);
+
+    snapshot.onNodesUpdate(nullptr);
+    REQUIRE(snapshot.size() == 0);
+}
+
+TEST_CASE("Node tree snapshot lists the children of a listed folder without the SDK")
+{
+    auto& snapshot(NodeTreeSnapshot::instance());
+    readTree(snapshot);
+
+    FakeMegaNode folder(2, 1, "a");
+    std::shared_ptr<FakeMegaNodeList> children(new FakeMegaNodeList());
+    children->add(FakeMegaNode(4, 2, "c"));
+    children->add(FakeMegaNode(5, 2, "d.txt", mega::MegaNode::TYPE_FILE));
+    snapshot.updateChildren(&folder, children, true);
+
+    //Without a session, a listing which is not in the snapshot is empty
+    REQUIRE(snapshot.getChildren(&folder, true).get() == children.get());
+    REQUIRE(snapshot.getChildren(&folder, false)->size() == 0);
+    REQUIRE(snapshot.getNumChildren(&folder, true) == 2);
+    REQUIRE(snapshot.getNumChildren(&folder, false) == 1);
+
+    //A renamed child is outdated in the listing, but the folder itself is not
+    update(snapshot, FakeMegaNode(5, 2, "e.txt", mega::MegaNode::TYPE_FILE, mega::MegaNode::CHANGE_TYPE_ATTRIBUTES));
+    REQUIRE(snapshot.getChildren(&folder, true)->size() == 0);
+    REQUIRE(snapshot.getNumChildren(&folder, true) == 2);
+    snapshot.reset();
+}
@@ -0,0 +1,35 @@
+#include <catch.hpp>
+#include "platform/linux/PathStateCache.h"
+
+TEST_CASE("Path state cache drops the least recently used paths")
+{
+    PathStateCache cache(2);
+    int state(0);
+
+    cache.insert("/sync/a", 1, cache.generation());
+    cache.insert("/sync/b", 2, cache.generation());
+    REQUIRE(cache.find("/sync/a", state));
+    REQUIRE(state == 1);
+
+    cache.insert("/sync/c", 3, cache.generation());
+    REQUIRE(cache.size() == 2);
+    REQUIRE_FALSE(cache.find("/sync/b", state));
+    REQUIRE(cache.find("/sync/c", state));
+    REQUIRE(state == 3);
+}
+
+TEST_CASE("Path state cache ignores states computed before an invalidation")
+{
+    PathStateCache cache;
+    int state(0);
+
+    auto generation(cache.generation());
+    cache.invalidate("/sync/a");
+    cache.insert("/sync/b", 1, generation);
+    REQUIRE_FALSE(cache.find("/sync/b", state));
+
+    cache.insert("/sync/b", 1, cache.generation());
+    REQUIRE(cache.find("/sync/b", state));
+    cache.invalidate("/sync/b");
+    REQUIRE_FALSE(cache.find("/sync/b", state));
+}
@@ -0,0 +1,317 @@
+#include <catch.hpp>
+#include "mega_ext_cache.h"
+#include "megasync-plugin-cache.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace
+{
+constexpr int FILES{2000};
+constexpr int LISTINGS{10};
+constexpr int CHANGES_PER_LISTING{50};
+
+QByteArray filePath(int file)
+{
+    return "/sync/folder/file" + QByteArray::number(file);
+}
+
+template <typename Condition>
+bool processEventsUntil(Condition condition, int timeoutMs = 5000)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while(!condition() && timer.elapsed() < timeoutMs)
+    {
+        QCoreApplication::processEvents();
+    }
+    return condition();
+}
+
+//Stand-in for the ExtServer, which answers "P:<path>" lines with the state of the path,
+//and for the NotifyServer, which sends a "P<path>" line to its clients when the state of a path changes
+class StandInServers
+{
+public:
+    StandInServers()
+        : mRequests(0)
+    {
+        auto pid(QCoreApplication::applicationPid());
+        mExtServerName = QString::fromLatin1("megasync-ext-test-%1").arg(pid);
+        mNotifyServerName = QString::fromLatin1("megasync-notify-test-%1").arg(pid);
+        QLocalServer::removeServer(mExtServerName);
+        QLocalServer::removeServer(mNotifyServerName);
+        mExtServer.listen(mExtServerName);
+        mNotifyServer.listen(mNotifyServerName);
+
+        QObject::connect(&mExtServer, &QLocalServer::newConnection, [this]()
+        {
+            while(auto client = mExtServer.nextPendingConnection())
+            {
+                QObject::connect(client, &QLocalSocket::readyRead, [this, client]()
+                {
+                    while(client->canReadLine())
+                    {
+                        QByteArray path = client->readLine().mid(2);
+                        path.chop(1);
+                        mRequests++;
+                        client->write(QByteArray::number(mStates.value(path, 9)) + '\n');
+                    }
+                });
+            }
+        });
+        QObject::connect(&mNotifyServer, &QLocalServer::newConnection, [this]()
+        {
+            while(auto client = mNotifyServer.nextPendingConnection())
+            {
+                mNotifyClients.push_back(client);
+            }
+        });
+    }
+
+    QString extServerName() const {return mExtServerName;}
+    QString notifyServerName() const {return mNotifyServerName;}
+    int requests() const {return mRequests;}
+    bool hasNotifyClient() const {return !mNotifyClients.empty();}
+
+    int state(const QByteArray& path) const
+    {
+        return mStates.value(path, 9);
+    }
+
+    void setState(const QByteArray& path, int state)
+    {
+        mStates[path] = state;
+        for(auto client : mNotifyClients)
+        {
+            client->write("P" + path + '\n');
+            client->flush();
+        }
+    }
+
+private:
+    QLocalServer mExtServer;
+    QLocalServer mNotifyServer;
+    QString mExtServerName;
+    QString mNotifyServerName;
+    std::vector<QLocalSocket*> mNotifyClients;
+    QHash<QByteArray, int> mStates;
+    int mRequests;
+};
+
+//Shell extension side of the IPC: asks the ExtServer only for the paths missing from its cache,
+//and drops the paths notified by the NotifyServer. find, insert and remove are the cache under test
+class ShellExtClient
+{
+public:
+    ShellExtClient(const StandInServers& servers,
+                   std::function<bool(const QByteArray&, int&)> find,
+                   std::function<void(const QByteArray&, int)> insert,
+                   std::function<void(const QByteArray&)> remove)
+        : mFind(find),
+          mInsert(insert),
+          mRemove(remove),
+          mNotifications(0)
+    {
+        QObject::connect(&mNotifySocket, &QLocalSocket::readyRead, [this]()
+        {
+            while(mNotifySocket.canReadLine())
+            {
+                QByteArray line = mNotifySocket.readLine();
+                line.chop(1);
+                if(line.startsWith('P'))
+                {
+                    mRemove(line.mid(1));
+                }
+                mNotifications++;
+            }
+        });
+        mExtSocket.connectToServer(servers.extServerName());
+        mNotifySocket.connectToServer(servers.notifyServerName());
+    }
+
+    int state(const QByteArray& path)
+    {
+        int state(0);
+        if(mFind(path, state))
+        {
+            return state;
+        }
+
+        mExtSocket.write("P:" + path + '\n');
+        mExtSocket.flush();
+        processEventsUntil([this](){ return mExtSocket.canReadLine(); });
+
+        state = mExtSocket.readLine().trimmed().toInt();
+        mInsert(path, state);
+        return state;
+    }
+
+    int notifications() const
+    {
+        return mNotifications;
+    }
+
+private:
+    std::function<bool(const QByteArray&, int&)> mFind;
+    std::function<void(const QByteArray&, int)> mInsert;
+    std::function<void(const QByteArray&)> mRemove;
+    QLocalSocket mExtSocket;
+    QLocalSocket mNotifySocket;
+    int mNotifications;
+};
+
+//Replays directory listings as a file manager does, with the 'P' notifications of the NotifyServer in between.
+//Returns the number of states asked to the ExtServer
+int replayListings(std::function<bool(const QByteArray&, int&)> find,
+                   std::function<void(const QByteArray&, int)> insert,
+                   std::function<void(const QByteArray&)> remove)
+{
+    StandInServers servers;
+    for(int file = 0; file < FILES; ++file)
+    {
+        servers.setState(filePath(file), 1);
+    }
+
+    ShellExtClient client(servers, find, insert, remove);
+    REQUIRE(processEventsUntil([&servers](){ return servers.hasNotifyClient(); }));
+
+    for(int listing = 0; listing < LISTINGS; ++listing)
+    {
+        for(int file = 0; file < FILES; ++file)
+        {
+            auto path(filePath(file));
+            REQUIRE(client.state(path) == servers.state(path));
+        }
+
+        //Some files start syncing: the NotifyServer sends a 'P' notification for each of them
+        for(int change = 0; change < CHANGES_PER_LISTING; ++change)
+        {
+            auto path(filePath((listing * CHANGES_PER_LISTING + change) % FILES));
+            servers.setState(path, (servers.state(path) == 1) ? 3 : 1);
+        }
+        auto notifications((listing + 1) * CHANGES_PER_LISTING);
+        REQUIRE(processEventsUntil([&client, notifications](){ return client.notifications() == notifications; }));
+    }
+    return servers.requests();
+}
+
+//Only the first listing and the notified paths reach the server
+constexpr int EXPECTED_REQUESTS{FILES + (LISTINGS - 1) * CHANGES_PER_LISTING};
+}
+
+TEST_CASE("Nautilus and Nemo path state cache drops the least recently used paths")
+{
+    MEGAExtCache* cache(mega_ext_cache_new(2));
+    int state(0);
+
+    mega_ext_cache_insert(cache, "/sync/a", 1);
+    mega_ext_cache_insert(cache, "/sync/b", 2);
+    REQUIRE(mega_ext_cache_lookup(cache, "/sync/a", &state));
+    REQUIRE(state == 1);
+
+    mega_ext_cache_insert(cache, "/sync/c", 3);
+    REQUIRE_FALSE(mega_ext_cache_lookup(cache, "/sync/b", &state));
+    REQUIRE(mega_ext_cache_lookup(cache, "/sync/c", &state));
+    REQUIRE(state == 3);
+    REQUIRE(mega_ext_cache_hits(cache) == 2);
+    REQUIRE(mega_ext_cache_misses(cache) == 1);
+
+    mega_ext_cache_free(cache);
+}
+
+TEST_CASE("Nautilus and Nemo path state cache removes the items of a changed folder")
+{
+    MEGAExtCache* cache(mega_ext_cache_new(16));
+    int state(0);
+
+    mega_ext_cache_insert(cache, "/sync/folder", 1);
+    mega_ext_cache_insert(cache, "/sync/folder/a", 1);
+    mega_ext_cache_insert(cache, "/sync/folder/sub/b", 1);
+    mega_ext_cache_insert(cache, "/sync/folder2/c", 1);
+
+    mega_ext_cache_remove_children(cache, "/sync/folder");
+    REQUIRE(mega_ext_cache_lookup(cache, "/sync/folder", &state));
+    REQUIRE_FALSE(mega_ext_cache_lookup(cache, "/sync/folder/a", &state));
+    REQUIRE_FALSE(mega_ext_cache_lookup(cache, "/sync/folder/sub/b", &state));
+    REQUIRE(mega_ext_cache_lookup(cache, "/sync/folder2/c", &state));
+
+    mega_ext_cache_clear(cache);
+    REQUIRE_FALSE(mega_ext_cache_lookup(cache, "/sync/folder", &state));
+
+    mega_ext_cache_free(cache);
+}
+
+TEST_CASE("Nautilus and Nemo path state cache replays directory listings with change notifications")
+{
+    MEGAExtCache* cache(mega_ext_cache_new(65536));
+
+    auto requests = replayListings(
+        [cache](const QByteArray& path, int& state) {return mega_ext_cache_lookup(cache, path.constData(), &state);},
+        [cache](const QByteArray& path, int state) {mega_ext_cache_insert(cache, path.constData(), state);},
+        [cache](const QByteArray& path) {mega_ext_cache_remove(cache, path.constData());});
+
+    REQUIRE(requests == EXPECTED_REQUESTS);
+    REQUIRE(mega_ext_cache_misses(cache) == static_cast<guint64>(requests));
+    REQUIRE(mega_ext_cache_hits(cache) == static_cast<guint64>(FILES * LISTINGS - requests));
+
+    mega_ext_cache_free(cache);
+}
+
+TEST_CASE("Dolphin path state cache drops the least recently used paths")
+{
+    MegasyncPathStateCache cache(2);
+    int state(0);
+
+    cache.insert(QLatin1String("/sync/a"), 1);
+    cache.insert(QLatin1String("/sync/b"), 2);
+    REQUIRE(cache.find(QLatin1String("/sync/a"), state));
+    REQUIRE(state == 1);
+
+    cache.insert(QLatin1String("/sync/c"), 3);
+    REQUIRE(cache.size() == 2);
+    REQUIRE_FALSE(cache.find(QLatin1String("/sync/b"), state));
+    REQUIRE(cache.find(QLatin1String("/sync/c"), state));
+    REQUIRE(state == 3);
+}
+
+TEST_CASE("Dolphin path state cache removes the items of a changed folder")
+{
+    MegasyncPathStateCache cache(16);
+    int state(0);
+
+    cache.insert(QLatin1String("/sync/folder"), 1);
+    cache.insert(QLatin1String("/sync/folder/a"), 1);
+    cache.insert(QLatin1String("/sync/folder/sub/b"), 1);
+    cache.insert(QLatin1String("/sync/folder2/c"), 1);
+
+    auto removed(cache.removeChildren(QLatin1String("/sync/folder")));
+    removed.sort();
+    REQUIRE(removed == QStringList({QLatin1String("/sync/folder/a"), QLatin1String("/sync/folder/sub/b")}));
+    REQUIRE(cache.find(QLatin1String("/sync/folder"), state));
+    REQUIRE(cache.find(QLatin1String("/sync/folder2/c"), state));
+
+    cache.clear();
+    REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("Dolphin path state cache replays directory listings with change notifications")
+{
+    MegasyncPathStateCache cache(65536);
+
+    auto requests = replayListings(
+        [&cache](const QByteArray& path, int& state) {return cache.find(QString::fromUtf8(path), state);},
+        [&cache](const QByteArray& path, int state) {cache.insert(QString::fromUtf8(path), state);},
+        [&cache](const QByteArray& path) {cache.remove(QString::fromUtf8(path));});
+
+    REQUIRE(requests == EXPECTED_REQUESTS);
+    REQUIRE(cache.misses() == requests);
+    REQUIRE(cache.hits() == FILES * LISTINGS - requests);
+}
@@ -0,0 +1,106 @@
+#include <catch.hpp>
+#include "DuplicatedNodeDialogs/DuplicatedNameAllocator.h"
+#include "FakeMegaNode.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <iostream>
+
+namespace
+{
+const mega::MegaHandle PARENT_HANDLE = 5;
+}
+
+TEST_CASE("Duplicated name allocator hands out the free numbers")
+{
+    FakeMegaNode parent(PARENT_HANDLE, mega::INVALID_HANDLE, "Parent");
+    FakeMegaNodeList children;
+    children.add("photo.jpg", mega::MegaNode::TYPE_FILE);
+    children.add("photo(1).jpg", mega::MegaNode::TYPE_FILE);
+    children.add("photo(2).jpg", mega::MegaNode::TYPE_FILE);
+    children.add("photo(4).jpg", mega::MegaNode::TYPE_FILE);
+    children.add("photo(03).jpg", mega::MegaNode::TYPE_FILE);
+    children.add("photo(3).jpg", mega::MegaNode::TYPE_FOLDER);
+    children.add("a(1)(2).txt", mega::MegaNode::TYPE_FILE);
+
+    DuplicatedNameAllocator allocator;
+    allocator.addChildren(PARENT_HANDLE, &children);
+
+    SECTION("Numbers used by files of the same name are skipped")
+    {
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo"), QLatin1String(".jpg"), true) == QLatin1String("photo(3).jpg"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo"), QLatin1String(".jpg"), true) == QLatin1String("photo(5).jpg"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo"), QLatin1String(".jpg"), true) == QLatin1String("photo(6).jpg"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo"), QLatin1String(".png"), true) == QLatin1String("photo(1).png"));
+    }
+
+    SECTION("Folders only conflict with folders")
+    {
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo(3).jpg"), QString(), false) == QLatin1String("photo(3).jpg(1)"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("photo"), QLatin1String(".jpg"), false) == QLatin1String("photo(1).jpg"));
+    }
+
+    SECTION("Every number of a name is parsed")
+    {
+        REQUIRE(allocator.nextName(&parent, QLatin1String("a(1)"), QLatin1String(".txt"), true) == QLatin1String("a(1)(1).txt"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("a"), QLatin1String(".txt"), true) == QLatin1String("a(1).txt"));
+        REQUIRE(allocator.nextName(&parent, QLatin1String("a"), QLatin1String("(2).txt"), true) == QLatin1String("a(2)(2).txt"));
+    }
+
+    SECTION("Parents are independent")
+    {
+        FakeMegaNode otherParent(PARENT_HANDLE + 1, mega::INVALID_HANDLE, "Other");
+        allocator.addChildren(PARENT_HANDLE + 1, nullptr);
+        REQUIRE(allocator.nextName(&otherParent, QLatin1String("photo"), QLatin1String(".jpg"), true) == QLatin1String("photo(1).jpg"));
+    }
+}
+
+TEST_CASE("Duplicated name allocator benchmark", "[.benchmark]")
+{
+    //Renaming all of 1000 uploads of a file into a folder with 1000 numbered copies of it
+    constexpr int copies{1000};
+    constexpr int conflicts{1000};
+
+    FakeMegaNode parent(PARENT_HANDLE, mega::INVALID_HANDLE, "Parent");
+    FakeMegaNodeList children;
+    QSet<QString> names;
+    for(int copy = 1; copy <= copies; ++copy)
+    {
+        auto name = DuplicatedNameAllocator::numberedName(QLatin1String("report"), copy, QLatin1String(".pdf"));
+        children.add(name.toStdString(), mega::MegaNode::TYPE_FILE);
+        names.insert(name);
+    }
+
+    //One lookup per candidate, as getChildNodeOfType was called before. A hash is much faster than the SDK call
+    QElapsedTimer timer;
+    timer.start();
+    long long lookups(0);
+    for(int conflict = 0; conflict < conflicts; ++conflict)
+    {
+        for(int number = 1; ; ++number)
+        {
+            lookups++;
+            if(!names.contains(DuplicatedNameAllocator::numberedName(QLatin1String("report"), number, QLatin1String(".pdf"))))
+            {
+                break;
+            }
+        }
+    }
+    auto lookupUs(timer.nsecsElapsed() / 1000);
+
+    timer.start();
+    DuplicatedNameAllocator allocator;
+    allocator.addChildren(PARENT_HANDLE, &children);
+    QString lastName;
+    for(int conflict = 0; conflict < conflicts; ++conflict)
+    {
+        lastName = allocator.nextName(&parent, QLatin1String("report"), QLatin1String(".pdf"), true);
+    }
+    auto allocatorUs(timer.nsecsElapsed() / 1000);
+
+    std::cout << conflicts << " new names: " << lookups << " lookups in " << lookupUs << " us one by one, "
+              << allocatorUs << " us with the allocator" << std::endl;
+
+    REQUIRE(lastName == DuplicatedNameAllocator::numberedName(QLatin1String("report"), copies + conflicts, QLatin1String(".pdf")));
+}
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include "DuplicatedNodeDialogs/DuplicatedUploadPreflight.h"
+#include "FakeMegaNode.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+void createFile(const QString& path)
+{
+    QFile file(path);
+    REQUIRE(file.open(QIODevice::WriteOnly));
+}
+}
+
+TEST_CASE("Upload preflight finds conflicts by name and type")
+{
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+    QDir localDir(dir.path());
+    createFile(localDir.filePath(QLatin1String("a.txt")));
+    createFile(localDir.filePath(QLatin1String("b.txt")));
+    REQUIRE(localDir.mkdir(QLatin1String("Photos")));
+    REQUIRE(localDir.mkdir(QLatin1String("Docs")));
+
+    auto children = new FakeMegaNodeList();
+    children->add("a.txt", mega::MegaNode::TYPE_FILE);
+    children->add("a.txt", mega::MegaNode::TYPE_FILE);
+    children->add("b.txt", mega::MegaNode::TYPE_FOLDER);
+    children->add("Photos", mega::MegaNode::TYPE_FOLDER);
+    ChildNameIndex index(children);
+    REQUIRE(index.size() == 4);
+
+    auto entries = DuplicatedUploadPreflight::check(QStringList() << localDir.filePath(QLatin1String("a.txt"))
+                                                                  << localDir.filePath(QLatin1String("b.txt"))
+                                                                  << localDir.filePath(QLatin1String("Photos"))
+                                                                  << localDir.filePath(QLatin1String("Docs")),
+                                                    index);
+    REQUIRE(entries.size() == 4);
+
+    //The first child with the name is found, like getChildNodeOfType does
+    REQUIRE(entries[0].isFile);
+    REQUIRE(entries[0].conflictNode);
+    REQUIRE(entries[0].conflictNode->getHandle() == 1);
+
+    //A folder with the same name is not a conflict for a file
+    REQUIRE(entries[1].isFile);
+    REQUIRE_FALSE(entries[1].conflictNode);
+
+    REQUIRE_FALSE(entries[2].isFile);
+    REQUIRE(entries[2].conflictNode);
+    REQUIRE(entries[2].conflictNode->getHandle() == 4);
+
+    REQUIRE_FALSE(entries[3].isFile);
+    REQUIRE_FALSE(entries[3].conflictNode);
+
+    REQUIRE_FALSE(ChildNameIndex().find(QLatin1String("a.txt"), true));
+}
+
+TEST_CASE("Upload preflight allocates the new names from the listed children")
+{
+    auto children = new FakeMegaNodeList();
+    children->add("a.txt", mega::MegaNode::TYPE_FILE);
+    children->add("a(1).txt", mega::MegaNode::TYPE_FILE);
+    children->add("a(2).txt", mega::MegaNode::TYPE_FOLDER);
+    ChildNameIndex index(children);
+
+    //The parent is already parsed, so no listing is needed for the names
+    auto nameAllocator = DuplicatedUploadPreflight::createNameAllocator(mega::INVALID_HANDLE, index);
+    REQUIRE(nameAllocator->nextName(nullptr, QLatin1String("a"), QLatin1String(".txt"), true) == QLatin1String("a(2).txt"));
+    REQUIRE(nameAllocator->nextName(nullptr, QLatin1String("a"), QLatin1String(".txt"), true) == QLatin1String("a(3).txt"));
+    REQUIRE(nameAllocator->nextName(nullptr, QLatin1String("a"), QLatin1String(".txt"), false) == QLatin1String("a(1).txt"));
+}
+
+TEST_CASE("Upload preflight benchmark", "[.benchmark]")
+{
+    //A drop of 100k files into a folder which already has half of them
+    constexpr int files{100000};
+
+    QTemporaryDir dir;
+    QDir localDir(dir.path());
+    QStringList localPaths;
+    auto children = new FakeMegaNodeList();
+    for(int file = 0; file < files; ++file)
+    {
+        auto name = QString::fromLatin1("IMG_%1.jpg").arg(file, 6, 10, QLatin1Char('0'));
+        localPaths.append(localDir.filePath(name));
+        createFile(localPaths.back());
+        if(file % 2 == 0)
+        {
+            children->add(name.toStdString(), mega::MegaNode::TYPE_FILE);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    ChildNameIndex index(children);
+    auto indexMs(timer.elapsed());
+
+    //One path after the other, as the GUI thread checked them before
+    timer.start();
+    int serialConflicts(0);
+    for(const auto& localPath : localPaths)
+    {
+        QFileInfo fileInfo(localPath);
+        serialConflicts += index.find(QDir(localPath).dirName(), fileInfo.isFile()) ? 1 : 0;
+    }
+    auto serialMs(timer.elapsed());
+
+    timer.start();
+    int conflicts(0);
+    for(int begin = 0; begin < localPaths.size(); begin += DuplicatedUploadPreflight::BLOCK_SIZE)
+    {
+        for(const auto& entry : DuplicatedUploadPreflight::check(localPaths.mid(begin, DuplicatedUploadPreflight::BLOCK_SIZE), index))
+        {
+            conflicts += entry.conflictNode ? 1 : 0;
+        }
+    }
+    auto parallelMs(timer.elapsed());
+
+    std::cout << "Indexed " << index.size() << " children in " << indexMs << " ms. Checked " << files << " files: "
+              << files * 1000LL / std::max(serialMs, 1LL) << " files/s one by one, "
+              << files * 1000LL / std::max(parallelMs, 1LL) << " files/s in parallel blocks" << std::endl;
+
+    REQUIRE(serialConflicts == files / 2);
+    REQUIRE(conflicts == files / 2);
+}
@@ -0,0 +1,170 @@
+#include <catch.hpp>
+#include "TransferColumnStore.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QReadWriteLock>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+namespace
+{
+//Memory committed by the process, where the platform reports it. Zero otherwise
+long long processMemoryBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc)))
+    {
+        return static_cast<long long>(pmc.PrivateUsage);
+    }
+#elif defined(__APPLE__)
+    struct task_basic_info info;
+    mach_msg_type_number_t infoCount = TASK_BASIC_INFO_COUNT;
+    if(task_info(mach_task_self(), TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &infoCount) == KERN_SUCCESS)
+    {
+        return static_cast<long long>(info.resident_size);
+    }
+#else
+    QFile statm(QLatin1String("/proc/self/statm"));
+    if(statm.open(QIODevice::ReadOnly))
+    {
+        auto pages = statm.readAll().split(' ');
+        if(pages.size() > 1)
+        {
+            return pages.at(1).toLongLong() * sysconf(_SC_PAGESIZE);
+        }
+    }
+#endif
+    return 0;
+}
+
+QVariant legacyData(const QList<QExplicitlySharedDataPointer<TransferData>>& rows, QReadWriteLock& dataMutex, int row)
+{
+    QExplicitlySharedDataPointer<TransferData> transfer;
+    dataMutex.lockForRead();
+    transfer = rows.at(row);
+    dataMutex.unlock();
+    return QVariant::fromValue(TransferItem(transfer));
+}
+
+QExplicitlySharedDataPointer<TransferData> createTransfer(int tag, unsigned long long size, const QString& name)
+{
+    QExplicitlySharedDataPointer<TransferData> data(new TransferData());
+    data->mTag = tag;
+    data->mType = TransferData::TRANSFER_UPLOAD;
+    data->mTotalSize = size;
+    data->mTransferredBytes = size;
+    data->mSpeed = size / 10;
+    data->mPriority = static_cast<unsigned long long>(tag);
+    data->mFilename = name;
+    data->setState(TransferData::TRANSFER_COMPLETED);
+    return data;
+}
+}
+
+TEST_CASE("Transfer column store keeps columns aligned with rows")
+{
+    TransferColumnStore store;
+    store.append(*createTransfer(1, 300, QLatin1String("b.txt")));
+    store.append(*createTransfer(2, 100, QLatin1String("a.txt")));
+    store.append(*createTransfer(3, 200, QLatin1String("b.txt")));
+
+    REQUIRE(store.size() == 3);
+    REQUIRE(store.row(1).tag == 2);
+    REQUIRE(store.row(1).isCompleted());
+    REQUIRE(store.name(2) == QLatin1String("b.txt"));
+
+    bool comparable(false);
+    REQUIRE(store.lessThan(SortCriterion::TOTAL_SIZE, 1, 2, comparable));
+    REQUIRE(comparable);
+    REQUIRE(store.lessThan(SortCriterion::NAME, 1, 0, comparable));
+
+    store.remove(0);
+    REQUIRE(store.size() == 2);
+    REQUIRE(store.row(0).tag == 2);
+    REQUIRE(store.name(1) == QLatin1String("b.txt"));
+
+    auto renamed = createTransfer(3, 50, QLatin1String("c.txt"));
+    auto changedKeys = store.update(1, *renamed);
+    REQUIRE(store.name(1) == QLatin1String("c.txt"));
+    REQUIRE_FALSE(store.lessThan(SortCriterion::TOTAL_SIZE, 0, 1, comparable));
+    REQUIRE(changedKeys & TransferColumnStore::sortKey(SortCriterion::NAME));
+    REQUIRE(changedKeys & TransferColumnStore::sortKey(SortCriterion::TOTAL_SIZE));
+    REQUIRE_FALSE(changedKeys & TransferColumnStore::sortKey(SortCriterion::PRIORITY));
+
+    //Only the keys whose value is different are reported
+    renamed->mSpeed++;
+    REQUIRE(store.update(1, *renamed) == TransferColumnStore::sortKey(SortCriterion::SPEED));
+    REQUIRE(store.update(1, *renamed) == 0);
+}
+
+TEST_CASE("Transfer column store memory and sort benchmark", "[.benchmark]")
+{
+    constexpr int transfers{200000};
+    std::mt19937 random(42);
+    std::uniform_int_distribution<unsigned long long> sizes(1, 1ULL << 32);
+
+    //The model keeps both, as the delegates still read the TransferData rows
+    auto startMemory(processMemoryBytes());
+    QList<QExplicitlySharedDataPointer<TransferData>> rows;
+    for(int tag = 0; tag < transfers; ++tag)
+    {
+        //Many finished transfers share names (camera uploads, backups of the same tree...)
+        rows.append(createTransfer(tag, sizes(random), QString::fromLatin1("IMG_%1.jpg").arg(tag % 5000)));
+    }
+    auto rowsMemory(processMemoryBytes() - startMemory);
+
+    TransferColumnStore store;
+    store.reserve(transfers);
+    for(const auto& data : rows)
+    {
+        store.append(*data);
+    }
+    auto columnsMemory(processMemoryBytes() - startMemory - rowsMemory);
+
+    std::vector<int> order(transfers);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random);
+    QReadWriteLock dataMutex;
+
+    //As the proxy did before: each side read through TransfersModel::data and getTransfer, under the data lock
+    auto rowOrder(order);
+    QElapsedTimer timer;
+    timer.start();
+    std::sort(rowOrder.begin(), rowOrder.end(), [&rows, &dataMutex](int left, int right){
+        auto leftItem(qvariant_cast<TransferItem>(legacyData(rows, dataMutex, left)).getTransferData());
+        auto rightItem(qvariant_cast<TransferItem>(legacyData(rows, dataMutex, right)).getTransferData());
+        return leftItem->mTotalSize < rightItem->mTotalSize;
+    });
+    auto rowsSortMs = timer.elapsed();
+
+    //As the proxy does: one data lock for the whole sort, held while the columns are compared
+    auto columnOrder(order);
+    timer.restart();
+    dataMutex.lockForRead();
+    std::sort(columnOrder.begin(), columnOrder.end(), [&store](int left, int right){
+        bool comparable;
+        return store.lessThan(SortCriterion::TOTAL_SIZE, left, right, comparable);
+    });
+    dataMutex.unlock();
+    auto columnsSortMs = timer.elapsed();
+
+    std::cout << "Transfer rows: " << rowsMemory / transfers << " bytes/transfer, sort by size " << rowsSortMs << " ms" << std::endl;
+    std::cout << "Transfer rows and columns: " << (rowsMemory + columnsMemory) / transfers << " bytes/transfer ("
+              << store.memoryUsage() / transfers << " estimated for the columns), sort by size " << columnsSortMs << " ms" << std::endl;
+
+    REQUIRE(rowOrder == columnOrder);
+}
@@ -0,0 +1,91 @@
+#include <catch.hpp>
+#include "TransferMetaData.h"
+
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const unsigned long long FIRST_APP_ID = 1000000;
+}
+
+TEST_CASE("Transfer metadata container finds batches by folder transfer tag")
+{
+    auto first = TransferMetaDataContainer::createTransferMetaDataWithappDataId<UploadTransferMetaData>(FIRST_APP_ID, mega::INVALID_HANDLE);
+    auto second = TransferMetaDataContainer::createTransferMetaDataWithappDataId<UploadTransferMetaData>(FIRST_APP_ID + 1, mega::INVALID_HANDLE);
+
+    first->addFileFromFolder(10, 11);
+    first->addFileFromFolder(10, 12);
+    second->addFileFromFolder(20, 21);
+
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(10) == first);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag<UploadTransferMetaData>(20) == second);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag<DownloadTransferMetaData>(20) == nullptr);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(30) == nullptr);
+    REQUIRE(first->getTotalFiles() == 2);
+    REQUIRE(first->getFirstTransferIdByState(TransferData::TRANSFER_ACTIVE).isValid());
+    REQUIRE(first->getTransferIdsByState(TransferData::TRANSFER_ACTIVE).size() == 2);
+
+    //Removed batches are not returned even if they are still indexed
+    TransferMetaDataContainer::removeAppData(first->getAppId());
+    REQUIRE(TransferMetaDataContainer::getAppData(FIRST_APP_ID) == nullptr);
+    REQUIRE(TransferMetaDataContainer::getAppDataByFolderTransferTag(10) == nullptr);
+    REQUIRE(TransferMetaDataContainer::getAppData<UploadTransferMetaData>(FIRST_APP_ID + 1) == second);
+
+    TransferMetaDataContainer::removeAppData(second->getAppId());
+}
+
+TEST_CASE("Transfer metadata returns the pending transfers in tag order")
+{
+    auto data = TransferMetaDataContainer::createTransferMetaDataWithappDataId<UploadTransferMetaData>(FIRST_APP_ID, mega::INVALID_HANDLE);
+
+    //The SDK may start the files of a folder in any order
+    for(int tag = 200; tag > 100; --tag)
+    {
+        data->addFileFromFolder(100, tag);
+    }
+
+    REQUIRE(data->getFirstTransferIdByState(TransferData::TRANSFER_ACTIVE).tag == 101);
+    auto ids(data->getTransferIdsByState(TransferData::TRANSFER_ACTIVE));
+    REQUIRE(ids.size() == 100);
+    REQUIRE(std::is_sorted(ids.begin(), ids.end()));
+
+    TransferMetaDataContainer::removeAppData(data->getAppId());
+}
+
+TEST_CASE("Transfer metadata container lookup benchmark", "[.benchmark]")
+{
+    //200 batches with one folder each, and 200k files in the last one
+    constexpr int batches{200};
+    constexpr int files{200000};
+
+    std::vector<std::shared_ptr<UploadTransferMetaData>> data;
+    for(int batch = 0; batch < batches; ++batch)
+    {
+        data.push_back(TransferMetaDataContainer::createTransferMetaDataWithappDataId<UploadTransferMetaData>(
+                           FIRST_APP_ID + static_cast<unsigned long long>(batch), mega::INVALID_HANDLE));
+        data.back()->addFileFromFolder(batch + 1, batches + batch + 1);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    auto lastFolderTag(batches);
+    for(int file = 0; file < files; ++file)
+    {
+        auto batchData = TransferMetaDataContainer::getAppDataByFolderTransferTag(lastFolderTag);
+        batchData->addFileFromFolder(lastFolderTag, 2 * batches + file + 1);
+    }
+    auto elapsedNs(timer.nsecsElapsed());
+
+    std::cout << "Started " << files << " files of a folder in " << elapsedNs / 1000000 << " ms ("
+              << elapsedNs / files << " ns/file)" << std::endl;
+
+    REQUIRE(data.back()->getTotalFiles() == files + 1);
+    for(auto& batchData : data)
+    {
+        TransferMetaDataContainer::removeAppData(batchData->getAppId());
+    }
+}
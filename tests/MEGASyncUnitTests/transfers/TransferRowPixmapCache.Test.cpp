@@ -0,0 +1,173 @@
+#include <catch.hpp>
+#include "TransferRowPixmapCache.h"
+#include "TransferManagerDelegateWidget.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const QSize ROW_SIZE(772, 64);
+
+QExplicitlySharedDataPointer<TransferData> createActiveTransfer(int tag)
+{
+    QExplicitlySharedDataPointer<TransferData> data(new TransferData());
+    data->mTag = tag;
+    data->mType = TransferData::TRANSFER_DOWNLOAD;
+    data->mFilename = QString::fromLatin1("IMG_%1.jpg").arg(tag);
+    data->mTotalSize = 10 * 1024 * 1024;
+    data->mTransferredBytes = static_cast<unsigned long long>(tag) * 1024;
+    data->mSpeed = 1024 * 1024;
+    data->mRemainingTime = 10;
+    data->setState(TransferData::TRANSFER_ACTIVE);
+    return data;
+}
+
+QPixmap createRowPixmap()
+{
+    QPixmap pixmap(ROW_SIZE);
+    pixmap.fill(Qt::transparent);
+    return pixmap;
+}
+}
+
+TEST_CASE("Transfer row pixmap cache only returns rows with the same content and size")
+{
+    TransferRowPixmapCache cache;
+    auto data = createActiveTransfer(1);
+    auto key = TransferRowPixmapCache::contentKey(*data);
+
+    REQUIRE(cache.find(1, key, ROW_SIZE) == nullptr);
+    REQUIRE(cache.insert(1, key, createRowPixmap()) != nullptr);
+    REQUIRE(cache.find(1, key, ROW_SIZE) != nullptr);
+    REQUIRE(cache.find(1, key, ROW_SIZE * 2) == nullptr);
+
+    data->mTransferredBytes += 1024;
+    auto newKey = TransferRowPixmapCache::contentKey(*data);
+    REQUIRE(newKey != key);
+    REQUIRE(cache.find(1, newKey, ROW_SIZE) == nullptr);
+
+    REQUIRE(cache.hits() == 1);
+    REQUIRE(cache.misses() == 3);
+}
+
+TEST_CASE("Transfer row pixmap cache drops the least recently used rows")
+{
+    auto rowBytes(ROW_SIZE.width() * ROW_SIZE.height() * createRowPixmap().depth() / 8);
+    TransferRowPixmapCache cache(rowBytes * 2);
+
+    cache.insert(1, 0, createRowPixmap());
+    cache.insert(2, 0, createRowPixmap());
+    REQUIRE(cache.find(1, 0, ROW_SIZE) != nullptr);
+
+    cache.insert(3, 0, createRowPixmap());
+    REQUIRE(cache.size() == 2);
+    REQUIRE(cache.find(1, 0, ROW_SIZE) != nullptr);
+    REQUIRE(cache.find(2, 0, ROW_SIZE) == nullptr);
+    REQUIRE(cache.find(3, 0, ROW_SIZE) != nullptr);
+}
+
+TEST_CASE("Transfer rows scroll and repaint frame time benchmark", "[.benchmark]")
+{
+    //Scrolls one row per frame over active transfers, while a tenth of the visible rows progress every frame
+    constexpr int transfers{5000};
+    constexpr int visibleRows{12};
+    constexpr int frames{600};
+
+    std::vector<QExplicitlySharedDataPointer<TransferData>> rows;
+    for(int tag = 0; tag < transfers; ++tag)
+    {
+        rows.push_back(createActiveTransfer(tag));
+    }
+
+    std::vector<TransferManagerDelegateWidget*> widgets;
+    for(int row = 0; row < visibleRows + 1; ++row)
+    {
+        auto widget = new TransferManagerDelegateWidget();
+        widget->resize(ROW_SIZE);
+        widgets.push_back(widget);
+    }
+
+    QImage viewport(ROW_SIZE.width(), ROW_SIZE.height() * visibleRows, QImage::Format_ARGB32_Premultiplied);
+    TransferRowPixmapCache cache;
+
+    auto runFrames = [&](bool useCache)
+    {
+        std::vector<double> frameTimes;
+        QElapsedTimer timer;
+
+        for(int frame = 0; frame < frames; ++frame)
+        {
+            //Scroll down and then up again, so the rows are painted again
+            auto firstRow((frame < frames / 2) ? frame : frames - frame);
+            timer.start();
+
+            QPainter painter(&viewport);
+            for(int visible = 0; visible < visibleRows; ++visible)
+            {
+                auto row(firstRow + visible);
+                auto data = rows[static_cast<size_t>(row)];
+                if(row % 10 == frame % 10)
+                {
+                    data->mTransferredBytes += 1024;
+                }
+
+                auto widget(widgets[static_cast<size_t>(row % (visibleRows + 1))]);
+                painter.save();
+                painter.translate(0, visible * ROW_SIZE.height());
+
+                if(useCache)
+                {
+                    auto key(TransferRowPixmapCache::contentKey(*data));
+                    auto pixmap(cache.find(data->mTag, key, ROW_SIZE));
+                    if(!pixmap)
+                    {
+                        QPixmap rendered(ROW_SIZE);
+                        rendered.fill(Qt::transparent);
+                        QPainter rowPainter(&rendered);
+                        widget->updateUi(data, row);
+                        widget->renderContent(&rowPainter, QRegion(QRect(QPoint(), ROW_SIZE)));
+                        rowPainter.end();
+                        pixmap = cache.insert(data->mTag, key, rendered);
+                    }
+                    painter.drawPixmap(0, 0, *pixmap);
+                }
+                else
+                {
+                    widget->updateUi(data, row);
+                    widget->render(QStyleOptionViewItem(), &painter, QRegion(QRect(QPoint(), ROW_SIZE)));
+                }
+
+                painter.restore();
+            }
+            painter.end();
+
+            frameTimes.push_back(static_cast<double>(timer.nsecsElapsed()) / 1000000.0);
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        double total(0.0);
+        for(auto frameTime : frameTimes)
+        {
+            total += frameTime;
+        }
+
+        std::cout << (useCache ? "Cached rows: " : "Widget rows: ")
+                  << "mean " << total / frames << " ms/frame, p99 "
+                  << frameTimes[static_cast<size_t>(frames * 99 / 100)] << " ms/frame" << std::endl;
+    };
+
+    runFrames(false);
+    runFrames(true);
+
+    std::cout << "Row cache hit rate: "
+              << 100.0 * cache.hits() / std::max(1LL, cache.hits() + cache.misses()) << "%" << std::endl;
+
+    qDeleteAll(widgets);
+    REQUIRE(cache.hits() > 0);
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+#include "TransferTagIndex.h"
+
+#include <QElapsedTimer>
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+TEST_CASE("Transfer tag index follows rows after removals")
+{
+    TransferTagIndex index;
+    std::vector<TransferTag> rows;
+    std::mt19937 random(7);
+
+    TransferTag nextTag(1);
+    for(int operation = 0; operation < 5000; ++operation)
+    {
+        if(rows.empty() || random() % 3)
+        {
+            index.append(nextTag);
+            rows.push_back(nextTag++);
+        }
+        else
+        {
+            auto row = random() % rows.size();
+            index.remove(rows[row]);
+            rows.erase(rows.begin() + static_cast<long>(row));
+        }
+    }
+
+    REQUIRE(index.size() == static_cast<int>(rows.size()));
+    for(size_t row = 0; row < rows.size(); ++row)
+    {
+        REQUIRE(index.row(rows[row]) == static_cast<int>(row));
+    }
+
+    REQUIRE(index.row(nextTag) == -1);
+    REQUIRE_FALSE(index.contains(nextTag));
+}
+
+TEST_CASE("Transfer tag index clear completed benchmark", "[.benchmark]")
+{
+    //100k completed transfers interleaved with 100k active ones, cleared in one go
+    constexpr int transfers{200000};
+
+    TransferTagIndex index;
+    QList<TransferTag> completed;
+    for(TransferTag tag = 0; tag < transfers; ++tag)
+    {
+        index.append(tag);
+        if(tag % 2)
+        {
+            completed.append(tag);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    index.remove(completed);
+    auto removeMs = timer.elapsed();
+
+    timer.restart();
+    long long rowsSum(0);
+    for(TransferTag tag = 0; tag < transfers; tag += 2)
+    {
+        rowsSum += index.row(tag);
+    }
+    auto lookupMs = timer.elapsed();
+
+    std::cout << "Transfer tag index: cleared " << completed.size() << " completed transfers in "
+              << removeMs << " ms, " << index.size() << " row lookups in " << lookupMs << " ms" << std::endl;
+
+    REQUIRE(index.size() == transfers / 2);
+    REQUIRE(index.row(transfers - 2) == transfers / 2 - 1);
+    REQUIRE(rowsSum == static_cast<long long>(transfers / 2) * (transfers / 2 - 1) / 2);
+}